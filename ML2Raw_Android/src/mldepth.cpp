@@ -1,4 +1,8 @@
 #include "mldepth.h"
+#include "mldepthkernels.h"
+#include "mldepthnormals.h"
+#include "mldepthpyramid.h"
+#include "mlframeslot.h"
 
 #include <atomic>
 #include <mutex>
@@ -18,26 +22,68 @@ static std::atomic<bool> g_running{false};
 static std::thread g_thread;
 
 static MLHandle g_handle = ML_INVALID_HANDLE;
-static std::mutex g_lock;
+
+// Per-stream frame slots: the capture thread never waits for Unity readers
+// and readers never wait for the capture thread. One slot beyond the triple
+// buffer so a frame leased by Unity doesn't force the producer to drop.
+typedef FrameSlots<DepthFrameInfo, 4> DepthSlots;
 
 // Processed depth
-static DepthFrameInfo g_depthInfo{};
-static std::vector<uint8_t> g_depthBytes;
+static DepthSlots g_depthSlots;
 
 // Optional extras
-static DepthFrameInfo g_confInfo{};
-static std::vector<uint8_t> g_confBytes;
-
-static DepthFrameInfo g_flagsInfo{};
-static std::vector<uint8_t> g_flagsBytes;
-
-static DepthFrameInfo g_rawInfo{};
-static std::vector<uint8_t> g_rawBytes;
-
-static DepthFrameInfo g_ambientRawInfo{};
-static std::vector<uint8_t> g_ambientRawBytes;
-
-static uint32_t g_flagsMask = 0;
+static DepthSlots g_confSlots;
+static DepthSlots g_flagsSlots;
+static DepthSlots g_rawSlots;
+static DepthSlots g_ambientRawSlots;
+
+// Optional buffers requested from the SDK (MLDepthCameraFlags); can change at
+// runtime via MLDepthUnity_Reconfigure.
+static std::atomic<uint32_t> g_flagsMask{0};
+
+// Fused confidence/flag mask for processed depth (DepthMaskMode bits, 0 = off)
+static std::atomic<uint32_t> g_maskMode{0};
+static std::atomic<float> g_maskMinConfidence{0.0f};
+static std::atomic<uint32_t> g_maskRejectFlags{0};
+
+// Temporal filter (alpha <= 0 = off). The filter state is the previously
+// published filtered frame: the producer never rewrites the latest slot, so
+// it can read it while writing the next one, with no extra state buffer.
+static DepthSlots g_filteredSlots;
+static std::atomic<float> g_filterAlpha{0.0f};
+static std::atomic<float> g_filterResetThreshold{0.0f};
+static const DepthSlots::Slot* g_filterPrev = nullptr;  // capture thread only
+
+// Intrinsics and camera pose of the last frames, newest at g_calibrationNext - 1
+struct FrameCalibration {
+    DepthIntrinsics intrinsics;
+    DepthCameraPose pose;
+};
+static std::mutex g_intrinsicsLock;
+static FrameCalibration g_calibration[DEPTH_CALIBRATION_HISTORY]{};
+static uint32_t g_calibrationNext = 0;
+
+// History ring (depth + confidence), preallocated by MLDepthUnity_ConfigureHistory.
+// Entries are written in arrival order, so timestamps increase with age order.
+struct HistoryEntry {
+    DepthFrameInfo depthInfo;
+    DepthFrameInfo confInfo;
+    int32_t depthSize;
+    int32_t confSize;   // 0 if the frame had no confidence
+};
+
+// Largest buffer the SDK delivers: 544x480 float32 (depth and confidence).
+static constexpr int32_t HISTORY_MAX_FRAME_BYTES = 544 * 480 * 4;
+
+static std::mutex g_historyLock;
+static std::vector<HistoryEntry> g_historyEntries;
+static std::vector<uint8_t> g_historyDepth;   // capacity * HISTORY_MAX_FRAME_BYTES
+static std::vector<uint8_t> g_historyConf;    // capacity * HISTORY_MAX_FRAME_BYTES
+static int32_t g_historyHead = 0;             // next slot to write
+static int32_t g_historyCount = 0;
+static uint64_t g_historyStored = 0;
+static uint64_t g_historyOverwritten = 0;
+static uint64_t g_historyDropped = 0;
 
 // Stream constants - must match C# and SDK
 static constexpr uint32_t STREAM_LONG  = 1u << 0;  // MLDepthCameraStream_LongRange
@@ -53,6 +99,174 @@ static constexpr uint32_t EXPOSURE_SHORT_MAX = 375;
 static constexpr uint32_t EXPOSURE_SHORT_DEFAULT = 200;
 
 // ---------- Capture loop ----------
+// Returns a free slot with its info filled from fb, or nullptr to drop the frame.
+static DepthSlots::Slot* BeginStore(DepthSlots& slots, const MLDepthCameraFrameBuffer* fb, int64_t ts) {
+    if (!fb || !fb->data || fb->size == 0) return nullptr;
+
+    DepthSlots::Slot* slot = slots.BeginWrite();
+    if (!slot) {
+        // Every slot is pinned by a reader - drop rather than block.
+        static int dropCount = 0;
+        if (dropCount++ < 10) {
+            LOGW("All depth slots busy, dropping frame ts=%lld", (long long)ts);
+        }
+        return nullptr;
+    }
+
+    slot->info.width         = (int32_t)fb->width;
+    slot->info.height        = (int32_t)fb->height;
+    slot->info.strideBytes   = (int32_t)fb->stride;
+    slot->info.captureTimeNs = ts;
+    slot->info.bytesPerPixel = (int32_t)fb->bytes_per_unit;
+    slot->info.format        = 0;
+
+    slot->bytes.resize(fb->size);
+    return slot;
+}
+
+// Copies one SDK buffer into a free slot and publishes it.
+static const DepthSlots::Slot* StoreBuffer(DepthSlots& slots, const MLDepthCameraFrameBuffer* fb, int64_t ts) {
+    DepthSlots::Slot* slot = BeginStore(slots, fb, ts);
+    if (!slot) return nullptr;
+
+    std::memcpy(slot->bytes.data(), fb->data, fb->size);
+
+    slots.Publish(slot);
+    return slot;
+}
+
+// Returns fb if it can be read alongside depth (same size, 4 bytes/pixel).
+static const MLDepthCameraFrameBuffer* MatchingBuffer(const MLDepthCameraFrameBuffer* fb,
+                                                  const MLDepthCameraFrameBuffer* depth) {
+    if (!fb || !fb->data || fb->bytes_per_unit != 4) return nullptr;
+    if (fb->width != depth->width || fb->height != depth->height) return nullptr;
+    return fb;
+}
+
+// Processed depth: plain copy, or (if a mask is set) a fused copy that zeroes
+// low-confidence / flagged pixels so consumers need only this one buffer.
+static const DepthSlots::Slot* StoreDepth(const MLDepthCameraFrame* frame, int64_t ts) {
+    const MLDepthCameraFrameBuffer* depth = frame->depth_image;
+    const uint32_t mode = g_maskMode.load(std::memory_order_relaxed);
+    if (mode == 0 || !depth || depth->bytes_per_unit != 4) {
+        return StoreBuffer(g_depthSlots, depth, ts);
+    }
+
+    const MLDepthCameraFrameBuffer* conf =
+        (mode & DepthMask_Confidence) ? MatchingBuffer(frame->confidence, depth) : nullptr;
+    const MLDepthCameraFrameBuffer* flags =
+        (mode & DepthMask_Flags) ? MatchingBuffer(frame->flags, depth) : nullptr;
+    if (!conf && !flags) {
+        return StoreBuffer(g_depthSlots, depth, ts);
+    }
+
+    DepthSlots::Slot* slot = BeginStore(g_depthSlots, depth, ts);
+    if (!slot) return nullptr;
+
+    const float minConf = g_maskMinConfidence.load(std::memory_order_relaxed);
+    const uint32_t reject = g_maskRejectFlags.load(std::memory_order_relaxed);
+    for (uint32_t v = 0; v < depth->height; v++) {
+        const size_t rowOffset = (size_t)v * depth->stride;
+        DepthMaskRow(
+            (const float*)((const uint8_t*)depth->data + rowOffset),
+            conf ? (const float*)((const uint8_t*)conf->data + (size_t)v * conf->stride) : nullptr,
+            flags ? (const uint32_t*)((const uint8_t*)flags->data + (size_t)v * flags->stride) : nullptr,
+            minConf, reject, (int32_t)depth->width,
+            (float*)(slot->bytes.data() + rowOffset));
+    }
+
+    g_depthSlots.Publish(slot);
+    return slot;
+}
+
+// Filters the processed depth just published (depthSlot) against the previous
+// filtered frame and publishes the result as DepthStream_Filtered.
+static void StoreFiltered(const DepthSlots::Slot* depthSlot, const MLDepthCameraFrameBuffer* conf) {
+    const float alpha = g_filterAlpha.load(std::memory_order_relaxed);
+    if (alpha <= 0.0f || !depthSlot || depthSlot->info.bytesPerPixel != 4) {
+        g_filterPrev = nullptr;  // restart cleanly when re-enabled
+        return;
+    }
+    const float resetThreshold = g_filterResetThreshold.load(std::memory_order_relaxed);
+
+    const DepthFrameInfo& info = depthSlot->info;
+    const DepthSlots::Slot* prev = g_filterPrev;
+    if (prev && (prev->info.width != info.width || prev->info.height != info.height ||
+                 prev->info.strideBytes != info.strideBytes)) {
+        prev = nullptr;
+    }
+
+    DepthSlots::Slot* slot = g_filteredSlots.BeginWrite();
+    if (!slot) return;  // keep the previous state; next frame filters against it
+
+    slot->info = info;
+    slot->bytes.resize(depthSlot->bytes.size());  // no-op after the first frame
+
+    for (int32_t v = 0; v < info.height; v++) {
+        const size_t rowOffset = (size_t)v * info.strideBytes;
+        DepthTemporalRow(
+            (const float*)(depthSlot->bytes.data() + rowOffset),
+            conf ? (const float*)((const uint8_t*)conf->data + (size_t)v * conf->stride) : nullptr,
+            prev ? (const float*)(prev->bytes.data() + rowOffset) : nullptr,
+            alpha, resetThreshold, info.width,
+            (float*)(slot->bytes.data() + rowOffset));
+    }
+
+    g_filteredSlots.Publish(slot);
+    g_filterPrev = slot;
+}
+
+// Appends a frame to the history ring. depthSlot is the processed depth just
+// published by this thread (so history matches what TryGetLatestDepth returns);
+// only the producer writes slots, so reading it here is safe. Never allocates:
+// frames that don't fit (or whose depth slot was dropped) count as dropped.
+static void StoreHistory(const DepthSlots::Slot* depthSlot, const MLDepthCameraFrameBuffer* conf, int64_t ts) {
+    std::lock_guard<std::mutex> guard(g_historyLock);
+
+    const int32_t capacity = (int32_t)g_historyEntries.size();
+    if (capacity == 0) return;
+
+    if (!depthSlot) {
+        g_historyDropped++;
+        return;
+    }
+
+    const int32_t depthSize = (int32_t)depthSlot->bytes.size();
+    bool hasConf = conf && conf->data && conf->size > 0;
+    if (depthSize > HISTORY_MAX_FRAME_BYTES ||
+        (hasConf && (int32_t)conf->size > HISTORY_MAX_FRAME_BYTES)) {
+        g_historyDropped++;
+        return;
+    }
+
+    const int32_t idx = g_historyHead;
+    HistoryEntry& e = g_historyEntries[idx];
+
+    e.depthInfo = depthSlot->info;
+    e.depthSize = depthSize;
+    std::memcpy(g_historyDepth.data() + (size_t)idx * HISTORY_MAX_FRAME_BYTES, depthSlot->bytes.data(), depthSize);
+
+    e.confInfo = DepthFrameInfo{};
+    e.confSize = 0;
+    if (hasConf) {
+        e.confInfo.width         = (int32_t)conf->width;
+        e.confInfo.height        = (int32_t)conf->height;
+        e.confInfo.strideBytes   = (int32_t)conf->stride;
+        e.confInfo.captureTimeNs = ts;
+        e.confInfo.bytesPerPixel = (int32_t)conf->bytes_per_unit;
+        e.confSize = (int32_t)conf->size;
+        std::memcpy(g_historyConf.data() + (size_t)idx * HISTORY_MAX_FRAME_BYTES, conf->data, conf->size);
+    }
+
+    g_historyHead = (idx + 1) % capacity;
+    if (g_historyCount < capacity) {
+        g_historyCount++;
+    } else {
+        g_historyOverwritten++;
+    }
+    g_historyStored++;
+}
+
 static void CaptureLoop() {
     LOGI("Capture thread started");
     
@@ -81,155 +295,194 @@ static void CaptureLoop() {
 
         MLDepthCameraFrame* frame = &data.frames[0];
         const int64_t ts = (int64_t)frame->frame_timestamp;
+        const uint32_t flagsMask = g_flagsMask.load();
+        DepthIntrinsics frameIntrinsics;
 
         {
-            std::lock_guard<std::mutex> guard(g_lock);
-
-            // Depth (processed)
-            MLDepthCameraFrameBuffer* depth = frame->depth_image;
-            if (depth && depth->data && depth->size > 0) {
-                g_depthInfo.width         = (int32_t)depth->width;
-                g_depthInfo.height        = (int32_t)depth->height;
-                g_depthInfo.strideBytes   = (int32_t)depth->stride;
-                g_depthInfo.captureTimeNs = ts;
-                g_depthInfo.bytesPerPixel = (int32_t)depth->bytes_per_unit;
-                g_depthInfo.format        = 0;
-
-                g_depthBytes.resize(depth->size);
-                std::memcpy(g_depthBytes.data(), depth->data, depth->size);
-            }
+            std::lock_guard<std::mutex> guard(g_intrinsicsLock);
+            FrameCalibration& c = g_calibration[g_calibrationNext % DEPTH_CALIBRATION_HISTORY];
+            c.intrinsics.width         = (int32_t)frame->intrinsics.width;
+            c.intrinsics.height        = (int32_t)frame->intrinsics.height;
+            c.intrinsics.fx            = frame->intrinsics.focal_length.x;
+            c.intrinsics.fy            = frame->intrinsics.focal_length.y;
+            c.intrinsics.cx            = frame->intrinsics.principal_point.x;
+            c.intrinsics.cy            = frame->intrinsics.principal_point.y;
+            c.intrinsics.captureTimeNs = ts;
+            c.pose.rotation_x          = frame->camera_pose.rotation.x;
+            c.pose.rotation_y          = frame->camera_pose.rotation.y;
+            c.pose.rotation_z          = frame->camera_pose.rotation.z;
+            c.pose.rotation_w          = frame->camera_pose.rotation.w;
+            c.pose.position_x          = frame->camera_pose.position.x;
+            c.pose.position_y          = frame->camera_pose.position.y;
+            c.pose.position_z          = frame->camera_pose.position.z;
+            c.pose.captureTimeNs       = ts;
+            frameIntrinsics = c.intrinsics;
+            g_calibrationNext++;
+        }
 
-            // Confidence
-            if ((g_flagsMask & MLDepthCameraFlags_Confidence) &&
-                frame->confidence && frame->confidence->data && frame->confidence->size > 0) {
-                MLDepthCameraFrameBuffer* conf = frame->confidence;
-                g_confInfo.width         = (int32_t)conf->width;
-                g_confInfo.height        = (int32_t)conf->height;
-                g_confInfo.strideBytes   = (int32_t)conf->stride;
-                g_confInfo.captureTimeNs = ts;
-                g_confInfo.bytesPerPixel = (int32_t)conf->bytes_per_unit;
-                g_confBytes.resize(conf->size);
-                std::memcpy(g_confBytes.data(), conf->data, conf->size);
-            }
+        // Depth (processed, optionally masked)
+        const DepthSlots::Slot* depthSlot = StoreDepth(frame, ts);
 
-            // Depth flags
-            if ((g_flagsMask & MLDepthCameraFlags_DepthFlags) &&
-                frame->flags && frame->flags->data && frame->flags->size > 0) {
-                MLDepthCameraFrameBuffer* fl = frame->flags;
-                g_flagsInfo.width         = (int32_t)fl->width;
-                g_flagsInfo.height        = (int32_t)fl->height;
-                g_flagsInfo.strideBytes   = (int32_t)fl->stride;
-                g_flagsInfo.captureTimeNs = ts;
-                g_flagsInfo.bytesPerPixel = (int32_t)fl->bytes_per_unit;
-                g_flagsBytes.resize(fl->size);
-                std::memcpy(g_flagsBytes.data(), fl->data, fl->size);
-            }
+        // Confidence
+        if (flagsMask & MLDepthCameraFlags_Confidence) {
+            StoreBuffer(g_confSlots, frame->confidence, ts);
+        }
 
-            // Raw depth
-            if ((g_flagsMask & MLDepthCameraFlags_RawDepthImage) &&
-                frame->raw_depth_image && frame->raw_depth_image->data && frame->raw_depth_image->size > 0) {
-                MLDepthCameraFrameBuffer* raw = frame->raw_depth_image;
-                g_rawInfo.width         = (int32_t)raw->width;
-                g_rawInfo.height        = (int32_t)raw->height;
-                g_rawInfo.strideBytes   = (int32_t)raw->stride;
-                g_rawInfo.captureTimeNs = ts;
-                g_rawInfo.bytesPerPixel = (int32_t)raw->bytes_per_unit;
-                g_rawBytes.resize(raw->size);
-                std::memcpy(g_rawBytes.data(), raw->data, raw->size);
-            }
+        // Depth flags
+        if (flagsMask & MLDepthCameraFlags_DepthFlags) {
+            StoreBuffer(g_flagsSlots, frame->flags, ts);
+        }
 
-            // Ambient raw depth
-            if ((g_flagsMask & MLDepthCameraFlags_AmbientRawDepthImage) &&
-                frame->ambient_raw_depth_image && frame->ambient_raw_depth_image->data && frame->ambient_raw_depth_image->size > 0) {
-                MLDepthCameraFrameBuffer* amb = frame->ambient_raw_depth_image;
-                g_ambientRawInfo.width         = (int32_t)amb->width;
-                g_ambientRawInfo.height        = (int32_t)amb->height;
-                g_ambientRawInfo.strideBytes   = (int32_t)amb->stride;
-                g_ambientRawInfo.captureTimeNs = ts;
-                g_ambientRawInfo.bytesPerPixel = (int32_t)amb->bytes_per_unit;
-                g_ambientRawBytes.resize(amb->size);
-                std::memcpy(g_ambientRawBytes.data(), amb->data, amb->size);
-            }
+        // Raw depth
+        if (flagsMask & MLDepthCameraFlags_RawDepthImage) {
+            StoreBuffer(g_rawSlots, frame->raw_depth_image, ts);
+        }
+
+        // Ambient raw depth
+        if (flagsMask & MLDepthCameraFlags_AmbientRawDepthImage) {
+            StoreBuffer(g_ambientRawSlots, frame->ambient_raw_depth_image, ts);
+        }
+
+        const MLDepthCameraFrameBuffer* conf = frame->depth_image && (flagsMask & MLDepthCameraFlags_Confidence)
+            ? MatchingBuffer(frame->confidence, frame->depth_image) : nullptr;
+
+        // Temporal filter (no-op unless configured)
+        StoreFiltered(depthSlot, conf);
+
+        // Pyramid levels (no-op unless configured)
+        if (depthSlot) {
+            DepthPyramid_ProcessFrame(depthSlot->info, depthSlot->bytes.data(),
+                                      conf ? (const float*)conf->data : nullptr,
+                                      conf ? (int32_t)conf->stride : 0);
+        }
+
+        // Normals (no-op unless configured)
+        if (depthSlot) {
+            DepthNormals_ProcessFrame(depthSlot->info, depthSlot->bytes.data(), frameIntrinsics);
         }
 
+        // History ring (no-op unless configured)
+        StoreHistory(depthSlot,
+                     (flagsMask & MLDepthCameraFlags_Confidence) ? frame->confidence : nullptr,
+                     ts);
+
         MLDepthCameraReleaseDepthData(g_handle, &data);
     }
     
     LOGI("Capture thread exiting");
 }
 
-// ---------- Init ----------
-bool MLDepthUnity_Init(uint32_t streamMask, uint32_t flagsMask, uint32_t frameRateEnum) {
-    if (g_running.load()) {
-        LOGI("Already running");
-        return true;
+// ---------- Configuration ----------
+static std::mutex g_configLock;
+static DepthConfig g_config{};  // effective configuration (valid while running)
+
+static const char* FrameRateName(uint32_t frameRate) {
+    switch (frameRate) {
+        case MLDepthCameraFrameRate_1FPS:  return "1";
+        case MLDepthCameraFrameRate_5FPS:  return "5";
+        case MLDepthCameraFrameRate_25FPS: return "25/30";
+        case MLDepthCameraFrameRate_50FPS: return "50/60";
+        default:                           return "?";
     }
+}
+
+// Clamps a requested configuration to what the SDK supports.
+static DepthConfig ValidateConfig(const DepthConfig& requested) {
+    DepthConfig cfg = requested;
 
     // Force single stream - SDK only supports one at a time
-    if (streamMask == (STREAM_LONG | STREAM_SHORT)) {
+    if (cfg.streamMask == (STREAM_LONG | STREAM_SHORT)) {
         LOGW("Both streams requested - forcing SHORT only (SDK limitation)");
-        streamMask = STREAM_SHORT;
-    }
-    
-    // If no stream specified, default to SHORT
-    if (streamMask == 0) {
-        streamMask = STREAM_SHORT;
+        cfg.streamMask = STREAM_SHORT;
     }
 
-    g_flagsMask = flagsMask;
-
-    // Determine which stream we're using
-    bool useShort = (streamMask & STREAM_SHORT) != 0;
-    bool useLong = (streamMask & STREAM_LONG) != 0 && !useShort;
+    // If no (or an unknown) stream is specified, default to SHORT
+    if (cfg.streamMask != STREAM_LONG && cfg.streamMask != STREAM_SHORT) {
+        cfg.streamMask = STREAM_SHORT;
+    }
+    const bool useShort = cfg.streamMask == STREAM_SHORT;
 
-    // Pick appropriate frame rate
-    MLDepthCameraFrameRate frameRate;
-    uint32_t exposure;
-    
+    // Frame rate: short range supports 5, 25, 50 (50Hz) or 5, 30, 60 (60Hz);
+    // long range supports 1, 5 FPS only
     if (useShort) {
-        // Short range: supports 5, 25, 50 (50Hz) or 5, 30, 60 (60Hz)
-        // Use 5 FPS for reliability
-        frameRate = MLDepthCameraFrameRate_5FPS;
-        exposure = EXPOSURE_SHORT_DEFAULT;
-        LOGI("Using SHORT range: exposure=%u fps=5", exposure);
+        if (cfg.frameRate != MLDepthCameraFrameRate_5FPS &&
+            cfg.frameRate != MLDepthCameraFrameRate_25FPS &&
+            cfg.frameRate != MLDepthCameraFrameRate_50FPS) {
+            LOGW("Frame rate %u not supported by SHORT range - using 5 FPS", cfg.frameRate);
+            cfg.frameRate = MLDepthCameraFrameRate_5FPS;
+        }
     } else {
-        // Long range: supports 1, 5 FPS only
-        frameRate = MLDepthCameraFrameRate_5FPS;
-        exposure = EXPOSURE_LONG_DEFAULT;
-        LOGI("Using LONG range: exposure=%u fps=5", exposure);
+        if (cfg.frameRate != MLDepthCameraFrameRate_1FPS &&
+            cfg.frameRate != MLDepthCameraFrameRate_5FPS) {
+            LOGW("Frame rate %u not supported by LONG range - using 5 FPS", cfg.frameRate);
+            cfg.frameRate = MLDepthCameraFrameRate_5FPS;
+        }
     }
 
-    // Start with minimal flags if too many requested
-    uint32_t safeFlags = flagsMask;
-    if (flagsMask > MLDepthCameraFlags_DepthImage) {
-        // Keep depth, optionally confidence
-        safeFlags = MLDepthCameraFlags_DepthImage;
-        if (flagsMask & MLDepthCameraFlags_Confidence) {
-            safeFlags |= MLDepthCameraFlags_Confidence;
-        }
-        LOGW("Reducing flags from %u to %u for stability", flagsMask, safeFlags);
+    // Exposure: 0 = stream default, otherwise clamp to the stream's range
+    const uint32_t expMin = useShort ? EXPOSURE_SHORT_MIN : EXPOSURE_LONG_MIN;
+    const uint32_t expMax = useShort ? EXPOSURE_SHORT_MAX : EXPOSURE_LONG_MAX;
+    if (cfg.exposureUs == 0) {
+        cfg.exposureUs = useShort ? EXPOSURE_SHORT_DEFAULT : EXPOSURE_LONG_DEFAULT;
+    } else if (cfg.exposureUs < expMin || cfg.exposureUs > expMax) {
+        uint32_t clamped = cfg.exposureUs < expMin ? expMin : expMax;
+        LOGW("Exposure %u us out of range [%u, %u] - using %u", cfg.exposureUs, expMin, expMax, clamped);
+        cfg.exposureUs = clamped;
     }
-    g_flagsMask = safeFlags;
 
-    MLDepthCameraSettings settings;
-    MLDepthCameraSettingsInit(&settings);
+    // Flags: known bits only, depth image always on
+    const uint32_t knownFlags = MLDepthCameraFlags_DepthImage | MLDepthCameraFlags_Confidence |
+                                MLDepthCameraFlags_DepthFlags | MLDepthCameraFlags_AmbientRawDepthImage |
+                                MLDepthCameraFlags_RawDepthImage;
+    if (cfg.flagsMask & ~knownFlags) {
+        LOGW("Ignoring unknown depth flags 0x%X", cfg.flagsMask & ~knownFlags);
+    }
+    cfg.flagsMask = (cfg.flagsMask & knownFlags) | MLDepthCameraFlags_DepthImage;
 
-    settings.streams = streamMask;
+    return cfg;
+}
+
+static void BuildSettings(const DepthConfig& cfg, MLDepthCameraSettings* settings) {
+    MLDepthCameraSettingsInit(settings);
+
+    settings->streams = cfg.streamMask;
 
     // Configure the active stream
-    if (useShort) {
-        settings.stream_configs[MLDepthCameraFrameType_ShortRange].flags = safeFlags;
-        settings.stream_configs[MLDepthCameraFrameType_ShortRange].exposure = exposure;
-        settings.stream_configs[MLDepthCameraFrameType_ShortRange].frame_rate = frameRate;
-    }
-    if (useLong) {
-        settings.stream_configs[MLDepthCameraFrameType_LongRange].flags = safeFlags;
-        settings.stream_configs[MLDepthCameraFrameType_LongRange].exposure = exposure;
-        settings.stream_configs[MLDepthCameraFrameType_LongRange].frame_rate = frameRate;
+    MLDepthCameraFrameType type = cfg.streamMask == STREAM_SHORT ? MLDepthCameraFrameType_ShortRange
+                                                                  : MLDepthCameraFrameType_LongRange;
+    settings->stream_configs[type].flags = cfg.flagsMask;
+    settings->stream_configs[type].exposure = cfg.exposureUs;
+    settings->stream_configs[type].frame_rate = (MLDepthCameraFrameRate)cfg.frameRate;
+}
+
+// ---------- Init ----------
+bool MLDepthUnity_Init(uint32_t streamMask, uint32_t flagsMask, uint32_t frameRateEnum) {
+    DepthConfig requested{};
+    requested.streamMask = streamMask;
+    requested.flagsMask = flagsMask;
+    requested.frameRate = frameRateEnum;
+    requested.exposureUs = 0;
+    return MLDepthUnity_InitWithConfig(&requested, nullptr);
+}
+
+bool MLDepthUnity_InitWithConfig(const DepthConfig* requested, DepthConfig* outEffective) {
+    if (!requested) return false;
+
+    std::lock_guard<std::mutex> guard(g_configLock);
+
+    if (g_running.load()) {
+        LOGI("Already running");
+        if (outEffective) *outEffective = g_config;
+        return true;
     }
 
-    LOGI("Connecting: streams=%u flags=%u exposure=%u frameRate=%d", 
-         streamMask, safeFlags, exposure, (int)frameRate);
+    const DepthConfig cfg = ValidateConfig(*requested);
+
+    MLDepthCameraSettings settings;
+    BuildSettings(cfg, &settings);
+
+    LOGI("Connecting: streams=%u flags=%u exposure=%u fps=%s", 
+         cfg.streamMask, cfg.flagsMask, cfg.exposureUs, FrameRateName(cfg.frameRate));
 
     MLResult r = MLDepthCameraConnect(&settings, &g_handle);
     
@@ -242,47 +495,347 @@ bool MLDepthUnity_Init(uint32_t streamMask, uint32_t flagsMask, uint32_t frameRa
 
     LOGI("MLDepthCameraConnect OK handle=%llu", (unsigned long long)g_handle);
 
+    g_config = cfg;
+    g_flagsMask.store(cfg.flagsMask);
+    if (outEffective) *outEffective = cfg;
+
     g_running.store(true);
     g_thread = std::thread(CaptureLoop);
     
     return true;
 }
 
+// Runtime reconfiguration: the capture thread keeps running and picks up the
+// new stream/rate/flags with the next frame the SDK delivers.
+bool MLDepthUnity_Reconfigure(const DepthConfig* requested, DepthConfig* outEffective) {
+    if (!requested) return false;
+
+    std::lock_guard<std::mutex> guard(g_configLock);
+
+    if (!g_running.load() || g_handle == ML_INVALID_HANDLE) {
+        LOGW("Reconfigure: not running");
+        return false;
+    }
+
+    const DepthConfig cfg = ValidateConfig(*requested);
+
+    MLDepthCameraSettings settings;
+    BuildSettings(cfg, &settings);
+
+    MLResult r = MLDepthCameraUpdateSettings(g_handle, &settings);
+    if (r != MLResult_Ok) {
+        LOGE("MLDepthCameraUpdateSettings FAILED r=%d - keeping previous configuration", (int)r);
+        if (outEffective) *outEffective = g_config;
+        return false;
+    }
+
+    // Optional streams dropped from flagsMask keep their last frame; they
+    // just stop being updated.
+    g_config = cfg;
+    g_flagsMask.store(cfg.flagsMask);
+    if (outEffective) *outEffective = cfg;
+
+    LOGI("Reconfigured: streams=%u flags=%u exposure=%u fps=%s",
+         cfg.streamMask, cfg.flagsMask, cfg.exposureUs, FrameRateName(cfg.frameRate));
+    return true;
+}
+
+bool MLDepthUnity_GetConfig(DepthConfig* outEffective) {
+    if (!outEffective) return false;
+
+    std::lock_guard<std::mutex> guard(g_configLock);
+    if (!g_running.load()) return false;
+
+    *outEffective = g_config;
+    return true;
+}
+
 // ---------- Copy out helpers ----------
-static bool CopyOut(const std::vector<uint8_t>& src, const DepthFrameInfo& info,
-                    DepthFrameInfo* outInfo, uint8_t* outBytes, int32_t cap, int32_t* written) {
+static DepthSlots* StreamSlots(uint32_t stream) {
+    switch (stream) {
+        case DepthStream_Depth:           return &g_depthSlots;
+        case DepthStream_Confidence:      return &g_confSlots;
+        case DepthStream_DepthFlags:      return &g_flagsSlots;
+        case DepthStream_RawDepth:        return &g_rawSlots;
+        case DepthStream_AmbientRawDepth: return &g_ambientRawSlots;
+        case DepthStream_Filtered:        return &g_filteredSlots;
+        default:                          return nullptr;
+    }
+}
+
+static bool CopyOut(DepthSlots& slots,
+                    DepthFrameInfo* outInfo, uint8_t* outBytes, int32_t cap, int32_t* written,
+                    uint64_t* outSequence = nullptr) {
     if (!outInfo || !outBytes || !written) return false;
 
-    std::lock_guard<std::mutex> guard(g_lock);
-    if (src.empty()) return false;
+    const DepthSlots::Slot* slot = slots.Acquire();
+    if (!slot) return false;
+
+    // The sequence is reported even when the frame doesn't fit, so "since"
+    // readers can skip it
+    if (outSequence) *outSequence = slot->sequence;
+
+    bool ok = false;
+    int32_t n = (int32_t)slot->bytes.size();
+    if (n > 0 && n <= cap) {
+        *outInfo = slot->info;
+        std::memcpy(outBytes, slot->bytes.data(), n);
+        *written = n;
+        ok = true;
+    } else if (n > cap) {
+        *written = n;  // required size
+    }
 
-    int32_t n = (int32_t)src.size();
-    if (n > cap) return false;
+    slots.Release(slot);
+    return ok;
+}
+
+// Last processed-depth sequence handed out by MLDepthUnity_TryGetLatestDepth,
+// so a blocking call waits for a frame the caller has not seen yet.
+static std::atomic<uint64_t> g_lastDepthSequence{0};
 
-    *outInfo = info;
-    std::memcpy(outBytes, src.data(), n);
-    *written = n;
+bool MLDepthUnity_TryGetLatestDepth(uint32_t timeoutMs, DepthFrameInfo* outInfo, uint8_t* outBytes, int32_t cap, int32_t* written) {
+    if (timeoutMs == 0) {
+        // Non-blocking: latest frame, even if it was returned before
+        uint64_t seq = 0;
+        if (!CopyOut(g_depthSlots, outInfo, outBytes, cap, written, &seq)) return false;
+        g_lastDepthSequence.store(seq);
+        return true;
+    }
+
+    // Blocking: wait for a frame newer than the last one returned here
+    uint64_t seq = 0;
+    uint32_t skipped = 0;
+    if (!MLDepthUnity_TryGetLatestSince(DepthStream_Depth, g_lastDepthSequence.load(), timeoutMs,
+                                        outInfo, outBytes, cap, written, &seq, &skipped)) {
+        return false;
+    }
+    g_lastDepthSequence.store(seq);
     return true;
 }
 
-bool MLDepthUnity_TryGetLatestDepth(uint32_t, DepthFrameInfo* outInfo, uint8_t* outBytes, int32_t cap, int32_t* written) {
-    return CopyOut(g_depthBytes, g_depthInfo, outInfo, outBytes, cap, written);
+bool MLDepthUnity_TryGetLatestSince(uint32_t stream, uint64_t sinceSequence, uint32_t timeoutMs,
+                                    DepthFrameInfo* outInfo, uint8_t* outBytes, int32_t cap, int32_t* written,
+                                    uint64_t* outSequence, uint32_t* outSkipped) {
+    if (!outSequence || !outSkipped) return false;
+    *outSequence = sinceSequence;
+    *outSkipped = 0;
+
+    DepthSlots* slots = StreamSlots(stream);
+    if (!slots) return false;
+
+    if (!slots->WaitForNewer(sinceSequence, timeoutMs)) return false;
+
+    uint64_t seq = 0;
+    const bool copied = CopyOut(*slots, outInfo, outBytes, cap, written, &seq);
+    if (seq <= sinceSequence) return false;
+
+    // Also on a copy failure, so the caller can step past a frame it can't take
+    *outSequence = seq;
+    if (sinceSequence > 0) {
+        *outSkipped = (uint32_t)(seq - sinceSequence - 1);
+    }
+    return copied;
 }
 
 bool MLDepthUnity_TryGetLatestConfidence(DepthFrameInfo* outInfo, uint8_t* outBytes, int32_t cap, int32_t* written) {
-    return CopyOut(g_confBytes, g_confInfo, outInfo, outBytes, cap, written);
+    return CopyOut(g_confSlots, outInfo, outBytes, cap, written);
 }
 
 bool MLDepthUnity_TryGetLatestDepthFlags(DepthFrameInfo* outInfo, uint8_t* outBytes, int32_t cap, int32_t* written) {
-    return CopyOut(g_flagsBytes, g_flagsInfo, outInfo, outBytes, cap, written);
+    return CopyOut(g_flagsSlots, outInfo, outBytes, cap, written);
 }
 
 bool MLDepthUnity_TryGetLatestRawDepth(DepthFrameInfo* outInfo, uint8_t* outBytes, int32_t cap, int32_t* written) {
-    return CopyOut(g_rawBytes, g_rawInfo, outInfo, outBytes, cap, written);
+    return CopyOut(g_rawSlots, outInfo, outBytes, cap, written);
 }
 
 bool MLDepthUnity_TryGetLatestAmbientRawDepth(DepthFrameInfo* outInfo, uint8_t* outBytes, int32_t cap, int32_t* written) {
-    return CopyOut(g_ambientRawBytes, g_ambientRawInfo, outInfo, outBytes, cap, written);
+    return CopyOut(g_ambientRawSlots, outInfo, outBytes, cap, written);
+}
+
+bool MLDepthUnity_TryGetLatestFilteredDepth(DepthFrameInfo* outInfo, uint8_t* outBytes, int32_t cap, int32_t* written) {
+    return CopyOut(g_filteredSlots, outInfo, outBytes, cap, written);
+}
+
+// ---------- Leased (zero-copy) access ----------
+bool MLDepthUnity_AcquireLatest(uint32_t stream, DepthFrameInfo* outInfo, const uint8_t** outBytes,
+                                int32_t* outSizeBytes, void** outLease) {
+    if (!outInfo || !outBytes || !outSizeBytes || !outLease) return false;
+    *outBytes = nullptr;
+    *outSizeBytes = 0;
+    *outLease = nullptr;
+
+    DepthSlots* slots = StreamSlots(stream);
+    if (!slots) return false;
+
+    const DepthSlots::Slot* slot = slots->Acquire();
+    if (!slot) return false;
+
+    if (slot->bytes.empty()) {
+        slots->Release(slot);
+        return false;
+    }
+
+    *outInfo = slot->info;
+    *outBytes = slot->bytes.data();
+    *outSizeBytes = (int32_t)slot->bytes.size();
+    *outLease = (void*)slot;
+    return true;
+}
+
+void MLDepthUnity_ReleaseFrame(void* lease) {
+    DepthSlots::Release((const DepthSlots::Slot*)lease);
+}
+
+void MLDepthUnity_SetDepthMask(uint32_t maskMode, float minConfidence, uint32_t rejectFlagBits) {
+    g_maskMinConfidence.store(minConfidence, std::memory_order_relaxed);
+    g_maskRejectFlags.store(rejectFlagBits, std::memory_order_relaxed);
+    g_maskMode.store(maskMode, std::memory_order_relaxed);
+
+    if ((maskMode & DepthMask_Confidence) && !(g_flagsMask.load() & MLDepthCameraFlags_Confidence)) {
+        LOGW("Confidence mask requested but confidence stream is not enabled");
+    }
+    if ((maskMode & DepthMask_Flags) && !(g_flagsMask.load() & MLDepthCameraFlags_DepthFlags)) {
+        LOGW("Flag mask requested but depth flags stream is not enabled");
+    }
+    LOGI("Depth mask mode=%u minConfidence=%f rejectFlags=0x%X", maskMode, minConfidence, rejectFlagBits);
+}
+
+void MLDepthUnity_SetTemporalFilter(float alpha, float resetThresholdM) {
+    if (alpha > 1.0f) alpha = 1.0f;
+    if (!(resetThresholdM > 0.0f)) resetThresholdM = 0.0f;  // 0 = reset on any change
+
+    g_filterResetThreshold.store(resetThresholdM, std::memory_order_relaxed);
+    g_filterAlpha.store(alpha > 0.0f ? alpha : 0.0f, std::memory_order_relaxed);
+    LOGI("Temporal filter alpha=%f resetThreshold=%f m", alpha, resetThresholdM);
+}
+
+bool MLDepthUnity_GetIntrinsics(DepthIntrinsics* outIntrinsics) {
+    if (!outIntrinsics) return false;
+
+    std::lock_guard<std::mutex> guard(g_intrinsicsLock);
+    if (g_calibrationNext == 0) return false;
+    const DepthIntrinsics& latest = g_calibration[(g_calibrationNext - 1) % DEPTH_CALIBRATION_HISTORY].intrinsics;
+    if (latest.width <= 0 || latest.fx == 0.0f) return false;
+
+    *outIntrinsics = latest;
+    return true;
+}
+
+bool MLDepthUnity_GetFrameCalibration(int64_t captureTimeNs, DepthIntrinsics* outIntrinsics, DepthCameraPose* outPose) {
+    std::lock_guard<std::mutex> guard(g_intrinsicsLock);
+    const uint32_t count = g_calibrationNext < DEPTH_CALIBRATION_HISTORY ? g_calibrationNext : DEPTH_CALIBRATION_HISTORY;
+    for (uint32_t i = 1; i <= count; i++) {
+        const FrameCalibration& c = g_calibration[(g_calibrationNext - i) % DEPTH_CALIBRATION_HISTORY];
+        if (c.intrinsics.captureTimeNs != captureTimeNs) continue;
+        if (c.intrinsics.width <= 0 || c.intrinsics.fx == 0.0f) return false;
+
+        if (outIntrinsics) *outIntrinsics = c.intrinsics;
+        if (outPose) *outPose = c.pose;
+        return true;
+    }
+    return false;
+}
+
+// ---------- History ----------
+bool MLDepthUnity_ConfigureHistory(int32_t capacityFrames) {
+    if (g_running.load()) {
+        LOGW("ConfigureHistory must be called before Init");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(g_historyLock);
+
+    if (capacityFrames <= 0) {
+        g_historyEntries.clear();
+        g_historyEntries.shrink_to_fit();
+        g_historyDepth.clear();
+        g_historyDepth.shrink_to_fit();
+        g_historyConf.clear();
+        g_historyConf.shrink_to_fit();
+    } else {
+        g_historyEntries.assign((size_t)capacityFrames, HistoryEntry{});
+        g_historyDepth.resize((size_t)capacityFrames * HISTORY_MAX_FRAME_BYTES);
+        g_historyConf.resize((size_t)capacityFrames * HISTORY_MAX_FRAME_BYTES);
+    }
+
+    g_historyHead = 0;
+    g_historyCount = 0;
+    g_historyStored = 0;
+    g_historyOverwritten = 0;
+    g_historyDropped = 0;
+
+    LOGI("Depth history capacity=%d frames", capacityFrames > 0 ? capacityFrames : 0);
+    return true;
+}
+
+bool MLDepthUnity_GetHistoryNearest(
+    int64_t timestampNs,
+    DepthFrameInfo* outDepthInfo, uint8_t* outDepthBytes, int32_t depthCapacity, int32_t* depthWritten,
+    DepthFrameInfo* outConfInfo, uint8_t* outConfBytes, int32_t confCapacity, int32_t* confWritten) {
+    if (!outDepthInfo || !outDepthBytes || !depthWritten) return false;
+    *depthWritten = 0;
+    if (confWritten) *confWritten = 0;
+
+    std::lock_guard<std::mutex> guard(g_historyLock);
+
+    const int32_t capacity = (int32_t)g_historyEntries.size();
+    if (g_historyCount == 0) return false;
+
+    // Linear scan - N is small and the ring is already time-ordered.
+    int32_t best = -1;
+    int64_t bestDelta = 0;
+    for (int32_t i = 0; i < g_historyCount; i++) {
+        int32_t idx = (g_historyHead - 1 - i + capacity) % capacity;
+        int64_t delta = g_historyEntries[idx].depthInfo.captureTimeNs - timestampNs;
+        if (delta < 0) delta = -delta;
+        if (best < 0 || delta < bestDelta) {
+            best = idx;
+            bestDelta = delta;
+        }
+    }
+
+    const HistoryEntry& e = g_historyEntries[best];
+    if (e.depthSize > depthCapacity) {
+        *depthWritten = e.depthSize;
+        return false;
+    }
+
+    *outDepthInfo = e.depthInfo;
+    std::memcpy(outDepthBytes, g_historyDepth.data() + (size_t)best * HISTORY_MAX_FRAME_BYTES, e.depthSize);
+    *depthWritten = e.depthSize;
+
+    // Confidence is optional for the caller
+    if (outConfInfo && outConfBytes && confWritten && e.confSize > 0 && e.confSize <= confCapacity) {
+        *outConfInfo = e.confInfo;
+        std::memcpy(outConfBytes, g_historyConf.data() + (size_t)best * HISTORY_MAX_FRAME_BYTES, e.confSize);
+        *confWritten = e.confSize;
+    }
+
+    return true;
+}
+
+bool MLDepthUnity_GetHistoryStats(DepthHistoryStats* outStats) {
+    if (!outStats) return false;
+
+    std::lock_guard<std::mutex> guard(g_historyLock);
+
+    const int32_t capacity = (int32_t)g_historyEntries.size();
+    outStats->capacity = capacity;
+    outStats->count = g_historyCount;
+    outStats->oldestNs = 0;
+    outStats->newestNs = 0;
+    if (g_historyCount > 0) {
+        int32_t newest = (g_historyHead - 1 + capacity) % capacity;
+        int32_t oldest = (g_historyHead - g_historyCount + capacity) % capacity;
+        outStats->newestNs = g_historyEntries[newest].depthInfo.captureTimeNs;
+        outStats->oldestNs = g_historyEntries[oldest].depthInfo.captureTimeNs;
+    }
+    outStats->stored = g_historyStored;
+    outStats->overwritten = g_historyOverwritten;
+    outStats->dropped = g_historyDropped;
+    return true;
 }
 
 // ---------- Shutdown ----------
@@ -300,18 +853,33 @@ void MLDepthUnity_Shutdown() {
         g_handle = ML_INVALID_HANDLE;
     }
 
-    std::lock_guard<std::mutex> guard(g_lock);
-    g_depthBytes.clear();
-    g_confBytes.clear();
-    g_flagsBytes.clear();
-    g_rawBytes.clear();
-    g_ambientRawBytes.clear();
+    if (g_depthSlots.DroppedCount() > 0) {
+        LOGW("Dropped %llu depth frames (all slots busy)",
+             (unsigned long long)g_depthSlots.DroppedCount());
+    }
+
+    g_depthSlots.Reset();
+    g_confSlots.Reset();
+    g_flagsSlots.Reset();
+    g_rawSlots.Reset();
+    g_ambientRawSlots.Reset();
+    g_filteredSlots.Reset();
+    g_filterPrev = nullptr;
+    DepthPyramid_Reset();
+    DepthNormals_Reset();
+
+    {
+        std::lock_guard<std::mutex> guard(g_intrinsicsLock);
+        for (FrameCalibration& c : g_calibration) c = FrameCalibration{};
+        g_calibrationNext = 0;
+    }
 
-    g_depthInfo = DepthFrameInfo{};
-    g_confInfo = DepthFrameInfo{};
-    g_flagsInfo = DepthFrameInfo{};
-    g_rawInfo = DepthFrameInfo{};
-    g_ambientRawInfo = DepthFrameInfo{};
+    {
+        // Keep the preallocated ring, just forget its contents
+        std::lock_guard<std::mutex> guard(g_historyLock);
+        g_historyHead = 0;
+        g_historyCount = 0;
+    }
     
     LOGI("Shutdown complete");
 }
\ No newline at end of file
@@ -14,8 +14,43 @@ typedef struct DepthFrameInfo {
   int32_t format;
 } DepthFrameInfo;
 
+// Pinhole intrinsics of the active depth stream (pixels).
+typedef struct DepthIntrinsics {
+  int32_t width;
+  int32_t height;
+  float fx, fy;   // Focal length
+  float cx, cy;   // Principal point
+  int64_t captureTimeNs;  // Frame the intrinsics were taken from
+} DepthIntrinsics;
+
+// Depth camera configuration. Requested values are validated against what the
+// SDK supports and the effective configuration is reported back.
+typedef struct DepthConfig {
+  uint32_t streamMask;  // 1 = long range, 2 = short range (one at a time; 0 -> short)
+  uint32_t flagsMask;   // MLDepthCameraFlags; depth image is always included
+  uint32_t frameRate;   // MLDepthCameraFrameRate: 0=1, 1=5, 2=25 (30 @60Hz), 3=50 (60 @60Hz) FPS
+                        //   short range: 5/25/50, long range: 1/5
+  uint32_t exposureUs;  // 0 = stream default; clamped to the stream's range
+} DepthConfig;
+
+// Same as MLDepthUnity_InitWithConfig with the default exposure.
 bool MLDepthUnity_Init(uint32_t streamMask, uint32_t flagsMask, uint32_t frameRateEnum);
 
+// outEffective (optional): configuration actually applied.
+bool MLDepthUnity_InitWithConfig(const DepthConfig* requested, DepthConfig* outEffective);
+
+// Switch stream, frame rate, exposure or flags while running
+// (MLDepthCameraUpdateSettings) without restarting the capture thread.
+// On failure the previous configuration stays active and is reported.
+bool MLDepthUnity_Reconfigure(const DepthConfig* requested, DepthConfig* outEffective);
+
+bool MLDepthUnity_GetConfig(DepthConfig* outEffective);
+
+// timeoutMs == 0: return the latest frame immediately (may repeat a frame).
+// timeoutMs  > 0: block up to timeoutMs for a frame newer than the last one
+//                 this function returned; false on timeout.
+// The TryGetLatest* calls set bytesWritten to the required size and return
+// false when capacityBytes is too small.
 bool MLDepthUnity_TryGetLatestDepth(
     uint32_t timeoutMs,
     DepthFrameInfo* outInfo,
@@ -48,6 +83,135 @@ bool MLDepthUnity_TryGetLatestAmbientRawDepth(
     int32_t capacityBytes,
     int32_t* bytesWritten);
 
+// Stream selector for the leased (zero-copy) API.
+typedef enum DepthStream {
+  DepthStream_Depth = 0,
+  DepthStream_Confidence = 1,
+  DepthStream_DepthFlags = 2,
+  DepthStream_RawDepth = 3,
+  DepthStream_AmbientRawDepth = 4,
+  DepthStream_Filtered = 5         // see MLDepthUnity_SetTemporalFilter
+} DepthStream;
+
+// Zero-copy access: pins the latest frame of `stream` and returns a read-only
+// pointer into the plugin's own buffer instead of copying it out.
+// The data stays valid and unchanged until MLDepthUnity_ReleaseFrame(*outLease);
+// the capture thread writes new frames into other pool slots meanwhile.
+// Every successful acquire must be released exactly once.
+bool MLDepthUnity_AcquireLatest(
+    uint32_t stream,
+    DepthFrameInfo* outInfo,
+    const uint8_t** outBytes,
+    int32_t* outSizeBytes,
+    void** outLease);
+
+void MLDepthUnity_ReleaseFrame(void* lease);
+
+// Waits up to timeoutMs (0 = don't wait) for a frame of `stream` with a
+// sequence number greater than sinceSequence, then copies it out.
+// Pass 0 on the first call and the returned *outSequence afterwards.
+// outSkipped: frames produced after sinceSequence that the caller never got
+//             (0 when sinceSequence is 0).
+// If a newer frame exists but can't be copied (bytesWritten = required size
+// when it doesn't fit), returns false with *outSequence / *outSkipped set for
+// that frame: passing *outSequence back skips it, passing sinceSequence again
+// retries it.
+// Keeps no state of its own, so it doesn't affect the blocking
+// MLDepthUnity_TryGetLatestDepth of other callers.
+bool MLDepthUnity_TryGetLatestSince(
+    uint32_t stream,
+    uint64_t sinceSequence,
+    uint32_t timeoutMs,
+    DepthFrameInfo* outInfo,
+    uint8_t* outBytes,
+    int32_t capacityBytes,
+    int32_t* bytesWritten,
+    uint64_t* outSequence,
+    uint32_t* outSkipped);
+
+// ---- Fused depth mask ----
+typedef enum DepthMaskMode {
+  DepthMask_None = 0,
+  DepthMask_Confidence = 1 << 0,  // needs MLDepthCameraFlags_Confidence at Init
+  DepthMask_Flags = 1 << 1        // needs MLDepthCameraFlags_DepthFlags at Init
+} DepthMaskMode;
+
+// Zeroes processed-depth pixels on the capture thread, in the same pass that
+// copies the frame out of the SDK: pixels with confidence < minConfidence
+// and/or whose depth flags intersect rejectFlagBits. Applies to the depth
+// stream (and history); the confidence/flags streams are left untouched.
+// maskMode 0 disables masking. Can be changed at any time.
+void MLDepthUnity_SetDepthMask(uint32_t maskMode, float minConfidence, uint32_t rejectFlagBits);
+
+// ---- Temporal filter ----
+// Per-pixel exponential filter over processed depth, run on the capture thread
+// and published as DepthStream_Filtered:
+//   filtered += alpha * w * (depth - filtered), w = confidence clamped to [0, 1]
+// (w = 1 if the confidence stream is off). A pixel restarts from the new depth
+// when it had no value or when |depth - filtered| > resetThresholdM (motion,
+// disocclusion), so moving edges don't smear. Invalid depth gives 0.
+// alpha in (0, 1]; alpha <= 0 disables the filter. Can be changed at any time.
+void MLDepthUnity_SetTemporalFilter(float alpha, float resetThresholdM);
+
+bool MLDepthUnity_TryGetLatestFilteredDepth(
+    DepthFrameInfo* outInfo,
+    uint8_t* outBytes,
+    int32_t capacityBytes,
+    int32_t* bytesWritten);
+
+// Intrinsics reported with the most recent depth frame.
+bool MLDepthUnity_GetIntrinsics(DepthIntrinsics* outIntrinsics);
+
+// Depth camera pose in world reported with a frame (MLDepthCameraFrame::camera_pose;
+// camera looks down -z, +y up, like the RGB and CV camera poses).
+typedef struct DepthCameraPose {
+  float rotation_x, rotation_y, rotation_z, rotation_w;
+  float position_x, position_y, position_z;
+  int64_t captureTimeNs;  // Frame the pose was taken from
+} DepthCameraPose;
+
+// Intrinsics and camera pose the frame with this captureTimeNs (as reported in
+// its DepthFrameInfo) was captured with, for one of the last
+// DEPTH_CALIBRATION_HISTORY frames. Pairs a leased or copied frame with its
+// own calibration, also across MLDepthUnity_Reconfigure. Either output may be
+// null. Returns false for an older or unknown frame.
+#define DEPTH_CALIBRATION_HISTORY 16
+
+bool MLDepthUnity_GetFrameCalibration(int64_t captureTimeNs, DepthIntrinsics* outIntrinsics, DepthCameraPose* outPose);
+
+// ---- Depth history ----
+// Keeps the last N depth (+ confidence, if enabled) frames so callers can pick
+// the one closest to another sensor's timestamp. Storage is preallocated here;
+// the capture thread never allocates for history.
+// Call before MLDepthUnity_Init. capacityFrames <= 0 disables history.
+bool MLDepthUnity_ConfigureHistory(int32_t capacityFrames);
+
+// Copies the history frame whose captureTimeNs is nearest to timestampNs.
+// The confidence outputs are optional (pass null to skip them).
+// If depthCapacity is too small, *depthWritten is set to the required size.
+bool MLDepthUnity_GetHistoryNearest(
+    int64_t timestampNs,
+    DepthFrameInfo* outDepthInfo,
+    uint8_t* outDepthBytes,
+    int32_t depthCapacity,
+    int32_t* depthWritten,
+    DepthFrameInfo* outConfInfo,
+    uint8_t* outConfBytes,
+    int32_t confCapacity,
+    int32_t* confWritten);
+
+typedef struct DepthHistoryStats {
+  int32_t capacity;
+  int32_t count;
+  int64_t oldestNs;
+  int64_t newestNs;
+  uint64_t stored;       // frames written to the ring
+  uint64_t overwritten;  // frames evicted by newer ones
+  uint64_t dropped;      // frames that could not be stored (too large)
+} DepthHistoryStats;
+
+bool MLDepthUnity_GetHistoryStats(DepthHistoryStats* outStats);
+
 void MLDepthUnity_Shutdown();
 
 #ifdef __cplusplus
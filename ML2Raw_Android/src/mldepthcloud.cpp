@@ -0,0 +1,260 @@
+#include "mldepthcloud.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#endif
+
+#include <android/log.h>
+
+#define LOG_TAG "MLDepthCloudUnity"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+
+// ---------- Kernels ----------
+// Each kernel unprojects one row: x = z * colScale[u], y = z * rowScale, z = depth.
+// colScale[u] = (u - cx) / fx and rowScale = (v - cy) / fy are precomputed.
+
+static void UnprojectRowScalar(const float* depth, const float* conf, const float* colScale,
+                               float rowScale, int32_t width, bool withConf, float* out) {
+    const int32_t comps = withConf ? 4 : 3;
+    for (int32_t u = 0; u < width; u++) {
+        float z = depth[u];
+        if (!(z > 0.0f)) z = 0.0f;  // also catches NaN
+        float* p = out + u * comps;
+        p[0] = z * colScale[u];
+        p[1] = z * rowScale;
+        p[2] = z;
+        if (withConf) p[3] = conf ? conf[u] : 0.0f;
+    }
+}
+
+#if defined(__aarch64__)
+
+static void UnprojectRowSimd(const float* depth, const float* conf, const float* colScale,
+                             float rowScale, int32_t width, bool withConf, float* out) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t ry = vdupq_n_f32(rowScale);
+    int32_t u = 0;
+
+    if (withConf) {
+        for (; u + 4 <= width; u += 4) {
+            float32x4_t z = vld1q_f32(depth + u);
+            z = vbslq_f32(vcgtq_f32(z, zero), z, zero);
+            float32x4x4_t p;
+            p.val[0] = vmulq_f32(z, vld1q_f32(colScale + u));
+            p.val[1] = vmulq_f32(z, ry);
+            p.val[2] = z;
+            p.val[3] = conf ? vld1q_f32(conf + u) : zero;
+            vst4q_f32(out + u * 4, p);
+        }
+    } else {
+        for (; u + 4 <= width; u += 4) {
+            float32x4_t z = vld1q_f32(depth + u);
+            z = vbslq_f32(vcgtq_f32(z, zero), z, zero);
+            float32x4x3_t p;
+            p.val[0] = vmulq_f32(z, vld1q_f32(colScale + u));
+            p.val[1] = vmulq_f32(z, ry);
+            p.val[2] = z;
+            vst3q_f32(out + u * 3, p);
+        }
+    }
+
+    if (u < width) {
+        const int32_t comps = withConf ? 4 : 3;
+        UnprojectRowScalar(depth + u, conf ? conf + u : nullptr, colScale + u, rowScale,
+                           width - u, withConf, out + u * comps);
+    }
+}
+
+#elif defined(__SSE2__)
+
+static void UnprojectRowSimd(const float* depth, const float* conf, const float* colScale,
+                             float rowScale, int32_t width, bool withConf, float* out) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 ry = _mm_set1_ps(rowScale);
+    int32_t u = 0;
+
+    if (withConf) {
+        for (; u + 4 <= width; u += 4) {
+            __m128 z = _mm_loadu_ps(depth + u);
+            z = _mm_and_ps(z, _mm_cmpgt_ps(z, zero));
+            __m128 x = _mm_mul_ps(z, _mm_loadu_ps(colScale + u));
+            __m128 y = _mm_mul_ps(z, ry);
+            __m128 c = conf ? _mm_loadu_ps(conf + u) : zero;
+            _MM_TRANSPOSE4_PS(x, y, z, c);
+            float* p = out + u * 4;
+            _mm_storeu_ps(p + 0, x);
+            _mm_storeu_ps(p + 4, y);
+            _mm_storeu_ps(p + 8, z);
+            _mm_storeu_ps(p + 12, c);
+        }
+    } else {
+        // 4-wide stores at a 3-float pitch: each store spills one float into
+        // the next point, which is overwritten right after. Keep one pixel of
+        // headroom so the last store never runs past the row.
+        for (; u + 4 < width; u += 4) {
+            __m128 z = _mm_loadu_ps(depth + u);
+            z = _mm_and_ps(z, _mm_cmpgt_ps(z, zero));
+            __m128 x = _mm_mul_ps(z, _mm_loadu_ps(colScale + u));
+            __m128 y = _mm_mul_ps(z, ry);
+            __m128 w = zero;
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+            float* p = out + u * 3;
+            _mm_storeu_ps(p + 0, x);
+            _mm_storeu_ps(p + 3, y);
+            _mm_storeu_ps(p + 6, z);
+            _mm_storeu_ps(p + 9, w);
+        }
+    }
+
+    if (u < width) {
+        const int32_t comps = withConf ? 4 : 3;
+        UnprojectRowScalar(depth + u, conf ? conf + u : nullptr, colScale + u, rowScale,
+                           width - u, withConf, out + u * comps);
+    }
+}
+
+#else
+
+static void UnprojectRowSimd(const float* depth, const float* conf, const float* colScale,
+                             float rowScale, int32_t width, bool withConf, float* out) {
+    UnprojectRowScalar(depth, conf, colScale, rowScale, width, withConf, out);
+}
+
+#endif
+
+// ---------- API ----------
+
+bool MLDepthCloudUnity_Unproject(
+    const DepthFrameInfo* depth_info,
+    const uint8_t* depth_bytes,
+    const DepthFrameInfo* conf_info,
+    const uint8_t* conf_bytes,
+    const DepthIntrinsics* intrinsics,
+    uint32_t flags,
+    float* out_points,
+    int32_t capacity_floats,
+    int32_t* out_point_count)
+{
+    if (!depth_info || !depth_bytes || !intrinsics || !out_points || !out_point_count) return false;
+    *out_point_count = 0;
+
+    const int32_t width = depth_info->width;
+    const int32_t height = depth_info->height;
+    if (width <= 0 || height <= 0) return false;
+
+    if (depth_info->bytesPerPixel != (int32_t)sizeof(float)) {
+        static int warnCount = 0;
+        if (warnCount++ < 5) {
+            LOGW("Unproject expects float32 depth, got bytesPerPixel=%d", depth_info->bytesPerPixel);
+        }
+        return false;
+    }
+
+    if (intrinsics->fx == 0.0f || intrinsics->fy == 0.0f) return false;
+
+    const bool withConf = (flags & DepthCloudFlag_Confidence) != 0;
+    const int32_t comps = withConf ? 4 : 3;
+    const int32_t pointCount = width * height;
+    if ((int64_t)pointCount * comps > (int64_t)capacity_floats) {
+        *out_point_count = pointCount;
+        return false;
+    }
+
+    // Confidence must match the depth layout to be used
+    const uint8_t* confBase = nullptr;
+    int32_t confStride = 0;
+    if (withConf && conf_info && conf_bytes &&
+        conf_info->width == width && conf_info->height == height &&
+        conf_info->bytesPerPixel == (int32_t)sizeof(float)) {
+        confBase = conf_bytes;
+        confStride = conf_info->strideBytes > 0 ? conf_info->strideBytes : width * (int32_t)sizeof(float);
+    }
+
+    // Per-column scale, grown once per thread
+    static thread_local std::vector<float> colScale;
+    if ((int32_t)colScale.size() < width) colScale.resize(width);
+    const float invFx = 1.0f / intrinsics->fx;
+    const float invFy = 1.0f / intrinsics->fy;
+    for (int32_t u = 0; u < width; u++) {
+        colScale[u] = ((float)u - intrinsics->cx) * invFx;
+    }
+
+    const int32_t depthStride = depth_info->strideBytes > 0 ? depth_info->strideBytes : width * (int32_t)sizeof(float);
+    const bool scalar = (flags & DepthCloudFlag_ForceScalar) != 0;
+
+    for (int32_t v = 0; v < height; v++) {
+        const float* depthRow = (const float*)(depth_bytes + (size_t)v * depthStride);
+        const float* confRow = confBase ? (const float*)(confBase + (size_t)v * confStride) : nullptr;
+        const float rowScale = ((float)v - intrinsics->cy) * invFy;
+        float* outRow = out_points + (size_t)v * width * comps;
+
+        if (scalar) {
+            UnprojectRowScalar(depthRow, confRow, colScale.data(), rowScale, width, withConf, outRow);
+        } else {
+            UnprojectRowSimd(depthRow, confRow, colScale.data(), rowScale, width, withConf, outRow);
+        }
+    }
+
+    *out_point_count = pointCount;
+    return true;
+}
+
+bool MLDepthCloudUnity_TryGetLatest(
+    uint32_t flags,
+    DepthFrameInfo* out_info,
+    float* out_points,
+    int32_t capacity_floats,
+    int32_t* out_point_count)
+{
+    if (!out_info || !out_points || !out_point_count) return false;
+    *out_point_count = 0;
+
+    // Lease the depth (and confidence) frames instead of copying them out
+    DepthFrameInfo depthInfo;
+    const uint8_t* depthBytes = nullptr;
+    int32_t depthSize = 0;
+    void* depthLease = nullptr;
+    if (!MLDepthUnity_AcquireLatest(DepthStream_Depth, &depthInfo, &depthBytes, &depthSize, &depthLease)) {
+        return false;
+    }
+
+    // Intrinsics reported with this frame; the latest ones may already
+    // belong to a newer frame than the one leased
+    DepthIntrinsics intrinsics;
+    if (!MLDepthUnity_GetFrameCalibration(depthInfo.captureTimeNs, &intrinsics, nullptr)) {
+        MLDepthUnity_ReleaseFrame(depthLease);
+        return false;
+    }
+
+    DepthFrameInfo confInfo;
+    const uint8_t* confBytes = nullptr;
+    int32_t confSize = 0;
+    void* confLease = nullptr;
+    if (flags & DepthCloudFlag_Confidence) {
+        if (!MLDepthUnity_AcquireLatest(DepthStream_Confidence, &confInfo, &confBytes, &confSize, &confLease) ||
+            confInfo.captureTimeNs != depthInfo.captureTimeNs) {
+            // Missing or from a different frame - emit confidence 0
+            if (confLease) MLDepthUnity_ReleaseFrame(confLease);
+            confLease = nullptr;
+            confBytes = nullptr;
+        }
+    }
+
+    bool ok = MLDepthCloudUnity_Unproject(&depthInfo, depthBytes,
+                                          confBytes ? &confInfo : nullptr, confBytes,
+                                          &intrinsics, flags, out_points, capacity_floats, out_point_count);
+    if (ok) *out_info = depthInfo;
+
+    if (confLease) MLDepthUnity_ReleaseFrame(confLease);
+    MLDepthUnity_ReleaseFrame(depthLease);
+    return ok;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mldepth.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Options for the unprojection stage (bitmask)
+typedef enum {
+    DepthCloudFlag_None = 0,
+    DepthCloudFlag_Confidence = 1 << 0,   // Emit XYZC (4 floats) instead of XYZ (3 floats)
+    DepthCloudFlag_ForceScalar = 1 << 1   // Use the scalar reference kernel
+} DepthCloudFlag;
+
+// Unproject a float32 depth image (meters) into a point cloud in the depth
+// camera frame (+x right, +y down, +z forward), one point per pixel in row
+// order. Pixels with depth <= 0 or NaN become (0,0,0). Lens distortion is ignored.
+// depth_bytes / conf_bytes may point into a leased frame (MLDepthUnity_AcquireLatest).
+// conf_bytes is only read with DepthCloudFlag_Confidence (null -> confidence 0).
+// out_points: caller buffer of width*height*3 (or *4) floats.
+// out_point_count: points written, or required points if the buffer is too small.
+bool MLDepthCloudUnity_Unproject(
+    const DepthFrameInfo* depth_info,
+    const uint8_t* depth_bytes,
+    const DepthFrameInfo* conf_info,
+    const uint8_t* conf_bytes,
+    const DepthIntrinsics* intrinsics,
+    uint32_t flags,
+    float* out_points,
+    int32_t capacity_floats,
+    int32_t* out_point_count);
+
+// Unproject the latest processed depth frame directly from the capture pool
+// (no intermediate copy) using the intrinsics reported with that frame.
+// Fails if they are no longer in the calibration history.
+bool MLDepthCloudUnity_TryGetLatest(
+    uint32_t flags,
+    DepthFrameInfo* out_info,
+    float* out_points,
+    int32_t capacity_floats,
+    int32_t* out_point_count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,305 @@
+#include "mldepthcodec.h"
+
+#include <cstring>
+
+#include <android/log.h>
+
+#define LOG_TAG "MLDepthCodecUnity"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+
+// Stream header (little-endian, 32 bytes)
+static constexpr uint32_t CODEC_MAGIC = 0x444C5652;  // "RVLD"
+static constexpr uint16_t CODEC_VERSION = 1;
+
+struct CodecHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t bytesPerPixel;
+    int32_t width;
+    int32_t height;
+    int32_t format;
+    int32_t payloadBytes;
+    int64_t captureTimeNs;
+};
+static_assert(sizeof(CodecHeader) == 32, "CodecHeader must stay 32 bytes");
+
+// ---------- Nibble I/O ----------
+// Nibbles are packed 8 per 32-bit word, most significant first (as in RVL).
+
+struct NibbleWriter {
+    uint8_t* out;
+    uint8_t* end;
+    uint32_t word = 0;
+    int32_t nibbles = 0;
+    bool overflow = false;
+
+    void Put(uint32_t nibble) {
+        word = (word << 4) | nibble;
+        if (++nibbles == 8) Store();
+    }
+
+    // 3 data bits per nibble, high bit = "more follows"
+    void PutVLE(uint32_t value) {
+        do {
+            uint32_t nibble = value & 0x7;
+            value >>= 3;
+            if (value) nibble |= 0x8;
+            Put(nibble);
+        } while (value);
+    }
+
+    void Flush() {
+        if (nibbles == 0) return;
+        word <<= 4 * (8 - nibbles);
+        Store();
+    }
+
+    void Store() {
+        if (end - out < 4) {
+            overflow = true;
+        } else {
+            std::memcpy(out, &word, 4);
+            out += 4;
+        }
+        word = 0;
+        nibbles = 0;
+    }
+};
+
+struct NibbleReader {
+    const uint8_t* in;
+    const uint8_t* end;
+    uint32_t word = 0;
+    int32_t nibbles = 0;
+    bool underflow = false;
+
+    uint32_t Get() {
+        if (nibbles == 0) {
+            if (end - in < 4) {
+                underflow = true;
+                return 0;
+            }
+            std::memcpy(&word, in, 4);
+            in += 4;
+            nibbles = 8;
+        }
+        uint32_t nibble = word >> 28;
+        word <<= 4;
+        nibbles--;
+        return nibble;
+    }
+
+    uint32_t GetVLE() {
+        uint32_t value = 0;
+        int32_t shift = 0;
+        uint32_t nibble;
+        do {
+            nibble = Get();
+            if (shift < 32) value |= (nibble & 0x7) << shift;
+            shift += 3;
+        } while ((nibble & 0x8) && !underflow && shift < 36);
+        return value;
+    }
+};
+
+// ---------- Row coding ----------
+// Each row is coded as alternating (zero count, nonzero count, deltas...) runs.
+// Deltas run across rows. Values are handled as unsigned bit patterns, so the
+// wrap-around delta is exact for uint16 and float32 alike.
+
+template <typename T>
+static void EncodeRow(const T* row, int32_t width, uint32_t& prev, NibbleWriter& w) {
+    int32_t u = 0;
+    while (u < width) {
+        int32_t zeros = 0;
+        while (u < width && row[u] == 0) { u++; zeros++; }
+        w.PutVLE((uint32_t)zeros);
+
+        int32_t nonzeros = 0;
+        for (int32_t p = u; p < width && row[p] != 0; p++) nonzeros++;
+        w.PutVLE((uint32_t)nonzeros);
+
+        for (int32_t i = 0; i < nonzeros; i++, u++) {
+            uint32_t cur = (uint32_t)row[u];
+            int32_t delta = (int32_t)(cur - prev);
+            w.PutVLE(((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+            prev = cur;
+        }
+    }
+}
+
+template <typename T>
+static bool DecodeRow(T* row, int32_t width, uint32_t& prev, NibbleReader& r) {
+    int32_t u = 0;
+    while (u < width) {
+        uint32_t zeros = r.GetVLE();
+        if (r.underflow || zeros > (uint32_t)(width - u)) return false;
+        std::memset(row + u, 0, zeros * sizeof(T));
+        u += (int32_t)zeros;
+
+        uint32_t nonzeros = r.GetVLE();
+        if (r.underflow || nonzeros > (uint32_t)(width - u)) return false;
+        for (uint32_t i = 0; i < nonzeros; i++, u++) {
+            uint32_t zz = r.GetVLE();
+            int32_t delta = (int32_t)(zz >> 1) ^ -(int32_t)(zz & 1);
+            prev += (uint32_t)delta;
+            row[u] = (T)prev;
+        }
+        if (r.underflow) return false;
+    }
+    return true;
+}
+
+// Bit patterns of 4-byte pixels (float32 depth) are coded as uint32.
+static bool IsSupportedPixelSize(int32_t bytesPerPixel) {
+    return bytesPerPixel == 2 || bytesPerPixel == 4;
+}
+
+// ---------- API ----------
+
+int32_t MLDepthCodecUnity_MaxEncodedSize(const DepthFrameInfo* info) {
+    if (!info || info->width <= 0 || info->height <= 0) return 0;
+
+    // Worst case per pixel: 11 nibbles for the value plus one zero run and one
+    // nonzero run header (up to 11 nibbles each for 32-bit counts).
+    const int64_t pixels = (int64_t)info->width * info->height;
+    const int64_t nibbles = pixels * 33 + (int64_t)info->height * 22;
+    const int64_t bytes = ((nibbles + 7) / 8) * 4 + (int64_t)sizeof(CodecHeader);
+    return bytes > INT32_MAX ? INT32_MAX : (int32_t)bytes;
+}
+
+bool MLDepthCodecUnity_Encode(
+    const DepthFrameInfo* info,
+    const uint8_t* bytes,
+    uint8_t* out_encoded,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written)
+{
+    if (!info || !bytes || !out_encoded || !out_bytes_written) return false;
+    *out_bytes_written = 0;
+
+    if (info->width <= 0 || info->height <= 0 || !IsSupportedPixelSize(info->bytesPerPixel)) {
+        LOGW("Encode: unsupported frame %dx%d bpp=%d", info->width, info->height, info->bytesPerPixel);
+        return false;
+    }
+    if (capacity_bytes < (int32_t)sizeof(CodecHeader)) {
+        *out_bytes_written = MLDepthCodecUnity_MaxEncodedSize(info);
+        return false;
+    }
+
+    const int32_t stride = info->strideBytes > 0 ? info->strideBytes : info->width * info->bytesPerPixel;
+
+    NibbleWriter w;
+    w.out = out_encoded + sizeof(CodecHeader);
+    w.end = out_encoded + capacity_bytes;
+
+    uint32_t prev = 0;
+    for (int32_t v = 0; v < info->height && !w.overflow; v++) {
+        const uint8_t* row = bytes + (size_t)v * stride;
+        if (info->bytesPerPixel == 2) {
+            EncodeRow((const uint16_t*)row, info->width, prev, w);
+        } else {
+            EncodeRow((const uint32_t*)row, info->width, prev, w);
+        }
+    }
+    w.Flush();
+
+    if (w.overflow) {
+        *out_bytes_written = MLDepthCodecUnity_MaxEncodedSize(info);
+        return false;
+    }
+
+    CodecHeader header;
+    header.magic = CODEC_MAGIC;
+    header.version = CODEC_VERSION;
+    header.bytesPerPixel = (uint16_t)info->bytesPerPixel;
+    header.width = info->width;
+    header.height = info->height;
+    header.format = info->format;
+    header.payloadBytes = (int32_t)(w.out - (out_encoded + sizeof(CodecHeader)));
+    header.captureTimeNs = info->captureTimeNs;
+    std::memcpy(out_encoded, &header, sizeof(header));
+
+    *out_bytes_written = (int32_t)sizeof(CodecHeader) + header.payloadBytes;
+    return true;
+}
+
+bool MLDepthCodecUnity_Decode(
+    const uint8_t* encoded,
+    int32_t encoded_size,
+    DepthFrameInfo* out_info,
+    uint8_t* out_bytes,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written)
+{
+    if (!encoded || !out_info || !out_bytes || !out_bytes_written) return false;
+    *out_bytes_written = 0;
+
+    if (encoded_size < (int32_t)sizeof(CodecHeader)) return false;
+
+    CodecHeader header;
+    std::memcpy(&header, encoded, sizeof(header));
+    if (header.magic != CODEC_MAGIC || header.version != CODEC_VERSION ||
+        header.width <= 0 || header.height <= 0 || !IsSupportedPixelSize(header.bytesPerPixel) ||
+        header.payloadBytes < 0 || header.payloadBytes > encoded_size - (int32_t)sizeof(CodecHeader)) {
+        LOGW("Decode: invalid header");
+        return false;
+    }
+
+    const int32_t stride = header.width * header.bytesPerPixel;
+    const int64_t required = (int64_t)stride * header.height;
+    if (required > capacity_bytes) {
+        *out_bytes_written = required > INT32_MAX ? INT32_MAX : (int32_t)required;
+        return false;
+    }
+
+    NibbleReader r;
+    r.in = encoded + sizeof(CodecHeader);
+    r.end = r.in + header.payloadBytes;
+
+    uint32_t prev = 0;
+    for (int32_t v = 0; v < header.height; v++) {
+        uint8_t* row = out_bytes + (size_t)v * stride;
+        bool ok = header.bytesPerPixel == 2
+            ? DecodeRow((uint16_t*)row, header.width, prev, r)
+            : DecodeRow((uint32_t*)row, header.width, prev, r);
+        if (!ok) {
+            LOGW("Decode: corrupt payload at row %d", v);
+            return false;
+        }
+    }
+
+    out_info->width = header.width;
+    out_info->height = header.height;
+    out_info->strideBytes = stride;
+    out_info->captureTimeNs = header.captureTimeNs;
+    out_info->bytesPerPixel = header.bytesPerPixel;
+    out_info->format = header.format;
+    *out_bytes_written = (int32_t)required;
+    return true;
+}
+
+bool MLDepthCodecUnity_EncodeLatest(
+    uint32_t stream,
+    DepthFrameInfo* out_info,
+    uint8_t* out_encoded,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written)
+{
+    if (!out_info || !out_encoded || !out_bytes_written) return false;
+    *out_bytes_written = 0;
+
+    DepthFrameInfo info;
+    const uint8_t* bytes = nullptr;
+    int32_t size = 0;
+    void* lease = nullptr;
+    if (!MLDepthUnity_AcquireLatest(stream, &info, &bytes, &size, &lease)) return false;
+
+    bool ok = MLDepthCodecUnity_Encode(&info, bytes, out_encoded, capacity_bytes, out_bytes_written);
+    if (ok) *out_info = info;
+
+    MLDepthUnity_ReleaseFrame(lease);
+    return ok;
+}
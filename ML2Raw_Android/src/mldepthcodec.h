@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mldepth.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Lossless depth codec (RVL-style: zero-run lengths + zigzag deltas, packed as
+// variable-length nibbles). Works on 16-bit depth and on 32-bit float depth
+// (bit patterns are coded exactly, so NaN/invalid values survive).
+//
+// Encoded stream = small header (frame info) + nibble payload.
+// Decoded frames are tightly packed: strideBytes = width * bytesPerPixel.
+
+// Worst-case encoded size for a frame, for sizing the output buffer.
+int32_t MLDepthCodecUnity_MaxEncodedSize(const DepthFrameInfo* info);
+
+// Encode a frame (rows read using info->strideBytes).
+// out_bytes_written: encoded size, or required size if the buffer is too small.
+bool MLDepthCodecUnity_Encode(
+    const DepthFrameInfo* info,
+    const uint8_t* bytes,
+    uint8_t* out_encoded,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written);
+
+// Decode a stream produced by MLDepthCodecUnity_Encode.
+// out_bytes_written: decoded size, or required size if the buffer is too small.
+bool MLDepthCodecUnity_Decode(
+    const uint8_t* encoded,
+    int32_t encoded_size,
+    DepthFrameInfo* out_info,
+    uint8_t* out_bytes,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written);
+
+// Encode the latest frame of a depth stream (DepthStream) straight from the
+// capture pool, without copying it out first.
+bool MLDepthCodecUnity_EncodeLatest(
+    uint32_t stream,
+    DepthFrameInfo* out_info,
+    uint8_t* out_encoded,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,463 @@
+#include "mldepthkernels.h"
+
+#include <cmath>
+
+// NEON kernels need AArch64 (vdivq_f32); 32-bit ARM uses the scalar paths.
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ---------- Confidence / flag mask ----------
+
+void DepthMaskRowScalar(const float* depth, const float* conf, const uint32_t* flags,
+                        float minConfidence, uint32_t rejectFlags, int32_t width, float* out) {
+    for (int32_t u = 0; u < width; u++) {
+        bool keep = true;
+        if (conf && !(conf[u] >= minConfidence)) keep = false;
+        if (flags && (flags[u] & rejectFlags) != 0) keep = false;
+        out[u] = keep ? depth[u] : 0.0f;
+    }
+}
+
+#if defined(__aarch64__)
+
+void DepthMaskRow(const float* depth, const float* conf, const uint32_t* flags,
+                  float minConfidence, uint32_t rejectFlags, int32_t width, float* out) {
+    const float32x4_t thr = vdupq_n_f32(minConfidence);
+    const uint32x4_t rej = vdupq_n_u32(rejectFlags);
+    const uint32x4_t all = vdupq_n_u32(0xFFFFFFFFu);
+    int32_t u = 0;
+
+    for (; u + 4 <= width; u += 4) {
+        uint32x4_t keep = all;
+        if (conf) keep = vandq_u32(keep, vcgeq_f32(vld1q_f32(conf + u), thr));
+        if (flags) keep = vbicq_u32(keep, vtstq_u32(vld1q_u32(flags + u), rej));
+        uint32x4_t d = vreinterpretq_u32_f32(vld1q_f32(depth + u));
+        vst1q_f32(out + u, vreinterpretq_f32_u32(vandq_u32(d, keep)));
+    }
+
+    if (u < width) {
+        DepthMaskRowScalar(depth + u, conf ? conf + u : nullptr, flags ? flags + u : nullptr,
+                           minConfidence, rejectFlags, width - u, out + u);
+    }
+}
+
+#elif defined(__SSE2__)
+
+void DepthMaskRow(const float* depth, const float* conf, const uint32_t* flags,
+                  float minConfidence, uint32_t rejectFlags, int32_t width, float* out) {
+    const __m128 thr = _mm_set1_ps(minConfidence);
+    const __m128i rej = _mm_set1_epi32((int32_t)rejectFlags);
+    const __m128i zero = _mm_setzero_si128();
+    int32_t u = 0;
+
+    for (; u + 4 <= width; u += 4) {
+        __m128 keep = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        if (conf) keep = _mm_and_ps(keep, _mm_cmpge_ps(_mm_loadu_ps(conf + u), thr));
+        if (flags) {
+            __m128i f = _mm_and_si128(_mm_loadu_si128((const __m128i*)(flags + u)), rej);
+            keep = _mm_and_ps(keep, _mm_castsi128_ps(_mm_cmpeq_epi32(f, zero)));
+        }
+        _mm_storeu_ps(out + u, _mm_and_ps(_mm_loadu_ps(depth + u), keep));
+    }
+
+    if (u < width) {
+        DepthMaskRowScalar(depth + u, conf ? conf + u : nullptr, flags ? flags + u : nullptr,
+                           minConfidence, rejectFlags, width - u, out + u);
+    }
+}
+
+#else
+
+void DepthMaskRow(const float* depth, const float* conf, const uint32_t* flags,
+                  float minConfidence, uint32_t rejectFlags, int32_t width, float* out) {
+    DepthMaskRowScalar(depth, conf, flags, minConfidence, rejectFlags, width, out);
+}
+
+#endif
+
+// ---------- Pyramid reductions ----------
+// The scalar versions use the same operation order as the SIMD ones, so all
+// paths produce bit-identical output.
+
+static inline float ValidOrInf(float d) {
+    return d > 0.0f ? d : INFINITY;
+}
+
+static inline void SortPair(float& a, float& b) {
+    float lo = a < b ? a : b;
+    float hi = a < b ? b : a;
+    a = lo;
+    b = hi;
+}
+
+void DepthReduceMinRowScalar(const float* row0, const float* row1, int32_t outWidth, float* out) {
+    for (int32_t x = 0; x < outWidth; x++) {
+        float a = ValidOrInf(row0[2 * x]), b = ValidOrInf(row0[2 * x + 1]);
+        float c = ValidOrInf(row1[2 * x]), d = ValidOrInf(row1[2 * x + 1]);
+        float ab = a < b ? a : b;
+        float cd = c < d ? c : d;
+        float m = ab < cd ? ab : cd;
+        out[x] = m == INFINITY ? 0.0f : m;
+    }
+}
+
+void DepthReduceMedianRowScalar(const float* row0, const float* row1, int32_t outWidth, float* out) {
+    for (int32_t x = 0; x < outWidth; x++) {
+        float a = ValidOrInf(row0[2 * x]), b = ValidOrInf(row0[2 * x + 1]);
+        float c = ValidOrInf(row1[2 * x]), d = ValidOrInf(row1[2 * x + 1]);
+        int n = (a != INFINITY) + (b != INFINITY) + (c != INFINITY) + (d != INFINITY);
+
+        // 4-element sorting network: invalid (+inf) samples end up last
+        SortPair(a, b);
+        SortPair(c, d);
+        SortPair(a, c);
+        SortPair(b, d);
+        SortPair(b, c);
+
+        float r = 0.0f;
+        if (n == 4)      r = (b + c) * 0.5f;
+        else if (n == 3) r = b;
+        else if (n == 2) r = (a + b) * 0.5f;
+        else if (n == 1) r = a;
+        out[x] = r;
+    }
+}
+
+static inline float ClampWeight(float w) {
+    w = w > 0.0f ? w : 0.0f;   // also maps NaN to 0
+    return w < 1.0f ? w : 1.0f;
+}
+
+void DepthReduceWeightedRowScalar(const float* row0, const float* row1, const float* w0, const float* w1,
+                                  int32_t outWidth, float* out, float* outWeight) {
+    for (int32_t x = 0; x < outWidth; x++) {
+        float d[4] = { row0[2 * x], row0[2 * x + 1], row1[2 * x], row1[2 * x + 1] };
+        float w[4] = { w0 ? ClampWeight(w0[2 * x]) : 1.0f, w0 ? ClampWeight(w0[2 * x + 1]) : 1.0f,
+                       w1 ? ClampWeight(w1[2 * x]) : 1.0f, w1 ? ClampWeight(w1[2 * x + 1]) : 1.0f };
+        for (int i = 0; i < 4; i++) {
+            if (!(d[i] > 0.0f)) { d[i] = 0.0f; w[i] = 0.0f; }
+        }
+        float sw = (w[0] + w[1]) + (w[2] + w[3]);
+        float swd = (w[0] * d[0] + w[1] * d[1]) + (w[2] * d[2] + w[3] * d[3]);
+        out[x] = sw > 0.0f ? swd / sw : 0.0f;
+        if (outWeight) outWeight[x] = sw * 0.25f;
+    }
+}
+
+#if defined(__aarch64__)
+
+// Loads 4 output blocks: a/b = even/odd of row0, c/d = even/odd of row1
+#define LOAD_BLOCKS(r0, r1, x, a, b, c, d)          \
+    float32x4x2_t p0_ = vld2q_f32((r0) + 2 * (x));  \
+    float32x4x2_t p1_ = vld2q_f32((r1) + 2 * (x));  \
+    float32x4_t a = p0_.val[0], b = p0_.val[1];      \
+    float32x4_t c = p1_.val[0], d = p1_.val[1];
+
+static inline float32x4_t ValidOrInf4(float32x4_t v) {
+    return vbslq_f32(vcgtq_f32(v, vdupq_n_f32(0.0f)), v, vdupq_n_f32(INFINITY));
+}
+
+void DepthReduceMinRow(const float* row0, const float* row1, int32_t outWidth, float* out) {
+    const float32x4_t inf = vdupq_n_f32(INFINITY);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    int32_t x = 0;
+    for (; x + 4 <= outWidth; x += 4) {
+        LOAD_BLOCKS(row0, row1, x, a, b, c, d);
+        float32x4_t m = vminq_f32(vminq_f32(ValidOrInf4(a), ValidOrInf4(b)),
+                                  vminq_f32(ValidOrInf4(c), ValidOrInf4(d)));
+        vst1q_f32(out + x, vbslq_f32(vceqq_f32(m, inf), zero, m));
+    }
+    if (x < outWidth) DepthReduceMinRowScalar(row0 + 2 * x, row1 + 2 * x, outWidth - x, out + x);
+}
+
+void DepthReduceMedianRow(const float* row0, const float* row1, int32_t outWidth, float* out) {
+    const float32x4_t inf = vdupq_n_f32(INFINITY);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const uint32x4_t one = vdupq_n_u32(1);
+    int32_t x = 0;
+    for (; x + 4 <= outWidth; x += 4) {
+        LOAD_BLOCKS(row0, row1, x, a0, b0, c0, d0);
+        float32x4_t a = ValidOrInf4(a0), b = ValidOrInf4(b0), c = ValidOrInf4(c0), d = ValidOrInf4(d0);
+        uint32x4_t n = vaddq_u32(vaddq_u32(vandq_u32(vmvnq_u32(vceqq_f32(a, inf)), one),
+                                           vandq_u32(vmvnq_u32(vceqq_f32(b, inf)), one)),
+                                 vaddq_u32(vandq_u32(vmvnq_u32(vceqq_f32(c, inf)), one),
+                                           vandq_u32(vmvnq_u32(vceqq_f32(d, inf)), one)));
+        float32x4_t t;
+        t = vminq_f32(a, b); b = vmaxq_f32(a, b); a = t;
+        t = vminq_f32(c, d); d = vmaxq_f32(c, d); c = t;
+        t = vminq_f32(a, c); c = vmaxq_f32(a, c); a = t;
+        t = vminq_f32(b, d); d = vmaxq_f32(b, d); b = t;
+        t = vminq_f32(b, c); c = vmaxq_f32(b, c); b = t;
+
+        float32x4_t r = vdupq_n_f32(0.0f);
+        r = vbslq_f32(vceqq_u32(n, vdupq_n_u32(1)), a, r);
+        r = vbslq_f32(vceqq_u32(n, vdupq_n_u32(2)), vmulq_f32(vaddq_f32(a, b), half), r);
+        r = vbslq_f32(vceqq_u32(n, vdupq_n_u32(3)), b, r);
+        r = vbslq_f32(vceqq_u32(n, vdupq_n_u32(4)), vmulq_f32(vaddq_f32(b, c), half), r);
+        vst1q_f32(out + x, r);
+    }
+    if (x < outWidth) DepthReduceMedianRowScalar(row0 + 2 * x, row1 + 2 * x, outWidth - x, out + x);
+}
+
+static inline float32x4_t ClampWeight4(float32x4_t w) {
+    w = vbslq_f32(vcgtq_f32(w, vdupq_n_f32(0.0f)), w, vdupq_n_f32(0.0f));
+    return vbslq_f32(vcltq_f32(w, vdupq_n_f32(1.0f)), w, vdupq_n_f32(1.0f));
+}
+
+void DepthReduceWeightedRow(const float* row0, const float* row1, const float* w0, const float* w1,
+                            int32_t outWidth, float* out, float* outWeight) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t ones = vdupq_n_f32(1.0f);
+    const float32x4_t quarter = vdupq_n_f32(0.25f);
+    int32_t x = 0;
+    for (; x + 4 <= outWidth; x += 4) {
+        LOAD_BLOCKS(row0, row1, x, a, b, c, d);
+        float32x4_t wa = ones, wb = ones, wc = ones, wd = ones;
+        if (w0) {
+            float32x4x2_t q = vld2q_f32(w0 + 2 * x);
+            wa = ClampWeight4(q.val[0]);
+            wb = ClampWeight4(q.val[1]);
+        }
+        if (w1) {
+            float32x4x2_t q = vld2q_f32(w1 + 2 * x);
+            wc = ClampWeight4(q.val[0]);
+            wd = ClampWeight4(q.val[1]);
+        }
+        uint32x4_t va = vcgtq_f32(a, zero), vb = vcgtq_f32(b, zero);
+        uint32x4_t vc = vcgtq_f32(c, zero), vd = vcgtq_f32(d, zero);
+        a = vbslq_f32(va, a, zero);   wa = vbslq_f32(va, wa, zero);
+        b = vbslq_f32(vb, b, zero);   wb = vbslq_f32(vb, wb, zero);
+        c = vbslq_f32(vc, c, zero);   wc = vbslq_f32(vc, wc, zero);
+        d = vbslq_f32(vd, d, zero);   wd = vbslq_f32(vd, wd, zero);
+
+        float32x4_t sw = vaddq_f32(vaddq_f32(wa, wb), vaddq_f32(wc, wd));
+        float32x4_t swd = vaddq_f32(vaddq_f32(vmulq_f32(wa, a), vmulq_f32(wb, b)),
+                                    vaddq_f32(vmulq_f32(wc, c), vmulq_f32(wd, d)));
+        uint32x4_t has = vcgtq_f32(sw, zero);
+        float32x4_t r = vbslq_f32(has, vdivq_f32(swd, vbslq_f32(has, sw, ones)), zero);
+        vst1q_f32(out + x, r);
+        if (outWeight) vst1q_f32(outWeight + x, vmulq_f32(sw, quarter));
+    }
+    if (x < outWidth) {
+        DepthReduceWeightedRowScalar(row0 + 2 * x, row1 + 2 * x, w0 ? w0 + 2 * x : nullptr, w1 ? w1 + 2 * x : nullptr,
+                                     outWidth - x, out + x, outWeight ? outWeight + x : nullptr);
+    }
+}
+
+#undef LOAD_BLOCKS
+
+#elif defined(__SSE2__)
+
+// Splits 8 consecutive floats into even and odd lanes
+static inline void Deinterleave(const float* p, __m128& even, __m128& odd) {
+    __m128 lo = _mm_loadu_ps(p);
+    __m128 hi = _mm_loadu_ps(p + 4);
+    even = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+    odd  = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+static inline __m128 Select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128 ValidOrInf4(__m128 v) {
+    return Select(_mm_cmpgt_ps(v, _mm_setzero_ps()), v, _mm_set1_ps(INFINITY));
+}
+
+void DepthReduceMinRow(const float* row0, const float* row1, int32_t outWidth, float* out) {
+    const __m128 inf = _mm_set1_ps(INFINITY);
+    int32_t x = 0;
+    for (; x + 4 <= outWidth; x += 4) {
+        __m128 a, b, c, d;
+        Deinterleave(row0 + 2 * x, a, b);
+        Deinterleave(row1 + 2 * x, c, d);
+        __m128 m = _mm_min_ps(_mm_min_ps(ValidOrInf4(a), ValidOrInf4(b)),
+                              _mm_min_ps(ValidOrInf4(c), ValidOrInf4(d)));
+        _mm_storeu_ps(out + x, _mm_andnot_ps(_mm_cmpeq_ps(m, inf), m));
+    }
+    if (x < outWidth) DepthReduceMinRowScalar(row0 + 2 * x, row1 + 2 * x, outWidth - x, out + x);
+}
+
+void DepthReduceMedianRow(const float* row0, const float* row1, int32_t outWidth, float* out) {
+    const __m128 inf = _mm_set1_ps(INFINITY);
+    const __m128 half = _mm_set1_ps(0.5f);
+    int32_t x = 0;
+    for (; x + 4 <= outWidth; x += 4) {
+        __m128 a, b, c, d;
+        Deinterleave(row0 + 2 * x, a, b);
+        Deinterleave(row1 + 2 * x, c, d);
+        a = ValidOrInf4(a); b = ValidOrInf4(b); c = ValidOrInf4(c); d = ValidOrInf4(d);
+
+        // Valid count: each invalid lane compares equal to inf (-1 as int)
+        __m128i n = _mm_set1_epi32(4);
+        n = _mm_add_epi32(n, _mm_castps_si128(_mm_cmpeq_ps(a, inf)));
+        n = _mm_add_epi32(n, _mm_castps_si128(_mm_cmpeq_ps(b, inf)));
+        n = _mm_add_epi32(n, _mm_castps_si128(_mm_cmpeq_ps(c, inf)));
+        n = _mm_add_epi32(n, _mm_castps_si128(_mm_cmpeq_ps(d, inf)));
+
+        // Same compare-select as SortPair so results match the scalar path
+        __m128 t;
+        t = _mm_min_ps(a, b); b = _mm_max_ps(a, b); a = t;
+        t = _mm_min_ps(c, d); d = _mm_max_ps(c, d); c = t;
+        t = _mm_min_ps(a, c); c = _mm_max_ps(a, c); a = t;
+        t = _mm_min_ps(b, d); d = _mm_max_ps(b, d); b = t;
+        t = _mm_min_ps(b, c); c = _mm_max_ps(b, c); b = t;
+
+        __m128 r = _mm_setzero_ps();
+        r = Select(_mm_castsi128_ps(_mm_cmpeq_epi32(n, _mm_set1_epi32(1))), a, r);
+        r = Select(_mm_castsi128_ps(_mm_cmpeq_epi32(n, _mm_set1_epi32(2))), _mm_mul_ps(_mm_add_ps(a, b), half), r);
+        r = Select(_mm_castsi128_ps(_mm_cmpeq_epi32(n, _mm_set1_epi32(3))), b, r);
+        r = Select(_mm_castsi128_ps(_mm_cmpeq_epi32(n, _mm_set1_epi32(4))), _mm_mul_ps(_mm_add_ps(b, c), half), r);
+        _mm_storeu_ps(out + x, r);
+    }
+    if (x < outWidth) DepthReduceMedianRowScalar(row0 + 2 * x, row1 + 2 * x, outWidth - x, out + x);
+}
+
+static inline __m128 ClampWeight4(__m128 w) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    w = Select(_mm_cmpgt_ps(w, zero), w, zero);
+    return Select(_mm_cmplt_ps(w, one), w, one);
+}
+
+void DepthReduceWeightedRow(const float* row0, const float* row1, const float* w0, const float* w1,
+                            int32_t outWidth, float* out, float* outWeight) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 ones = _mm_set1_ps(1.0f);
+    const __m128 quarter = _mm_set1_ps(0.25f);
+    int32_t x = 0;
+    for (; x + 4 <= outWidth; x += 4) {
+        __m128 a, b, c, d;
+        Deinterleave(row0 + 2 * x, a, b);
+        Deinterleave(row1 + 2 * x, c, d);
+        __m128 wa = ones, wb = ones, wc = ones, wd = ones;
+        if (w0) {
+            Deinterleave(w0 + 2 * x, wa, wb);
+            wa = ClampWeight4(wa);
+            wb = ClampWeight4(wb);
+        }
+        if (w1) {
+            Deinterleave(w1 + 2 * x, wc, wd);
+            wc = ClampWeight4(wc);
+            wd = ClampWeight4(wd);
+        }
+        __m128 va = _mm_cmpgt_ps(a, zero), vb = _mm_cmpgt_ps(b, zero);
+        __m128 vc = _mm_cmpgt_ps(c, zero), vd = _mm_cmpgt_ps(d, zero);
+        a = _mm_and_ps(va, a);   wa = _mm_and_ps(va, wa);
+        b = _mm_and_ps(vb, b);   wb = _mm_and_ps(vb, wb);
+        c = _mm_and_ps(vc, c);   wc = _mm_and_ps(vc, wc);
+        d = _mm_and_ps(vd, d);   wd = _mm_and_ps(vd, wd);
+
+        __m128 sw = _mm_add_ps(_mm_add_ps(wa, wb), _mm_add_ps(wc, wd));
+        __m128 swd = _mm_add_ps(_mm_add_ps(_mm_mul_ps(wa, a), _mm_mul_ps(wb, b)),
+                                _mm_add_ps(_mm_mul_ps(wc, c), _mm_mul_ps(wd, d)));
+        __m128 has = _mm_cmpgt_ps(sw, zero);
+        __m128 r = _mm_and_ps(has, _mm_div_ps(swd, Select(has, sw, ones)));
+        _mm_storeu_ps(out + x, r);
+        if (outWeight) _mm_storeu_ps(outWeight + x, _mm_mul_ps(sw, quarter));
+    }
+    if (x < outWidth) {
+        DepthReduceWeightedRowScalar(row0 + 2 * x, row1 + 2 * x, w0 ? w0 + 2 * x : nullptr, w1 ? w1 + 2 * x : nullptr,
+                                     outWidth - x, out + x, outWeight ? outWeight + x : nullptr);
+    }
+}
+
+#else
+
+void DepthReduceMinRow(const float* row0, const float* row1, int32_t outWidth, float* out) {
+    DepthReduceMinRowScalar(row0, row1, outWidth, out);
+}
+
+void DepthReduceMedianRow(const float* row0, const float* row1, int32_t outWidth, float* out) {
+    DepthReduceMedianRowScalar(row0, row1, outWidth, out);
+}
+
+void DepthReduceWeightedRow(const float* row0, const float* row1, const float* w0, const float* w1,
+                            int32_t outWidth, float* out, float* outWeight) {
+    DepthReduceWeightedRowScalar(row0, row1, w0, w1, outWidth, out, outWeight);
+}
+
+#endif
+
+// ---------- Temporal filter ----------
+
+void DepthTemporalRowScalar(const float* depth, const float* conf, const float* prev,
+                            float alpha, float resetThreshold, int32_t width, float* out) {
+    for (int32_t u = 0; u < width; u++) {
+        float d = depth[u];
+        if (!(d > 0.0f)) {
+            out[u] = 0.0f;
+            continue;
+        }
+        float p = prev ? prev[u] : 0.0f;
+        float diff = d - p;
+        float absDiff = diff < 0.0f ? -diff : diff;
+        if (!(p > 0.0f) || absDiff > resetThreshold) {
+            out[u] = d;
+            continue;
+        }
+        float w = conf ? ClampWeight(conf[u]) : 1.0f;
+        out[u] = p + (alpha * w) * diff;
+    }
+}
+
+#if defined(__aarch64__)
+
+void DepthTemporalRow(const float* depth, const float* conf, const float* prev,
+                      float alpha, float resetThreshold, int32_t width, float* out) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t va = vdupq_n_f32(alpha);
+    const float32x4_t thr = vdupq_n_f32(resetThreshold);
+    int32_t u = 0;
+    for (; u + 4 <= width; u += 4) {
+        float32x4_t d = vld1q_f32(depth + u);
+        float32x4_t p = prev ? vld1q_f32(prev + u) : zero;
+        float32x4_t diff = vsubq_f32(d, p);
+        float32x4_t a = conf ? vmulq_f32(va, ClampWeight4(vld1q_f32(conf + u))) : va;
+        float32x4_t f = vaddq_f32(p, vmulq_f32(a, diff));
+        uint32x4_t keep = vandq_u32(vcgtq_f32(p, zero), vmvnq_u32(vcgtq_f32(vabsq_f32(diff), thr)));
+        float32x4_t r = vbslq_f32(keep, f, d);
+        vst1q_f32(out + u, vbslq_f32(vcgtq_f32(d, zero), r, zero));
+    }
+    if (u < width) {
+        DepthTemporalRowScalar(depth + u, conf ? conf + u : nullptr, prev ? prev + u : nullptr,
+                               alpha, resetThreshold, width - u, out + u);
+    }
+}
+
+#elif defined(__SSE2__)
+
+void DepthTemporalRow(const float* depth, const float* conf, const float* prev,
+                      float alpha, float resetThreshold, int32_t width, float* out) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 va = _mm_set1_ps(alpha);
+    const __m128 thr = _mm_set1_ps(resetThreshold);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    int32_t u = 0;
+    for (; u + 4 <= width; u += 4) {
+        __m128 d = _mm_loadu_ps(depth + u);
+        __m128 p = prev ? _mm_loadu_ps(prev + u) : zero;
+        __m128 diff = _mm_sub_ps(d, p);
+        __m128 a = conf ? _mm_mul_ps(va, ClampWeight4(_mm_loadu_ps(conf + u))) : va;
+        __m128 f = _mm_add_ps(p, _mm_mul_ps(a, diff));
+        __m128 keep = _mm_andnot_ps(_mm_cmpgt_ps(_mm_and_ps(diff, absMask), thr), _mm_cmpgt_ps(p, zero));
+        __m128 r = Select(keep, f, d);
+        _mm_storeu_ps(out + u, _mm_and_ps(_mm_cmpgt_ps(d, zero), r));
+    }
+    if (u < width) {
+        DepthTemporalRowScalar(depth + u, conf ? conf + u : nullptr, prev ? prev + u : nullptr,
+                               alpha, resetThreshold, width - u, out + u);
+    }
+}
+
+#else
+
+void DepthTemporalRow(const float* depth, const float* conf, const float* prev,
+                      float alpha, float resetThreshold, int32_t width, float* out) {
+    DepthTemporalRowScalar(depth, conf, prev, alpha, resetThreshold, width, out);
+}
+
+#endif
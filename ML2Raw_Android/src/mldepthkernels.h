@@ -0,0 +1,44 @@
+#pragma once
+// Internal C++ pixel kernels used on the depth capture thread (not part of the
+// Unity API). Every kernel has a scalar reference; the default entry point
+// dispatches to NEON or SSE2 when the target supports it.
+
+#include <cstdint>
+
+// Copies one row of float32 depth, zeroing pixels whose confidence is below
+// minConfidence (if conf != null) or whose flags intersect rejectFlags
+// (if flags != null).
+void DepthMaskRowScalar(const float* depth, const float* conf, const uint32_t* flags,
+                        float minConfidence, uint32_t rejectFlags, int32_t width, float* out);
+void DepthMaskRow(const float* depth, const float* conf, const uint32_t* flags,
+                  float minConfidence, uint32_t rejectFlags, int32_t width, float* out);
+
+// 2x2 reductions for the depth pyramid. row0/row1 are two consecutive input
+// rows of at least 2 * outWidth floats. Depth <= 0 (or NaN) is invalid and
+// never contributes; an output with no valid input is 0.
+
+// Nearest valid depth of each 2x2 block.
+void DepthReduceMinRowScalar(const float* row0, const float* row1, int32_t outWidth, float* out);
+void DepthReduceMinRow(const float* row0, const float* row1, int32_t outWidth, float* out);
+
+// Median of the valid depths of each 2x2 block (mean of the middle two when even).
+void DepthReduceMedianRowScalar(const float* row0, const float* row1, int32_t outWidth, float* out);
+void DepthReduceMedianRow(const float* row0, const float* row1, int32_t outWidth, float* out);
+
+// Weighted mean with weights clamp(w, 0, 1) (w0/w1 null -> weight 1 for valid
+// depth). outWeight (optional) receives the block's mean weight so the next
+// level can be reduced the same way.
+void DepthReduceWeightedRowScalar(const float* row0, const float* row1, const float* w0, const float* w1,
+                                  int32_t outWidth, float* out, float* outWeight);
+void DepthReduceWeightedRow(const float* row0, const float* row1, const float* w0, const float* w1,
+                            int32_t outWidth, float* out, float* outWeight);
+
+// Temporal exponential filter for one row:
+//   out = prev + alpha * w * (depth - prev), w = clamp(conf, 0, 1) (1 if conf null)
+// Pixels restart from the new depth where there is no history (prev null or
+// <= 0) or where |depth - prev| > resetThreshold (motion / disocclusion).
+// Invalid depth gives 0. out may alias prev.
+void DepthTemporalRowScalar(const float* depth, const float* conf, const float* prev,
+                            float alpha, float resetThreshold, int32_t width, float* out);
+void DepthTemporalRow(const float* depth, const float* conf, const float* prev,
+                      float alpha, float resetThreshold, int32_t width, float* out);
@@ -0,0 +1,597 @@
+#include "mldepthnormals.h"
+#include "mlframeslot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <android/log.h>
+
+#define LOG_TAG "MLDepthNormalsUnity"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+
+static constexpr int16_t OCT_INVALID = -32768;
+
+// Capture-thread normals (MLDepthNormalsUnity_Configure)
+static std::atomic<bool> g_enabled{false};
+static std::atomic<uint32_t> g_format{DepthNormalFormat_Float3};
+static std::atomic<int32_t> g_smoothRadius{0};
+static std::atomic<float> g_maxDepthJump{0.0f};
+
+typedef FrameSlots<DepthFrameInfo, 3> NormalSlots;
+static NormalSlots g_normalSlots;
+
+// Scratch, grown once per calling thread
+struct NormalScratch {
+    std::vector<float> px, py, pz;      // point planes (0 = invalid)
+    std::vector<float> sx, sy, sz;      // smoothed point planes
+    std::vector<double> ix, iy, iz;     // integral images, (W+1) x (H+1)
+    std::vector<int32_t> ic;            // integral image of valid counts
+    std::vector<float> nx, ny, nz;      // one row of normals
+};
+
+// ---------- Point cloud ----------
+
+static void UnprojectPlanes(const uint8_t* depth, int32_t stride, int32_t width, int32_t height,
+                            const DepthIntrinsics& k, NormalScratch& s) {
+    const float invFx = 1.0f / k.fx, invFy = 1.0f / k.fy;
+    for (int32_t v = 0; v < height; v++) {
+        const float* row = (const float*)(depth + (size_t)v * stride);
+        const float rowRay = ((float)v - k.cy) * invFy;
+        float* x = &s.px[(size_t)v * width];
+        float* y = &s.py[(size_t)v * width];
+        float* z = &s.pz[(size_t)v * width];
+        for (int32_t u = 0; u < width; u++) {
+            const float d = row[u] > 0.0f ? row[u] : 0.0f;  // also catches NaN
+            x[u] = d * (((float)u - k.cx) * invFx);
+            y[u] = d * rowRay;
+            z[u] = d;
+        }
+    }
+}
+
+// Box-filters the point planes over valid pixels using integral images
+// (double sums, so large windows don't lose precision).
+static void SmoothPlanes(int32_t width, int32_t height, int32_t radius, NormalScratch& s) {
+    const int32_t iw = width + 1;
+    const size_t isize = (size_t)iw * (height + 1);
+    s.ix.assign(isize, 0.0);
+    s.iy.assign(isize, 0.0);
+    s.iz.assign(isize, 0.0);
+    s.ic.assign(isize, 0);
+
+    for (int32_t v = 0; v < height; v++) {
+        double rx = 0.0, ry = 0.0, rz = 0.0;
+        int32_t rc = 0;
+        const size_t src = (size_t)v * width;
+        const size_t above = (size_t)v * iw, cur = (size_t)(v + 1) * iw;
+        for (int32_t u = 0; u < width; u++) {
+            if (s.pz[src + u] > 0.0f) {
+                rx += s.px[src + u];
+                ry += s.py[src + u];
+                rz += s.pz[src + u];
+                rc++;
+            }
+            s.ix[cur + u + 1] = s.ix[above + u + 1] + rx;
+            s.iy[cur + u + 1] = s.iy[above + u + 1] + ry;
+            s.iz[cur + u + 1] = s.iz[above + u + 1] + rz;
+            s.ic[cur + u + 1] = s.ic[above + u + 1] + rc;
+        }
+    }
+
+    for (int32_t v = 0; v < height; v++) {
+        const size_t top = (size_t)std::max(v - radius, 0) * iw;
+        const size_t bottom = (size_t)(std::min(v + radius, height - 1) + 1) * iw;
+        const size_t dst = (size_t)v * width;
+        for (int32_t u = 0; u < width; u++) {
+            if (!(s.pz[dst + u] > 0.0f)) {
+                s.sx[dst + u] = s.sy[dst + u] = s.sz[dst + u] = 0.0f;
+                continue;
+            }
+            const size_t l = (size_t)std::max(u - radius, 0);
+            const size_t r = (size_t)std::min(u + radius, width - 1) + 1;
+            const int32_t count = s.ic[bottom + r] - s.ic[bottom + l] - s.ic[top + r] + s.ic[top + l];
+            const double inv = 1.0 / (double)count;  // >= 1: the center is valid
+            s.sx[dst + u] = (float)((s.ix[bottom + r] - s.ix[bottom + l] - s.ix[top + r] + s.ix[top + l]) * inv);
+            s.sy[dst + u] = (float)((s.iy[bottom + r] - s.iy[bottom + l] - s.iy[top + r] + s.iy[top + l]) * inv);
+            s.sz[dst + u] = (float)((s.iz[bottom + r] - s.iz[bottom + l] - s.iz[top + r] + s.iz[top + l]) * inv);
+        }
+    }
+}
+
+// ---------- Normal kernels ----------
+// One row of normals at pixels [step, width - step) from the point rows at
+// v (c), v - step (a) and v + step (b). Invalid pixels get (0, 0, 0).
+// jump is the relative depth jump limit (INFINITY = off).
+
+struct PointRows {
+    const float *cx, *cy, *cz;
+    const float *ax, *ay, *az;
+    const float *bx, *by, *bz;
+};
+
+static void NormalRowScalar(const PointRows& p, int32_t step, int32_t begin, int32_t end, float jump,
+                            float* nx, float* ny, float* nz) {
+    for (int32_t u = begin; u < end; u++) {
+        const float zc = p.cz[u], zl = p.cz[u - step], zr = p.cz[u + step];
+        const float zu = p.az[u], zd = p.bz[u];
+
+        const float dux = p.cx[u + step] - p.cx[u - step];
+        const float duy = p.cy[u + step] - p.cy[u - step];
+        const float duz = zr - zl;
+        const float dvx = p.bx[u] - p.ax[u];
+        const float dvy = p.by[u] - p.ay[u];
+        const float dvz = zd - zu;
+
+        // dv x du faces the camera for a surface seen head-on
+        const float x = dvy * duz - dvz * duy;
+        const float y = dvz * dux - dvx * duz;
+        const float z = dvx * duy - dvy * dux;
+        const float len2 = x * x + y * y + z * z;
+
+        const float limit = jump * zc;
+        const bool valid = zc > 0.0f && zl > 0.0f && zr > 0.0f && zu > 0.0f && zd > 0.0f &&
+                           std::fabs(duz) <= limit && std::fabs(dvz) <= limit && len2 > 0.0f;
+        if (valid) {
+            const float inv = 1.0f / std::sqrt(len2);
+            nx[u] = x * inv;
+            ny[u] = y * inv;
+            nz[u] = z * inv;
+        } else {
+            nx[u] = ny[u] = nz[u] = 0.0f;
+        }
+    }
+}
+
+// Octahedral encoding into snorm16 pairs
+static void EncodeOctScalar(const float* nx, const float* ny, const float* nz, int32_t width, int16_t* out) {
+    for (int32_t u = 0; u < width; u++) {
+        const float l1 = std::fabs(nx[u]) + std::fabs(ny[u]) + std::fabs(nz[u]);
+        if (!(l1 > 0.0f)) {
+            out[u * 2 + 0] = OCT_INVALID;
+            out[u * 2 + 1] = OCT_INVALID;
+            continue;
+        }
+        float ox = nx[u] / l1, oy = ny[u] / l1;
+        if (nz[u] < 0.0f) {
+            const float fx = (1.0f - std::fabs(oy)) * std::copysign(1.0f, ox);
+            const float fy = (1.0f - std::fabs(ox)) * std::copysign(1.0f, oy);
+            ox = fx;
+            oy = fy;
+        }
+        out[u * 2 + 0] = (int16_t)std::lrint(ox * 32767.0f);
+        out[u * 2 + 1] = (int16_t)std::lrint(oy * 32767.0f);
+    }
+}
+
+#if defined(__aarch64__)
+
+static void NormalRowSimd(const PointRows& p, int32_t step, int32_t begin, int32_t end, float jump,
+                          float* nx, float* ny, float* nz) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t vjump = vdupq_n_f32(jump);
+    int32_t u = begin;
+    for (; u + 4 <= end; u += 4) {
+        const float32x4_t zc = vld1q_f32(p.cz + u);
+        const float32x4_t zl = vld1q_f32(p.cz + u - step), zr = vld1q_f32(p.cz + u + step);
+        const float32x4_t zu = vld1q_f32(p.az + u), zd = vld1q_f32(p.bz + u);
+
+        const float32x4_t dux = vsubq_f32(vld1q_f32(p.cx + u + step), vld1q_f32(p.cx + u - step));
+        const float32x4_t duy = vsubq_f32(vld1q_f32(p.cy + u + step), vld1q_f32(p.cy + u - step));
+        const float32x4_t duz = vsubq_f32(zr, zl);
+        const float32x4_t dvx = vsubq_f32(vld1q_f32(p.bx + u), vld1q_f32(p.ax + u));
+        const float32x4_t dvy = vsubq_f32(vld1q_f32(p.by + u), vld1q_f32(p.ay + u));
+        const float32x4_t dvz = vsubq_f32(zd, zu);
+
+        const float32x4_t x = vsubq_f32(vmulq_f32(dvy, duz), vmulq_f32(dvz, duy));
+        const float32x4_t y = vsubq_f32(vmulq_f32(dvz, dux), vmulq_f32(dvx, duz));
+        const float32x4_t z = vsubq_f32(vmulq_f32(dvx, duy), vmulq_f32(dvy, dux));
+        const float32x4_t len2 = vaddq_f32(vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y)), vmulq_f32(z, z));
+
+        const float32x4_t limit = vmulq_f32(vjump, zc);
+        uint32x4_t ok = vandq_u32(vcgtq_f32(zc, zero), vandq_u32(vcgtq_f32(zl, zero), vcgtq_f32(zr, zero)));
+        ok = vandq_u32(ok, vandq_u32(vcgtq_f32(zu, zero), vcgtq_f32(zd, zero)));
+        ok = vandq_u32(ok, vandq_u32(vcleq_f32(vabsq_f32(duz), limit), vcleq_f32(vabsq_f32(dvz), limit)));
+        ok = vandq_u32(ok, vcgtq_f32(len2, zero));
+
+        const float32x4_t inv = vdivq_f32(one, vsqrtq_f32(len2));
+        vst1q_f32(nx + u, vbslq_f32(ok, vmulq_f32(x, inv), zero));
+        vst1q_f32(ny + u, vbslq_f32(ok, vmulq_f32(y, inv), zero));
+        vst1q_f32(nz + u, vbslq_f32(ok, vmulq_f32(z, inv), zero));
+    }
+    NormalRowScalar(p, step, u, end, jump, nx, ny, nz);
+}
+
+static void EncodeOctSimd(const float* nx, const float* ny, const float* nz, int32_t width, int16_t* out) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t scale = vdupq_n_f32(32767.0f);
+    const uint32x4_t signBit = vdupq_n_u32(0x80000000u);
+    const int16x4_t invalid = vdup_n_s16(OCT_INVALID);
+    int32_t u = 0;
+    for (; u + 4 <= width; u += 4) {
+        const float32x4_t x = vld1q_f32(nx + u), y = vld1q_f32(ny + u), z = vld1q_f32(nz + u);
+        const float32x4_t l1 = vaddq_f32(vaddq_f32(vabsq_f32(x), vabsq_f32(y)), vabsq_f32(z));
+        const uint32x4_t ok = vcgtq_f32(l1, zero);
+
+        float32x4_t ox = vdivq_f32(x, l1), oy = vdivq_f32(y, l1);
+        const float32x4_t sx = vbslq_f32(signBit, ox, one);  // copysign(1, ox)
+        const float32x4_t sy = vbslq_f32(signBit, oy, one);
+        const float32x4_t fx = vmulq_f32(vsubq_f32(one, vabsq_f32(oy)), sx);
+        const float32x4_t fy = vmulq_f32(vsubq_f32(one, vabsq_f32(ox)), sy);
+        const uint32x4_t lower = vcltq_f32(z, zero);
+        ox = vbslq_f32(lower, fx, ox);
+        oy = vbslq_f32(lower, fy, oy);
+
+        int16x4_t ex = vmovn_s32(vcvtnq_s32_f32(vmulq_f32(ox, scale)));
+        int16x4_t ey = vmovn_s32(vcvtnq_s32_f32(vmulq_f32(oy, scale)));
+        const uint16x4_t ok16 = vmovn_u32(ok);
+        ex = vbsl_s16(ok16, ex, invalid);
+        ey = vbsl_s16(ok16, ey, invalid);
+        int16x4x2_t pair;
+        pair.val[0] = ex;
+        pair.val[1] = ey;
+        vst2_s16(out + u * 2, pair);
+    }
+    EncodeOctScalar(nx + u, ny + u, nz + u, width - u, out + u * 2);
+}
+
+#elif defined(__SSE2__)
+
+static inline __m128 Abs4(__m128 v) {
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+static void NormalRowSimd(const PointRows& p, int32_t step, int32_t begin, int32_t end, float jump,
+                          float* nx, float* ny, float* nz) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 vjump = _mm_set1_ps(jump);
+    int32_t u = begin;
+    for (; u + 4 <= end; u += 4) {
+        const __m128 zc = _mm_loadu_ps(p.cz + u);
+        const __m128 zl = _mm_loadu_ps(p.cz + u - step), zr = _mm_loadu_ps(p.cz + u + step);
+        const __m128 zu = _mm_loadu_ps(p.az + u), zd = _mm_loadu_ps(p.bz + u);
+
+        const __m128 dux = _mm_sub_ps(_mm_loadu_ps(p.cx + u + step), _mm_loadu_ps(p.cx + u - step));
+        const __m128 duy = _mm_sub_ps(_mm_loadu_ps(p.cy + u + step), _mm_loadu_ps(p.cy + u - step));
+        const __m128 duz = _mm_sub_ps(zr, zl);
+        const __m128 dvx = _mm_sub_ps(_mm_loadu_ps(p.bx + u), _mm_loadu_ps(p.ax + u));
+        const __m128 dvy = _mm_sub_ps(_mm_loadu_ps(p.by + u), _mm_loadu_ps(p.ay + u));
+        const __m128 dvz = _mm_sub_ps(zd, zu);
+
+        const __m128 x = _mm_sub_ps(_mm_mul_ps(dvy, duz), _mm_mul_ps(dvz, duy));
+        const __m128 y = _mm_sub_ps(_mm_mul_ps(dvz, dux), _mm_mul_ps(dvx, duz));
+        const __m128 z = _mm_sub_ps(_mm_mul_ps(dvx, duy), _mm_mul_ps(dvy, dux));
+        const __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+
+        const __m128 limit = _mm_mul_ps(vjump, zc);
+        __m128 ok = _mm_and_ps(_mm_cmpgt_ps(zc, zero), _mm_and_ps(_mm_cmpgt_ps(zl, zero), _mm_cmpgt_ps(zr, zero)));
+        ok = _mm_and_ps(ok, _mm_and_ps(_mm_cmpgt_ps(zu, zero), _mm_cmpgt_ps(zd, zero)));
+        ok = _mm_and_ps(ok, _mm_and_ps(_mm_cmple_ps(Abs4(duz), limit), _mm_cmple_ps(Abs4(dvz), limit)));
+        ok = _mm_and_ps(ok, _mm_cmpgt_ps(len2, zero));
+
+        const __m128 inv = _mm_div_ps(one, _mm_sqrt_ps(len2));
+        _mm_storeu_ps(nx + u, _mm_and_ps(ok, _mm_mul_ps(x, inv)));
+        _mm_storeu_ps(ny + u, _mm_and_ps(ok, _mm_mul_ps(y, inv)));
+        _mm_storeu_ps(nz + u, _mm_and_ps(ok, _mm_mul_ps(z, inv)));
+    }
+    NormalRowScalar(p, step, u, end, jump, nx, ny, nz);
+}
+
+static void EncodeOctSimd(const float* nx, const float* ny, const float* nz, int32_t width, int16_t* out) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128i invalid = _mm_set1_epi16(OCT_INVALID);
+    int32_t u = 0;
+    for (; u + 4 <= width; u += 4) {
+        const __m128 x = _mm_loadu_ps(nx + u), y = _mm_loadu_ps(ny + u), z = _mm_loadu_ps(nz + u);
+        const __m128 l1 = _mm_add_ps(_mm_add_ps(Abs4(x), Abs4(y)), Abs4(z));
+        const __m128 ok = _mm_cmpgt_ps(l1, zero);
+
+        __m128 ox = _mm_div_ps(x, l1), oy = _mm_div_ps(y, l1);
+        const __m128 sx = _mm_or_ps(one, _mm_and_ps(signBit, ox));  // copysign(1, ox)
+        const __m128 sy = _mm_or_ps(one, _mm_and_ps(signBit, oy));
+        const __m128 fx = _mm_mul_ps(_mm_sub_ps(one, Abs4(oy)), sx);
+        const __m128 fy = _mm_mul_ps(_mm_sub_ps(one, Abs4(ox)), sy);
+        const __m128 lower = _mm_cmplt_ps(z, zero);
+        ox = _mm_or_ps(_mm_and_ps(lower, fx), _mm_andnot_ps(lower, ox));
+        oy = _mm_or_ps(_mm_and_ps(lower, fy), _mm_andnot_ps(lower, oy));
+
+        // Invalid lanes produce NaN here; they are replaced below
+        const __m128i ex = _mm_cvtps_epi32(_mm_mul_ps(ox, scale));
+        const __m128i ey = _mm_cvtps_epi32(_mm_mul_ps(oy, scale));
+        const __m128i packed = _mm_unpacklo_epi16(_mm_packs_epi32(ex, ex), _mm_packs_epi32(ey, ey));
+        const __m128i mask = _mm_castps_si128(ok);  // one 32-bit lane per pixel = both int16s
+        _mm_storeu_si128((__m128i*)(out + u * 2),
+                         _mm_or_si128(_mm_and_si128(mask, packed), _mm_andnot_si128(mask, invalid)));
+    }
+    EncodeOctScalar(nx + u, ny + u, nz + u, width - u, out + u * 2);
+}
+
+#else
+
+static void NormalRowSimd(const PointRows& p, int32_t step, int32_t begin, int32_t end, float jump,
+                          float* nx, float* ny, float* nz) {
+    NormalRowScalar(p, step, begin, end, jump, nx, ny, nz);
+}
+
+static void EncodeOctSimd(const float* nx, const float* ny, const float* nz, int32_t width, int16_t* out) {
+    EncodeOctScalar(nx, ny, nz, width, out);
+}
+
+#endif
+
+// ---------- API ----------
+
+bool MLDepthNormalsUnity_Compute(
+    const DepthFrameInfo* depth_info,
+    const uint8_t* depth_bytes,
+    const DepthIntrinsics* intrinsics,
+    uint32_t format,
+    int32_t smooth_radius,
+    float max_depth_jump,
+    uint32_t flags,
+    uint8_t* out_normals,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written)
+{
+    if (!depth_info || !depth_bytes || !intrinsics || !out_normals || !out_bytes_written) return false;
+    *out_bytes_written = 0;
+
+    const int32_t width = depth_info->width;
+    const int32_t height = depth_info->height;
+    if (width <= 0 || height <= 0) return false;
+
+    if (depth_info->bytesPerPixel != (int32_t)sizeof(float)) {
+        static int warnCount = 0;
+        if (warnCount++ < 5) {
+            LOGW("Normals expect float32 depth, got bytesPerPixel=%d", depth_info->bytesPerPixel);
+        }
+        return false;
+    }
+    if (intrinsics->fx == 0.0f || intrinsics->fy == 0.0f) return false;
+    if (format != DepthNormalFormat_Float3 && format != DepthNormalFormat_Oct16) return false;
+
+    const int32_t pixelBytes = format == DepthNormalFormat_Float3 ? 3 * (int32_t)sizeof(float) : 2 * (int32_t)sizeof(int16_t);
+    const int64_t required = (int64_t)width * height * pixelBytes;
+    if (required > capacity_bytes) {
+        *out_bytes_written = required > INT32_MAX ? INT32_MAX : (int32_t)required;
+        return false;
+    }
+
+    static thread_local NormalScratch s;
+    const size_t pixels = (size_t)width * height;
+    if (s.pz.size() < pixels) {
+        s.px.resize(pixels);
+        s.py.resize(pixels);
+        s.pz.resize(pixels);
+    }
+    if ((int32_t)s.nz.size() < width) {
+        s.nx.resize(width);
+        s.ny.resize(width);
+        s.nz.resize(width);
+    }
+
+    const int32_t stride = depth_info->strideBytes > 0 ? depth_info->strideBytes : width * (int32_t)sizeof(float);
+    UnprojectPlanes(depth_bytes, stride, width, height, *intrinsics, s);
+
+    const float* X = s.px.data();
+    const float* Y = s.py.data();
+    const float* Z = s.pz.data();
+    int32_t step = 1;
+    if (smooth_radius > 0) {
+        if (s.sz.size() < pixels) {
+            s.sx.resize(pixels);
+            s.sy.resize(pixels);
+            s.sz.resize(pixels);
+        }
+        SmoothPlanes(width, height, smooth_radius, s);
+        X = s.sx.data();
+        Y = s.sy.data();
+        Z = s.sz.data();
+        step = smooth_radius;
+    }
+
+    const float jump = max_depth_jump > 0.0f ? max_depth_jump : INFINITY;
+    const bool scalar = (flags & DepthNormalFlag_ForceScalar) != 0;
+    const int32_t begin = std::min(step, width);
+    const int32_t end = std::max(width - step, begin);
+
+    for (int32_t v = 0; v < height; v++) {
+        float* nx = s.nx.data();
+        float* ny = s.ny.data();
+        float* nz = s.nz.data();
+        std::fill(nx, nx + width, 0.0f);
+        std::fill(ny, ny + width, 0.0f);
+        std::fill(nz, nz + width, 0.0f);
+
+        if (v >= step && v + step < height) {
+            PointRows rows;
+            const size_t c = (size_t)v * width, a = (size_t)(v - step) * width, b = (size_t)(v + step) * width;
+            rows.cx = X + c; rows.cy = Y + c; rows.cz = Z + c;
+            rows.ax = X + a; rows.ay = Y + a; rows.az = Z + a;
+            rows.bx = X + b; rows.by = Y + b; rows.bz = Z + b;
+            if (scalar) {
+                NormalRowScalar(rows, step, begin, end, jump, nx, ny, nz);
+            } else {
+                NormalRowSimd(rows, step, begin, end, jump, nx, ny, nz);
+            }
+        }
+
+        if (format == DepthNormalFormat_Float3) {
+            float* out = (float*)out_normals + (size_t)v * width * 3;
+            for (int32_t u = 0; u < width; u++) {
+                out[u * 3 + 0] = nx[u];
+                out[u * 3 + 1] = ny[u];
+                out[u * 3 + 2] = nz[u];
+            }
+        } else {
+            int16_t* out = (int16_t*)out_normals + (size_t)v * width * 2;
+            if (scalar) {
+                EncodeOctScalar(nx, ny, nz, width, out);
+            } else {
+                EncodeOctSimd(nx, ny, nz, width, out);
+            }
+        }
+    }
+
+    *out_bytes_written = (int32_t)required;
+    return true;
+}
+
+bool MLDepthNormalsUnity_TryGetLatest(
+    uint32_t format,
+    int32_t smooth_radius,
+    float max_depth_jump,
+    uint32_t flags,
+    DepthFrameInfo* out_info,
+    uint8_t* out_normals,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written)
+{
+    if (!out_info || !out_normals || !out_bytes_written) return false;
+    *out_bytes_written = 0;
+
+    // Lease the depth frame instead of copying it out
+    DepthFrameInfo info;
+    const uint8_t* bytes = nullptr;
+    int32_t size = 0;
+    void* lease = nullptr;
+    if (!MLDepthUnity_AcquireLatest(DepthStream_Depth, &info, &bytes, &size, &lease)) return false;
+
+    // Intrinsics reported with this frame, not whatever arrived since
+    DepthIntrinsics intrinsics;
+    if (!MLDepthUnity_GetFrameCalibration(info.captureTimeNs, &intrinsics, nullptr)) {
+        MLDepthUnity_ReleaseFrame(lease);
+        return false;
+    }
+
+    bool ok = MLDepthNormalsUnity_Compute(&info, bytes, &intrinsics, format, smooth_radius, max_depth_jump,
+                                          flags, out_normals, capacity_bytes, out_bytes_written);
+    if (ok) *out_info = info;
+
+    MLDepthUnity_ReleaseFrame(lease);
+    return ok;
+}
+
+// ---------- Capture thread ----------
+
+void DepthNormals_ProcessFrame(const DepthFrameInfo& depthInfo, const uint8_t* depth,
+                               const DepthIntrinsics& intrinsics) {
+    if (!g_enabled.load(std::memory_order_relaxed) || !depth) return;
+
+    const uint32_t format = g_format.load(std::memory_order_relaxed);
+    const int32_t pixelBytes = format == DepthNormalFormat_Float3 ? 3 * (int32_t)sizeof(float) : 2 * (int32_t)sizeof(int16_t);
+    const int64_t required = (int64_t)depthInfo.width * depthInfo.height * pixelBytes;
+    if (required <= 0 || required > INT32_MAX) return;
+
+    NormalSlots::Slot* slot = g_normalSlots.BeginWrite();
+    if (!slot) return;  // every slot pinned: dropped and counted
+
+    slot->bytes.resize((size_t)required);
+    int32_t written = 0;
+    if (!MLDepthNormalsUnity_Compute(&depthInfo, depth, &intrinsics, format,
+                                     g_smoothRadius.load(std::memory_order_relaxed),
+                                     g_maxDepthJump.load(std::memory_order_relaxed), DepthNormalFlag_None,
+                                     slot->bytes.data(), (int32_t)required, &written)) {
+        return;  // slot stays unpublished and is reused next frame
+    }
+
+    slot->info.width = depthInfo.width;
+    slot->info.height = depthInfo.height;
+    slot->info.strideBytes = depthInfo.width * pixelBytes;
+    slot->info.captureTimeNs = depthInfo.captureTimeNs;
+    slot->info.bytesPerPixel = pixelBytes;
+    slot->info.format = (int32_t)format;
+    g_normalSlots.Publish(slot);
+}
+
+void DepthNormals_Reset() {
+    g_normalSlots.Reset();
+}
+
+bool MLDepthNormalsUnity_Configure(bool enabled, uint32_t format, int32_t smooth_radius, float max_depth_jump) {
+    if (format != DepthNormalFormat_Float3 && format != DepthNormalFormat_Oct16) {
+        LOGW("Configure: unknown format %u", format);
+        return false;
+    }
+    if (smooth_radius < 0 || !(max_depth_jump >= 0.0f)) {
+        LOGW("Configure: smooth_radius=%d max_depth_jump=%f out of range", smooth_radius, max_depth_jump);
+        return false;
+    }
+
+    g_format.store(format, std::memory_order_relaxed);
+    g_smoothRadius.store(smooth_radius, std::memory_order_relaxed);
+    g_maxDepthJump.store(max_depth_jump, std::memory_order_relaxed);
+    g_enabled.store(enabled, std::memory_order_relaxed);
+
+    LOGI("Depth normals enabled=%d format=%u radius=%d jump=%.3f", enabled ? 1 : 0, format, smooth_radius,
+         max_depth_jump);
+    return true;
+}
+
+bool MLDepthNormalsUnity_TryGetProcessed(
+    DepthFrameInfo* out_info,
+    uint8_t* out_normals,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written)
+{
+    if (!out_info || !out_normals || !out_bytes_written) return false;
+    *out_bytes_written = 0;
+
+    const NormalSlots::Slot* slot = g_normalSlots.Acquire();
+    if (!slot) return false;
+
+    bool ok = false;
+    int32_t n = (int32_t)slot->bytes.size();
+    if (n > capacity_bytes) {
+        *out_bytes_written = n;
+    } else if (n > 0) {
+        *out_info = slot->info;
+        std::memcpy(out_normals, slot->bytes.data(), n);
+        *out_bytes_written = n;
+        ok = true;
+    }
+
+    NormalSlots::Release(slot);
+    return ok;
+}
+
+bool MLDepthNormalsUnity_AcquireProcessed(
+    DepthFrameInfo* out_info,
+    const uint8_t** out_normals,
+    int32_t* out_size_bytes,
+    void** out_lease)
+{
+    if (!out_info || !out_normals || !out_size_bytes || !out_lease) return false;
+    *out_normals = nullptr;
+    *out_size_bytes = 0;
+    *out_lease = nullptr;
+
+    const NormalSlots::Slot* slot = g_normalSlots.Acquire();
+    if (!slot) return false;
+
+    *out_info = slot->info;
+    *out_normals = slot->bytes.data();
+    *out_size_bytes = (int32_t)slot->bytes.size();
+    *out_lease = (void*)slot;
+    return true;
+}
+
+void MLDepthNormalsUnity_ReleaseFrame(void* lease) {
+    NormalSlots::Release((const NormalSlots::Slot*)lease);
+}
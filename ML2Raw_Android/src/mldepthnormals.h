@@ -0,0 +1,93 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mldepth.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Output encoding of the normal map
+typedef enum {
+    DepthNormalFormat_Float3 = 0,  // 3 floats per pixel (12 bytes), (0,0,0) = invalid
+    DepthNormalFormat_Oct16 = 1    // octahedral, 2 x int16 snorm per pixel (4 bytes),
+                                   // (-32768, -32768) = invalid
+} DepthNormalFormat;
+
+// Options for the normal stage (bitmask)
+typedef enum {
+    DepthNormalFlag_None = 0,
+    DepthNormalFlag_ForceScalar = 1 << 0  // Use the scalar reference kernels
+} DepthNormalFlag;
+
+// Per-pixel surface normals of a float32 depth image, in the depth camera
+// frame (+x right, +y down, +z forward), unit length, facing the camera.
+// Normals come from central differences of the unprojected point cloud:
+// n = normalize((P(v+s) - P(v-s)) x (P(u+s) - P(u-s))).
+// smooth_radius > 0 first box-filters the point cloud over a
+// (2r+1)x(2r+1) window with integral images (valid pixels only) and uses
+// step s = r; 0 uses the raw points with s = 1.
+// max_depth_jump: pixels whose neighbors differ in depth by more than this
+// fraction of their own depth are marked invalid (0 = no check).
+// Pixels within s of the border, or next to invalid depth, are invalid.
+// out_bytes_written: bytes written, or required bytes if the buffer is too small.
+bool MLDepthNormalsUnity_Compute(
+    const DepthFrameInfo* depth_info,
+    const uint8_t* depth_bytes,
+    const DepthIntrinsics* intrinsics,
+    uint32_t format,
+    int32_t smooth_radius,
+    float max_depth_jump,
+    uint32_t flags,
+    uint8_t* out_normals,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written);
+
+// Same, on the latest processed depth frame straight from the capture pool,
+// with the intrinsics reported for that frame. Computed on the calling thread.
+bool MLDepthNormalsUnity_TryGetLatest(
+    uint32_t format,
+    int32_t smooth_radius,
+    float max_depth_jump,
+    uint32_t flags,
+    DepthFrameInfo* out_info,
+    uint8_t* out_normals,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written);
+
+// Compute normals on the capture thread for every new processed depth frame
+// (parameters as for MLDepthNormalsUnity_Compute, scalar kernels never used).
+// enabled = false stops it. Can be changed at any time.
+bool MLDepthNormalsUnity_Configure(bool enabled, uint32_t format, int32_t smooth_radius, float max_depth_jump);
+
+// Copy out the normals of the latest processed depth frame computed on the
+// capture thread. out_info: depth size and capture time, bytesPerPixel of the
+// encoding (12 or 4) and format = DepthNormalFormat.
+// out_bytes_written: bytes copied, or required size if the buffer is too small.
+bool MLDepthNormalsUnity_TryGetProcessed(
+    DepthFrameInfo* out_info,
+    uint8_t* out_normals,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written);
+
+// Zero-copy variant (see MLDepthUnity_AcquireLatest). Release with MLDepthNormalsUnity_ReleaseFrame.
+bool MLDepthNormalsUnity_AcquireProcessed(
+    DepthFrameInfo* out_info,
+    const uint8_t** out_normals,
+    int32_t* out_size_bytes,
+    void** out_lease);
+
+void MLDepthNormalsUnity_ReleaseFrame(void* lease);
+
+#ifdef __cplusplus
+}
+
+// Internal: called by the depth capture thread with the frame it just
+// published and the intrinsics reported with it.
+void DepthNormals_ProcessFrame(const DepthFrameInfo& depthInfo, const uint8_t* depth,
+                               const DepthIntrinsics& intrinsics);
+
+// Internal: forget published normals (depth shutdown).
+void DepthNormals_Reset();
+#endif
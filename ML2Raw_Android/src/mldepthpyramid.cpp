@@ -0,0 +1,186 @@
+#include "mldepthpyramid.h"
+#include "mldepthkernels.h"
+#include "mlframeslot.h"
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include <android/log.h>
+
+#define LOG_TAG "MLDepthPyramidUnity"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+
+static constexpr int32_t MAX_LEVELS = 4;
+
+static std::atomic<int32_t> g_levels{0};
+static std::atomic<uint32_t> g_mode{DepthPyramid_Min};
+
+// Published levels (index = level - 1)
+typedef FrameSlots<DepthFrameInfo, 4> LevelSlots;
+static LevelSlots g_levelSlots[MAX_LEVELS];
+
+// Per-level mean weights for the confidence-weighted mode (capture thread only)
+static std::vector<float> g_levelWeights[MAX_LEVELS];
+
+void DepthPyramid_ProcessFrame(const DepthFrameInfo& depthInfo, const uint8_t* depth,
+                               const float* conf, int32_t confStrideBytes) {
+    const int32_t levels = g_levels.load(std::memory_order_relaxed);
+    if (levels <= 0 || !depth || depthInfo.bytesPerPixel != (int32_t)sizeof(float)) return;
+
+    const uint32_t mode = g_mode.load(std::memory_order_relaxed);
+
+    // Source of the current level: the full frame, then each previous level
+    const float* src = (const float*)depth;
+    int32_t srcWidth = depthInfo.width;
+    int32_t srcHeight = depthInfo.height;
+    int32_t srcStride = (depthInfo.strideBytes > 0 ? depthInfo.strideBytes : srcWidth * 4) / 4;
+    const float* srcWeights = mode == DepthPyramid_ConfidenceWeighted ? conf : nullptr;
+    int32_t srcWeightStride = confStrideBytes / 4;
+
+    for (int32_t level = 0; level < levels; level++) {
+        const int32_t outWidth = srcWidth / 2;
+        const int32_t outHeight = srcHeight / 2;
+        if (outWidth <= 0 || outHeight <= 0) break;
+
+        // Deeper levels are built from this one, so stop if it can't be written
+        LevelSlots::Slot* slot = g_levelSlots[level].BeginWrite();
+        if (!slot) break;
+
+        slot->info.width = outWidth;
+        slot->info.height = outHeight;
+        slot->info.strideBytes = outWidth * 4;
+        slot->info.captureTimeNs = depthInfo.captureTimeNs;
+        slot->info.bytesPerPixel = 4;
+        slot->info.format = depthInfo.format;
+        slot->bytes.resize((size_t)outWidth * outHeight * 4);
+        float* dst = (float*)slot->bytes.data();
+
+        float* dstWeights = nullptr;
+        if (mode == DepthPyramid_ConfidenceWeighted) {
+            g_levelWeights[level].resize((size_t)outWidth * outHeight);
+            dstWeights = g_levelWeights[level].data();
+        }
+
+        for (int32_t y = 0; y < outHeight; y++) {
+            const float* row0 = src + (size_t)(2 * y) * srcStride;
+            const float* row1 = row0 + srcStride;
+            float* out = dst + (size_t)y * outWidth;
+
+            switch (mode) {
+                case DepthPyramid_Median:
+                    DepthReduceMedianRow(row0, row1, outWidth, out);
+                    break;
+                case DepthPyramid_ConfidenceWeighted: {
+                    const float* w0 = srcWeights ? srcWeights + (size_t)(2 * y) * srcWeightStride : nullptr;
+                    const float* w1 = srcWeights ? w0 + srcWeightStride : nullptr;
+                    DepthReduceWeightedRow(row0, row1, w0, w1, outWidth, out, dstWeights + (size_t)y * outWidth);
+                    break;
+                }
+                default:
+                    DepthReduceMinRow(row0, row1, outWidth, out);
+                    break;
+            }
+        }
+
+        g_levelSlots[level].Publish(slot);
+
+        // Only this thread writes slots, so reading the published one is safe
+        src = dst;
+        srcWidth = outWidth;
+        srcHeight = outHeight;
+        srcStride = outWidth;
+        srcWeights = dstWeights;
+        srcWeightStride = outWidth;
+    }
+}
+
+void DepthPyramid_Reset() {
+    for (LevelSlots& slots : g_levelSlots) {
+        slots.Reset();
+    }
+}
+
+bool MLDepthPyramidUnity_Configure(int32_t levels, uint32_t mode) {
+    if (levels < 0 || levels > MAX_LEVELS) {
+        LOGW("Configure: levels=%d out of range [0, %d]", levels, MAX_LEVELS);
+        return false;
+    }
+    if (mode > DepthPyramid_ConfidenceWeighted) {
+        LOGW("Configure: unknown mode %u", mode);
+        return false;
+    }
+
+    g_mode.store(mode, std::memory_order_relaxed);
+    g_levels.store(levels, std::memory_order_relaxed);
+
+    LOGI("Depth pyramid levels=%d mode=%u", levels, mode);
+    return true;
+}
+
+static LevelSlots* SlotsForLevel(int32_t level) {
+    if (level < 1 || level > MAX_LEVELS) return nullptr;
+    return &g_levelSlots[level - 1];
+}
+
+bool MLDepthPyramidUnity_TryGetLevel(
+    int32_t level,
+    DepthFrameInfo* out_info,
+    uint8_t* out_bytes,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written)
+{
+    if (!out_info || !out_bytes || !out_bytes_written) return false;
+    *out_bytes_written = 0;
+
+    LevelSlots* slots = SlotsForLevel(level);
+    if (!slots) return false;
+
+    const LevelSlots::Slot* slot = slots->Acquire();
+    if (!slot) return false;
+
+    bool ok = false;
+    int32_t n = (int32_t)slot->bytes.size();
+    if (n > capacity_bytes) {
+        *out_bytes_written = n;
+    } else if (n > 0) {
+        *out_info = slot->info;
+        std::memcpy(out_bytes, slot->bytes.data(), n);
+        *out_bytes_written = n;
+        ok = true;
+    }
+
+    LevelSlots::Release(slot);
+    return ok;
+}
+
+bool MLDepthPyramidUnity_AcquireLevel(
+    int32_t level,
+    DepthFrameInfo* out_info,
+    const uint8_t** out_bytes,
+    int32_t* out_size_bytes,
+    void** out_lease)
+{
+    if (!out_info || !out_bytes || !out_size_bytes || !out_lease) return false;
+    *out_bytes = nullptr;
+    *out_size_bytes = 0;
+    *out_lease = nullptr;
+
+    LevelSlots* slots = SlotsForLevel(level);
+    if (!slots) return false;
+
+    const LevelSlots::Slot* slot = slots->Acquire();
+    if (!slot) return false;
+
+    *out_info = slot->info;
+    *out_bytes = slot->bytes.data();
+    *out_size_bytes = (int32_t)slot->bytes.size();
+    *out_lease = (void*)slot;
+    return true;
+}
+
+void MLDepthPyramidUnity_ReleaseFrame(void* lease) {
+    LevelSlots::Release((const LevelSlots::Slot*)lease);
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mldepth.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Reduction used to build each 2x2 -> 1 pyramid level
+typedef enum {
+    DepthPyramid_Min = 0,                 // nearest valid depth (conservative for obstacles)
+    DepthPyramid_Median = 1,              // median of valid depths (robust to flying pixels)
+    DepthPyramid_ConfidenceWeighted = 2   // mean weighted by confidence clamped to [0,1]
+} DepthPyramidMode;
+
+// Build a depth pyramid on the capture thread for every new processed depth frame.
+// levels: 0 disables, 1..4 -> levels at 1/2 .. 1/16 resolution
+// ConfidenceWeighted needs MLDepthCameraFlags_Confidence (otherwise a plain mean of valid depths).
+// Can be changed at any time.
+bool MLDepthPyramidUnity_Configure(int32_t levels, uint32_t mode);
+
+// Copy out a pyramid level (1 = half resolution). Levels are tightly packed float32.
+// out_bytes_written: bytes copied, or required size if the buffer is too small.
+bool MLDepthPyramidUnity_TryGetLevel(
+    int32_t level,
+    DepthFrameInfo* out_info,
+    uint8_t* out_bytes,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written);
+
+// Zero-copy variant (see MLDepthUnity_AcquireLatest). Release with MLDepthPyramidUnity_ReleaseFrame.
+bool MLDepthPyramidUnity_AcquireLevel(
+    int32_t level,
+    DepthFrameInfo* out_info,
+    const uint8_t** out_bytes,
+    int32_t* out_size_bytes,
+    void** out_lease);
+
+void MLDepthPyramidUnity_ReleaseFrame(void* lease);
+
+#ifdef __cplusplus
+}
+
+// Internal: called by the depth capture thread with the frame it just
+// published. conf may be null (same size as depth, float32).
+void DepthPyramid_ProcessFrame(const DepthFrameInfo& depthInfo, const uint8_t* depth,
+                               const float* conf, int32_t confStrideBytes);
+
+// Internal: forget published levels (depth shutdown).
+void DepthPyramid_Reset();
+#endif
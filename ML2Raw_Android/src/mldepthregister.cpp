@@ -0,0 +1,409 @@
+#include "mldepthregister.h"
+#include "mlthreadpool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <android/log.h>
+
+#define LOG_TAG "MLDepthRegisterUnity"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+
+// Depth rows per projection task
+static constexpr int32_t REG_TILE_ROWS = 16;
+// Marks a depth pixel that doesn't land in the output
+static constexpr int32_t REG_INVALID = -(1 << 20);
+
+// ===== Global state =====
+// g_lock serializes calls: the scratch buffers below are shared.
+static std::mutex g_lock;
+static WorkerPool g_pool;
+
+// Per depth pixel: output column/row (REG_INVALID if off-image) and z
+static std::vector<int32_t> g_projU;
+static std::vector<int32_t> g_projV;
+static std::vector<float> g_projZ;
+// Per depth column: (u - cx) / fx
+static std::vector<float> g_colRay;
+// Output row range reached by each projection tile
+static std::vector<int32_t> g_tileMinV;
+static std::vector<int32_t> g_tileMaxV;
+
+// Depth image frame -> RGB image frame, plus the output camera
+struct Projection {
+    float M[9];  // row-major
+    float t[3];
+    float fx, fy, cx, cy;
+    int32_t width, height;
+};
+
+// ---------- Pose math ----------
+
+static void QuatToMatrix(float qx, float qy, float qz, float qw, float* R) {
+    const float n = std::sqrt(qx * qx + qy * qy + qz * qz + qw * qw);
+    if (n > 0.0f) { qx /= n; qy /= n; qz /= n; qw /= n; } else { qw = 1.0f; }
+    R[0] = 1 - 2 * (qy * qy + qz * qz); R[1] = 2 * (qx * qy - qz * qw);     R[2] = 2 * (qx * qz + qy * qw);
+    R[3] = 2 * (qx * qy + qz * qw);     R[4] = 1 - 2 * (qx * qx + qz * qz); R[5] = 2 * (qy * qz - qx * qw);
+    R[6] = 2 * (qx * qz - qy * qw);     R[7] = 2 * (qy * qz + qx * qw);     R[8] = 1 - 2 * (qx * qx + qy * qy);
+}
+
+// Poses look down -z with +y up; image frames look down +z with +y down, so
+// both ends get F = diag(1, -1, -1):  M = F * Rr^T * Rd * F,  t = F * Rr^T * (td - tr)
+static void BuildTransform(const DepthRegisterPose& depth, const RGBFrameWithPose& rgb, Projection& p) {
+    float Rd[9], Rr[9];
+    QuatToMatrix(depth.rotation_x, depth.rotation_y, depth.rotation_z, depth.rotation_w, Rd);
+    QuatToMatrix(rgb.pose_rotation_x, rgb.pose_rotation_y, rgb.pose_rotation_z, rgb.pose_rotation_w, Rr);
+
+    const float sign[3] = { 1.0f, -1.0f, -1.0f };
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            float s = 0.0f;
+            for (int k = 0; k < 3; k++) s += Rr[k * 3 + i] * Rd[k * 3 + j];
+            p.M[i * 3 + j] = sign[i] * s * sign[j];
+        }
+    }
+
+    const float d[3] = {
+        depth.position_x - rgb.pose_position_x,
+        depth.position_y - rgb.pose_position_y,
+        depth.position_z - rgb.pose_position_z
+    };
+    for (int i = 0; i < 3; i++) {
+        p.t[i] = sign[i] * (Rr[0 * 3 + i] * d[0] + Rr[1 * 3 + i] * d[1] + Rr[2 * 3 + i] * d[2]);
+    }
+}
+
+// ---------- Projection kernels ----------
+// Point = z * (ray[u], rowRay, 1) -> q = M * point + t -> pixel of the output camera.
+// Writes the rounded pixel (or REG_INVALID) and q.z for one depth row.
+
+static void ProjectRowScalar(const float* depth, const float* colRay, float rowRay, const Projection& p,
+                             int32_t width, int32_t* outU, int32_t* outV, float* outZ) {
+    const float b0 = p.M[1] * rowRay + p.M[2];
+    const float b1 = p.M[4] * rowRay + p.M[5];
+    const float b2 = p.M[7] * rowRay + p.M[8];
+    const float w = (float)p.width, h = (float)p.height;
+
+    for (int32_t u = 0; u < width; u++) {
+        const float d = depth[u];
+        const float qx = d * (p.M[0] * colRay[u] + b0) + p.t[0];
+        const float qy = d * (p.M[3] * colRay[u] + b1) + p.t[1];
+        const float qz = d * (p.M[6] * colRay[u] + b2) + p.t[2];
+        const float x = p.fx * (qx / qz) + p.cx + 0.5f;
+        const float y = p.fy * (qy / qz) + p.cy + 0.5f;
+
+        // Written so NaN depth fails every test
+        if (d > 0.0f && qz > 0.0f && x >= 0.0f && x < w && y >= 0.0f && y < h) {
+            outU[u] = (int32_t)x;
+            outV[u] = (int32_t)y;
+        } else {
+            outU[u] = REG_INVALID;
+            outV[u] = REG_INVALID;
+        }
+        outZ[u] = qz;
+    }
+}
+
+#if defined(__aarch64__)
+
+static void ProjectRowSimd(const float* depth, const float* colRay, float rowRay, const Projection& p,
+                           int32_t width, int32_t* outU, int32_t* outV, float* outZ) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const float32x4_t m0 = vdupq_n_f32(p.M[0]), m3 = vdupq_n_f32(p.M[3]), m6 = vdupq_n_f32(p.M[6]);
+    const float32x4_t b0 = vdupq_n_f32(p.M[1] * rowRay + p.M[2]);
+    const float32x4_t b1 = vdupq_n_f32(p.M[4] * rowRay + p.M[5]);
+    const float32x4_t b2 = vdupq_n_f32(p.M[7] * rowRay + p.M[8]);
+    const float32x4_t t0 = vdupq_n_f32(p.t[0]), t1 = vdupq_n_f32(p.t[1]), t2 = vdupq_n_f32(p.t[2]);
+    const float32x4_t fx = vdupq_n_f32(p.fx), fy = vdupq_n_f32(p.fy);
+    const float32x4_t cx = vdupq_n_f32(p.cx), cy = vdupq_n_f32(p.cy);
+    const float32x4_t w = vdupq_n_f32((float)p.width), h = vdupq_n_f32((float)p.height);
+    const int32x4_t invalid = vdupq_n_s32(REG_INVALID);
+
+    int32_t u = 0;
+    for (; u + 4 <= width; u += 4) {
+        const float32x4_t d = vld1q_f32(depth + u);
+        const float32x4_t ray = vld1q_f32(colRay + u);
+        const float32x4_t qx = vaddq_f32(vmulq_f32(d, vaddq_f32(vmulq_f32(m0, ray), b0)), t0);
+        const float32x4_t qy = vaddq_f32(vmulq_f32(d, vaddq_f32(vmulq_f32(m3, ray), b1)), t1);
+        const float32x4_t qz = vaddq_f32(vmulq_f32(d, vaddq_f32(vmulq_f32(m6, ray), b2)), t2);
+        const float32x4_t x = vaddq_f32(vaddq_f32(vmulq_f32(fx, vdivq_f32(qx, qz)), cx), half);
+        const float32x4_t y = vaddq_f32(vaddq_f32(vmulq_f32(fy, vdivq_f32(qy, qz)), cy), half);
+
+        uint32x4_t ok = vandq_u32(vcgtq_f32(d, zero), vcgtq_f32(qz, zero));
+        ok = vandq_u32(ok, vandq_u32(vcgeq_f32(x, zero), vcltq_f32(x, w)));
+        ok = vandq_u32(ok, vandq_u32(vcgeq_f32(y, zero), vcltq_f32(y, h)));
+
+        vst1q_s32(outU + u, vbslq_s32(ok, vcvtq_s32_f32(x), invalid));
+        vst1q_s32(outV + u, vbslq_s32(ok, vcvtq_s32_f32(y), invalid));
+        vst1q_f32(outZ + u, qz);
+    }
+    if (u < width) {
+        ProjectRowScalar(depth + u, colRay + u, rowRay, p, width - u, outU + u, outV + u, outZ + u);
+    }
+}
+
+#elif defined(__SSE2__)
+
+static void ProjectRowSimd(const float* depth, const float* colRay, float rowRay, const Projection& p,
+                           int32_t width, int32_t* outU, int32_t* outV, float* outZ) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 m0 = _mm_set1_ps(p.M[0]), m3 = _mm_set1_ps(p.M[3]), m6 = _mm_set1_ps(p.M[6]);
+    const __m128 b0 = _mm_set1_ps(p.M[1] * rowRay + p.M[2]);
+    const __m128 b1 = _mm_set1_ps(p.M[4] * rowRay + p.M[5]);
+    const __m128 b2 = _mm_set1_ps(p.M[7] * rowRay + p.M[8]);
+    const __m128 t0 = _mm_set1_ps(p.t[0]), t1 = _mm_set1_ps(p.t[1]), t2 = _mm_set1_ps(p.t[2]);
+    const __m128 fx = _mm_set1_ps(p.fx), fy = _mm_set1_ps(p.fy);
+    const __m128 cx = _mm_set1_ps(p.cx), cy = _mm_set1_ps(p.cy);
+    const __m128 w = _mm_set1_ps((float)p.width), h = _mm_set1_ps((float)p.height);
+    const __m128i invalid = _mm_set1_epi32(REG_INVALID);
+
+    int32_t u = 0;
+    for (; u + 4 <= width; u += 4) {
+        const __m128 d = _mm_loadu_ps(depth + u);
+        const __m128 ray = _mm_loadu_ps(colRay + u);
+        const __m128 qx = _mm_add_ps(_mm_mul_ps(d, _mm_add_ps(_mm_mul_ps(m0, ray), b0)), t0);
+        const __m128 qy = _mm_add_ps(_mm_mul_ps(d, _mm_add_ps(_mm_mul_ps(m3, ray), b1)), t1);
+        const __m128 qz = _mm_add_ps(_mm_mul_ps(d, _mm_add_ps(_mm_mul_ps(m6, ray), b2)), t2);
+        const __m128 x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(fx, _mm_div_ps(qx, qz)), cx), half);
+        const __m128 y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(fy, _mm_div_ps(qy, qz)), cy), half);
+
+        __m128 ok = _mm_and_ps(_mm_cmpgt_ps(d, zero), _mm_cmpgt_ps(qz, zero));
+        ok = _mm_and_ps(ok, _mm_and_ps(_mm_cmpge_ps(x, zero), _mm_cmplt_ps(x, w)));
+        ok = _mm_and_ps(ok, _mm_and_ps(_mm_cmpge_ps(y, zero), _mm_cmplt_ps(y, h)));
+        const __m128i mask = _mm_castps_si128(ok);
+
+        const __m128i ui = _mm_or_si128(_mm_and_si128(mask, _mm_cvttps_epi32(x)), _mm_andnot_si128(mask, invalid));
+        const __m128i vi = _mm_or_si128(_mm_and_si128(mask, _mm_cvttps_epi32(y)), _mm_andnot_si128(mask, invalid));
+        _mm_storeu_si128((__m128i*)(outU + u), ui);
+        _mm_storeu_si128((__m128i*)(outV + u), vi);
+        _mm_storeu_ps(outZ + u, qz);
+    }
+    if (u < width) {
+        ProjectRowScalar(depth + u, colRay + u, rowRay, p, width - u, outU + u, outV + u, outZ + u);
+    }
+}
+
+#else
+
+static void ProjectRowSimd(const float* depth, const float* colRay, float rowRay, const Projection& p,
+                           int32_t width, int32_t* outU, int32_t* outV, float* outZ) {
+    ProjectRowScalar(depth, colRay, rowRay, p, width, outU, outV, outZ);
+}
+
+#endif
+
+// ---------- Z-buffer ----------
+// Splats every projected point whose square overlaps rows [rowBegin, rowEnd)
+// into out, keeping the nearest z. Tiles whose row range misses the band are
+// skipped. The band starts at +inf so the depth test is a plain min; pixels
+// nothing landed on are turned into 0 at the end.
+
+static void SplatBand(int32_t rowBegin, int32_t rowEnd, int32_t splat, int32_t tiles, int32_t tileSize,
+                      int32_t pointCount, const Projection& p, float* out) {
+    float* band = out + (size_t)rowBegin * p.width;
+    const size_t bandSize = (size_t)(rowEnd - rowBegin) * p.width;
+    std::fill(band, band + bandSize, INFINITY);
+
+    const int32_t back = (splat - 1) / 2;  // square covers [c - back, c - back + splat)
+    for (int32_t tile = 0; tile < tiles; tile++) {
+        if (g_tileMaxV[tile] + splat - back <= rowBegin || g_tileMinV[tile] - back >= rowEnd) continue;
+
+        const int32_t begin = tile * tileSize;
+        const int32_t end = std::min(begin + tileSize, pointCount);
+        for (int32_t i = begin; i < end; i++) {
+            const int32_t v0 = g_projV[i] - back;
+            if (v0 + splat <= rowBegin || v0 >= rowEnd) continue;  // also skips REG_INVALID
+
+            const float z = g_projZ[i];
+            const int32_t u0 = std::max(g_projU[i] - back, 0);
+            const int32_t u1 = std::min(g_projU[i] - back + splat, p.width);
+            const int32_t r0 = std::max(v0, rowBegin);
+            const int32_t r1 = std::min(v0 + splat, rowEnd);
+            for (int32_t r = r0; r < r1; r++) {
+                float* row = out + (size_t)r * p.width;
+                for (int32_t c = u0; c < u1; c++) row[c] = std::min(row[c], z);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < bandSize; i++) {
+        if (band[i] == INFINITY) band[i] = 0.0f;
+    }
+}
+
+// ---------- API ----------
+
+bool MLDepthRegisterUnity_ToRGB(
+    const DepthFrameInfo* depth_info,
+    const uint8_t* depth_bytes,
+    const DepthIntrinsics* depth_intrinsics,
+    const DepthRegisterPose* depth_pose,
+    const RGBFrameWithPose* rgb_frame,
+    int32_t out_width,
+    int32_t out_height,
+    uint32_t flags,
+    float* out_depth,
+    int32_t capacity_floats,
+    int32_t* out_pixel_count)
+{
+    if (!depth_info || !depth_bytes || !depth_intrinsics || !depth_pose || !rgb_frame ||
+        !out_depth || !out_pixel_count) return false;
+    *out_pixel_count = 0;
+
+    const int32_t width = depth_info->width;
+    const int32_t height = depth_info->height;
+    if (width <= 0 || height <= 0 || depth_info->bytesPerPixel != (int32_t)sizeof(float)) {
+        static int warnCount = 0;
+        if (warnCount++ < 5) {
+            LOGW("ToRGB expects float32 depth, got %dx%d bpp=%d", width, height, depth_info->bytesPerPixel);
+        }
+        return false;
+    }
+    if (depth_intrinsics->fx == 0.0f || depth_intrinsics->fy == 0.0f) return false;
+    if (!rgb_frame->pose_valid || rgb_frame->width <= 0 || rgb_frame->height <= 0 ||
+        rgb_frame->fx == 0.0f || rgb_frame->fy == 0.0f) {
+        return false;
+    }
+
+    Projection p;
+    p.width = out_width > 0 ? out_width : rgb_frame->width;
+    p.height = out_height > 0 ? out_height : rgb_frame->height;
+    const int64_t pixels = (int64_t)p.width * p.height;
+    if (pixels > capacity_floats) {
+        *out_pixel_count = pixels > INT32_MAX ? INT32_MAX : (int32_t)pixels;
+        return false;
+    }
+
+    // RGB intrinsics scaled to the output size (pixel centers stay aligned)
+    const float sx = (float)p.width / (float)rgb_frame->width;
+    const float sy = (float)p.height / (float)rgb_frame->height;
+    p.fx = rgb_frame->fx * sx;
+    p.fy = rgb_frame->fy * sy;
+    p.cx = (rgb_frame->cx + 0.5f) * sx - 0.5f;
+    p.cy = (rgb_frame->cy + 0.5f) * sy - 0.5f;
+    BuildTransform(*depth_pose, *rgb_frame, p);
+
+    int32_t splat = 1;
+    if (!(flags & DepthRegisterFlag_NoSplat)) {
+        splat = (int32_t)std::ceil(std::max(p.fx / depth_intrinsics->fx, p.fy / depth_intrinsics->fy));
+        splat = std::max(1, std::min(4, splat));
+    }
+
+    std::lock_guard<std::mutex> guard(g_lock);
+
+    const int32_t pointCount = width * height;
+    if ((int32_t)g_projZ.size() < pointCount) {
+        g_projU.resize(pointCount);
+        g_projV.resize(pointCount);
+        g_projZ.resize(pointCount);
+    }
+    if ((int32_t)g_colRay.size() < width) g_colRay.resize(width);
+    const float invFx = 1.0f / depth_intrinsics->fx;
+    for (int32_t u = 0; u < width; u++) {
+        g_colRay[u] = ((float)u - depth_intrinsics->cx) * invFx;
+    }
+
+    const int32_t tiles = (height + REG_TILE_ROWS - 1) / REG_TILE_ROWS;
+    g_tileMinV.resize(tiles);
+    g_tileMaxV.resize(tiles);
+
+    const int32_t stride = depth_info->strideBytes > 0 ? depth_info->strideBytes : width * (int32_t)sizeof(float);
+    const float invFy = 1.0f / depth_intrinsics->fy;
+    const bool scalar = (flags & DepthRegisterFlag_ForceScalar) != 0;
+    const bool single = (flags & DepthRegisterFlag_SingleThread) != 0;
+
+    // Pass 1: project depth rows, tile by tile
+    auto project = [&](int32_t tile) {
+        int32_t minV = INT32_MAX, maxV = INT32_MIN;
+        const int32_t v1 = std::min((tile + 1) * REG_TILE_ROWS, height);
+        for (int32_t v = tile * REG_TILE_ROWS; v < v1; v++) {
+            const float* row = (const float*)(depth_bytes + (size_t)v * stride);
+            const float rowRay = ((float)v - depth_intrinsics->cy) * invFy;
+            const size_t o = (size_t)v * width;
+            if (scalar) {
+                ProjectRowScalar(row, g_colRay.data(), rowRay, p, width, &g_projU[o], &g_projV[o], &g_projZ[o]);
+            } else {
+                ProjectRowSimd(row, g_colRay.data(), rowRay, p, width, &g_projU[o], &g_projV[o], &g_projZ[o]);
+            }
+            for (int32_t u = 0; u < width; u++) {
+                const int32_t r = g_projV[o + u];
+                if (r == REG_INVALID) continue;
+                minV = std::min(minV, r);
+                maxV = std::max(maxV, r);
+            }
+        }
+        g_tileMinV[tile] = minV;
+        g_tileMaxV[tile] = maxV;
+    };
+
+    // Pass 2: each task owns a band of output rows, so the z-buffer needs no atomics
+    const int32_t bands = single ? 1 : g_pool.Threads();
+    auto splatBand = [&](int32_t band) {
+        const int32_t r0 = (int32_t)((int64_t)p.height * band / bands);
+        const int32_t r1 = (int32_t)((int64_t)p.height * (band + 1) / bands);
+        SplatBand(r0, r1, splat, tiles, REG_TILE_ROWS * width, pointCount, p, out_depth);
+    };
+
+    if (single) {
+        for (int32_t t = 0; t < tiles; t++) project(t);
+        splatBand(0);
+    } else {
+        g_pool.Run(tiles, project);
+        g_pool.Run(bands, splatBand);
+    }
+
+    *out_pixel_count = (int32_t)pixels;
+    return true;
+}
+
+bool MLDepthRegisterUnity_LatestToRGB(
+    const RGBFrameWithPose* rgb_frame,
+    int32_t out_width,
+    int32_t out_height,
+    uint32_t flags,
+    DepthFrameInfo* out_depth_info,
+    float* out_depth,
+    int32_t capacity_floats,
+    int32_t* out_pixel_count)
+{
+    if (!out_depth_info || !out_pixel_count) return false;
+    *out_pixel_count = 0;
+
+    DepthFrameInfo info;
+    const uint8_t* bytes = nullptr;
+    int32_t size = 0;
+    void* lease = nullptr;
+    if (!MLDepthUnity_AcquireLatest(DepthStream_Depth, &info, &bytes, &size, &lease)) return false;
+
+    // Calibration of this very frame, not whatever arrived since
+    DepthIntrinsics intrinsics;
+    DepthCameraPose pose;
+    if (!MLDepthUnity_GetFrameCalibration(info.captureTimeNs, &intrinsics, &pose)) {
+        MLDepthUnity_ReleaseFrame(lease);
+        return false;
+    }
+    const DepthRegisterPose depthPose = {
+        pose.rotation_x, pose.rotation_y, pose.rotation_z, pose.rotation_w,
+        pose.position_x, pose.position_y, pose.position_z
+    };
+
+    bool ok = MLDepthRegisterUnity_ToRGB(&info, bytes, &intrinsics, &depthPose, rgb_frame,
+                                         out_width, out_height, flags, out_depth, capacity_floats, out_pixel_count);
+    if (ok) *out_depth_info = info;
+
+    MLDepthUnity_ReleaseFrame(lease);
+    return ok;
+}
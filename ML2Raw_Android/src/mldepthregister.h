@@ -0,0 +1,70 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mldepth.h"
+#include "mlrgbcamera.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Options for the registration stage (bitmask)
+typedef enum {
+    DepthRegisterFlag_None = 0,
+    DepthRegisterFlag_ForceScalar = 1 << 0,   // Use the scalar reference kernel
+    DepthRegisterFlag_SingleThread = 1 << 1,  // Run on the calling thread only
+    DepthRegisterFlag_NoSplat = 1 << 2        // One output pixel per depth pixel (no hole filling)
+} DepthRegisterFlag;
+
+// Camera pose in world, same convention as the RGBFrameWithPose pose
+// (camera looks down -z, +y up).
+typedef struct DepthRegisterPose {
+    float rotation_x;
+    float rotation_y;
+    float rotation_z;
+    float rotation_w;
+    float position_x;
+    float position_y;
+    float position_z;
+} DepthRegisterPose;
+
+// Reprojects a float32 depth frame (meters) into the RGB camera image:
+// every depth pixel is moved into the RGB camera frame using both poses,
+// projected with the RGB intrinsics, and z-buffered so the nearest surface
+// wins where several land on one pixel. Each point covers a small square
+// sized from the focal length ratio so upsampled output has no pinholes.
+// rgb_frame: pose (pose_valid must be 1), intrinsics and size of the RGB frame.
+// out_width/out_height: output size (0 = RGB frame size); intrinsics are
+//                       scaled to match, so a downscaled map lines up too.
+// out_depth: out_width*out_height floats, z in the RGB camera (meters), 0 = no data.
+// out_pixel_count: pixels written, or required pixels if the buffer is too small.
+bool MLDepthRegisterUnity_ToRGB(
+    const DepthFrameInfo* depth_info,
+    const uint8_t* depth_bytes,
+    const DepthIntrinsics* depth_intrinsics,
+    const DepthRegisterPose* depth_pose,
+    const RGBFrameWithPose* rgb_frame,
+    int32_t out_width,
+    int32_t out_height,
+    uint32_t flags,
+    float* out_depth,
+    int32_t capacity_floats,
+    int32_t* out_pixel_count);
+
+// Same, using the latest processed depth frame straight from the capture pool
+// with the intrinsics and camera pose recorded for that frame
+// (MLDepthUnity_GetFrameCalibration). Fails if they are no longer known.
+bool MLDepthRegisterUnity_LatestToRGB(
+    const RGBFrameWithPose* rgb_frame,
+    int32_t out_width,
+    int32_t out_height,
+    uint32_t flags,
+    DepthFrameInfo* out_depth_info,
+    float* out_depth,
+    int32_t capacity_floats,
+    int32_t* out_pixel_count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,4 +1,5 @@
 #include "mleyecamera.h"
+#include "mlframeslot.h"
 
 #include <atomic>
 #include <mutex>
@@ -28,14 +29,26 @@ struct CameraState {
     int64_t last_frame_number = -1;
     uint64_t total_frames = 0;
     bool has_new_frame = false;
-    
-    // Latest frame data (copied)
-    EyeCameraFrameInfo info;
-    std::vector<uint8_t> data;
 };
 
 static std::map<uint32_t, CameraState> g_cameraStates;
 
+// Latest frame data per camera (indexed by camera ID bit position).
+// Kept outside g_cameraStates so leased frames outlive a Shutdown().
+typedef FrameSlots<EyeCameraFrameInfo, 4> EyeCameraSlots;
+static EyeCameraSlots g_frameSlots[4];
+
+// Helper: Camera ID to slot index
+static int CameraIndex(uint32_t id) {
+    switch (id) {
+        case 1: return 0;
+        case 2: return 1;
+        case 4: return 2;
+        case 8: return 3;
+        default: return -1;
+    }
+}
+
 // Helper: MLResult to string
 static const char* ResultToString(MLResult r) {
     switch (r) {
@@ -134,22 +147,26 @@ bool MLEyeCameraUnity_TryGetLatestFrame(
 
     CameraState& cam = g_cameraStates[camera_id];
 
-    // If no new frame, return cached data
-    if (!cam.has_new_frame && cam.data.empty()) {
+    // Pin the cached frame (if any)
+    EyeCameraSlots& slots = g_frameSlots[CameraIndex(camera_id)];
+    const EyeCameraSlots::Slot* slot = slots.Acquire();
+    if (!slot) {
         return false;
     }
 
     // Return cached frame
-    if (cam.data.size() > (size_t)capacity_bytes) {
+    if (slot->bytes.size() > (size_t)capacity_bytes) {
         // Buffer too small - tell caller how much is needed
-        *bytes_written = (int32_t)cam.data.size();
+        *bytes_written = (int32_t)slot->bytes.size();
+        EyeCameraSlots::Release(slot);
         return false;
     }
 
     // Copy cached data
-    *out_info = cam.info;
-    std::memcpy(out_bytes, cam.data.data(), cam.data.size());
-    *bytes_written = (int32_t)cam.data.size();
+    *out_info = slot->info;
+    std::memcpy(out_bytes, slot->bytes.data(), slot->bytes.size());
+    *bytes_written = (int32_t)slot->bytes.size();
+    EyeCameraSlots::Release(slot);
 
     // Clear new frame flag (consumed)
     cam.has_new_frame = false;
@@ -157,6 +174,48 @@ bool MLEyeCameraUnity_TryGetLatestFrame(
     return true;
 }
 
+// Zero-copy access to the cached frame of a camera
+bool MLEyeCameraUnity_AcquireLatestFrame(
+    uint32_t camera_id,
+    EyeCameraFrameInfo* out_info,
+    const uint8_t** out_bytes,
+    int32_t* out_size_bytes,
+    void** out_lease)
+{
+    if (!out_info || !out_bytes || !out_size_bytes || !out_lease) return false;
+
+    *out_bytes = nullptr;
+    *out_size_bytes = 0;
+    *out_lease = nullptr;
+    std::memset(out_info, 0, sizeof(EyeCameraFrameInfo));
+
+    if (!g_initialized.load()) return false;
+
+    std::lock_guard<std::mutex> guard(g_lock);
+
+    if (g_cameraStates.find(camera_id) == g_cameraStates.end()) {
+        return false;
+    }
+
+    const EyeCameraSlots::Slot* slot = g_frameSlots[CameraIndex(camera_id)].Acquire();
+    if (!slot) {
+        return false;
+    }
+
+    *out_info = slot->info;
+    *out_bytes = slot->bytes.data();
+    *out_size_bytes = (int32_t)slot->bytes.size();
+    *out_lease = (void*)slot;
+
+    g_cameraStates[camera_id].has_new_frame = false;
+
+    return true;
+}
+
+void MLEyeCameraUnity_ReleaseFrame(void* lease) {
+    EyeCameraSlots::Release((const EyeCameraSlots::Slot*)lease);
+}
+
 // Poll for new frames (should be called regularly from Update thread)
 static void PollFrames() {
     if (!g_initialized.load()) return;
@@ -203,20 +262,27 @@ static void PollFrames() {
             continue; // Old frame, skip
         }
 
-        // Update frame info
-        cam.info.camera_id = cam_id;
-        cam.info.frame_number = frame.frame_number;
-        cam.info.timestamp_ns = (int64_t)frame.timestamp;
-        cam.info.width = frame.frame_buffer.width;
-        cam.info.height = frame.frame_buffer.height;
-        cam.info.stride = frame.frame_buffer.stride;
-        cam.info.bytes_per_pixel = frame.frame_buffer.bytes_per_pixel;
-        cam.info.size = frame.frame_buffer.size;
-
-        // Copy frame data
+        // Copy frame into a pool slot no lease is holding
         if (frame.frame_buffer.data && frame.frame_buffer.size > 0) {
-            cam.data.resize(frame.frame_buffer.size);
-            std::memcpy(cam.data.data(), frame.frame_buffer.data, frame.frame_buffer.size);
+            EyeCameraSlots& slots = g_frameSlots[CameraIndex(cam_id)];
+            EyeCameraSlots::Slot* slot = slots.BeginWrite();
+            if (!slot) {
+                continue; // Every slot leased - drop this frame
+            }
+
+            slot->info.camera_id = cam_id;
+            slot->info.frame_number = frame.frame_number;
+            slot->info.timestamp_ns = (int64_t)frame.timestamp;
+            slot->info.width = frame.frame_buffer.width;
+            slot->info.height = frame.frame_buffer.height;
+            slot->info.stride = frame.frame_buffer.stride;
+            slot->info.bytes_per_pixel = frame.frame_buffer.bytes_per_pixel;
+            slot->info.size = frame.frame_buffer.size;
+
+            slot->bytes.resize(frame.frame_buffer.size);
+            std::memcpy(slot->bytes.data(), frame.frame_buffer.data, frame.frame_buffer.size);
+
+            slots.Publish(slot);
         }
 
         // Update state
@@ -289,6 +355,9 @@ void MLEyeCameraUnity_Shutdown() {
     }
 
     g_cameraStates.clear();
+    for (EyeCameraSlots& slots : g_frameSlots) {
+        slots.Reset();
+    }
     g_activeCamerasMask = 0;
 
     LOGI("Eye camera shutdown complete");
@@ -45,6 +45,20 @@ bool MLEyeCameraUnity_TryGetLatestFrame(
     int32_t capacity_bytes,
     int32_t* bytes_written);
 
+// Zero-copy variant of MLEyeCameraUnity_TryGetLatestFrame: pins the latest
+// frame of camera_id and returns a read-only pointer into the plugin's pooled
+// buffer. The data stays valid until MLEyeCameraUnity_ReleaseFrame(*out_lease);
+// new frames are written into other pool slots meanwhile.
+// Every successful acquire must be released exactly once.
+bool MLEyeCameraUnity_AcquireLatestFrame(
+    uint32_t camera_id,
+    EyeCameraFrameInfo* out_info,
+    const uint8_t** out_bytes,
+    int32_t* out_size_bytes,
+    void** out_lease);
+
+void MLEyeCameraUnity_ReleaseFrame(void* lease);
+
 // Check if camera has new frame available
 bool MLEyeCameraUnity_HasNewFrame(uint32_t camera_id);
 
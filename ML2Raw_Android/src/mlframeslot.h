@@ -0,0 +1,133 @@
+#pragma once
+// Internal C++ helper shared by the capture modules (not part of the Unity API).
+//
+// FrameSlots<Info, N> publishes "latest frame" data from one capture thread to
+// any number of reader threads without a shared mutex:
+//   - the capture thread fills a slot nobody is reading and publishes its index
+//     with a single atomic store,
+//   - readers pin the published slot with a reference count, copy (or keep a
+//     pointer to) it, then release it.
+// With N = 3 this is a classic writer/ready/reader triple buffer. Readers never
+// block the producer; if every slot is pinned the producer drops the frame and
+// counts it instead of waiting.
+//
+// Every frame the producer offers gets a sequence number (dropped ones too), so
+// readers can tell how many frames they missed and block for a newer one with
+// WaitForNewer(). The producer only touches the wait mutex while someone waits.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+template <typename Info, int N = 3>
+class FrameSlots {
+    static_assert(N >= 3, "FrameSlots needs at least writer/ready/reader slots");
+
+public:
+    struct Slot {
+        Info info{};
+        std::vector<uint8_t> bytes;
+        uint64_t sequence = 0;
+        std::atomic<int32_t> refs{0};
+    };
+
+    // ---------- Producer side (single capture thread) ----------
+
+    // Returns a slot that is neither published nor pinned by a reader, or
+    // nullptr if all of them are in use (the frame is counted as dropped).
+    Slot* BeginWrite() {
+        const int32_t latest = m_latest.load();
+        for (int i = 0; i < N; i++) {
+            int32_t idx = (m_next + i) % N;
+            if (idx == latest) continue;
+            if (m_slots[idx].refs.load() != 0) continue;
+            m_next = (idx + 1) % N;
+            return &m_slots[idx];
+        }
+        ++m_sequence;
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    // Makes a slot returned by BeginWrite() the latest frame.
+    void Publish(Slot* slot) {
+        slot->sequence = ++m_sequence;
+        m_latest.store((int32_t)(slot - m_slots));
+        m_published.store(slot->sequence);
+
+        if (m_waiters.load() > 0) {
+            { std::lock_guard<std::mutex> lock(m_waitMutex); }
+            m_waitCv.notify_all();
+        }
+    }
+
+    // ---------- Reader side (any thread) ----------
+
+    // Pins the latest published slot. Returns nullptr if nothing was published.
+    const Slot* Acquire() {
+        for (;;) {
+            int32_t idx = m_latest.load();
+            if (idx < 0) return nullptr;
+
+            Slot& slot = m_slots[idx];
+            slot.refs.fetch_add(1);
+            // The producer only writes unpublished slots, so if idx is still
+            // the latest after pinning it the contents are complete and stable.
+            if (m_latest.load() == idx) return &slot;
+            slot.refs.fetch_sub(1);
+        }
+    }
+
+    // Static: a pinned slot can be released without knowing its owner, which
+    // lets the leased APIs hand out the slot pointer itself as the lease.
+    static void Release(const Slot* slot) {
+        if (slot) const_cast<Slot*>(slot)->refs.fetch_sub(1);
+    }
+
+    // Blocks until a frame with sequence > afterSequence has been published or
+    // timeoutMs elapses. Returns true if such a frame is available.
+    bool WaitForNewer(uint64_t afterSequence, uint32_t timeoutMs) {
+        if (m_published.load() > afterSequence) return true;
+        if (timeoutMs == 0) return false;
+
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_waiters.fetch_add(1);
+        bool ok = m_waitCv.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                                    [&] { return m_published.load() > afterSequence; });
+        m_waiters.fetch_sub(1);
+        return ok;
+    }
+
+    bool HasFrame() const { return m_latest.load() >= 0; }
+    uint64_t LatestSequence() const { return m_published.load(); }
+    uint64_t DroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // Forgets the published frame. Call with the producer stopped; slots still
+    // pinned by a reader keep their memory until the next Reset(). Sequence
+    // numbers keep counting so readers' "since" values stay meaningful.
+    void Reset() {
+        m_latest.store(-1);
+        for (int i = 0; i < N; i++) {
+            if (m_slots[i].refs.load() != 0) continue;
+            m_slots[i].info = Info{};
+            m_slots[i].bytes.clear();
+            m_slots[i].sequence = 0;
+        }
+        m_next = 0;
+        m_dropped.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    Slot m_slots[N];
+    std::atomic<int32_t> m_latest{-1};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_published{0};
+    std::atomic<int32_t> m_waiters{0};
+    std::mutex m_waitMutex;
+    std::condition_variable m_waitCv;
+    int32_t m_next = 0;          // producer-only
+    uint64_t m_sequence = 0;     // producer-only
+};
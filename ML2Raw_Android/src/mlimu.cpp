@@ -1,12 +1,21 @@
 #include "mlimu.h"
 
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <thread>
-#include <vector>
 #include <cstring>
 
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "mlimufilter.h"
+#include "mlsensordirect.h"
+#include "mlspscring.h"
+
 #include <android/sensor.h>
+#include <android/sharedmem.h>
 #include <android/looper.h>
 #include <android/log.h>
 
@@ -18,35 +27,510 @@
 // Ring buffer size for high-frequency IMU data
 static constexpr size_t BUFFER_SIZE = 2048;
 
+// Raw per-sensor rings (each sensor can run at up to ~1 kHz)
+static constexpr size_t RAW_BUFFER_SIZE = 4096;
+
+// Synchronizer history: samples waiting for (or kept to bracket) the other sensor
+static constexpr size_t SYNC_HISTORY = 512;
+
+// Samples of each sensor seen before IMUSync_Auto picks the reference
+static constexpr uint32_t SYNC_AUTO_SAMPLES = 64;
+
+// Gyro gaps longer than this restart the filter integration instead of
+// taking one huge step (e.g. after the sensors were suspended)
+static constexpr int64_t FILTER_MAX_GAP_NS = 100000000;
+
+// Statistics: effective-rate window and running-mean weight of the intervals
+static constexpr int64_t STATS_RATE_WINDOW_NS = 1000000000;
+static constexpr double STATS_INTERVAL_WEIGHT = 1.0 / 256.0;
+static constexpr float JITTER_EDGES[IMU_JITTER_BINS - 1] = {
+    0.5f, 0.8f, 0.9f, 0.95f, 0.99f, 1.01f, 1.05f, 1.1f, 1.2f, 1.5f, 2.0f, 4.0f
+};
+
+// Direct channel: shared-memory ring size (~2.5 s of two sensors at ~800 Hz)
+// and how often the capture thread parses it
+static constexpr size_t DIRECT_REPORTS = 4096;
+static constexpr int32_t DIRECT_POLL_US = 2000;
+
+// Events read per ASensorEventQueue_getEvents call
+static constexpr size_t EVENT_BATCH = 64;
+
 // State
 static std::atomic<bool> g_initialized{false};
 static std::atomic<bool> g_running{false};
 static std::thread g_thread;
-static std::mutex g_mutex;
+static std::mutex g_drainMutex;  // serializes consumers only; the sensor thread never takes it
 
 // Android sensor handles
 static ASensorManager* g_sensorManager = nullptr;
 static const ASensor* g_accelSensor = nullptr;
 static const ASensor* g_gyroSensor = nullptr;
 static ASensorEventQueue* g_eventQueue = nullptr;
-static ALooper* g_looper = nullptr;
+static ALooper* g_looper = nullptr;  // set while the poll loop runs
+static std::mutex g_looperMutex;
+
+// Direct channel backend
+static int32_t g_backend = IMUBackend_EventQueue;
+static int g_directFd = -1;
+static void* g_directMemory = nullptr;
+static size_t g_directSize = 0;
+static int g_directChannel = 0;
+static SensorDirectReader g_directReader;
+static std::atomic<uint64_t> g_directLost{0};  // mirror of g_directReader.Lost() for readers
 
-// Latest data
+// Unity marshals arrays of these; new per-sample data goes in new structs
+static_assert(sizeof(IMUData) == 56, "IMUData layout is part of the plugin ABI");
+
+// Latest data (g_latestData is only touched by the sensor thread)
 static IMUData g_latestData;
+static LatestValue<IMUData> g_latest;
 static std::atomic<bool> g_hasNewData{false};
 
-// Ring buffer for high-frequency data
-static std::vector<IMUData> g_buffer;
-static size_t g_bufferHead = 0;
-static size_t g_bufferTail = 0;
-static size_t g_bufferCount = 0;
+// Ring buffer for high-frequency data: sensor thread -> MLIMUUnity_GetBuffered
+static SpscRing<IMUData, BUFFER_SIZE> g_buffer;
+
+// Orientation filter output: latest value and every output
+static LatestValue<IMUOrientation> g_latestOrientation;
+static std::atomic<bool> g_hasNewOrientation{false};
+static SpscRing<IMUOrientation, BUFFER_SIZE> g_orientationBuffer;
 
-// Counters
+// Raw and synchronized streams
+static SpscRing<IMUVectorSample, RAW_BUFFER_SIZE> g_accelBuffer;
+static SpscRing<IMUVectorSample, RAW_BUFFER_SIZE> g_gyroBuffer;
+static SpscRing<IMUData, BUFFER_SIZE> g_syncBuffer;
+
+// Secondary raw streams for in-plugin consumers
+static std::atomic<bool> g_secondaryEnabled{false};
+static std::mutex g_secondaryDrainMutex;
+static SpscRing<IMUVectorSample, RAW_BUFFER_SIZE> g_secondaryAccel;
+static SpscRing<IMUVectorSample, RAW_BUFFER_SIZE> g_secondaryGyro;
+
+// Column-wise copy of the paired or synchronized stream (IMUSoASource)
+static std::atomic<int32_t> g_soaSource{IMUSoA_Off};
+static SpscColumnRing<BUFFER_SIZE, int64_t, int64_t, float, float, float, float, float, float> g_soaBuffer;
+
+// Counters, written only by the capture thread (StatAdd, like the statistics)
 static std::atomic<uint64_t> g_accelCount{0};
 static std::atomic<uint64_t> g_gyroCount{0};
+static std::atomic<uint64_t> g_wakeupCount{0};
+static std::atomic<uint64_t> g_eventCount{0};
+
+// Statistics. Only the capture thread writes them (load + store, no
+// read-modify-write); readers take relaxed snapshots. Resets are requested
+// through a flag and applied by the capture thread, so it never waits.
+struct SensorStats {
+    std::atomic<uint64_t> samples{0};
+    std::atomic<uint64_t> outOfOrder{0};
+    std::atomic<float> rateHz{0.0f};
+    std::atomic<float> meanIntervalUs{0.0f};
+    std::atomic<float> minIntervalUs{0.0f};
+    std::atomic<float> maxIntervalUs{0.0f};
+    std::atomic<uint32_t> histogram[IMU_JITTER_BINS] = {};
+    std::atomic<uint64_t> dropBaseline{0};
 
-// Sample rate
+    // Capture thread only
+    int64_t lastNs = 0;
+    int64_t windowStartNs = 0;
+    uint32_t windowCount = 0;
+    double meanNs = 0.0;
+};
+
+static SensorStats g_accelStats;
+static SensorStats g_gyroStats;
+static std::atomic<float> g_maxDeliveryLatencyUs{0.0f};
+static std::atomic<float> g_maxCallbackUs{0.0f};
+static std::atomic<uint64_t> g_pairedDropBaseline{0};
+static std::atomic<uint64_t> g_syncedDropBaseline{0};
+static std::atomic<uint64_t> g_directLostBaseline{0};
+static std::atomic<uint64_t> g_wakeupBaseline{0};
+static std::atomic<uint64_t> g_eventBaseline{0};
+static std::atomic<bool> g_statsResetRequested{false};
+
+// Sample rate and FIFO batching
 static int32_t g_sampleRateHz = 200;
+static int32_t g_maxReportLatencyUs = 0;
+static int32_t g_syncMode = IMUSync_Off;
+
+// Orientation filter (sensor thread only)
+static bool g_filterEnabled = false;
+static OrientationFilter g_filter;
+static float g_filterAccel[3] = {0.0f, 0.0f, 0.0f};
+static bool g_filterHasAccel = false;
+static int64_t g_filterLastGyroNs = 0;
+static IMUOrientation g_orientationData;
+
+// Collects samples on the stack and pushes them to a ring in runs
+template <typename T, size_t N>
+struct StagedPush {
+    SpscRing<T, N>& ring;
+    void (*mirror)(const T* items, size_t count);  // optional second destination
+    T items[EVENT_BATCH];
+    size_t count = 0;
+
+    explicit StagedPush(SpscRing<T, N>& r, void (*m)(const T*, size_t) = nullptr) : ring(r), mirror(m) {}
+    void Add(const T& item) {
+        items[count++] = item;
+        if (count == EVENT_BATCH) Flush();
+    }
+    void Flush() {
+        if (count > 0) {
+            ring.Push(items, count);
+            if (mirror) mirror(items, count);
+        }
+        count = 0;
+    }
+};
+
+// Copies entries of the selected source into the column ring
+static void PushSoA(int32_t source, const IMUData* items, size_t count) {
+    if (g_soaSource.load(std::memory_order_relaxed) != source) return;
+    
+    const size_t n = g_soaBuffer.Reserve(count);
+    for (size_t i = 0; i < n; i++) {
+        const IMUData& d = items[i];
+        g_soaBuffer.Set(i, d.accel_timestamp_ns, d.gyro_timestamp_ns,
+                        d.accel_x, d.accel_y, d.accel_z, d.gyro_x, d.gyro_y, d.gyro_z);
+    }
+    g_soaBuffer.Commit(n);
+}
+
+static void PushSyncedSoA(const IMUData* items, size_t count) {
+    PushSoA(IMUSoA_Synced, items, count);
+}
+
+// Fixed-size FIFO used only by the sensor thread
+template <typename T, size_t N>
+struct LocalFifo {
+    T items[N];
+    size_t head = 0;
+    size_t count = 0;
+
+    bool Empty() const { return count == 0; }
+    size_t Size() const { return count; }
+    const T& operator[](size_t i) const { return items[(head + i) % N]; }
+    const T& Front() const { return items[head]; }
+    const T& Back() const { return (*this)[count - 1]; }
+    void PopFront() { head = (head + 1) % N; count--; }
+    void PushBack(const T& item) {  // drops the oldest when full
+        if (count == N) PopFront();
+        items[(head + count) % N] = item;
+        count++;
+    }
+    void Clear() { head = count = 0; }
+};
+
+// Synchronizer state (sensor thread only). The reference sensor's samples
+// wait in g_syncPending until the other sensor has caught up to them;
+// g_syncOther keeps enough of the other sensor's history to bracket them,
+// so batched deliveries of one sensor ahead of the other still line up.
+static int32_t g_syncReference = -1;  // ASENSOR_TYPE_* of the reference, -1 = undecided
+static uint32_t g_syncSeenAccel = 0;
+static uint32_t g_syncSeenGyro = 0;
+static LocalFifo<IMUVectorSample, SYNC_HISTORY> g_syncPending;
+static LocalFifo<IMUVectorSample, SYNC_HISTORY> g_syncOther;
+
+static void ResetSync() {
+    g_syncReference = g_syncMode == IMUSync_ToGyro  ? ASENSOR_TYPE_GYROSCOPE
+                    : g_syncMode == IMUSync_ToAccel ? ASENSOR_TYPE_ACCELEROMETER
+                                                    : -1;
+    g_syncSeenAccel = 0;
+    g_syncSeenGyro = 0;
+    g_syncPending.Clear();
+    g_syncOther.Clear();
+}
+
+// Emits every pending reference sample the other sensor now brackets
+static void FlushSync(StagedPush<IMUData, BUFFER_SIZE>& out) {
+    const bool refIsGyro = g_syncReference == ASENSOR_TYPE_GYROSCOPE;
+    while (!g_syncPending.Empty() && !g_syncOther.Empty()) {
+        const IMUVectorSample& r = g_syncPending.Front();
+        if (g_syncOther.Back().timestamp_ns < r.timestamp_ns) break;  // wait for the other sensor
+
+        // Keep the last other-sensor sample at or before r
+        while (g_syncOther.Size() >= 2 && g_syncOther[1].timestamp_ns <= r.timestamp_ns) {
+            g_syncOther.PopFront();
+        }
+        const IMUVectorSample& a = g_syncOther.Front();
+        if (a.timestamp_ns > r.timestamp_ns) {
+            // Before the other sensor's first retained sample: cannot interpolate
+            g_syncPending.PopFront();
+            continue;
+        }
+        const IMUVectorSample& b = g_syncOther.Size() >= 2 ? g_syncOther[1] : a;
+        const int64_t span = b.timestamp_ns - a.timestamp_ns;
+        const float t = span > 0 ? (float)((double)(r.timestamp_ns - a.timestamp_ns) / (double)span) : 0.0f;
+
+        IMUVectorSample o;
+        o.timestamp_ns = r.timestamp_ns;
+        o.x = a.x + (b.x - a.x) * t;
+        o.y = a.y + (b.y - a.y) * t;
+        o.z = a.z + (b.z - a.z) * t;
+        o.reserved = 0;
+
+        const IMUVectorSample& accel = refIsGyro ? o : r;
+        const IMUVectorSample& gyro = refIsGyro ? r : o;
+        IMUData d = {};
+        d.accel_x = accel.x;
+        d.accel_y = accel.y;
+        d.accel_z = accel.z;
+        d.accel_timestamp_ns = r.timestamp_ns;
+        d.gyro_x = gyro.x;
+        d.gyro_y = gyro.y;
+        d.gyro_z = gyro.z;
+        d.gyro_timestamp_ns = r.timestamp_ns;
+        d.has_accel = 1;
+        d.has_gyro = 1;
+        out.Add(d);
+
+        g_syncPending.PopFront();
+    }
+}
+
+static void AddSyncSample(int32_t type, const IMUVectorSample& sample, StagedPush<IMUData, BUFFER_SIZE>& out) {
+    if (g_syncReference < 0) {
+        // IMUSync_Auto: the sensor with more samples after a short warm-up is the faster one
+        uint32_t& seen = type == ASENSOR_TYPE_ACCELEROMETER ? g_syncSeenAccel : g_syncSeenGyro;
+        seen++;
+        if (g_syncSeenAccel < SYNC_AUTO_SAMPLES || g_syncSeenGyro < SYNC_AUTO_SAMPLES) return;
+        g_syncReference = g_syncSeenGyro >= g_syncSeenAccel ? ASENSOR_TYPE_GYROSCOPE : ASENSOR_TYPE_ACCELEROMETER;
+        LOGI("Synchronized stream uses %s timestamps",
+             g_syncReference == ASENSOR_TYPE_GYROSCOPE ? "gyroscope" : "accelerometer");
+        return;
+    }
+
+    if (type == g_syncReference) {
+        g_syncPending.PushBack(sample);
+    } else {
+        // Out-of-order samples of one sensor would break the bracketing
+        if (!g_syncOther.Empty() && sample.timestamp_ns <= g_syncOther.Back().timestamp_ns) return;
+        g_syncOther.PushBack(sample);
+    }
+    FlushSync(out);
+}
+
+// ---------- Statistics ----------
+
+template <typename T>
+static inline void StatAdd(std::atomic<T>& counter, T amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+static inline void StatMax(std::atomic<float>& value, float candidate) {
+    if (candidate > value.load(std::memory_order_relaxed)) value.store(candidate, std::memory_order_relaxed);
+}
+
+static inline int64_t NowNs(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + (int64_t)ts.tv_nsec;
+}
+
+static void ResetSensorStats(SensorStats& s, uint64_t dropBaseline) {
+    s.samples.store(0, std::memory_order_relaxed);
+    s.outOfOrder.store(0, std::memory_order_relaxed);
+    s.rateHz.store(0.0f, std::memory_order_relaxed);
+    s.meanIntervalUs.store(0.0f, std::memory_order_relaxed);
+    s.minIntervalUs.store(0.0f, std::memory_order_relaxed);
+    s.maxIntervalUs.store(0.0f, std::memory_order_relaxed);
+    for (std::atomic<uint32_t>& bin : s.histogram) bin.store(0, std::memory_order_relaxed);
+    s.dropBaseline.store(dropBaseline, std::memory_order_relaxed);
+    s.lastNs = 0;
+    s.windowStartNs = 0;
+    s.windowCount = 0;
+    s.meanNs = 0.0;
+}
+
+// Capture thread (or Init, before it starts)
+static void ResetStatsNow() {
+    ResetSensorStats(g_accelStats, g_accelBuffer.Dropped());
+    ResetSensorStats(g_gyroStats, g_gyroBuffer.Dropped());
+    g_maxDeliveryLatencyUs.store(0.0f, std::memory_order_relaxed);
+    g_maxCallbackUs.store(0.0f, std::memory_order_relaxed);
+    g_pairedDropBaseline.store(g_buffer.Dropped(), std::memory_order_relaxed);
+    g_syncedDropBaseline.store(g_syncBuffer.Dropped(), std::memory_order_relaxed);
+    g_directLostBaseline.store(g_directLost.load(), std::memory_order_relaxed);
+    g_wakeupBaseline.store(g_wakeupCount.load(), std::memory_order_relaxed);
+    g_eventBaseline.store(g_eventCount.load(), std::memory_order_relaxed);
+}
+
+static void RecordSample(SensorStats& s, int64_t timestamp) {
+    StatAdd<uint64_t>(s.samples, 1);
+    
+    if (s.lastNs != 0) {
+        const int64_t interval = timestamp - s.lastNs;
+        if (interval <= 0) {
+            StatAdd<uint64_t>(s.outOfOrder, 1);
+            return;
+        }
+        
+        s.meanNs = s.meanNs == 0.0 ? (double)interval : s.meanNs + ((double)interval - s.meanNs) * STATS_INTERVAL_WEIGHT;
+        const float ratio = (float)((double)interval / s.meanNs);
+        int bin = 0;
+        while (bin < IMU_JITTER_BINS - 1 && ratio >= JITTER_EDGES[bin]) bin++;
+        StatAdd<uint32_t>(s.histogram[bin], 1);
+        
+        const float us = (float)interval * 1e-3f;
+        s.meanIntervalUs.store((float)(s.meanNs * 1e-3), std::memory_order_relaxed);
+        StatMax(s.maxIntervalUs, us);
+        const float minUs = s.minIntervalUs.load(std::memory_order_relaxed);
+        if (minUs == 0.0f || us < minUs) s.minIntervalUs.store(us, std::memory_order_relaxed);
+    }
+    s.lastNs = timestamp;
+    
+    // Effective rate from the sensor timestamps, one window at a time
+    if (s.windowStartNs == 0) {
+        s.windowStartNs = timestamp;
+        s.windowCount = 0;
+    } else if (++s.windowCount, timestamp - s.windowStartNs >= STATS_RATE_WINDOW_NS) {
+        s.rateHz.store((float)((double)s.windowCount * 1e9 / (double)(timestamp - s.windowStartNs)),
+                       std::memory_order_relaxed);
+        s.windowStartNs = timestamp;
+        s.windowCount = 0;
+    }
+}
+
+// Start of a capture wake-up: applies a pending reset, returns the start time
+static int64_t BeginWakeup() {
+    if (g_statsResetRequested.exchange(false, std::memory_order_relaxed)) {
+        ResetStatsNow();
+    }
+    StatAdd<uint64_t>(g_wakeupCount, 1);
+    return NowNs(CLOCK_MONOTONIC);
+}
+
+// End of a capture wake-up. Sensor timestamps use CLOCK_BOOTTIME, so the
+// newest one gives the delivery latency of the batch.
+static void EndWakeup(int64_t startNs, int64_t newestTimestamp) {
+    if (newestTimestamp > 0) {
+        StatMax(g_maxDeliveryLatencyUs, (float)(NowNs(CLOCK_BOOTTIME) - newestTimestamp) * 1e-3f);
+    }
+    StatMax(g_maxCallbackUs, (float)(NowNs(CLOCK_MONOTONIC) - startNs) * 1e-3f);
+}
+
+// Per-wakeup staging shared by both capture backends
+struct CaptureBatch {
+    IMUData paired[EVENT_BATCH];
+    size_t pairedCount = 0;
+    StagedPush<IMUVectorSample, RAW_BUFFER_SIZE> accelOut{g_accelBuffer};
+    StagedPush<IMUVectorSample, RAW_BUFFER_SIZE> gyroOut{g_gyroBuffer};
+    StagedPush<IMUData, BUFFER_SIZE> syncOut{g_syncBuffer, PushSyncedSoA};
+    StagedPush<IMUVectorSample, RAW_BUFFER_SIZE> secondaryAccelOut{g_secondaryAccel};
+    StagedPush<IMUVectorSample, RAW_BUFFER_SIZE> secondaryGyroOut{g_secondaryGyro};
+    StagedPush<IMUOrientation, BUFFER_SIZE> orientationOut{g_orientationBuffer};
+    bool orientationUpdated = false;
+};
+
+// Publishes the whole batch at once. A full ring drops the new samples
+// (counted); the consumer owns the tail.
+static void PublishBatch(CaptureBatch& batch) {
+    if (batch.pairedCount > 0) {
+        g_buffer.Push(batch.paired, batch.pairedCount);
+        PushSoA(IMUSoA_Paired, batch.paired, batch.pairedCount);
+        g_latest.Store(batch.paired[batch.pairedCount - 1]);
+        g_hasNewData.store(true, std::memory_order_release);
+        batch.pairedCount = 0;
+    }
+    batch.accelOut.Flush();
+    batch.gyroOut.Flush();
+    batch.syncOut.Flush();
+    batch.secondaryAccelOut.Flush();
+    batch.secondaryGyroOut.Flush();
+    batch.orientationOut.Flush();
+    if (batch.orientationUpdated) {
+        g_latestOrientation.Store(g_orientationData);
+        g_hasNewOrientation.store(true, std::memory_order_release);
+        batch.orientationUpdated = false;
+    }
+}
+
+// Runs the orientation filter at the gyro rate, corrected with the latest
+// accel sample, and emits one output per gyro sample
+static void UpdateOrientation(int32_t type, int64_t timestamp, const float* data, CaptureBatch& batch) {
+    if (type == ASENSOR_TYPE_ACCELEROMETER) {
+        g_filterAccel[0] = data[0];
+        g_filterAccel[1] = data[1];
+        g_filterAccel[2] = data[2];
+        g_filterHasAccel = true;
+        if (!g_filter.Initialized()) {
+            g_filter.InitFromAccel(g_filterAccel);
+        }
+        return;
+    }
+    
+    const int64_t gap = timestamp - g_filterLastGyroNs;
+    if (g_filterLastGyroNs > 0 && gap > 0 && gap <= FILTER_MAX_GAP_NS) {
+        g_filter.Update(data, g_filterHasAccel ? g_filterAccel : nullptr, (float)((double)gap * 1e-9));
+    }
+    g_filterLastGyroNs = timestamp;
+    if (!g_filter.Initialized()) {
+        return;
+    }
+    
+    float q[4], gravity[3];
+    g_filter.Quaternion(q);
+    g_filter.Gravity(gravity);
+    g_orientationData.timestamp_ns = timestamp;
+    g_orientationData.orientation_x = q[0];
+    g_orientationData.orientation_y = q[1];
+    g_orientationData.orientation_z = q[2];
+    g_orientationData.orientation_w = q[3];
+    g_orientationData.gravity_x = gravity[0];
+    g_orientationData.gravity_y = gravity[1];
+    g_orientationData.gravity_z = gravity[2];
+    batch.orientationOut.Add(g_orientationData);
+    batch.orientationUpdated = true;
+}
+
+// One accelerometer or gyroscope event, from either backend
+static void HandleSensorEvent(int32_t type, int64_t timestamp, const float* data, CaptureBatch& batch) {
+    if (type != ASENSOR_TYPE_ACCELEROMETER && type != ASENSOR_TYPE_GYROSCOPE) {
+        return;
+    }
+    
+    RecordSample(type == ASENSOR_TYPE_ACCELEROMETER ? g_accelStats : g_gyroStats, timestamp);
+    
+    IMUVectorSample raw;
+    raw.timestamp_ns = timestamp;
+    raw.x = data[0];
+    raw.y = data[1];
+    raw.z = data[2];
+    raw.reserved = 0;
+    (type == ASENSOR_TYPE_ACCELEROMETER ? batch.accelOut : batch.gyroOut).Add(raw);
+    if (g_syncMode != IMUSync_Off) {
+        AddSyncSample(type, raw, batch.syncOut);
+    }
+    if (g_secondaryEnabled.load(std::memory_order_relaxed)) {
+        (type == ASENSOR_TYPE_ACCELEROMETER ? batch.secondaryAccelOut : batch.secondaryGyroOut).Add(raw);
+    }
+    
+    if (type == ASENSOR_TYPE_ACCELEROMETER) {
+        g_latestData.accel_x = data[0];
+        g_latestData.accel_y = data[1];
+        g_latestData.accel_z = data[2];
+        g_latestData.accel_timestamp_ns = timestamp;
+        g_latestData.has_accel = 1;
+        StatAdd<uint64_t>(g_accelCount, 1);
+    } else {
+        g_latestData.gyro_x = data[0];
+        g_latestData.gyro_y = data[1];
+        g_latestData.gyro_z = data[2];
+        g_latestData.gyro_timestamp_ns = timestamp;
+        g_latestData.has_gyro = 1;
+        StatAdd<uint64_t>(g_gyroCount, 1);
+    }
+    
+    if (g_filterEnabled) {
+        UpdateOrientation(type, timestamp, data, batch);
+    }
+    
+    // Store in ring buffer when we have both accel and gyro
+    if (g_latestData.has_accel && g_latestData.has_gyro) {
+        batch.paired[batch.pairedCount++] = g_latestData;
+        if (batch.pairedCount == EVENT_BATCH) {
+            PublishBatch(batch);
+        }
+    }
+}
 
 // Sensor callback (called from looper)
 static int SensorCallback(int fd, int events, void* data) {
@@ -54,56 +538,172 @@ static int SensorCallback(int fd, int events, void* data) {
     (void)events;
     (void)data;
     
-    ASensorEvent event;
+    const int64_t startNs = BeginWakeup();
+    int64_t newest = 0;
     
-    while (ASensorEventQueue_getEvents(g_eventQueue, &event, 1) > 0) {
-        std::lock_guard<std::mutex> lock(g_mutex);
-        
-        if (event.type == ASENSOR_TYPE_ACCELEROMETER) {
+    ASensorEvent sensorEvents[EVENT_BATCH];
+    CaptureBatch batch;
+    ssize_t eventCount;
+    
+    while ((eventCount = ASensorEventQueue_getEvents(g_eventQueue, sensorEvents, EVENT_BATCH)) > 0) {
+        StatAdd(g_eventCount, (uint64_t)eventCount);
+        for (ssize_t i = 0; i < eventCount; i++) {
             // Use data array - most portable across NDK versions
-            g_latestData.accel_x = event.data[0];
-            g_latestData.accel_y = event.data[1];
-            g_latestData.accel_z = event.data[2];
-            g_latestData.accel_timestamp_ns = event.timestamp;
-            g_latestData.has_accel = 1;
-            g_accelCount.fetch_add(1);
+            HandleSensorEvent(sensorEvents[i].type, sensorEvents[i].timestamp, sensorEvents[i].data, batch);
+            if (sensorEvents[i].timestamp > newest) newest = sensorEvents[i].timestamp;
         }
-        else if (event.type == ASENSOR_TYPE_GYROSCOPE) {
-            // Use data array - most portable across NDK versions
-            g_latestData.gyro_x = event.data[0];
-            g_latestData.gyro_y = event.data[1];
-            g_latestData.gyro_z = event.data[2];
-            g_latestData.gyro_timestamp_ns = event.timestamp;
-            g_latestData.has_gyro = 1;
-            g_gyroCount.fetch_add(1);
+        PublishBatch(batch);
+    }
+    
+    EndWakeup(startNs, newest);
+    return 1; // Continue receiving events
+}
+
+// Enables one sensor on the event queue, with FIFO batching if requested
+static void EnableSensor(const ASensor* sensor, const char* name, int32_t samplePeriodUs) {
+    if (g_maxReportLatencyUs > 0) {
+        if (ASensorEventQueue_registerSensor(g_eventQueue, sensor, samplePeriodUs, g_maxReportLatencyUs) < 0) {
+            LOGE("Failed to enable %s", name);
+            return;
         }
+        // Samples beyond the hardware FIFO are lost or force an early wake-up
+        int32_t fifoMax = ASensor_getFifoMaxEventCount(sensor);
+        int64_t held = (int64_t)g_maxReportLatencyUs * g_sampleRateHz / 1000000;
+        if (held > fifoMax) {
+            LOGW("%s FIFO holds %d events, %lld requested by the report latency",
+                 name, fifoMax, (long long)held);
+        }
+        LOGI("%s enabled at %d Hz, batched up to %d us", name, g_sampleRateHz, g_maxReportLatencyUs);
+        return;
+    }
+    
+    if (ASensorEventQueue_enableSensor(g_eventQueue, sensor) < 0) {
+        LOGE("Failed to enable %s", name);
+    } else {
+        ASensorEventQueue_setEventRate(g_eventQueue, sensor, samplePeriodUs);
+        LOGI("%s enabled at %d Hz", name, g_sampleRateHz);
+    }
+}
+
+// ---------- Direct channel backend ----------
+
+static bool ConfigureDirectReport(const ASensor* sensor, const char* name) {
+    if (!ASensor_isDirectChannelTypeSupported(sensor, ASENSOR_DIRECT_CHANNEL_TYPE_SHARED_MEMORY)) {
+        LOGW("%s has no shared-memory direct channel", name);
+        return false;
+    }
+    int level = ASensor_getHighestDirectReportRateLevel(sensor);
+    if (level <= ASENSOR_DIRECT_RATE_STOP) {
+        LOGW("%s does not support direct reports", name);
+        return false;
+    }
+    int token = ASensorManager_configureDirectReport(g_sensorManager, sensor, g_directChannel, level);
+    if (token <= 0) {
+        LOGE("Failed to configure %s direct report: %d", name, token);
+        return false;
+    }
+    LOGI("%s direct report at rate level %d (token %d)", name, level, token);
+    return true;
+}
+
+static void StopDirectChannel() {
+    if (g_directChannel > 0) {
+        if (g_accelSensor) {
+            ASensorManager_configureDirectReport(g_sensorManager, g_accelSensor, g_directChannel, ASENSOR_DIRECT_RATE_STOP);
+        }
+        if (g_gyroSensor) {
+            ASensorManager_configureDirectReport(g_sensorManager, g_gyroSensor, g_directChannel, ASENSOR_DIRECT_RATE_STOP);
+        }
+        ASensorManager_destroyDirectChannel(g_sensorManager, g_directChannel);
+        g_directChannel = 0;
+    }
+    g_directReader.Detach();
+    if (g_directMemory) {
+        munmap(g_directMemory, g_directSize);
+        g_directMemory = nullptr;
+    }
+    if (g_directFd >= 0) {
+        close(g_directFd);
+        g_directFd = -1;
+    }
+    g_directSize = 0;
+}
+
+// Every available sensor must support the channel, otherwise the caller
+// falls back to the event queue for both
+static bool StartDirectChannel() {
+    g_directSize = DIRECT_REPORTS * SENSOR_DIRECT_REPORT_SIZE;
+    g_directFd = ASharedMemory_create("MLIMUUnity", g_directSize);
+    if (g_directFd < 0) {
+        LOGE("Failed to create sensor shared memory");
+        StopDirectChannel();
+        return false;
+    }
+    
+    g_directMemory = mmap(nullptr, g_directSize, PROT_READ, MAP_SHARED, g_directFd, 0);
+    if (g_directMemory == MAP_FAILED) {
+        g_directMemory = nullptr;
+        LOGE("Failed to map sensor shared memory");
+        StopDirectChannel();
+        return false;
+    }
+    
+    g_directChannel = ASensorManager_createSharedMemoryDirectChannel(g_sensorManager, g_directFd, g_directSize);
+    if (g_directChannel <= 0) {
+        g_directChannel = 0;
+        LOGE("Failed to create sensor direct channel");
+        StopDirectChannel();
+        return false;
+    }
+    
+    g_directReader.Attach(g_directMemory, g_directSize);
+    if ((g_accelSensor && !ConfigureDirectReport(g_accelSensor, "Accelerometer")) ||
+        (g_gyroSensor && !ConfigureDirectReport(g_gyroSensor, "Gyroscope"))) {
+        StopDirectChannel();
+        return false;
+    }
+    return true;
+}
+
+// Direct channel thread: no looper, just parse whatever the sensor service
+// has written since the last pass
+static void DirectLoop() {
+    LOGI("Direct channel thread started");
+    
+    SensorDirectEvent directEvents[EVENT_BATCH];
+    CaptureBatch batch;
+    
+    while (g_running.load()) {
+        const int64_t startNs = BeginWakeup();
+        int64_t newest = 0;
         
-        // Store in ring buffer when we have both accel and gyro
-        if (g_latestData.has_accel && g_latestData.has_gyro) {
-            g_buffer[g_bufferHead] = g_latestData;
-            g_bufferHead = (g_bufferHead + 1) % BUFFER_SIZE;
-            
-            if (g_bufferCount < BUFFER_SIZE) {
-                g_bufferCount++;
-            } else {
-                // Buffer full, advance tail
-                g_bufferTail = (g_bufferTail + 1) % BUFFER_SIZE;
+        size_t eventCount;
+        while ((eventCount = g_directReader.Read(directEvents, EVENT_BATCH)) > 0) {
+            StatAdd(g_eventCount, (uint64_t)eventCount);
+            for (size_t i = 0; i < eventCount; i++) {
+                HandleSensorEvent(directEvents[i].type, directEvents[i].timestamp, directEvents[i].data, batch);
+                if (directEvents[i].timestamp > newest) newest = directEvents[i].timestamp;
             }
-            
-            g_hasNewData.store(true);
+            PublishBatch(batch);
         }
+        
+        g_directLost.store(g_directReader.Lost(), std::memory_order_relaxed);
+        EndWakeup(startNs, newest);
+        std::this_thread::sleep_for(std::chrono::microseconds(DIRECT_POLL_US));
     }
     
-    return 1; // Continue receiving events
+    LOGI("Direct channel thread exiting (%llu reports lost)", (unsigned long long)g_directReader.Lost());
 }
 
+// ---------- Event queue backend ----------
+
 // Sensor polling thread
 static void SensorLoop() {
     LOGI("Sensor thread started");
     
     // Create looper for this thread
-    g_looper = ALooper_prepare(ALOOPER_PREPARE_ALLOW_NON_CALLBACKS);
-    if (!g_looper) {
+    ALooper* looper = ALooper_prepare(ALOOPER_PREPARE_ALLOW_NON_CALLBACKS);
+    if (!looper) {
         LOGE("Failed to prepare looper");
         return;
     }
@@ -111,7 +711,7 @@ static void SensorLoop() {
     // Create event queue
     g_eventQueue = ASensorManager_createEventQueue(
         g_sensorManager,
-        g_looper,
+        looper,
         ALOOPER_POLL_CALLBACK,
         SensorCallback,
         nullptr
@@ -125,30 +725,26 @@ static void SensorLoop() {
     // Calculate sample period in microseconds
     int32_t samplePeriodUs = 1000000 / g_sampleRateHz;
     
-    // Enable accelerometer
+    // Enable accelerometer and gyroscope
     if (g_accelSensor) {
-        if (ASensorEventQueue_enableSensor(g_eventQueue, g_accelSensor) < 0) {
-            LOGE("Failed to enable accelerometer");
-        } else {
-            ASensorEventQueue_setEventRate(g_eventQueue, g_accelSensor, samplePeriodUs);
-            LOGI("Accelerometer enabled at %d Hz", g_sampleRateHz);
-        }
+        EnableSensor(g_accelSensor, "Accelerometer", samplePeriodUs);
     }
-    
-    // Enable gyroscope
     if (g_gyroSensor) {
-        if (ASensorEventQueue_enableSensor(g_eventQueue, g_gyroSensor) < 0) {
-            LOGE("Failed to enable gyroscope");
-        } else {
-            ASensorEventQueue_setEventRate(g_eventQueue, g_gyroSensor, samplePeriodUs);
-            LOGI("Gyroscope enabled at %d Hz", g_sampleRateHz);
-        }
+        EnableSensor(g_gyroSensor, "Gyroscope", samplePeriodUs);
     }
     
-    // Poll loop
+    // Poll loop. Sleeps until events arrive; Shutdown wakes the looper, so
+    // there is no periodic timeout to undo the FIFO batching.
+    {
+        std::lock_guard<std::mutex> lock(g_looperMutex);
+        g_looper = looper;
+    }
     while (g_running.load()) {
-        // Poll with timeout (10ms) - use pollOnce instead of deprecated pollAll
-        ALooper_pollOnce(10, nullptr, nullptr, nullptr);
+        ALooper_pollOnce(-1, nullptr, nullptr, nullptr);
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_looperMutex);
+        g_looper = nullptr;
     }
     
     // Cleanup
@@ -162,18 +758,48 @@ static void SensorLoop() {
     ASensorManager_destroyEventQueue(g_sensorManager, g_eventQueue);
     g_eventQueue = nullptr;
     
+    LOGI("%llu wake-ups, %llu events",
+         (unsigned long long)g_wakeupCount.load(), (unsigned long long)g_eventCount.load());
+    
     LOGI("Sensor thread exiting");
 }
 
 bool MLIMUUnity_Init(int32_t sample_rate_hz) {
+    IMUConfig config;
+    config.sample_rate_hz = sample_rate_hz;
+    config.max_report_latency_us = 0;
+    config.sync_mode = IMUSync_Off;
+    config.backend = IMUBackend_EventQueue;
+    config.orientation_filter = IMUFilter_Off;
+    config.filter_gain = 0.0f;
+    config.filter_bias_gain = 0.0f;
+    return MLIMUUnity_InitWithConfig(&config);
+}
+
+bool MLIMUUnity_InitWithConfig(const IMUConfig* config) {
+    if (!config) {
+        return false;
+    }
     if (g_initialized.load()) {
         LOGI("Already initialized");
         return true;
     }
     
-    g_sampleRateHz = sample_rate_hz > 0 ? sample_rate_hz : 200;
+    g_sampleRateHz = config->sample_rate_hz > 0 ? config->sample_rate_hz : 200;
+    g_maxReportLatencyUs = config->max_report_latency_us > 0 ? config->max_report_latency_us : 0;
+    g_syncMode = config->sync_mode >= IMUSync_Auto && config->sync_mode <= IMUSync_ToAccel
+                     ? config->sync_mode : IMUSync_Off;
+    g_filterEnabled = config->orientation_filter == IMUFilter_Madgwick ||
+                      config->orientation_filter == IMUFilter_Mahony;
+    if (g_filterEnabled) {
+        g_filter.Configure(config->orientation_filter, config->filter_gain, config->filter_bias_gain);
+        LOGI("%s orientation filter enabled",
+             config->orientation_filter == IMUFilter_Mahony ? "Mahony" : "Madgwick");
+    }
+    g_filterHasAccel = false;
+    g_filterLastGyroNs = 0;
     
-    LOGI("Initializing IMU at %d Hz", g_sampleRateHz);
+    LOGI("Initializing IMU at %d Hz (report latency %d us)", g_sampleRateHz, g_maxReportLatencyUs);
     
     // Get sensor manager
     g_sensorManager = ASensorManager_getInstanceForPackage(nullptr);
@@ -204,18 +830,40 @@ bool MLIMUUnity_Init(int32_t sample_rate_hz) {
         return false;
     }
     
-    // Initialize buffer
-    g_buffer.resize(BUFFER_SIZE);
-    g_bufferHead = 0;
-    g_bufferTail = 0;
-    g_bufferCount = 0;
+    // Initialize buffers
+    g_buffer.Reset();
+    g_accelBuffer.Reset();
+    g_gyroBuffer.Reset();
+    g_syncBuffer.Reset();
+    g_secondaryAccel.Reset();
+    g_secondaryGyro.Reset();
+    g_soaBuffer.Reset();
+    g_orientationBuffer.Reset();
+    ResetSync();
+    g_directLost.store(0);
+    g_statsResetRequested.store(false);
+    ResetStatsNow();
     
     // Clear latest data
     memset(&g_latestData, 0, sizeof(g_latestData));
+    g_latest.Store(g_latestData);
+    g_hasNewData.store(false);
+    memset(&g_orientationData, 0, sizeof(g_orientationData));
+    g_latestOrientation.Store(g_orientationData);
+    g_hasNewOrientation.store(false);
+    
+    g_backend = IMUBackend_EventQueue;
+    if (config->backend == IMUBackend_DirectChannel) {
+        if (StartDirectChannel()) {
+            g_backend = IMUBackend_DirectChannel;
+        } else {
+            LOGW("Direct channel unavailable, using the sensor event queue");
+        }
+    }
     
     g_initialized.store(true);
     g_running.store(true);
-    g_thread = std::thread(SensorLoop);
+    g_thread = g_backend == IMUBackend_DirectChannel ? std::thread(DirectLoop) : std::thread(SensorLoop);
     
     LOGI("IMU initialized");
     return true;
@@ -225,40 +873,105 @@ bool MLIMUUnity_IsInitialized() {
     return g_initialized.load();
 }
 
+int32_t MLIMUUnity_GetBackend() {
+    return g_backend;
+}
+
 bool MLIMUUnity_TryGetLatest(IMUData* out_data) {
     if (!out_data || !g_initialized.load()) {
         return false;
     }
     
-    if (!g_hasNewData.load()) {
+    if (!g_hasNewData.exchange(false, std::memory_order_acquire)) {
         return false;
     }
     
-    std::lock_guard<std::mutex> lock(g_mutex);
-    *out_data = g_latestData;
-    g_hasNewData.store(false);
+    *out_data = g_latest.Load();
+    return true;
+}
+
+bool MLIMUUnity_TryGetLatestOrientation(IMUOrientation* out_data) {
+    if (!out_data || !g_initialized.load() || !g_filterEnabled) {
+        return false;
+    }
+    
+    if (!g_hasNewOrientation.exchange(false, std::memory_order_acquire)) {
+        return false;
+    }
     
+    *out_data = g_latestOrientation.Load();
     return true;
 }
 
-bool MLIMUUnity_GetBuffered(IMUData* out_data, int32_t max_count, int32_t* out_count) {
+// Shared drain for all sample rings
+template <typename T, size_t N>
+static bool DrainRing(SpscRing<T, N>& ring, std::mutex& consumerMutex, T* out_data, int32_t max_count, int32_t* out_count) {
     if (!out_data || !out_count || max_count <= 0 || !g_initialized.load()) {
         if (out_count) *out_count = 0;
         return false;
     }
     
-    std::lock_guard<std::mutex> lock(g_mutex);
-    
-    int32_t count = 0;
-    while (g_bufferCount > 0 && count < max_count) {
-        out_data[count] = g_buffer[g_bufferTail];
-        g_bufferTail = (g_bufferTail + 1) % BUFFER_SIZE;
-        g_bufferCount--;
-        count++;
+    std::lock_guard<std::mutex> lock(consumerMutex);
+    *out_count = (int32_t)ring.Pop(out_data, (size_t)max_count);
+    return *out_count > 0;
+}
+
+bool MLIMUUnity_GetBuffered(IMUData* out_data, int32_t max_count, int32_t* out_count) {
+    return DrainRing(g_buffer, g_drainMutex, out_data, max_count, out_count);
+}
+
+bool MLIMUUnity_GetBufferedAccel(IMUVectorSample* out_data, int32_t max_count, int32_t* out_count) {
+    return DrainRing(g_accelBuffer, g_drainMutex, out_data, max_count, out_count);
+}
+
+bool MLIMUUnity_GetBufferedGyro(IMUVectorSample* out_data, int32_t max_count, int32_t* out_count) {
+    return DrainRing(g_gyroBuffer, g_drainMutex, out_data, max_count, out_count);
+}
+
+bool MLIMUUnity_GetBufferedSynced(IMUData* out_data, int32_t max_count, int32_t* out_count) {
+    if (g_syncMode == IMUSync_Off) {
+        if (out_count) *out_count = 0;
+        return false;
+    }
+    return DrainRing(g_syncBuffer, g_drainMutex, out_data, max_count, out_count);
+}
+
+bool MLIMUUnity_GetBufferedOrientation(IMUOrientation* out_data, int32_t max_count, int32_t* out_count) {
+    if (!g_filterEnabled) {
+        if (out_count) *out_count = 0;
+        return false;
+    }
+    return DrainRing(g_orientationBuffer, g_drainMutex, out_data, max_count, out_count);
+}
+
+void MLIMUUnity_EnableSecondaryStreams(bool enable) {
+    g_secondaryEnabled.store(enable);
+}
+
+bool MLIMUUnity_GetSecondaryAccel(IMUVectorSample* out_data, int32_t max_count, int32_t* out_count) {
+    return DrainRing(g_secondaryAccel, g_secondaryDrainMutex, out_data, max_count, out_count);
+}
+
+bool MLIMUUnity_GetSecondaryGyro(IMUVectorSample* out_data, int32_t max_count, int32_t* out_count) {
+    return DrainRing(g_secondaryGyro, g_secondaryDrainMutex, out_data, max_count, out_count);
+}
+
+void MLIMUUnity_EnableSoAStream(int32_t source) {
+    g_soaSource.store(source == IMUSoA_Paired || source == IMUSoA_Synced ? source : IMUSoA_Off);
+}
+
+bool MLIMUUnity_GetBufferedSoA(const IMUSoABuffers* out_buffers, int32_t max_count, int32_t* out_count) {
+    if (!out_buffers || !out_count || max_count <= 0 || !g_initialized.load()) {
+        if (out_count) *out_count = 0;
+        return false;
     }
     
-    *out_count = count;
-    return count > 0;
+    std::lock_guard<std::mutex> lock(g_drainMutex);
+    *out_count = (int32_t)g_soaBuffer.Pop((size_t)max_count,
+                                          out_buffers->accel_timestamp_ns, out_buffers->gyro_timestamp_ns,
+                                          out_buffers->accel_x, out_buffers->accel_y, out_buffers->accel_z,
+                                          out_buffers->gyro_x, out_buffers->gyro_y, out_buffers->gyro_z);
+    return *out_count > 0;
 }
 
 uint64_t MLIMUUnity_GetAccelCount() {
@@ -269,26 +982,100 @@ uint64_t MLIMUUnity_GetGyroCount() {
     return g_gyroCount.load();
 }
 
+uint64_t MLIMUUnity_GetWakeupCount() {
+    return g_wakeupCount.load();
+}
+
+uint64_t MLIMUUnity_GetEventCount() {
+    return g_eventCount.load();
+}
+
+bool MLIMUUnity_GetStats(IMUStats* out_stats) {
+    if (!out_stats || !g_initialized.load()) {
+        return false;
+    }
+    
+    const float requestedRate = g_backend == IMUBackend_EventQueue ? (float)g_sampleRateHz : 0.0f;
+    // A reset still pending in the capture thread makes the differences
+    // below negative for a moment; clamp rather than wrap
+    auto since = [](uint64_t value, uint64_t baseline) -> uint64_t {
+        return value > baseline ? value - baseline : 0;
+    };
+    
+    auto fillSensor = [requestedRate, since](const SensorStats& s, const SpscRing<IMUVectorSample, RAW_BUFFER_SIZE>& ring,
+                                      IMUSensorStats& out) {
+        out.samples = s.samples.load(std::memory_order_relaxed);
+        out.ring_drops = since(ring.Dropped(), s.dropBaseline.load(std::memory_order_relaxed));
+        out.out_of_order = s.outOfOrder.load(std::memory_order_relaxed);
+        out.requested_rate_hz = requestedRate;
+        out.effective_rate_hz = s.rateHz.load(std::memory_order_relaxed);
+        out.mean_interval_us = s.meanIntervalUs.load(std::memory_order_relaxed);
+        out.min_interval_us = s.minIntervalUs.load(std::memory_order_relaxed);
+        out.max_interval_us = s.maxIntervalUs.load(std::memory_order_relaxed);
+        for (int i = 0; i < IMU_JITTER_BINS; i++) {
+            out.interval_histogram[i] = s.histogram[i].load(std::memory_order_relaxed);
+        }
+    };
+    
+    fillSensor(g_accelStats, g_accelBuffer, out_stats->accel);
+    fillSensor(g_gyroStats, g_gyroBuffer, out_stats->gyro);
+    out_stats->paired_drops = since(g_buffer.Dropped(), g_pairedDropBaseline.load(std::memory_order_relaxed));
+    out_stats->synced_drops = since(g_syncBuffer.Dropped(), g_syncedDropBaseline.load(std::memory_order_relaxed));
+    out_stats->direct_lost = since(g_directLost.load(), g_directLostBaseline.load(std::memory_order_relaxed));
+    out_stats->wakeups = since(g_wakeupCount.load(), g_wakeupBaseline.load(std::memory_order_relaxed));
+    out_stats->events = since(g_eventCount.load(), g_eventBaseline.load(std::memory_order_relaxed));
+    out_stats->max_delivery_latency_us = g_maxDeliveryLatencyUs.load(std::memory_order_relaxed);
+    out_stats->max_callback_us = g_maxCallbackUs.load(std::memory_order_relaxed);
+    return true;
+}
+
+void MLIMUUnity_ResetStats() {
+    g_statsResetRequested.store(true);
+}
+
 void MLIMUUnity_Shutdown() {
     LOGI("Shutting down...");
     
     g_running.store(false);
     
+    // Break the sensor thread out of its untimed poll
+    {
+        std::lock_guard<std::mutex> lock(g_looperMutex);
+        if (g_looper) {
+            ALooper_wake(g_looper);
+        }
+    }
+    
     if (g_thread.joinable()) {
         g_thread.join();
     }
     
+    StopDirectChannel();
+    g_backend = IMUBackend_EventQueue;
+    
     g_sensorManager = nullptr;
     g_accelSensor = nullptr;
     g_gyroSensor = nullptr;
     
-    g_buffer.clear();
-    g_bufferHead = 0;
-    g_bufferTail = 0;
-    g_bufferCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_drainMutex);
+        g_buffer.Reset();
+        g_accelBuffer.Reset();
+        g_gyroBuffer.Reset();
+        g_syncBuffer.Reset();
+        g_soaBuffer.Reset();
+        g_orientationBuffer.Reset();
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_secondaryDrainMutex);
+        g_secondaryAccel.Reset();
+        g_secondaryGyro.Reset();
+    }
     
     g_accelCount.store(0);
     g_gyroCount.store(0);
+    g_wakeupCount.store(0);
+    g_eventCount.store(0);
     
     g_initialized.store(false);
     
@@ -25,13 +25,69 @@ typedef struct IMUData {
     int32_t has_gyro;   // 1 if gyro data valid
 } IMUData;
 
+// One raw accelerometer (m/s²) or gyroscope (rad/s) sample
+typedef struct IMUVectorSample {
+    int64_t timestamp_ns;
+    float x;
+    float y;
+    float z;
+    int32_t reserved;
+} IMUVectorSample;
+
+// Synchronized stream: the other sensor is linearly interpolated to the
+// timestamps of the reference sensor, one IMUData per reference sample
+typedef enum {
+    IMUSync_Off = 0,
+    IMUSync_Auto = 1,     // reference = the faster sensor (picked after the first samples)
+    IMUSync_ToGyro = 2,   // reference = gyroscope
+    IMUSync_ToAccel = 3   // reference = accelerometer
+} IMUSyncMode;
+
+// Orientation filters
+typedef enum {
+    IMUFilter_Off = 0,
+    IMUFilter_Madgwick = 1,  // gain = beta (default 0.033)
+    IMUFilter_Mahony = 2     // gain = Kp (default 1.0), bias_gain = Ki (gyro bias estimation, 0 = off)
+} IMUFilterType;
+
+// Capture backends
+typedef enum {
+    IMUBackend_EventQueue = 0,     // sensor event queue on a looper thread
+    IMUBackend_DirectChannel = 1   // sensor direct channel: the sensor service writes into
+                                   // shared memory at the highest rate it supports and a
+                                   // thread parses it; sample_rate_hz and
+                                   // max_report_latency_us are ignored
+} IMUBackend;
+
+// Capture settings
+typedef struct IMUConfig {
+    int32_t sample_rate_hz;         // desired sampling rate (e.g., 100, 200, 500)
+    int32_t max_report_latency_us;  // sensor FIFO batching: how long the sensor hub may
+                                    // hold samples before delivering them (0 = deliver
+                                    // as they arrive). Larger values wake the capture
+                                    // thread less often; timestamps are unchanged.
+    int32_t sync_mode;              // IMUSyncMode for MLIMUUnity_GetBufferedSynced
+    int32_t backend;                // IMUBackend; falls back to the event queue if a
+                                    // sensor has no shared-memory direct channel
+    int32_t orientation_filter;     // IMUFilterType, runs on the capture thread
+    float filter_gain;              // 0 = default for the filter type
+    float filter_bias_gain;         // Mahony only
+} IMUConfig;
+
 // Initialize IMU sensors
 // sample_rate_hz: desired sampling rate (e.g., 100, 200, 500)
 bool MLIMUUnity_Init(int32_t sample_rate_hz);
 
+// Initialize with explicit settings
+// (MLIMUUnity_Init = no FIFO batching, no sync stream, no orientation filter)
+bool MLIMUUnity_InitWithConfig(const IMUConfig* config);
+
 // Check if initialized
 bool MLIMUUnity_IsInitialized();
 
+// Backend actually in use (IMUBackend)
+int32_t MLIMUUnity_GetBackend();
+
 // Get latest IMU data (non-blocking)
 // Returns true if new data available
 bool MLIMUUnity_TryGetLatest(IMUData* out_data);
@@ -41,12 +97,120 @@ bool MLIMUUnity_TryGetLatest(IMUData* out_data);
 // max_count: size of array
 // out_count: number of samples written
 // Returns true if any data retrieved
+// Note: entries pair each event with the other sensor's latest value, so a
+// sample can repeat a stale partner. Use the raw or synchronized streams below
+// when every sample and its exact timestamp matter.
 bool MLIMUUnity_GetBuffered(IMUData* out_data, int32_t max_count, int32_t* out_count);
 
+// Raw per-sensor streams: every accelerometer / gyroscope event exactly once,
+// with its own timestamp, oldest first. Same arguments as MLIMUUnity_GetBuffered.
+bool MLIMUUnity_GetBufferedAccel(IMUVectorSample* out_data, int32_t max_count, int32_t* out_count);
+bool MLIMUUnity_GetBufferedGyro(IMUVectorSample* out_data, int32_t max_count, int32_t* out_count);
+
+// Synchronized stream (needs sync_mode != IMUSync_Off): one entry per
+// reference sample with both timestamps equal to it. Entries are emitted once
+// the other sensor has a sample at or after that time, so the stream lags by
+// up to one sample period of the other sensor.
+bool MLIMUUnity_GetBufferedSynced(IMUData* out_data, int32_t max_count, int32_t* out_count);
+
+// Orientation filter output (needs orientation_filter != IMUFilter_Off): one
+// entry per gyro sample, once the filter has seen an accelerometer sample.
+typedef struct IMUOrientation {
+    int64_t timestamp_ns;  // gyro sample the filter stepped with
+    float orientation_x;   // sensor-to-earth rotation, earth +z up,
+    float orientation_y;   // heading relative to the start
+    float orientation_z;
+    float orientation_w;
+    float gravity_x;       // gravity in the sensor frame as the accelerometer
+    float gravity_y;       // reads it at rest (m/s², pointing up):
+    float gravity_z;       // linear acceleration = accel - gravity
+} IMUOrientation;
+
+// Latest filter output (non-blocking); true if a new one is available
+bool MLIMUUnity_TryGetLatestOrientation(IMUOrientation* out_data);
+
+// Every filter output, oldest first. Same arguments as MLIMUUnity_GetBuffered.
+bool MLIMUUnity_GetBufferedOrientation(IMUOrientation* out_data, int32_t max_count, int32_t* out_count);
+
+// Secondary copies of the raw streams for consumers inside the plugin
+// (e.g. preintegration), so they don't compete with Unity for the rings
+// above. Off by default; samples are only copied while enabled.
+void MLIMUUnity_EnableSecondaryStreams(bool enable);
+bool MLIMUUnity_GetSecondaryAccel(IMUVectorSample* out_data, int32_t max_count, int32_t* out_count);
+bool MLIMUUnity_GetSecondaryGyro(IMUVectorSample* out_data, int32_t max_count, int32_t* out_count);
+
+// Struct-of-arrays export: a copy of the paired or synchronized stream kept
+// column by column, so a drain is one memcpy per field into the caller's
+// arrays (e.g. Burst/SIMD jobs) instead of an array of IMUData.
+typedef enum {
+    IMUSoA_Off = 0,
+    IMUSoA_Paired = 1,   // same entries as MLIMUUnity_GetBuffered
+    IMUSoA_Synced = 2    // same entries as MLIMUUnity_GetBufferedSynced (both timestamps equal)
+} IMUSoASource;
+
+// Destination arrays, each with room for max_count entries. Null arrays are
+// skipped.
+typedef struct IMUSoABuffers {
+    int64_t* accel_timestamp_ns;
+    int64_t* gyro_timestamp_ns;
+    float* accel_x;
+    float* accel_y;
+    float* accel_z;
+    float* gyro_x;
+    float* gyro_y;
+    float* gyro_z;
+} IMUSoABuffers;
+
+// Off by default. Entries are only copied while a source is selected; drain
+// after switching sources, since entries already queued are kept.
+void MLIMUUnity_EnableSoAStream(int32_t source);
+bool MLIMUUnity_GetBufferedSoA(const IMUSoABuffers* out_buffers, int32_t max_count, int32_t* out_count);
+
 // Get sample counts
 uint64_t MLIMUUnity_GetAccelCount();
 uint64_t MLIMUUnity_GetGyroCount();
 
+// Number of times the capture thread woke up to read sensor events, and the
+// events read in total. Sample both over an interval for wakeups/sec.
+uint64_t MLIMUUnity_GetWakeupCount();
+uint64_t MLIMUUnity_GetEventCount();
+
+// Inter-sample interval histogram: bins by the ratio of each interval to the
+// sensor's running mean interval, with upper edges
+//   0.5, 0.8, 0.9, 0.95, 0.99, 1.01, 1.05, 1.1, 1.2, 1.5, 2, 4, inf
+#define IMU_JITTER_BINS 13
+
+typedef struct IMUSensorStats {
+    uint64_t samples;
+    uint64_t ring_drops;             // raw-stream samples lost to a full ring
+    uint64_t out_of_order;           // samples not newer than the previous one
+    float requested_rate_hz;         // 0 = backend-defined (direct channel)
+    float effective_rate_hz;         // over the last full second of timestamps
+    float mean_interval_us;          // running mean
+    float min_interval_us;
+    float max_interval_us;
+    uint32_t interval_histogram[IMU_JITTER_BINS];
+} IMUSensorStats;
+
+typedef struct IMUStats {
+    IMUSensorStats accel;
+    IMUSensorStats gyro;
+    uint64_t paired_drops;           // MLIMUUnity_GetBuffered ring overflows
+    uint64_t synced_drops;           // MLIMUUnity_GetBufferedSynced ring overflows
+    uint64_t direct_lost;            // direct channel reports overwritten before parsing
+    uint64_t wakeups;
+    uint64_t events;
+    float max_delivery_latency_us;   // capture time minus the newest event timestamp
+    float max_callback_us;           // longest time spent handling one wake-up
+} IMUStats;
+
+// Snapshot of the capture statistics since Init or the last reset. The capture
+// thread keeps them with relaxed atomics, so fields may be a few samples apart.
+bool MLIMUUnity_GetStats(IMUStats* out_stats);
+
+// Restarts the statistics (applied by the capture thread on its next wake-up).
+void MLIMUUnity_ResetStats();
+
 // Shutdown
 void MLIMUUnity_Shutdown();
 
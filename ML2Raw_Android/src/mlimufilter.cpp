@@ -0,0 +1,171 @@
+#include "mlimufilter.h"
+
+#include <cmath>
+
+static constexpr float STANDARD_GRAVITY = 9.80665f;
+
+void OrientationFilter::Configure(int32_t type, float gain, float biasGain) {
+    m_type = type == Mahony ? Mahony : Madgwick;
+    m_gain = gain > 0.0f ? gain : (m_type == Mahony ? DEFAULT_MAHONY_GAIN : DEFAULT_MADGWICK_GAIN);
+    m_biasGain = biasGain > 0.0f ? biasGain : 0.0f;
+    Reset();
+}
+
+void OrientationFilter::Reset() {
+    m_initialized = false;
+    m_q0 = 1.0f;
+    m_q1 = m_q2 = m_q3 = 0.0f;
+    m_bias[0] = m_bias[1] = m_bias[2] = 0.0f;
+}
+
+void OrientationFilter::InitFromAccel(const float accel[3]) {
+    const float norm = std::sqrt(accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2]);
+    if (!(norm > 0.0f)) return;
+
+    // Shortest rotation taking the measured up direction a onto earth +z:
+    // q = normalize(1 + a.z, a.y, -a.x, 0)
+    const float ax = accel[0] / norm, ay = accel[1] / norm, az = accel[2] / norm;
+    if (az < -0.9999f) {
+        // Upside down: any 180° turn about a horizontal axis
+        m_q0 = 0.0f;
+        m_q1 = 1.0f;
+        m_q2 = m_q3 = 0.0f;
+    } else {
+        float w = 1.0f + az, x = ay, y = -ax;
+        const float inv = 1.0f / std::sqrt(w * w + x * x + y * y);
+        m_q0 = w * inv;
+        m_q1 = x * inv;
+        m_q2 = y * inv;
+        m_q3 = 0.0f;
+    }
+    m_initialized = true;
+}
+
+void OrientationFilter::Update(const float gyro[3], const float accel[3], float dt) {
+    if (!m_initialized) {
+        if (accel) InitFromAccel(accel);
+        return;
+    }
+    if (!(dt > 0.0f)) return;
+
+    if (m_type == Mahony) {
+        UpdateMahony(gyro[0], gyro[1], gyro[2], accel, dt);
+    } else {
+        UpdateMadgwick(gyro[0], gyro[1], gyro[2], accel, dt);
+    }
+}
+
+// Madgwick, "An efficient orientation filter for inertial and
+// inertial/magnetic sensor arrays" (IMU variant)
+void OrientationFilter::UpdateMadgwick(float gx, float gy, float gz, const float* accel, float dt) {
+    float q0 = m_q0, q1 = m_q1, q2 = m_q2, q3 = m_q3;
+
+    // Rate of change of the quaternion from the gyroscope
+    float qDot1 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    float qDot2 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    float qDot3 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    float qDot4 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    float ax = accel ? accel[0] : 0.0f, ay = accel ? accel[1] : 0.0f, az = accel ? accel[2] : 0.0f;
+    float norm2 = ax * ax + ay * ay + az * az;
+    if (norm2 > 0.0f) {
+        float inv = 1.0f / std::sqrt(norm2);
+        ax *= inv;
+        ay *= inv;
+        az *= inv;
+
+        const float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+        const float _4q0 = 4.0f * q0, _4q1 = 4.0f * q1, _4q2 = 4.0f * q2;
+        const float _8q1 = 8.0f * q1, _8q2 = 8.0f * q2;
+        const float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+
+        // Gradient of the gravity direction error
+        float s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+        float s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+        float s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+        float s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+        float sNorm2 = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+        if (sNorm2 > 0.0f) {
+            inv = 1.0f / std::sqrt(sNorm2);
+            qDot1 -= m_gain * s0 * inv;
+            qDot2 -= m_gain * s1 * inv;
+            qDot3 -= m_gain * s2 * inv;
+            qDot4 -= m_gain * s3 * inv;
+        }
+    }
+
+    q0 += qDot1 * dt;
+    q1 += qDot2 * dt;
+    q2 += qDot3 * dt;
+    q3 += qDot4 * dt;
+
+    const float inv = 1.0f / std::sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    m_q0 = q0 * inv;
+    m_q1 = q1 * inv;
+    m_q2 = q2 * inv;
+    m_q3 = q3 * inv;
+}
+
+// Mahony et al., "Nonlinear complementary filters on the special orthogonal group"
+void OrientationFilter::UpdateMahony(float gx, float gy, float gz, const float* accel, float dt) {
+    float q0 = m_q0, q1 = m_q1, q2 = m_q2, q3 = m_q3;
+
+    float ax = accel ? accel[0] : 0.0f, ay = accel ? accel[1] : 0.0f, az = accel ? accel[2] : 0.0f;
+    float norm2 = ax * ax + ay * ay + az * az;
+    if (norm2 > 0.0f) {
+        const float inv = 1.0f / std::sqrt(norm2);
+        ax *= inv;
+        ay *= inv;
+        az *= inv;
+
+        // Estimated up direction in the sensor frame
+        const float vx = 2.0f * (q1 * q3 - q0 * q2);
+        const float vy = 2.0f * (q0 * q1 + q2 * q3);
+        const float vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+
+        // Error = measured x estimated
+        const float ex = ay * vz - az * vy;
+        const float ey = az * vx - ax * vz;
+        const float ez = ax * vy - ay * vx;
+
+        if (m_biasGain > 0.0f) {
+            m_bias[0] += m_biasGain * ex * dt;
+            m_bias[1] += m_biasGain * ey * dt;
+            m_bias[2] += m_biasGain * ez * dt;
+        }
+        gx += m_gain * ex;
+        gy += m_gain * ey;
+        gz += m_gain * ez;
+    }
+    gx += m_bias[0];
+    gy += m_bias[1];
+    gz += m_bias[2];
+
+    // Integrate the quaternion rate
+    const float hx = 0.5f * gx * dt, hy = 0.5f * gy * dt, hz = 0.5f * gz * dt;
+    const float a = q0, b = q1, c = q2;
+    q0 += -b * hx - c * hy - q3 * hz;
+    q1 += a * hx + c * hz - q3 * hy;
+    q2 += a * hy - b * hz + q3 * hx;
+    q3 += a * hz + b * hy - c * hx;
+
+    const float inv = 1.0f / std::sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    m_q0 = q0 * inv;
+    m_q1 = q1 * inv;
+    m_q2 = q2 * inv;
+    m_q3 = q3 * inv;
+}
+
+void OrientationFilter::Quaternion(float out[4]) const {
+    out[0] = m_q1;
+    out[1] = m_q2;
+    out[2] = m_q3;
+    out[3] = m_q0;
+}
+
+void OrientationFilter::Gravity(float out[3]) const {
+    // Earth +z expressed in the sensor frame
+    out[0] = STANDARD_GRAVITY * 2.0f * (m_q1 * m_q3 - m_q0 * m_q2);
+    out[1] = STANDARD_GRAVITY * 2.0f * (m_q0 * m_q1 + m_q2 * m_q3);
+    out[2] = STANDARD_GRAVITY * (m_q0 * m_q0 - m_q1 * m_q1 - m_q2 * m_q2 + m_q3 * m_q3);
+}
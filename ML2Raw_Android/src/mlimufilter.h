@@ -0,0 +1,52 @@
+#pragma once
+// Internal C++ helper for the IMU module (not part of the Unity API).
+//
+// OrientationFilter fuses gyroscope and accelerometer samples into an
+// orientation quaternion, one gyro sample at a time, with either
+//   - Madgwick: gradient-descent correction towards the measured gravity
+//     direction, step size = gain (beta), or
+//   - Mahony: proportional-integral feedback on the gravity direction error,
+//     gain = Kp, biasGain = Ki (estimates the gyro bias; 0 = off).
+// The earth frame has +z along the measured specific force (up); without a
+// magnetometer the heading is only held by the gyro and drifts slowly.
+// No allocation, no Android dependencies.
+
+#include <cstdint>
+
+class OrientationFilter {
+public:
+    enum Type { Madgwick = 1, Mahony = 2 };
+
+    static constexpr float DEFAULT_MADGWICK_GAIN = 0.033f;
+    static constexpr float DEFAULT_MAHONY_GAIN = 1.0f;
+
+    // gain <= 0 picks the default for the type
+    void Configure(int32_t type, float gain, float biasGain);
+    void Reset();
+
+    // Starts from the tilt given by an accelerometer sample (heading 0)
+    void InitFromAccel(const float accel[3]);
+    bool Initialized() const { return m_initialized; }
+
+    // One step: gyro (rad/s) over dt seconds, corrected with accel (m/s²,
+    // may be null when no sample is available)
+    void Update(const float gyro[3], const float accel[3], float dt);
+
+    // Sensor-to-earth rotation as x, y, z, w
+    void Quaternion(float out[4]) const;
+
+    // Gravity in the sensor frame as the accelerometer reads it at rest
+    // (pointing up, 9.80665 m/s²), so linear acceleration = accel - gravity
+    void Gravity(float out[3]) const;
+
+private:
+    void UpdateMadgwick(float gx, float gy, float gz, const float* accel, float dt);
+    void UpdateMahony(float gx, float gy, float gz, const float* accel, float dt);
+
+    int32_t m_type = Madgwick;
+    float m_gain = DEFAULT_MADGWICK_GAIN;
+    float m_biasGain = 0.0f;
+    bool m_initialized = false;
+    float m_q0 = 1.0f, m_q1 = 0.0f, m_q2 = 0.0f, m_q3 = 0.0f;  // w, x, y, z
+    float m_bias[3] = {0.0f, 0.0f, 0.0f};                      // Mahony integral term
+};
@@ -0,0 +1,470 @@
+#include "mlimupreint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+#include <android/log.h>
+
+#define LOG_TAG "MLIMUPreintUnity"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+
+// Samples kept per sensor (~8 s at 1 kHz)
+static constexpr size_t HISTORY_SIZE = 8192;
+
+// Samples pulled from the IMU module per drain call
+static constexpr int32_t DRAIN_CHUNK = 256;
+
+static constexpr float DEFAULT_GYRO_NOISE = 1.7e-4f;   // rad/s/sqrt(Hz)
+static constexpr float DEFAULT_ACCEL_NOISE = 2.0e-3f;  // m/s²/sqrt(Hz)
+
+// ---------- Sample tracks ----------
+
+// Read-only view of ascending samples, contiguous or in a ring
+struct Track {
+    const IMUVectorSample* data = nullptr;
+    size_t head = 0;
+    size_t count = 0;
+    size_t capacity = 0;
+
+    const IMUVectorSample& At(size_t i) const { return data[(head + i) % capacity]; }
+    bool Empty() const { return count == 0; }
+};
+
+// Walks a track forward in time and interpolates it
+struct Cursor {
+    const Track& track;
+    size_t index = 0;  // last sample at or before the current time
+
+    explicit Cursor(const Track& t) : track(t) {}
+
+    // First sample index with timestamp >= t
+    size_t LowerBound(int64_t t) const {
+        size_t lo = 0, hi = track.count;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (track.At(mid).timestamp_ns < t) lo = mid + 1; else hi = mid;
+        }
+        return lo;
+    }
+
+    void Seek(int64_t t) {
+        size_t i = LowerBound(t);
+        index = (i < track.count && track.At(i).timestamp_ns == t) || i == 0 ? i : i - 1;
+    }
+
+    // t must be within the track and not before the previous call
+    void Sample(int64_t t, double out[3]) {
+        while (index + 1 < track.count && track.At(index + 1).timestamp_ns <= t) index++;
+        const IMUVectorSample& a = track.At(index);
+        if (a.timestamp_ns >= t || index + 1 >= track.count) {
+            out[0] = a.x; out[1] = a.y; out[2] = a.z;
+            return;
+        }
+        const IMUVectorSample& b = track.At(index + 1);
+        const double s = (double)(t - a.timestamp_ns) / (double)(b.timestamp_ns - a.timestamp_ns);
+        out[0] = a.x + (b.x - a.x) * s;
+        out[1] = a.y + (b.y - a.y) * s;
+        out[2] = a.z + (b.z - a.z) * s;
+    }
+
+    // Timestamp of the next sample after t, or INT64_MAX
+    int64_t NextAfter(int64_t t) const {
+        size_t i = index;
+        while (i < track.count && track.At(i).timestamp_ns <= t) i++;
+        return i < track.count ? track.At(i).timestamp_ns : INT64_MAX;
+    }
+};
+
+// ---------- Small 3x3 / 9x9 helpers (row-major, double) ----------
+
+static void Mat3Mul(const double* a, const double* b, double* out) {
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            out[r * 3 + c] = a[r * 3 + 0] * b[0 * 3 + c] + a[r * 3 + 1] * b[1 * 3 + c] + a[r * 3 + 2] * b[2 * 3 + c];
+        }
+    }
+}
+
+static void Mat3MulVec(const double* m, const double* v, double* out) {
+    out[0] = m[0] * v[0] + m[1] * v[1] + m[2] * v[2];
+    out[1] = m[3] * v[0] + m[4] * v[1] + m[5] * v[2];
+    out[2] = m[6] * v[0] + m[7] * v[1] + m[8] * v[2];
+}
+
+static void Skew(const double* v, double* out) {
+    out[0] = 0.0;   out[1] = -v[2]; out[2] = v[1];
+    out[3] = v[2];  out[4] = 0.0;   out[5] = -v[0];
+    out[6] = -v[1]; out[7] = v[0];  out[8] = 0.0;
+}
+
+static void Identity3(double* out) {
+    memset(out, 0, 9 * sizeof(double));
+    out[0] = out[4] = out[8] = 1.0;
+}
+
+// SO(3) exponential and its right Jacobian
+static void ExpSO3(const double* phi, double* R, double* Jr) {
+    const double theta2 = phi[0] * phi[0] + phi[1] * phi[1] + phi[2] * phi[2];
+    const double theta = std::sqrt(theta2);
+    double K[9], K2[9];
+    Skew(phi, K);
+    Mat3Mul(K, K, K2);
+
+    double a, b, c, d;  // R = I + a K + b K², Jr = I - c K + d K²
+    if (theta < 1e-5) {
+        a = 1.0 - theta2 / 6.0;
+        b = 0.5 - theta2 / 24.0;
+        c = 0.5 - theta2 / 24.0;
+        d = 1.0 / 6.0 - theta2 / 120.0;
+    } else {
+        a = std::sin(theta) / theta;
+        b = (1.0 - std::cos(theta)) / theta2;
+        c = b;
+        d = (theta - std::sin(theta)) / (theta2 * theta);
+    }
+    Identity3(R);
+    Identity3(Jr);
+    for (int i = 0; i < 9; i++) {
+        R[i] += a * K[i] + b * K2[i];
+        Jr[i] += -c * K[i] + d * K2[i];
+    }
+}
+
+static void MatrixToQuaternion(const double* R, float* q) {
+    const double trace = R[0] + R[4] + R[8];
+    double x, y, z, w;
+    if (trace > 0.0) {
+        double s = std::sqrt(trace + 1.0) * 2.0;
+        w = 0.25 * s;
+        x = (R[7] - R[5]) / s;
+        y = (R[2] - R[6]) / s;
+        z = (R[3] - R[1]) / s;
+    } else if (R[0] > R[4] && R[0] > R[8]) {
+        double s = std::sqrt(1.0 + R[0] - R[4] - R[8]) * 2.0;
+        w = (R[7] - R[5]) / s;
+        x = 0.25 * s;
+        y = (R[1] + R[3]) / s;
+        z = (R[2] + R[6]) / s;
+    } else if (R[4] > R[8]) {
+        double s = std::sqrt(1.0 + R[4] - R[0] - R[8]) * 2.0;
+        w = (R[2] - R[6]) / s;
+        x = (R[1] + R[3]) / s;
+        y = 0.25 * s;
+        z = (R[5] + R[7]) / s;
+    } else {
+        double s = std::sqrt(1.0 + R[8] - R[0] - R[4]) * 2.0;
+        w = (R[3] - R[1]) / s;
+        x = (R[2] + R[6]) / s;
+        y = (R[5] + R[7]) / s;
+        z = 0.25 * s;
+    }
+    const double n = std::sqrt(x * x + y * y + z * z + w * w);
+    q[0] = (float)(x / n);
+    q[1] = (float)(y / n);
+    q[2] = (float)(z / n);
+    q[3] = (float)(w / n);
+}
+
+// ---------- Preintegration ----------
+
+struct PreintState {
+    double dR[9], dv[3], dp[3];
+    double cov[81];
+    double JRbg[9], Jvbg[9], Jvba[9], Jpbg[9], Jpba[9];
+};
+
+// One step with bias-corrected midpoint rates w (rad/s) and a (m/s²)
+static void PreintStep(PreintState& s, const double* w, const double* a, double dt, double gyroVar, double accelVar) {
+    const double dt2 = dt * dt;
+    double phi[3] = {w[0] * dt, w[1] * dt, w[2] * dt};
+    double dRstep[9], Jr[9];
+    ExpSO3(phi, dRstep, Jr);
+
+    // The mean rotates a by the midpoint orientation of the step (second order);
+    // covariance and Jacobians use the usual first-order terms
+    double halfPhi[3] = {0.5 * phi[0], 0.5 * phi[1], 0.5 * phi[2]};
+    double dRhalf[9], JrHalf[9], dRmid[9];
+    ExpSO3(halfPhi, dRhalf, JrHalf);
+    Mat3Mul(s.dR, dRhalf, dRmid);
+
+    double ra[3], aSkew[9], RaSkew[9];
+    Mat3MulVec(dRmid, a, ra);
+    Skew(a, aSkew);
+    Mat3Mul(s.dR, aSkew, RaSkew);  // dR [a]x
+
+    // Covariance: cov = A cov A^T + B Q B^T, built blockwise
+    double A[81] = {};
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            A[r * 9 + c] = dRstep[c * 3 + r];                        // Exp(phi)^T
+            A[(3 + r) * 9 + c] = -RaSkew[r * 3 + c] * dt;            // -dR [a]x dt
+            A[(6 + r) * 9 + c] = -0.5 * RaSkew[r * 3 + c] * dt2;     // -0.5 dR [a]x dt²
+        }
+        A[(3 + r) * 9 + 3 + r] = 1.0;
+        A[(6 + r) * 9 + 6 + r] = 1.0;
+        A[(6 + r) * 9 + 3 + r] = dt;
+    }
+    double B[54] = {};  // 9x6
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            B[r * 6 + c] = Jr[r * 3 + c] * dt;
+            B[(3 + r) * 6 + 3 + c] = s.dR[r * 3 + c] * dt;
+            B[(6 + r) * 6 + 3 + c] = 0.5 * s.dR[r * 3 + c] * dt2;
+        }
+    }
+    // Discrete noise from the densities
+    const double qg = gyroVar / dt, qa = accelVar / dt;
+
+    double AC[81];
+    for (int r = 0; r < 9; r++) {
+        for (int c = 0; c < 9; c++) {
+            double sum = 0.0;
+            for (int k = 0; k < 9; k++) sum += A[r * 9 + k] * s.cov[k * 9 + c];
+            AC[r * 9 + c] = sum;
+        }
+    }
+    for (int r = 0; r < 9; r++) {
+        for (int c = 0; c < 9; c++) {
+            double sum = 0.0;
+            for (int k = 0; k < 9; k++) sum += AC[r * 9 + k] * A[c * 9 + k];
+            for (int k = 0; k < 6; k++) sum += B[r * 6 + k] * B[c * 6 + k] * (k < 3 ? qg : qa);
+            s.cov[r * 9 + c] = sum;
+        }
+    }
+
+    // Bias Jacobians (position first: it uses the old velocity terms)
+    double tmp[9];
+    Mat3Mul(RaSkew, s.JRbg, tmp);  // dR [a]x J_R_bg
+    for (int i = 0; i < 9; i++) {
+        s.Jpba[i] += s.Jvba[i] * dt - 0.5 * s.dR[i] * dt2;
+        s.Jpbg[i] += s.Jvbg[i] * dt - 0.5 * tmp[i] * dt2;
+        s.Jvba[i] -= s.dR[i] * dt;
+        s.Jvbg[i] -= tmp[i] * dt;
+    }
+    double JRnew[9];
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            JRnew[r * 3 + c] = dRstep[0 * 3 + r] * s.JRbg[0 * 3 + c] + dRstep[1 * 3 + r] * s.JRbg[1 * 3 + c] +
+                               dRstep[2 * 3 + r] * s.JRbg[2 * 3 + c] - Jr[r * 3 + c] * dt;
+        }
+    }
+    memcpy(s.JRbg, JRnew, sizeof(JRnew));
+
+    // Mean
+    for (int i = 0; i < 3; i++) {
+        s.dp[i] += s.dv[i] * dt + 0.5 * ra[i] * dt2;
+        s.dv[i] += ra[i] * dt;
+    }
+    double Rnew[9];
+    Mat3Mul(s.dR, dRstep, Rnew);
+    memcpy(s.dR, Rnew, sizeof(Rnew));
+}
+
+static bool Preintegrate(const Track& accel, const Track& gyro, int64_t t0, int64_t t1,
+                         const float* bg, const float* ba, const IMUPreintNoise& noise, IMUPreintegration* out) {
+    if (t1 <= t0 || accel.Empty() || gyro.Empty()) return false;
+    if (accel.At(0).timestamp_ns > t0 || gyro.At(0).timestamp_ns > t0) return false;
+    if (accel.At(accel.count - 1).timestamp_ns < t1 || gyro.At(gyro.count - 1).timestamp_ns < t1) return false;
+
+    PreintState s;
+    Identity3(s.dR);
+    memset(s.dv, 0, sizeof(s.dv));
+    memset(s.dp, 0, sizeof(s.dp));
+    memset(s.cov, 0, sizeof(s.cov));
+    memset(s.JRbg, 0, sizeof(s.JRbg));
+    memset(s.Jvbg, 0, sizeof(s.Jvbg));
+    memset(s.Jvba, 0, sizeof(s.Jvba));
+    memset(s.Jpbg, 0, sizeof(s.Jpbg));
+    memset(s.Jpba, 0, sizeof(s.Jpba));
+
+    const double gyroVar = (double)noise.gyro_noise_density * noise.gyro_noise_density;
+    const double accelVar = (double)noise.accel_noise_density * noise.accel_noise_density;
+
+    Cursor ac(accel), gc(gyro);
+    ac.Seek(t0);
+    gc.Seek(t0);
+
+    // Steps run over the merged timestamps of both sensors
+    int64_t t = t0;
+    double w0[3], a0[3];
+    gc.Sample(t, w0);
+    ac.Sample(t, a0);
+    while (t < t1) {
+        int64_t next = std::min(std::min(ac.NextAfter(t), gc.NextAfter(t)), t1);
+        double w1[3], a1[3];
+        gc.Sample(next, w1);
+        ac.Sample(next, a1);
+
+        const double dt = (double)(next - t) * 1e-9;
+        double w[3], a[3];
+        for (int i = 0; i < 3; i++) {
+            w[i] = 0.5 * (w0[i] + w1[i]) - bg[i];
+            a[i] = 0.5 * (a0[i] + a1[i]) - ba[i];
+        }
+        PreintStep(s, w, a, dt, gyroVar, accelVar);
+
+        memcpy(w0, w1, sizeof(w0));
+        memcpy(a0, a1, sizeof(a0));
+        t = next;
+    }
+
+    out->start_ns = t0;
+    out->end_ns = t1;
+    MatrixToQuaternion(s.dR, out->delta_rotation);
+    for (int i = 0; i < 3; i++) {
+        out->delta_velocity[i] = (float)s.dv[i];
+        out->delta_position[i] = (float)s.dp[i];
+        out->gyro_bias[i] = bg[i];
+        out->accel_bias[i] = ba[i];
+    }
+    for (int i = 0; i < 81; i++) out->covariance[i] = (float)s.cov[i];
+    for (int i = 0; i < 9; i++) {
+        out->d_rotation_d_gyro_bias[i] = (float)s.JRbg[i];
+        out->d_velocity_d_gyro_bias[i] = (float)s.Jvbg[i];
+        out->d_velocity_d_accel_bias[i] = (float)s.Jvba[i];
+        out->d_position_d_gyro_bias[i] = (float)s.Jpbg[i];
+        out->d_position_d_accel_bias[i] = (float)s.Jpba[i];
+    }
+    out->gyro_sample_count = (int32_t)(Cursor(gyro).LowerBound(t1 + 1) - Cursor(gyro).LowerBound(t0));
+    out->accel_sample_count = (int32_t)(Cursor(accel).LowerBound(t1 + 1) - Cursor(accel).LowerBound(t0));
+    return true;
+}
+
+// ---------- Live history ----------
+
+struct History {
+    IMUVectorSample samples[HISTORY_SIZE];
+    size_t head = 0;
+    size_t count = 0;
+
+    void Clear() { head = count = 0; }
+
+    void Append(const IMUVectorSample* in, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            // Keep timestamps strictly ascending
+            if (count > 0 && in[i].timestamp_ns <= samples[(head + count - 1) % HISTORY_SIZE].timestamp_ns) continue;
+            if (count == HISTORY_SIZE) {
+                head = (head + 1) % HISTORY_SIZE;
+                count--;
+            }
+            samples[(head + count) % HISTORY_SIZE] = in[i];
+            count++;
+        }
+    }
+
+    Track View() const {
+        Track t;
+        t.data = samples;
+        t.head = head;
+        t.count = count;
+        t.capacity = HISTORY_SIZE;
+        return t;
+    }
+};
+
+static std::mutex g_lock;
+static bool g_running = false;
+static IMUPreintNoise g_noise = {DEFAULT_GYRO_NOISE, DEFAULT_ACCEL_NOISE};
+static float g_gyroBias[3] = {0.0f, 0.0f, 0.0f};
+static float g_accelBias[3] = {0.0f, 0.0f, 0.0f};
+static History g_accelHistory;
+static History g_gyroHistory;
+
+// Pulls everything the IMU thread has queued since the last call (g_lock held)
+static void DrainImu() {
+    IMUVectorSample chunk[DRAIN_CHUNK];
+    int32_t n = 0;
+    while (MLIMUUnity_GetSecondaryAccel(chunk, DRAIN_CHUNK, &n)) g_accelHistory.Append(chunk, (size_t)n);
+    while (MLIMUUnity_GetSecondaryGyro(chunk, DRAIN_CHUNK, &n)) g_gyroHistory.Append(chunk, (size_t)n);
+}
+
+bool MLIMUPreintUnity_Start(const IMUPreintNoise* noise) {
+    if (!MLIMUUnity_IsInitialized()) {
+        LOGE("IMU not initialized");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_lock);
+    g_noise.gyro_noise_density = noise && noise->gyro_noise_density > 0.0f ? noise->gyro_noise_density : DEFAULT_GYRO_NOISE;
+    g_noise.accel_noise_density = noise && noise->accel_noise_density > 0.0f ? noise->accel_noise_density : DEFAULT_ACCEL_NOISE;
+    g_accelHistory.Clear();
+    g_gyroHistory.Clear();
+    MLIMUUnity_EnableSecondaryStreams(true);
+    g_running = true;
+
+    LOGI("Preintegration started (gyro noise %g, accel noise %g)",
+         g_noise.gyro_noise_density, g_noise.accel_noise_density);
+    return true;
+}
+
+void MLIMUPreintUnity_SetBias(const float gyro_bias[3], const float accel_bias[3]) {
+    std::lock_guard<std::mutex> lock(g_lock);
+    for (int i = 0; i < 3; i++) {
+        g_gyroBias[i] = gyro_bias ? gyro_bias[i] : 0.0f;
+        g_accelBias[i] = accel_bias ? accel_bias[i] : 0.0f;
+    }
+}
+
+bool MLIMUPreintUnity_Integrate(int64_t start_ns, int64_t end_ns, IMUPreintegration* out) {
+    if (!out) return false;
+
+    std::lock_guard<std::mutex> lock(g_lock);
+    if (!g_running) return false;
+    DrainImu();
+    return Preintegrate(g_accelHistory.View(), g_gyroHistory.View(), start_ns, end_ns,
+                        g_gyroBias, g_accelBias, g_noise, out);
+}
+
+bool MLIMUPreintUnity_GetCoverage(int64_t* out_oldest_ns, int64_t* out_newest_ns) {
+    if (!out_oldest_ns || !out_newest_ns) return false;
+
+    std::lock_guard<std::mutex> lock(g_lock);
+    if (!g_running) return false;
+    DrainImu();
+    if (g_accelHistory.count == 0 || g_gyroHistory.count == 0) return false;
+
+    const Track a = g_accelHistory.View(), g = g_gyroHistory.View();
+    *out_oldest_ns = std::max(a.At(0).timestamp_ns, g.At(0).timestamp_ns);
+    *out_newest_ns = std::min(a.At(a.count - 1).timestamp_ns, g.At(g.count - 1).timestamp_ns);
+    return *out_newest_ns >= *out_oldest_ns;
+}
+
+void MLIMUPreintUnity_Stop() {
+    std::lock_guard<std::mutex> lock(g_lock);
+    if (!g_running) return;
+    MLIMUUnity_EnableSecondaryStreams(false);
+    g_accelHistory.Clear();
+    g_gyroHistory.Clear();
+    g_running = false;
+    LOGI("Preintegration stopped");
+}
+
+bool MLIMUPreintUnity_IntegrateSamples(
+    const IMUVectorSample* accel,
+    int32_t accel_count,
+    const IMUVectorSample* gyro,
+    int32_t gyro_count,
+    int64_t start_ns,
+    int64_t end_ns,
+    const float gyro_bias[3],
+    const float accel_bias[3],
+    const IMUPreintNoise* noise,
+    IMUPreintegration* out)
+{
+    if (!accel || !gyro || accel_count <= 0 || gyro_count <= 0 || !out) return false;
+
+    Track a, g;
+    a.data = accel;
+    a.count = a.capacity = (size_t)accel_count;
+    g.data = gyro;
+    g.count = g.capacity = (size_t)gyro_count;
+
+    const float zero[3] = {0.0f, 0.0f, 0.0f};
+    IMUPreintNoise n = {DEFAULT_GYRO_NOISE, DEFAULT_ACCEL_NOISE};
+    if (noise) n = *noise;
+    return Preintegrate(a, g, start_ns, end_ns, gyro_bias ? gyro_bias : zero, accel_bias ? accel_bias : zero, n, out);
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mlimu.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Continuous-time white noise of the IMU, used for the covariance
+typedef struct IMUPreintNoise {
+    float gyro_noise_density;   // rad/s/sqrt(Hz)
+    float accel_noise_density;  // m/s²/sqrt(Hz)
+} IMUPreintNoise;
+
+// Preintegrated IMU measurement between two timestamps, expressed in the IMU
+// frame at start_ns (on-manifold preintegration; gravity is not removed):
+//   dR = prod Exp((w - bg) dt)
+//   dv = sum dR_k (a - ba) dt
+//   dp = sum dv_k dt + 0.5 dR_k (a - ba) dt²
+// Samples are linearly interpolated onto the merged accel/gyro timestamps and
+// each step uses the midpoint of its two ends.
+// Matrices are row-major; the error state is [dphi, dv, dp] (9x9 covariance).
+typedef struct IMUPreintegration {
+    int64_t start_ns;
+    int64_t end_ns;
+    float delta_rotation[4];          // quaternion x, y, z, w
+    float delta_velocity[3];          // m/s
+    float delta_position[3];          // m
+    float covariance[81];
+    // First-order bias correction for a bias change (dbg, dba):
+    //   dR' = dR Exp(J_R_bg dbg)
+    //   dv' = dv + J_v_bg dbg + J_v_ba dba
+    //   dp' = dp + J_p_bg dbg + J_p_ba dba
+    float d_rotation_d_gyro_bias[9];
+    float d_velocity_d_gyro_bias[9];
+    float d_velocity_d_accel_bias[9];
+    float d_position_d_gyro_bias[9];
+    float d_position_d_accel_bias[9];
+    float gyro_bias[3];               // biases the measurement was computed with
+    float accel_bias[3];
+    int32_t gyro_sample_count;        // samples inside [start_ns, end_ns]
+    int32_t accel_sample_count;
+} IMUPreintegration;
+
+// Starts keeping a few seconds of IMU history for MLIMUPreintUnity_Integrate.
+// MLIMUUnity_Init must have been called. noise: null = typical MEMS values.
+bool MLIMUPreintUnity_Start(const IMUPreintNoise* noise);
+
+// Bias estimate subtracted by later integrations (e.g. fed back by the VIO).
+void MLIMUPreintUnity_SetBias(const float gyro_bias[3], const float accel_bias[3]);
+
+// Preintegrates the stream between two IMU-clock timestamps, e.g. consecutive
+// world camera timestampNs. Returns false while end_ns is newer than the
+// latest sample of either sensor (retry later) or if start_ns has already
+// left the history.
+bool MLIMUPreintUnity_Integrate(int64_t start_ns, int64_t end_ns, IMUPreintegration* out);
+
+// Time range currently covered by both sensors.
+bool MLIMUPreintUnity_GetCoverage(int64_t* out_oldest_ns, int64_t* out_newest_ns);
+
+void MLIMUPreintUnity_Stop();
+
+// Same computation on caller-provided samples (ascending timestamps), for
+// replaying recordings. gyro_bias/accel_bias/noise may be null.
+bool MLIMUPreintUnity_IntegrateSamples(
+    const IMUVectorSample* accel,
+    int32_t accel_count,
+    const IMUVectorSample* gyro,
+    int32_t gyro_count,
+    int64_t start_ns,
+    int64_t end_ns,
+    const float gyro_bias[3],
+    const float accel_bias[3],
+    const IMUPreintNoise* noise,
+    IMUPreintegration* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,10 +1,14 @@
 #include "mlrgbcamera.h"
 #include "mlcvcamera.h"  // Reuse existing CV camera functions
+#include "mlyuv.h"
 
 #include <atomic>
+#include <chrono>
+#include <climits>
 #include <mutex>
 #include <condition_variable>
 #include <cstring>
+#include <thread>
 #include <vector>
 
 #include <android/log.h>
@@ -24,13 +28,90 @@ static std::atomic<bool> g_initialized{false};
 static std::atomic<bool> g_capturing{false};
 static std::atomic<uint64_t> g_frameCount{0};
 
+// Serializes StartCapture and StopCapture, which calls into the camera
+// without g_mutex (lock order: g_captureControlMutex, then g_mutex)
+static std::mutex g_captureControlMutex;
+
 // Camera handle
 static MLCameraContext g_cameraContext = ML_INVALID_HANDLE;
 
-// Frame buffer (single latest frame)
-static RGBFrameWithPose g_latestFrameInfo;
-static std::vector<uint8_t> g_latestFrameData;
-static bool g_hasNewFrame = false;
+// Unity marshals this by layout; new per-frame data goes in new structs or calls
+static_assert(sizeof(RGBFrameWithPose) == 80, "RGBFrameWithPose layout is part of the plugin ABI");
+
+// Frame pool, allocated by StartCapture. Each slot index is in exactly one
+// place: the free list, the queue, or held by the callback filling it or a
+// reader copying it out (g_slotsInUse), so slot contents are used without
+// g_mutex. The lists are guarded by g_mutex.
+struct FrameSlot {
+    RGBFrameWithPose info;
+    bool posePending;            // pose fields not filled in yet (lookup still running)
+    RGBFrameLayout layout;       // planes of data (native or repacked by the callback)
+    std::vector<uint8_t> data;   // preallocated; the frame is the first size bytes
+    size_t size;
+};
+
+static std::vector<FrameSlot> g_pool;
+static std::vector<int32_t> g_freeSlots;
+static std::vector<int32_t> g_queue;        // ring of slot indices, oldest at g_queueHead
+static int32_t g_queueHead = 0;
+static int32_t g_queueCount = 0;
+static int32_t g_slotsInUse = 0;
+static std::condition_variable g_slotCv;    // a slot was returned
+
+// Queue config (MLRGBCameraUnity_SetFrameQueue), changed only while not capturing
+static int32_t g_queueCapacity = 1;
+static int32_t g_dropPolicy = RGBDropPolicy_DropOldest;
+static uint32_t g_blockTimeoutMs = 0;
+
+// Queue statistics, guarded by g_mutex (g_framesGrown: callback only)
+static uint64_t g_framesDroppedOldest = 0;
+static uint64_t g_framesDroppedNewest = 0;
+static uint64_t g_framesSkipped = 0;
+static uint64_t g_blockTimeouts = 0;
+static float g_maxBlockUs = 0;
+static int32_t g_queueHighWater = 0;
+static std::atomic<int32_t> g_framesGrown{0};
+
+// Output format (MLRGBCameraUnity_SetOutputFormat), guarded by g_mutex
+static int32_t g_outputFormat = RGBOutputFormat_Native;
+static int32_t g_outputDownscale = 1;
+static bool g_outputLimitedRange = false;
+
+// Pose worker: the callback only records each frame timestamp in
+// g_poseHistory; MLCVCameraUnity_GetPose takes the CV camera lock and calls
+// into perception, so it runs on the worker once the buffer is returned.
+// Lookups that fail are retried until kPoseRetryWindowNs after the frame.
+struct PoseEntry {
+    int64_t timestampNs;
+    int64_t arrivalNs;       // steady clock, callback entry
+    int64_t nextAttemptNs;
+    int32_t state;           // RGBPoseState, Unknown = unused entry
+    int32_t resultCode;
+    CVCameraPose pose;
+};
+
+static const int64_t kPoseRetryIntervalNs = 2000000;    // 2 ms
+static const int64_t kPoseRetryWindowNs = 100000000;    // 100 ms
+
+// Guarded by g_poseMutex (lock order: g_mutex, then g_poseMutex; the worker
+// never holds g_poseMutex while taking g_mutex)
+static std::mutex g_poseMutex;
+static std::condition_variable g_poseCv;
+static PoseEntry g_poseHistory[RGB_POSE_HISTORY];
+static uint32_t g_poseNext = 0;             // slot of the next frame
+static bool g_poseWorkerRunning = false;
+static std::thread g_poseWorker;
+static uint64_t g_posesResolved = 0;
+static uint64_t g_posesFailed = 0;
+static uint64_t g_poseRetries = 0;
+static uint64_t g_poseQueueDrops = 0;
+static float g_maxPoseLatencyUs = 0;
+
+// Callback timing, written by the camera callback only
+static std::atomic<uint64_t> g_statFrames{0};
+static std::atomic<uint64_t> g_statCallbackTotalNs{0};
+static std::atomic<float> g_statLastCallbackUs{0};
+static std::atomic<float> g_statMaxCallbackUs{0};
 
 // Camera config
 static RGBCaptureMode g_captureMode = RGBCaptureMode_Video;
@@ -41,48 +122,434 @@ static void OnVideoBufferAvailable(const MLCameraOutput* output, const MLHandle
 static void OnCaptureCompleted(MLHandle request_handle, const MLCameraResultExtras* extra, void* data);
 static void OnCaptureFailed(const MLCameraResultExtras* extra, void* data);
 
-// Get camera pose using existing CV camera infrastructure
-static bool GetCameraPose(int64_t timestamp_ns, RGBFrameWithPose* out_info) {
-    // Check if CV camera is initialized
-    if (!MLCVCameraUnity_IsInitialized()) {
-        out_info->pose_valid = 0;
-        out_info->pose_result_code = -1;
-        if (g_debug) {
+static inline int64_t SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Copies a pose lookup into the pose fields of a frame
+static void FillPose(const PoseEntry& entry, RGBFrameWithPose* out_info) {
+    const bool valid = entry.state == RGBPoseState_Valid;
+    out_info->pose_rotation_x = valid ? entry.pose.rotation_x : 0;
+    out_info->pose_rotation_y = valid ? entry.pose.rotation_y : 0;
+    out_info->pose_rotation_z = valid ? entry.pose.rotation_z : 0;
+    out_info->pose_rotation_w = valid ? entry.pose.rotation_w : 1.0f;
+    out_info->pose_position_x = valid ? entry.pose.position_x : 0;
+    out_info->pose_position_y = valid ? entry.pose.position_y : 0;
+    out_info->pose_position_z = valid ? entry.pose.position_z : 0;
+    out_info->pose_valid = valid ? 1 : 0;
+    out_info->pose_result_code = entry.resultCode;
+}
+
+// Caller holds g_poseMutex
+static const PoseEntry* FindPose(int64_t timestamp_ns) {
+    for (uint32_t i = 0; i < RGB_POSE_HISTORY; i++) {
+        const PoseEntry& entry = g_poseHistory[i];
+        if (entry.state != RGBPoseState_Unknown && entry.timestampNs == timestamp_ns) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+// Called by the camera callback with g_mutex held, right after it queued the
+// frame; the oldest entry is overwritten when the worker falls
+// RGB_POSE_HISTORY frames behind
+static void QueuePoseLookup(int64_t timestamp_ns, int64_t arrival_ns) {
+    {
+        std::lock_guard<std::mutex> lock(g_poseMutex);
+        PoseEntry& entry = g_poseHistory[g_poseNext % RGB_POSE_HISTORY];
+        if (entry.state == RGBPoseState_Pending) {
+            g_poseQueueDrops++;
+        }
+        memset(&entry, 0, sizeof(entry));
+        entry.timestampNs = timestamp_ns;
+        entry.arrivalNs = arrival_ns;
+        entry.nextAttemptNs = arrival_ns;
+        entry.state = RGBPoseState_Pending;
+        g_poseNext++;
+    }
+    g_poseCv.notify_one();
+}
+
+// Patches the queued frame the lookup was for, if it is still queued
+static void ApplyPoseToQueued(const PoseEntry& entry) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    for (int32_t i = 0; i < g_queueCount; i++) {
+        FrameSlot& frame = g_pool[g_queue[(g_queueHead + i) % (int32_t)g_queue.size()]];
+        if (frame.info.timestampNs == entry.timestampNs && frame.posePending) {
+            FillPose(entry, &frame.info);
+            frame.posePending = false;
+        }
+    }
+}
+
+static void PoseWorkerLoop() {
+    std::unique_lock<std::mutex> lock(g_poseMutex);
+    
+    while (g_poseWorkerRunning) {
+        // Oldest lookup that is due, else sleep until the next retry
+        const int64_t now = SteadyNowNs();
+        int32_t due = -1;
+        int64_t wakeNs = INT64_MAX;
+        for (uint32_t i = 0; i < RGB_POSE_HISTORY; i++) {
+            const uint32_t slot = (g_poseNext + i) % RGB_POSE_HISTORY;
+            const PoseEntry& entry = g_poseHistory[slot];
+            if (entry.state != RGBPoseState_Pending) {
+                continue;
+            }
+            if (entry.nextAttemptNs <= now) {
+                due = (int32_t)slot;
+                break;
+            }
+            if (entry.nextAttemptNs < wakeNs) {
+                wakeNs = entry.nextAttemptNs;
+            }
+        }
+        
+        if (due < 0) {
+            if (wakeNs == INT64_MAX) {
+                g_poseCv.wait(lock);
+            } else {
+                g_poseCv.wait_for(lock, std::chrono::nanoseconds(wakeNs - now));
+            }
+            continue;
+        }
+        
+        const int64_t timestampNs = g_poseHistory[due].timestampNs;
+        lock.unlock();
+        
+        CVCameraPose pose;
+        memset(&pose, 0, sizeof(pose));
+        const bool cvReady = MLCVCameraUnity_IsInitialized();
+        const bool ok = cvReady && MLCVCameraUnity_GetPose(timestampNs, CVCameraID_ColorCamera, &pose) && pose.resultCode == 0;
+        const int64_t doneNs = SteadyNowNs();
+        
+        if (!cvReady && g_debug) {
             static int warnCount = 0;
             if (warnCount++ < 5) {
                 LOGW("CV Camera not initialized - cannot get pose. Initialize CVCameraNativeConsumer first.");
             }
         }
+        
+        lock.lock();
+        PoseEntry& entry = g_poseHistory[due];
+        if (entry.state != RGBPoseState_Pending || entry.timestampNs != timestampNs) {
+            continue;  // overwritten by a newer frame meanwhile
+        }
+        
+        entry.resultCode = cvReady ? pose.resultCode : -1;
+        if (ok) {
+            entry.pose = pose;
+            entry.state = RGBPoseState_Valid;
+            g_posesResolved++;
+            const float latencyUs = (float)(doneNs - entry.arrivalNs) * 1e-3f;
+            if (latencyUs > g_maxPoseLatencyUs) {
+                g_maxPoseLatencyUs = latencyUs;
+            }
+        } else if (cvReady && doneNs - entry.arrivalNs < kPoseRetryWindowNs) {
+            entry.nextAttemptNs = doneNs + kPoseRetryIntervalNs;
+            g_poseRetries++;
+            continue;
+        } else {
+            entry.state = RGBPoseState_Failed;
+            g_posesFailed++;
+        }
+        
+        const PoseEntry resolved = entry;
+        lock.unlock();
+        ApplyPoseToQueued(resolved);
+        lock.lock();
+    }
+}
+
+// Caller holds g_mutex; the worker only takes g_mutex after a lookup, which
+// waits until StartCapture returns
+static void StartPoseWorker() {
+    std::lock_guard<std::mutex> lock(g_poseMutex);
+    if (g_poseWorkerRunning) {
+        return;
+    }
+    g_posesResolved = 0;
+    g_posesFailed = 0;
+    g_poseRetries = 0;
+    g_poseQueueDrops = 0;
+    g_maxPoseLatencyUs = 0;
+    g_statFrames.store(0);
+    g_statCallbackTotalNs.store(0);
+    g_statLastCallbackUs.store(0);
+    g_statMaxCallbackUs.store(0);
+    
+    g_poseWorkerRunning = true;
+    g_poseWorker = std::thread(PoseWorkerLoop);
+}
+
+// Must not be called with g_mutex held. Lookups still pending are failed.
+static void StopPoseWorker() {
+    {
+        std::lock_guard<std::mutex> lock(g_poseMutex);
+        g_poseWorkerRunning = false;
+    }
+    g_poseCv.notify_all();
+    if (g_poseWorker.joinable()) {
+        g_poseWorker.join();
+    }
+    
+    std::lock_guard<std::mutex> lock(g_poseMutex);
+    for (PoseEntry& entry : g_poseHistory) {
+        if (entry.state == RGBPoseState_Pending) {
+            entry.state = RGBPoseState_Failed;
+            g_posesFailed++;
+        }
+    }
+}
+
+// Describes a YUV_420_888 frame for the converters, checking that the planes
+// really hold the rows and samples their layout claims. data[i] = plane i.
+static bool DescribeYuv(int32_t format, const RGBPlaneLayout* planes, int32_t planeCount, const uint8_t* const* data, YuvImage* out) {
+    if (format != MLCameraOutputFormat_YUV_420_888 || planeCount < 3) {
         return false;
     }
+    
+    const RGBPlaneLayout& y = planes[0];
+    const RGBPlaneLayout& u = planes[1];
+    const RGBPlaneLayout& v = planes[2];
+    const int64_t pixelStride = u.pixel_stride > 0 ? u.pixel_stride : 1;
+    const int64_t chromaWidth = (y.width + 1) / 2;
+    const int64_t chromaHeight = (y.height + 1) / 2;
+    if (y.width <= 0 || y.height <= 0 || y.row_stride < y.width || u.row_stride != v.row_stride ||
+        (v.pixel_stride > 0 ? v.pixel_stride : 1) != pixelStride || u.row_stride < chromaWidth * pixelStride - pixelStride + 1) {
+        return false;
+    }
+    
+    const int64_t ySpan = (int64_t)(y.height - 1) * y.row_stride + y.width;
+    const int64_t uvSpan = (chromaHeight - 1) * u.row_stride + (chromaWidth - 1) * pixelStride + 1;
+    if (ySpan > y.size || uvSpan > u.size || uvSpan > v.size) {
+        return false;
+    }
+    
+    out->y = data[0];
+    out->u = data[1];
+    out->v = data[2];
+    out->width = y.width;
+    out->height = y.height;
+    out->yStride = y.row_stride;
+    out->uvStride = u.row_stride;
+    out->uvPixelStride = (int32_t)pixelStride;
+    return true;
+}
+
+// Layout of a tightly packed NV12 / I420 frame
+static void PackedLayout(int32_t width, int32_t height, int32_t format, RGBFrameLayout* out) {
+    const int32_t chromaWidth = (width + 1) / 2;
+    const int32_t chromaHeight = (height + 1) / 2;
+    const int32_t lumaBytes = width * height;
+    const int32_t chromaBytes = chromaWidth * chromaHeight;
+    
+    memset(out, 0, sizeof(*out));
+    out->output_format = format;
+    out->plane_count = 3;
+    out->total_bytes = (int32_t)YuvPackedSize(width, height);
+    out->planes[0] = {0, width, height, width, 1, lumaBytes};
+    if (format == RGBOutputFormat_NV12) {
+        out->planes[1] = {lumaBytes, chromaWidth, chromaHeight, 2 * chromaWidth, 2, 2 * chromaBytes - 1};
+        out->planes[2] = {lumaBytes + 1, chromaWidth, chromaHeight, 2 * chromaWidth, 2, 2 * chromaBytes - 1};
+    } else {
+        out->planes[1] = {lumaBytes, chromaWidth, chromaHeight, chromaWidth, 1, chromaBytes};
+        out->planes[2] = {lumaBytes + chromaBytes, chromaWidth, chromaHeight, chromaWidth, 1, chromaBytes};
+    }
+}
 
-    // Use the existing CV camera API to get pose
-    CVCameraPose pose;
-    bool ok = MLCVCameraUnity_GetPose(timestamp_ns, CVCameraID_ColorCamera, &pose);
-
-    out_info->pose_result_code = pose.resultCode;
-
-    if (ok && pose.resultCode == 0) {
-        out_info->pose_rotation_x = pose.rotation_x;
-        out_info->pose_rotation_y = pose.rotation_y;
-        out_info->pose_rotation_z = pose.rotation_z;
-        out_info->pose_rotation_w = pose.rotation_w;
-        out_info->pose_position_x = pose.position_x;
-        out_info->pose_position_y = pose.position_y;
-        out_info->pose_position_z = pose.position_z;
-        out_info->pose_valid = 1;
-        return true;
+// Grows a slot for a frame larger than StartCapture planned for (rare: only
+// when the camera pads planes more than StreamFrameBytes assumes)
+static uint8_t* SlotBytes(FrameSlot* frame, size_t size) {
+    if (size > frame->data.size()) {
+        if (g_framesGrown.fetch_add(1) < 5) {
+            LOGW("Frame of %zu bytes exceeds its preallocated %zu bytes", size, frame->data.size());
+        }
+        frame->data.resize(size);
+    }
+    frame->size = size;
+    return frame->data.data();
+}
+
+// Copies the camera output into a slot: repacked to NV12/I420 when that output
+// format is selected, otherwise the planes as delivered, one after the other
+static void StoreFrame(const MLCameraOutput* output, int32_t outputFormat, FrameSlot* frame) {
+    const int32_t planeCount = output->plane_count < RGB_MAX_PLANES ? output->plane_count : RGB_MAX_PLANES;
+    RGBPlaneLayout camera[RGB_MAX_PLANES];
+    const uint8_t* planeData[RGB_MAX_PLANES];
+    for (int32_t i = 0; i < planeCount; i++) {
+        const MLCameraPlaneInfo& p = output->planes[i];
+        camera[i] = {0, (int32_t)p.width, (int32_t)p.height, (int32_t)p.stride, (int32_t)p.pixel_stride, (int32_t)p.size};
+        planeData[i] = p.data;
+    }
+    
+    if (outputFormat == RGBOutputFormat_NV12 || outputFormat == RGBOutputFormat_I420) {
+        YuvImage image;
+        if (DescribeYuv((int32_t)output->format, camera, planeCount, planeData, &image)) {
+            PackedLayout(image.width, image.height, outputFormat, &frame->layout);
+            uint8_t* bytes = SlotBytes(frame, (size_t)frame->layout.total_bytes);
+            YuvRepack(image, outputFormat == RGBOutputFormat_NV12 ? YuvPacking_NV12 : YuvPacking_I420, bytes);
+            frame->info.strideBytes = image.width;
+            return;
+        }
+        
+        static int warnCount = 0;
+        if (warnCount++ < 5) {
+            LOGW("Frame format %d can't be repacked, storing it as delivered", (int)output->format);
+        }
+    }
+    
+    size_t totalSize = 0;
+    for (uint8_t i = 0; i < output->plane_count; i++) {
+        totalSize += output->planes[i].size;
+    }
+    uint8_t* bytes = SlotBytes(frame, totalSize);
+    
+    RGBFrameLayout& layout = frame->layout;
+    memset(&layout, 0, sizeof(layout));
+    layout.output_format = RGBOutputFormat_Native;
+    layout.plane_count = planeCount;
+    layout.total_bytes = (int32_t)totalSize;
+    
+    size_t offset = 0;
+    for (uint8_t i = 0; i < output->plane_count; i++) {
+        memcpy(bytes + offset, output->planes[i].data, output->planes[i].size);
+        if (i < planeCount) {
+            layout.planes[i] = camera[i];
+            layout.planes[i].offset = (int32_t)offset;
+        }
+        offset += output->planes[i].size;
+    }
+}
+
+// Queue ring (caller holds g_mutex)
+static void QueuePush(int32_t slot) {
+    g_queue[(g_queueHead + g_queueCount) % (int32_t)g_queue.size()] = slot;
+    g_queueCount++;
+    if (g_queueCount > g_queueHighWater) {
+        g_queueHighWater = g_queueCount;
+    }
+}
+
+static int32_t QueuePopFront() {
+    const int32_t slot = g_queue[g_queueHead];
+    g_queueHead = (g_queueHead + 1) % (int32_t)g_queue.size();
+    g_queueCount--;
+    return slot;
+}
+
+static int32_t QueuePopBack() {
+    g_queueCount--;
+    return g_queue[(g_queueHead + g_queueCount) % (int32_t)g_queue.size()];
+}
+
+static bool QueueHasRoom() {
+    return g_queueCount < g_queueCapacity && !g_freeSlots.empty();
+}
+
+// Slot for the camera callback to fill, applying the drop policy when the
+// queue is full; -1 = drop the new frame. Caller holds g_mutex.
+static int32_t AcquireSlot(std::unique_lock<std::mutex>& lock) {
+    if (g_pool.empty()) {
+        return -1;
+    }
+    
+    if (!QueueHasRoom() && g_dropPolicy == RGBDropPolicy_Block && g_blockTimeoutMs > 0 && g_capturing.load()) {
+        const int64_t waitStartNs = SteadyNowNs();
+        if (!g_slotCv.wait_for(lock, std::chrono::milliseconds(g_blockTimeoutMs),
+                               [] { return QueueHasRoom() || !g_capturing.load(); })) {
+            g_blockTimeouts++;
+        }
+        const float waitedUs = (float)(SteadyNowNs() - waitStartNs) * 1e-3f;
+        if (waitedUs > g_maxBlockUs) {
+            g_maxBlockUs = waitedUs;
+        }
+    }
+    
+    int32_t slot = -1;
+    if (QueueHasRoom()) {
+        slot = g_freeSlots.back();
+        g_freeSlots.pop_back();
+    } else if (g_dropPolicy == RGBDropPolicy_DropOldest && g_queueCount > 0) {
+        slot = QueuePopFront();
+        g_framesDroppedOldest++;
     } else {
-        out_info->pose_rotation_x = 0;
-        out_info->pose_rotation_y = 0;
-        out_info->pose_rotation_z = 0;
-        out_info->pose_rotation_w = 1.0f;
-        out_info->pose_position_x = 0;
-        out_info->pose_position_y = 0;
-        out_info->pose_position_z = 0;
-        out_info->pose_valid = 0;
-        return false;
+        g_framesDroppedNewest++;
+        return -1;
     }
+    
+    g_slotsInUse++;
+    return slot;
+}
+
+// Returns a slot taken by AcquireSlot or a reader to the free list (caller holds g_mutex)
+static void ReleaseSlot(int32_t slot) {
+    g_freeSlots.push_back(slot);
+    g_slotsInUse--;
+}
+
+// Frame buffer size for the stream. Native YUV_420_888 frames store Y and
+// separate U and V plane copies (stride * height / 2 each when the chroma is
+// semi-planar), so 2 * stride * height covers them with the row stride
+// assumed padded to 64 bytes; this also covers NV12/I420 and JPEG.
+static size_t StreamFrameBytes(int32_t width, int32_t height) {
+    const size_t stride = ((size_t)width + 63) & ~(size_t)63;
+    return 2 * stride * (size_t)height;
+}
+
+// (Re)allocates the pool for the queue config, waiting for slots still held
+// by a reader or a late callback. Caller holds g_mutex via lock.
+static void AllocatePool(std::unique_lock<std::mutex>& lock, size_t frameBytes) {
+    g_slotCv.wait(lock, [] { return g_slotsInUse == 0; });
+    
+    const int32_t slotCount = g_queueCapacity + 2;
+    if ((int32_t)g_pool.size() != slotCount || g_pool[0].data.size() < frameBytes) {
+        std::vector<FrameSlot>().swap(g_pool);
+        g_pool.resize(slotCount);
+        for (FrameSlot& frame : g_pool) {
+            frame.data.resize(frameBytes);
+        }
+    }
+    for (FrameSlot& frame : g_pool) {
+        memset(&frame.info, 0, sizeof(frame.info));
+        frame.posePending = false;
+        memset(&frame.layout, 0, sizeof(frame.layout));
+        frame.size = 0;
+    }
+    
+    g_freeSlots.clear();
+    g_freeSlots.reserve(slotCount);
+    for (int32_t i = slotCount - 1; i >= 0; i--) {
+        g_freeSlots.push_back(i);
+    }
+    g_queue.assign(g_queueCapacity, -1);
+    g_queueHead = 0;
+    g_queueCount = 0;
+    
+    g_framesDroppedOldest = 0;
+    g_framesDroppedNewest = 0;
+    g_framesSkipped = 0;
+    g_blockTimeouts = 0;
+    g_maxBlockUs = 0;
+    g_queueHighWater = 0;
+    g_framesGrown.store(0);
+    
+    LOGI("Frame pool: %d x %zu bytes, queue %d, drop policy %d",
+         (int)slotCount, frameBytes, (int)g_queueCapacity, (int)g_dropPolicy);
+}
+
+static void RecordCallbackTime(int64_t callbackStartNs, float* out_us) {
+    const uint64_t callbackNs = (uint64_t)(SteadyNowNs() - callbackStartNs);
+    const float callbackUs = (float)callbackNs * 1e-3f;
+    g_statFrames.fetch_add(1, std::memory_order_relaxed);
+    g_statCallbackTotalNs.fetch_add(callbackNs, std::memory_order_relaxed);
+    g_statLastCallbackUs.store(callbackUs, std::memory_order_relaxed);
+    if (callbackUs > g_statMaxCallbackUs.load(std::memory_order_relaxed)) {
+        g_statMaxCallbackUs.store(callbackUs, std::memory_order_relaxed);
+    }
+    *out_us = callbackUs;
 }
 
 // Video buffer callback - called by ML camera system
@@ -101,10 +568,28 @@ static void OnVideoBufferAvailable(const MLCameraOutput* output, const MLHandle
         return;
     }
 
+    const int64_t callbackStartNs = SteadyNowNs();
     int64_t timestamp_ns = (int64_t)extra->vcam_timestamp;
+    g_frameCount.fetch_add(1);
+
+    // Take a buffer from the pool (or make room per the drop policy)
+    int32_t slot;
+    int32_t outputFormat;
+    {
+        std::unique_lock<std::mutex> lock(g_mutex);
+        slot = AcquireSlot(lock);
+        outputFormat = g_outputFormat;
+    }
+    
+    float callbackUs;
+    if (slot < 0) {
+        RecordCallbackTime(callbackStartNs, &callbackUs);
+        return;
+    }
+    FrameSlot& frame = g_pool[slot];
 
     // Build frame info
-    RGBFrameWithPose info;
+    RGBFrameWithPose& info = frame.info;
     memset(&info, 0, sizeof(info));
     
     info.width = (int32_t)plane.width;
@@ -113,45 +598,36 @@ static void OnVideoBufferAvailable(const MLCameraOutput* output, const MLHandle
     info.format = (int32_t)output->format;
     info.timestampNs = timestamp_ns;
 
-    // Get camera pose for this frame's timestamp using existing CV camera
-    GetCameraPose(timestamp_ns, &info);
+    // Filled in by the pose worker, see QueuePoseLookup below
+    info.pose_rotation_w = 1.0f;
+    frame.posePending = true;
 
     // Intrinsics - set to 0, could be extracted from metadata if needed
     info.fx = info.fy = 0;
     info.cx = info.cy = 0;
 
-    // Calculate total size for all planes
-    size_t totalSize = 0;
-    for (uint8_t i = 0; i < output->plane_count; i++) {
-        totalSize += output->planes[i].size;
-    }
-
-    // Store frame
+    // Copy outside the lock, then queue the frame. The lookup is queued once
+    // the frame is, under the same lock: a pose resolved before the push
+    // would find no queued frame to patch, and a reader taking the frame
+    // would find no lookup to refresh from.
+    StoreFrame(output, outputFormat, &frame);
     {
         std::lock_guard<std::mutex> lock(g_mutex);
-        
-        g_latestFrameInfo = info;
-        
-        g_latestFrameData.resize(totalSize);
-        size_t offset = 0;
-        for (uint8_t i = 0; i < output->plane_count; i++) {
-            memcpy(g_latestFrameData.data() + offset, output->planes[i].data, output->planes[i].size);
-            offset += output->planes[i].size;
-        }
-        
-        g_hasNewFrame = true;
+        QueuePush(slot);
+        g_slotsInUse--;
+        QueuePoseLookup(timestamp_ns, callbackStartNs);
     }
     
     g_cv.notify_one();
-    g_frameCount.fetch_add(1);
+    g_slotCv.notify_all();
+    RecordCallbackTime(callbackStartNs, &callbackUs);
 
     if (g_debug && (g_frameCount.load() % 30 == 0)) {
-        LOGI("Frame %llu: %dx%d ts=%lld pose_valid=%d (r=%d)", 
+        LOGI("Frame %llu: %dx%d ts=%lld callback=%.0f us", 
              (unsigned long long)g_frameCount.load(),
              info.width, info.height, 
              (long long)timestamp_ns,
-             info.pose_valid,
-             info.pose_result_code);
+             callbackUs);
     }
 }
 
@@ -244,7 +720,8 @@ bool MLRGBCameraUnity_Init(RGBCaptureMode mode) {
 
 // Start capture
 bool MLRGBCameraUnity_StartCapture() {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    std::lock_guard<std::mutex> control(g_captureControlMutex);
+    std::unique_lock<std::mutex> lock(g_mutex);
 
     if (!g_initialized.load()) {
         LOGE("Not initialized");
@@ -290,6 +767,9 @@ bool MLRGBCameraUnity_StartCapture() {
              (unsigned long long)streamConfig.native_surface_handle);
     }
 
+    // Frame buffers for the whole capture, before the camera can deliver
+    AllocatePool(lock, StreamFrameBytes(streamConfig.width, streamConfig.height));
+
     MLHandle requestHandle = ML_INVALID_HANDLE;
     MLResult r = MLCameraPrepareCapture(g_cameraContext, &captureConfig, &requestHandle);
     if (r != MLResult_Ok) {
@@ -328,6 +808,7 @@ bool MLRGBCameraUnity_StartCapture() {
         LOGI("Image capture mode - use MLCameraCaptureImage() for capture");
     }
 
+    StartPoseWorker();
     g_capturing.store(true);
     LOGI("RGB Camera capture started");
     return true;
@@ -335,23 +816,95 @@ bool MLRGBCameraUnity_StartCapture() {
 
 // Stop capture
 void MLRGBCameraUnity_StopCapture() {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    std::lock_guard<std::mutex> control(g_captureControlMutex);
+    MLCameraContext context;
+    MLCameraCaptureType captureType;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
 
-    if (!g_capturing.load()) {
-        return;
+        if (!g_capturing.load()) {
+            return;
+        }
+        g_capturing.store(false);
+        context = g_cameraContext;
+        captureType = g_activeCaptureType;
     }
-
-    // Stop based on active capture type
-    if (g_activeCaptureType == MLCameraCaptureType_Video) {
-        MLCameraCaptureVideoStop(g_cameraContext);
+    g_slotCv.notify_all();  // a blocked callback stops waiting for readers
+    
+    // Without g_mutex: the stop waits for callbacks in flight, which take it
+    if (captureType == MLCameraCaptureType_Video) {
+        MLCameraCaptureVideoStop(context);
     }
     // Image mode doesn't have continuous capture to stop
     
-    g_capturing.store(false);
+    // Outside g_mutex: the worker may be waiting for it to patch a frame
+    StopPoseWorker();
     
     LOGI("RGB Camera capture stopped");
 }
 
+bool MLRGBCameraUnity_SetFrameQueue(int32_t capacity, RGBDropPolicy policy, uint32_t block_timeout_ms) {
+    if (capacity < 1 || capacity > RGB_MAX_QUEUED_FRAMES) {
+        LOGE("Queue capacity %d out of range (1..%d)", (int)capacity, RGB_MAX_QUEUED_FRAMES);
+        return false;
+    }
+    if (policy < RGBDropPolicy_DropOldest || policy > RGBDropPolicy_Block) {
+        LOGE("Unknown drop policy %d", (int)policy);
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_capturing.load()) {
+        LOGE("SetFrameQueue: stop capture first");
+        return false;
+    }
+    g_queueCapacity = capacity;
+    g_dropPolicy = policy;
+    g_blockTimeoutMs = block_timeout_ms;
+    
+    LOGI("Frame queue %d, drop policy %d, block timeout %u ms", (int)capacity, (int)policy, block_timeout_ms);
+    return true;
+}
+
+bool MLRGBCameraUnity_SetOutputFormat(RGBOutputFormat format, int32_t downscale, bool limited_range) {
+    if (format < RGBOutputFormat_Native || format > RGBOutputFormat_I420) {
+        LOGE("Unknown output format %d", (int)format);
+        return false;
+    }
+    if (downscale != 1 && downscale != 2 && downscale != 4) {
+        LOGE("Unsupported downscale %d (1, 2 or 4)", (int)downscale);
+        return false;
+    }
+    if (downscale != 1 && (format == RGBOutputFormat_NV12 || format == RGBOutputFormat_I420)) {
+        LOGE("NV12/I420 output can't be downscaled");
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_outputFormat = format;
+    g_outputDownscale = downscale;
+    g_outputLimitedRange = limited_range;
+    
+    LOGI("Output format %d, downscale %d, %s range", (int)format, (int)downscale, limited_range ? "limited" : "full");
+    return true;
+}
+
+// Picks up a pose resolved after the frame was queued
+static void RefreshPose(bool posePending, RGBFrameWithPose* out_info) {
+    if (!posePending) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_poseMutex);
+    const PoseEntry* entry = FindPose(out_info->timestampNs);
+    if (entry) {
+        FillPose(*entry, out_info);
+    }
+}
+
+static bool IsRgbFormat(int32_t format) {
+    return format == RGBOutputFormat_RGBA32 || format == RGBOutputFormat_RGB24 || format == RGBOutputFormat_BGRA32;
+}
+
 // Try to get latest frame
 bool MLRGBCameraUnity_TryGetLatestFrame(
     uint32_t timeout_ms,
@@ -359,6 +912,21 @@ bool MLRGBCameraUnity_TryGetLatestFrame(
     uint8_t* out_bytes,
     int32_t capacity_bytes,
     int32_t* out_bytes_written
+) {
+    return MLRGBCameraUnity_TryGetLatestFrameWithLayout(timeout_ms, out_info, nullptr, out_bytes, capacity_bytes, out_bytes_written);
+}
+
+// Takes the newest (releasing the older ones) or the oldest queued frame and
+// copies it out, converted per the output format. The slot is held without
+// g_mutex while copying, so the camera callback keeps filling others.
+static bool ReadFrame(
+    bool latest,
+    uint32_t timeout_ms,
+    RGBFrameWithPose* out_info,
+    RGBFrameLayout* out_layout,
+    uint8_t* out_bytes,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written
 ) {
     if (!out_info || !out_bytes_written) {
         return false;
@@ -369,28 +937,173 @@ bool MLRGBCameraUnity_TryGetLatestFrame(
     std::unique_lock<std::mutex> lock(g_mutex);
 
     // Wait for frame if needed
-    if (!g_hasNewFrame && timeout_ms > 0) {
-        g_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), []{ return g_hasNewFrame; });
+    if (g_queueCount == 0 && timeout_ms > 0) {
+        g_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), []{ return g_queueCount > 0; });
     }
 
-    if (!g_hasNewFrame) {
+    if (g_queueCount == 0) {
         return false;
     }
 
-    // Check capacity
-    int32_t required = (int32_t)g_latestFrameData.size();
+    const int32_t index = latest ? (g_queueHead + g_queueCount - 1) % (int32_t)g_queue.size() : g_queueHead;
+    const int32_t slot = g_queue[index];
+    FrameSlot& frame = g_pool[slot];
+
+    const uint8_t* planeData[RGB_MAX_PLANES];
+    for (int32_t i = 0; i < frame.layout.plane_count; i++) {
+        planeData[i] = frame.data.data() + frame.layout.planes[i].offset;
+    }
+    
+    // Output size, checked before the frame is taken
+    YuvImage image;
+    const bool convert = IsRgbFormat(g_outputFormat) &&
+        DescribeYuv(frame.info.format, frame.layout.planes, frame.layout.plane_count, planeData, &image);
+    const int32_t format = g_outputFormat;
+    const int32_t downscale = g_outputDownscale;
+    const YuvRange range = g_outputLimitedRange ? YuvRange_Limited : YuvRange_Full;
+    const RgbLayout layout = format == RGBOutputFormat_RGB24  ? RgbLayout_RGB
+                           : format == RGBOutputFormat_BGRA32 ? RgbLayout_BGRA
+                                                              : RgbLayout_RGBA;
+    int32_t outWidth = 0, outHeight = 0;
+    int64_t required = (int64_t)frame.size;
+    if (convert) {
+        YuvOutputSize(image, downscale, &outWidth, &outHeight);
+        required = (int64_t)outWidth * outHeight * RgbBytesPerPixel(layout);
+    }
     if (required > capacity_bytes) {
-        *out_bytes_written = required;
+        *out_bytes_written = (int32_t)required;
+        return false;
+    }
+    
+    bool freed = false;
+    if (latest) {
+        QueuePopBack();
+        while (g_queueCount > 0) {
+            g_freeSlots.push_back(QueuePopFront());
+            g_framesSkipped++;
+            freed = true;
+        }
+    } else {
+        QueuePopFront();
+    }
+    g_slotsInUse++;
+    lock.unlock();
+    if (freed) {
+        g_slotCv.notify_all();  // a blocked callback can have them before the copy is done
+    }
+    
+    *out_info = frame.info;
+    RefreshPose(frame.posePending, out_info);
+    
+    bool ok = true;
+    if (convert) {
+        ok = YuvToRgb(image, range, layout, downscale, out_bytes);
+        out_info->width = outWidth;
+        out_info->height = outHeight;
+        out_info->strideBytes = outWidth * RgbBytesPerPixel(layout);
+        if (out_layout) {
+            memset(out_layout, 0, sizeof(*out_layout));
+            out_layout->output_format = format;
+            out_layout->plane_count = 1;
+            out_layout->total_bytes = (int32_t)required;
+            out_layout->planes[0] = {0, outWidth, outHeight, out_info->strideBytes, RgbBytesPerPixel(layout), (int32_t)required};
+        }
+    } else {
+        // As stored: native planes or NV12/I420
+        if (out_layout) {
+            *out_layout = frame.layout;
+        }
+        memcpy(out_bytes, frame.data.data(), frame.size);
+    }
+    if (ok) {
+        *out_bytes_written = (int32_t)required;
+    }
+    
+    lock.lock();
+    ReleaseSlot(slot);
+    lock.unlock();
+    g_slotCv.notify_all();
+    
+    return ok;
+}
+
+bool MLRGBCameraUnity_TryGetLatestFrameWithLayout(
+    uint32_t timeout_ms,
+    RGBFrameWithPose* out_info,
+    RGBFrameLayout* out_layout,
+    uint8_t* out_bytes,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written
+) {
+    return ReadFrame(true, timeout_ms, out_info, out_layout, out_bytes, capacity_bytes, out_bytes_written);
+}
+
+bool MLRGBCameraUnity_TryGetNextFrame(
+    uint32_t timeout_ms,
+    RGBFrameWithPose* out_info,
+    RGBFrameLayout* out_layout,
+    uint8_t* out_bytes,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written
+) {
+    return ReadFrame(false, timeout_ms, out_info, out_layout, out_bytes, capacity_bytes, out_bytes_written);
+}
+
+int32_t MLRGBCameraUnity_GetQueuedFrameCount() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return g_queueCount;
+}
+
+bool MLRGBCameraUnity_GetFramePose(int64_t timestamp_ns, RGBFrameWithPose* out_info) {
+    if (!out_info) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(g_poseMutex);
+    const PoseEntry* entry = FindPose(timestamp_ns);
+    if (!entry) {
         return false;
     }
+    FillPose(*entry, out_info);
+    return entry->state != RGBPoseState_Pending;
+}
+
+int32_t MLRGBCameraUnity_GetFramePoseState(int64_t timestamp_ns) {
+    std::lock_guard<std::mutex> lock(g_poseMutex);
+    const PoseEntry* entry = FindPose(timestamp_ns);
+    return entry ? entry->state : RGBPoseState_Unknown;
+}
 
-    // Copy frame
-    *out_info = g_latestFrameInfo;
-    memcpy(out_bytes, g_latestFrameData.data(), required);
-    *out_bytes_written = required;
+bool MLRGBCameraUnity_GetStats(RGBCameraStats* out_stats) {
+    if (!out_stats) {
+        return false;
+    }
     
-    g_hasNewFrame = false;
+    memset(out_stats, 0, sizeof(*out_stats));
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        out_stats->frames_dropped_oldest = g_framesDroppedOldest;
+        out_stats->frames_dropped_newest = g_framesDroppedNewest;
+        out_stats->frames_skipped = g_framesSkipped;
+        out_stats->block_timeouts = g_blockTimeouts;
+        out_stats->max_block_us = g_maxBlockUs;
+        out_stats->queue_depth = g_queueCount;
+        out_stats->queue_high_water = g_queueHighWater;
+    }
+    out_stats->frames_grown = g_framesGrown.load();
+    out_stats->frames = g_statFrames.load(std::memory_order_relaxed);
+    out_stats->last_callback_us = g_statLastCallbackUs.load(std::memory_order_relaxed);
+    out_stats->max_callback_us = g_statMaxCallbackUs.load(std::memory_order_relaxed);
+    if (out_stats->frames > 0) {
+        out_stats->mean_callback_us = (float)((double)g_statCallbackTotalNs.load(std::memory_order_relaxed) * 1e-3 / (double)out_stats->frames);
+    }
     
+    std::lock_guard<std::mutex> lock(g_poseMutex);
+    out_stats->poses_resolved = g_posesResolved;
+    out_stats->poses_failed = g_posesFailed;
+    out_stats->pose_retries = g_poseRetries;
+    out_stats->pose_queue_drops = g_poseQueueDrops;
+    out_stats->max_pose_latency_us = g_maxPoseLatencyUs;
     return true;
 }
 
@@ -408,7 +1121,7 @@ void MLRGBCameraUnity_Shutdown() {
 
     MLRGBCameraUnity_StopCapture();
 
-    std::lock_guard<std::mutex> lock(g_mutex);
+    std::unique_lock<std::mutex> lock(g_mutex);
 
     if (g_cameraContext != ML_INVALID_HANDLE) {
         MLCameraDisconnect(g_cameraContext);
@@ -417,8 +1130,13 @@ void MLRGBCameraUnity_Shutdown() {
 
     // NOTE: We do NOT shutdown CV camera here - it's managed separately
 
-    g_latestFrameData.clear();
-    g_hasNewFrame = false;
+    // Release the frame pool once no reader holds a slot
+    g_slotCv.wait(lock, [] { return g_slotsInUse == 0; });
+    std::vector<FrameSlot>().swap(g_pool);
+    g_freeSlots.clear();
+    g_queue.clear();
+    g_queueHead = 0;
+    g_queueCount = 0;
     g_initialized.store(false);
     g_frameCount.store(0);
 
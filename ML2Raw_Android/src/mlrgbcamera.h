@@ -24,13 +24,56 @@ typedef struct RGBFrameWithPose {
     float pose_position_y;
     float pose_position_z;
     int32_t pose_valid;       // 1 if pose was successfully retrieved, 0 otherwise
-    int32_t pose_result_code; // MLResult from CVCameraGetFramePose
+    int32_t pose_result_code; // MLResult from CVCameraGetFramePose (last attempt)
     
     // Intrinsics (if available)
     float fx, fy;             // Focal length
     float cx, cy;             // Principal point
 } RGBFrameWithPose;
 
+// Pixel format returned by MLRGBCameraUnity_TryGetLatestFrame. For converted
+// formats width/height/strideBytes of RGBFrameWithPose describe the returned
+// bytes; RGBFrameLayout.output_format tells which format a frame came out in.
+typedef enum {
+    RGBOutputFormat_Native = 0,   // camera planes as delivered, concatenated
+    RGBOutputFormat_RGBA32 = 1,   // converted from YUV_420_888, tightly packed rows
+    RGBOutputFormat_RGB24 = 2,
+    RGBOutputFormat_BGRA32 = 3,
+    RGBOutputFormat_NV12 = 4,     // YUV_420_888 repacked while the callback copies it:
+    RGBOutputFormat_I420 = 5      // Y rows of width bytes, then UV (NV12) or U, V (I420)
+} RGBOutputFormat;
+
+// Where each plane sits in the returned bytes. YUV frames always list Y, U, V;
+// for interleaved chroma (NV12 or a semi-planar native frame) U and V share
+// rows with pixel_stride 2 and V starts one byte after U.
+#define RGB_MAX_PLANES 3
+
+typedef struct RGBPlaneLayout {
+    int32_t offset;        // first byte of the plane in the returned bytes
+    int32_t width;         // samples per row
+    int32_t height;        // rows
+    int32_t row_stride;    // bytes between rows
+    int32_t pixel_stride;  // bytes between samples of a row
+    int32_t size;          // bytes from the first to the last sample (inclusive)
+} RGBPlaneLayout;
+
+typedef struct RGBFrameLayout {
+    int32_t output_format;   // RGBOutputFormat of the bytes
+    int32_t plane_count;     // 1 for RGB formats and JPEG
+    int32_t total_bytes;
+    RGBPlaneLayout planes[RGB_MAX_PLANES];
+} RGBFrameLayout;
+
+// What happens to a new frame when the frame queue is full
+typedef enum {
+    RGBDropPolicy_DropOldest = 0,  // the oldest queued frame is discarded (default)
+    RGBDropPolicy_DropNewest = 1,  // the new frame is discarded
+    RGBDropPolicy_Block = 2        // the camera callback waits up to block_timeout_ms
+                                   // for a reader, then discards the new frame
+} RGBDropPolicy;
+
+#define RGB_MAX_QUEUED_FRAMES 64
+
 // Camera capture mode
 typedef enum {
     RGBCaptureMode_Preview = 0,    // Lower res, higher FPS
@@ -41,7 +84,8 @@ typedef enum {
 // Initialize RGB camera
 // mode: capture mode (preview/video/image)
 // NOTE: CV Camera (CVCameraNativeConsumer) must be initialized separately for poses to work.
-//       RGB camera will call MLCVCameraUnity_GetPose() internally for synchronized poses.
+//       RGB camera will call MLCVCameraUnity_GetPose() internally (on its pose worker
+//       thread) for synchronized poses.
 bool MLRGBCameraUnity_Init(RGBCaptureMode mode);
 
 // Start capturing
@@ -50,6 +94,23 @@ bool MLRGBCameraUnity_StartCapture();
 // Stop capturing
 void MLRGBCameraUnity_StopCapture();
 
+// Frame queue, applied by the next MLRGBCameraUnity_StartCapture (default: 1
+// frame, drop oldest = latest frame only). StartCapture preallocates
+// capacity + 2 frame buffers sized for the stream (one being filled by the
+// camera callback, one being read), so frames are never allocated while
+// capturing. Use a deeper queue with TryGetNextFrame when every frame
+// matters (recording).
+bool MLRGBCameraUnity_SetFrameQueue(int32_t capacity, RGBDropPolicy policy, uint32_t block_timeout_ms);
+
+// Select the format of the bytes returned by MLRGBCameraUnity_TryGetLatestFrame.
+// RGB formats are converted from YUV_420_888 (planar or semi-planar) on the
+// calling thread, BT.601; limited_range = video range input (else full/JFIF).
+// downscale: 1, 2 or 4 (2x2 box averaging). NV12/I420 are packed by the
+// camera callback during its only copy and need downscale 1. Frames in other
+// camera formats (e.g. JPEG in image mode) are returned as Native; use
+// MLRGBCameraUnity_TryGetLatestFrameWithLayout to see which one a frame got.
+bool MLRGBCameraUnity_SetOutputFormat(RGBOutputFormat format, int32_t downscale, bool limited_range);
+
 // Try to get the latest frame with its pose
 // timeout_ms: how long to wait for a frame
 // out_info: frame metadata and pose
@@ -65,6 +126,82 @@ bool MLRGBCameraUnity_TryGetLatestFrame(
     int32_t* out_bytes_written
 );
 
+// Same as MLRGBCameraUnity_TryGetLatestFrame, also describing the planes of
+// the returned bytes (out_layout may be null). Both return the newest queued
+// frame and release the older ones (counted as frames_skipped).
+bool MLRGBCameraUnity_TryGetLatestFrameWithLayout(
+    uint32_t timeout_ms,
+    RGBFrameWithPose* out_info,
+    RGBFrameLayout* out_layout,
+    uint8_t* out_bytes,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written
+);
+
+// Oldest queued frame first (FIFO), otherwise the same as
+// MLRGBCameraUnity_TryGetLatestFrameWithLayout. Don't mix with the latest-frame
+// calls on the same stream, they discard queued frames.
+bool MLRGBCameraUnity_TryGetNextFrame(
+    uint32_t timeout_ms,
+    RGBFrameWithPose* out_info,
+    RGBFrameLayout* out_layout,
+    uint8_t* out_bytes,
+    int32_t capacity_bytes,
+    int32_t* out_bytes_written
+);
+
+// Frames waiting in the queue
+int32_t MLRGBCameraUnity_GetQueuedFrameCount();
+
+// Poses are looked up by a worker thread after the camera callback has
+// returned the buffer, retrying until the CV camera has a pose for the frame
+// timestamp, so a frame may be read before its pose is known (pose_valid = 0).
+// Fills the pose fields of out_info (the rest is untouched) for one of the
+// last RGB_POSE_HISTORY frames. Returns true once the lookup finished
+// (pose_valid says whether it succeeded), false while it is pending or for an
+// unknown timestamp. Covers every frame the queue and pool can hold, so a
+// queued frame's pose can always still be looked up.
+#define RGB_POSE_HISTORY (RGB_MAX_QUEUED_FRAMES + 2)
+
+bool MLRGBCameraUnity_GetFramePose(int64_t timestamp_ns, RGBFrameWithPose* out_info);
+
+// Where the pose lookup of a frame stands
+typedef enum {
+    RGBPoseState_Unknown = 0,   // not one of the last RGB_POSE_HISTORY frames
+    RGBPoseState_Pending = 1,   // still being looked up
+    RGBPoseState_Valid = 2,
+    RGBPoseState_Failed = 3     // no pose (see pose_result_code)
+} RGBPoseState;
+
+// RGBPoseState of the frame with this timestamp; tells a frame whose pose is
+// still coming apart from one that has none
+int32_t MLRGBCameraUnity_GetFramePoseState(int64_t timestamp_ns);
+
+// Callback and pose worker statistics since StartCapture
+typedef struct RGBCameraStats {
+    uint64_t frames;
+    float last_callback_us;       // time spent in the camera buffer callback
+    float mean_callback_us;
+    float max_callback_us;
+    uint64_t poses_resolved;
+    uint64_t poses_failed;        // CV camera not initialized or no pose within the retry window
+    uint64_t pose_retries;
+    uint64_t pose_queue_drops;    // frames overwritten in the history before their lookup
+    float max_pose_latency_us;    // frame arrival to pose resolved
+    
+    // Frame queue
+    uint64_t frames_dropped_oldest;  // queued frames discarded for new ones
+    uint64_t frames_dropped_newest;  // new frames discarded (queue full, or no reader in time)
+    uint64_t frames_skipped;         // older frames released by the latest-frame calls
+    uint64_t block_timeouts;         // RGBDropPolicy_Block waits that ran out
+    float max_block_us;              // longest RGBDropPolicy_Block wait
+    int32_t queue_depth;
+    int32_t queue_high_water;
+    int32_t frames_grown;            // frame buffers reallocated for a larger frame
+} RGBCameraStats;
+
+bool MLRGBCameraUnity_GetStats(RGBCameraStats* out_stats);
+
 // Get number of frames captured so far
 uint64_t MLRGBCameraUnity_GetFrameCount();
 
@@ -0,0 +1,66 @@
+#include "mlsensordirect.h"
+
+#include <cstring>
+
+static constexpr size_t OFFSET_TOKEN = 0x04;
+static constexpr size_t OFFSET_TYPE = 0x08;
+static constexpr size_t OFFSET_COUNTER = 0x0C;
+static constexpr size_t OFFSET_TIMESTAMP = 0x10;
+static constexpr size_t OFFSET_DATA = 0x18;
+
+static inline uint32_t NextCounter(uint32_t counter) {
+    return counter + 1 == 0 ? 1 : counter + 1;
+}
+
+// The writer is another process: the counter is published last, so an
+// acquire load of it orders the payload reads after it.
+static inline uint32_t LoadCounter(const uint8_t* report) {
+    return __atomic_load_n((const uint32_t*)(report + OFFSET_COUNTER), __ATOMIC_ACQUIRE);
+}
+
+void SensorDirectReader::Attach(const void* buffer, size_t sizeBytes) {
+    m_buffer = (const uint8_t*)buffer;
+    m_slots = buffer ? sizeBytes / SENSOR_DIRECT_REPORT_SIZE : 0;
+    m_next = 0;
+    m_counter = 1;
+    m_lost = 0;
+}
+
+size_t SensorDirectReader::Read(SensorDirectEvent* out, size_t maxCount) {
+    if (!m_buffer || m_slots == 0 || !out) return 0;
+
+    size_t count = 0;
+    while (count < maxCount) {
+        const uint8_t* report = m_buffer + m_next * SENSOR_DIRECT_REPORT_SIZE;
+        const uint32_t counter = LoadCounter(report);
+        if (counter == 0) break;  // never written
+
+        if (counter != m_counter) {
+            // Signed distance in counter space: behind = old lap, caught up
+            const int32_t ahead = (int32_t)(counter - m_counter);
+            if (ahead < 0) break;
+            // Lapped: everything between the expected report and this one is gone.
+            // Continue from here; later slots hold its successors. A gap across
+            // the counter wrap is one shorter, since 0 is never used.
+            m_lost += (uint64_t)ahead - (counter < m_counter ? 1 : 0);
+            m_counter = counter;
+        }
+
+        SensorDirectEvent& e = out[count];
+        memcpy(&e.token, report + OFFSET_TOKEN, sizeof(e.token));
+        memcpy(&e.type, report + OFFSET_TYPE, sizeof(e.type));
+        memcpy(&e.timestamp, report + OFFSET_TIMESTAMP, sizeof(e.timestamp));
+        memcpy(e.data, report + OFFSET_DATA, sizeof(e.data));
+
+        // Overwritten while we copied it: drop it and resync on the next pass
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (LoadCounter(report) != counter) {
+            continue;
+        }
+
+        count++;
+        m_counter = NextCounter(m_counter);
+        m_next = (m_next + 1) % m_slots;
+    }
+    return count;
+}
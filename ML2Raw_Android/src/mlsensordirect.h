@@ -0,0 +1,51 @@
+#pragma once
+// Internal C++ helper for the IMU direct channel backend (not part of the Unity API).
+//
+// SensorDirectReader parses the shared-memory ring a sensor direct channel
+// writes into. The sensor service appends fixed 104-byte reports:
+//
+//   0x00 int32   size of the report (104)
+//   0x04 int32   report token (returned by ASensorManager_configureDirectReport)
+//   0x08 int32   sensor type (ASENSOR_TYPE_*)
+//   0x0C uint32  atomic counter: 1, 2, 3, ... (skips 0 on wrap), written last
+//   0x10 int64   timestamp (ns, same clock as ASensorEvent)
+//   0x18 float   data[16]
+//   0x58 int32   reserved[4]
+//
+// and wraps to the start of the buffer when it reaches the end. There is no
+// read index the writer could wait on, so the reader walks the ring by
+// counter: a slot holding the expected counter is new, an older counter
+// means "caught up", and a newer one means the writer lapped us (the skipped
+// reports are counted as lost). No Android headers, so it runs on a host.
+
+#include <cstddef>
+#include <cstdint>
+
+static constexpr size_t SENSOR_DIRECT_REPORT_SIZE = 104;
+
+struct SensorDirectEvent {
+    int32_t token;
+    int32_t type;
+    int64_t timestamp;
+    float data[3];
+};
+
+class SensorDirectReader {
+public:
+    // buffer: the mapped shared memory (size truncated to whole reports)
+    void Attach(const void* buffer, size_t sizeBytes);
+    void Detach() { Attach(nullptr, 0); }
+
+    // Copies up to maxCount new reports, oldest first; returns the count.
+    size_t Read(SensorDirectEvent* out, size_t maxCount);
+
+    // Reports overwritten before they could be read.
+    uint64_t Lost() const { return m_lost; }
+
+private:
+    const uint8_t* m_buffer = nullptr;
+    size_t m_slots = 0;
+    size_t m_next = 0;           // slot of the next expected report
+    uint32_t m_counter = 1;      // counter of the next expected report
+    uint64_t m_lost = 0;
+};
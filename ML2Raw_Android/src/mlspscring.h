@@ -0,0 +1,268 @@
+#pragma once
+// Internal C++ helpers shared by the sensor modules (not part of the Unity API).
+//
+// SpscRing<T, N> moves samples from one producer thread (the sensor callback)
+// to one consumer thread (the Unity drain) without a mutex:
+//   - head is written only by the producer, tail only by the consumer, each on
+//     its own cache line so the two threads don't bounce a shared line,
+//   - each side keeps a cached copy of the other side's index and only reloads
+//     it when the ring looks full (producer) or empty (consumer),
+//   - Push/Pop move whole runs with at most two memcpy calls (wrap-around).
+// Both sides are wait-free. When the ring is full the producer drops the new
+// samples and counts them rather than touching the consumer's tail.
+//
+// SpscColumnRing<N, Ts...> is the same ring stored column by column, one
+// array per field, so the consumer copies each field out as contiguous runs
+// (struct-of-arrays) for SIMD code instead of transposing structs.
+//
+// LatestValue<T> is a seqlock for a small "latest sample" struct: the producer
+// never waits, readers retry if they raced with a write.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+static constexpr size_t SPSC_CACHE_LINE = 64;
+
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing copies samples with memcpy");
+
+public:
+    static constexpr size_t Capacity = N;
+
+    // ---------- Producer side ----------
+
+    bool Push(const T& item) { return Push(&item, 1) == 1; }
+
+    // Appends up to count items; returns how many fit (the rest are dropped).
+    size_t Push(const T* items, size_t count) {
+        const uint64_t head = m_head.value.load(std::memory_order_relaxed);
+        size_t space = N - (size_t)(head - m_producer.cachedTail);
+        if (space < count) {
+            m_producer.cachedTail = m_tail.value.load(std::memory_order_acquire);
+            space = N - (size_t)(head - m_producer.cachedTail);
+        }
+        const size_t n = count < space ? count : space;
+        if (n < count) m_dropped.fetch_add(count - n, std::memory_order_relaxed);
+        if (n == 0) return 0;
+
+        const size_t start = (size_t)head & (N - 1);
+        const size_t first = n < N - start ? n : N - start;
+        memcpy(&m_items[start], items, first * sizeof(T));
+        if (n > first) memcpy(&m_items[0], items + first, (n - first) * sizeof(T));
+        m_head.value.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // Samples rejected because the ring was full.
+    uint64_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // ---------- Consumer side ----------
+
+    // Moves up to maxCount of the oldest items into out; returns the count.
+    size_t Pop(T* out, size_t maxCount) {
+        const uint64_t tail = m_tail.value.load(std::memory_order_relaxed);
+        size_t avail = (size_t)(m_consumer.cachedHead - tail);
+        if (avail < maxCount) {
+            m_consumer.cachedHead = m_head.value.load(std::memory_order_acquire);
+            avail = (size_t)(m_consumer.cachedHead - tail);
+        }
+        const size_t n = maxCount < avail ? maxCount : avail;
+        if (n == 0) return 0;
+
+        const size_t start = (size_t)tail & (N - 1);
+        const size_t first = n < N - start ? n : N - start;
+        memcpy(out, &m_items[start], first * sizeof(T));
+        if (n > first) memcpy(out + first, &m_items[0], (n - first) * sizeof(T));
+        m_tail.value.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // ---------- Either side ----------
+
+    // Approximate fill level (exact when called from one of the two sides).
+    size_t Size() const {
+        const uint64_t tail = m_tail.value.load(std::memory_order_acquire);
+        const uint64_t head = m_head.value.load(std::memory_order_acquire);
+        return (size_t)(head - tail);
+    }
+
+    // Only while neither side is running (Init/Shutdown).
+    void Reset() {
+        m_head.value.store(0);
+        m_tail.value.store(0);
+        m_producer.cachedTail = 0;
+        m_consumer.cachedHead = 0;
+        m_dropped.store(0);
+    }
+
+private:
+    struct alignas(SPSC_CACHE_LINE) Index {
+        std::atomic<uint64_t> value{0};
+    };
+    struct alignas(SPSC_CACHE_LINE) ProducerCache {
+        uint64_t cachedTail = 0;
+    };
+    struct alignas(SPSC_CACHE_LINE) ConsumerCache {
+        uint64_t cachedHead = 0;
+    };
+
+    Index m_head;              // next write position (producer)
+    ProducerCache m_producer;
+    Index m_tail;              // next read position (consumer)
+    ConsumerCache m_consumer;
+    alignas(SPSC_CACHE_LINE) std::atomic<uint64_t> m_dropped{0};
+    alignas(SPSC_CACHE_LINE) T m_items[N];
+};
+
+template <size_t N, typename... Ts>
+class SpscColumnRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscColumnRing size must be a power of two");
+    static_assert(sizeof...(Ts) > 0, "SpscColumnRing needs at least one column");
+
+public:
+    static constexpr size_t Capacity = N;
+
+    // ---------- Producer side ----------
+    // Reserve room for up to count rows (the rest are dropped and counted),
+    // fill rows 0..n-1 with Set, then Commit(n) publishes them together.
+
+    size_t Reserve(size_t count) {
+        const uint64_t head = m_head.value.load(std::memory_order_relaxed);
+        size_t space = N - (size_t)(head - m_producer.cachedTail);
+        if (space < count) {
+            m_producer.cachedTail = m_tail.value.load(std::memory_order_acquire);
+            space = N - (size_t)(head - m_producer.cachedTail);
+        }
+        const size_t n = count < space ? count : space;
+        if (n < count) m_dropped.fetch_add(count - n, std::memory_order_relaxed);
+        return n;
+    }
+
+    void Set(size_t row, const Ts&... values) {
+        const size_t slot = (size_t)(m_head.value.load(std::memory_order_relaxed) + row) & (N - 1);
+        SetColumns(slot, std::index_sequence_for<Ts...>{}, values...);
+    }
+
+    void Commit(size_t count) {
+        const uint64_t head = m_head.value.load(std::memory_order_relaxed);
+        m_head.value.store(head + count, std::memory_order_release);
+    }
+
+    uint64_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // ---------- Consumer side ----------
+
+    // Moves up to maxCount of the oldest rows into one array per column
+    // (null arrays skip that column); returns the row count.
+    size_t Pop(size_t maxCount, Ts*... columns) {
+        const uint64_t tail = m_tail.value.load(std::memory_order_relaxed);
+        size_t avail = (size_t)(m_consumer.cachedHead - tail);
+        if (avail < maxCount) {
+            m_consumer.cachedHead = m_head.value.load(std::memory_order_acquire);
+            avail = (size_t)(m_consumer.cachedHead - tail);
+        }
+        const size_t n = maxCount < avail ? maxCount : avail;
+        if (n == 0) return 0;
+
+        const size_t start = (size_t)tail & (N - 1);
+        const size_t first = n < N - start ? n : N - start;
+        CopyColumns(start, first, 0, std::index_sequence_for<Ts...>{}, columns...);
+        if (n > first) CopyColumns(0, n - first, first, std::index_sequence_for<Ts...>{}, columns...);
+        m_tail.value.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // ---------- Either side ----------
+
+    size_t Size() const {
+        const uint64_t tail = m_tail.value.load(std::memory_order_acquire);
+        const uint64_t head = m_head.value.load(std::memory_order_acquire);
+        return (size_t)(head - tail);
+    }
+
+    // Only while neither side is running.
+    void Reset() {
+        m_head.value.store(0);
+        m_tail.value.store(0);
+        m_producer.cachedTail = 0;
+        m_consumer.cachedHead = 0;
+        m_dropped.store(0);
+    }
+
+private:
+    template <size_t... I>
+    void SetColumns(size_t slot, std::index_sequence<I...>, const Ts&... values) {
+        ((std::get<I>(m_columns).items[slot] = values), ...);
+    }
+
+    template <size_t... I>
+    void CopyColumns(size_t from, size_t count, size_t to, std::index_sequence<I...>, Ts*... columns) const {
+        ((columns ? (void)memcpy(columns + to, &std::get<I>(m_columns).items[from], count * sizeof(Ts)) : (void)0), ...);
+    }
+
+    struct alignas(SPSC_CACHE_LINE) Index {
+        std::atomic<uint64_t> value{0};
+    };
+    struct alignas(SPSC_CACHE_LINE) ProducerCache {
+        uint64_t cachedTail = 0;
+    };
+    struct alignas(SPSC_CACHE_LINE) ConsumerCache {
+        uint64_t cachedHead = 0;
+    };
+    template <typename T>
+    struct alignas(SPSC_CACHE_LINE) Column {
+        static_assert(std::is_trivially_copyable<T>::value, "SpscColumnRing copies columns with memcpy");
+        T items[N];
+    };
+
+    Index m_head;
+    ProducerCache m_producer;
+    Index m_tail;
+    ConsumerCache m_consumer;
+    alignas(SPSC_CACHE_LINE) std::atomic<uint64_t> m_dropped{0};
+    std::tuple<Column<Ts>...> m_columns;
+};
+
+template <typename T>
+class LatestValue {
+    static_assert(std::is_trivially_copyable<T>::value, "LatestValue copies with memcpy");
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+public:
+    // Single writer.
+    void Store(const T& value) {
+        uint64_t words[WORDS] = {};
+        memcpy(words, &value, sizeof(T));
+        const uint32_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);  // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) m_words[i].store(words[i], std::memory_order_relaxed);
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    // Any number of readers.
+    T Load() const {
+        uint64_t words[WORDS];
+        for (;;) {
+            const uint32_t before = m_seq.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            for (size_t i = 0; i < WORDS; i++) words[i] = m_words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_seq.load(std::memory_order_relaxed) == before) break;
+        }
+        T value;
+        memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+private:
+    std::atomic<uint32_t> m_seq{0};
+    std::atomic<uint64_t> m_words[WORDS] = {};
+};
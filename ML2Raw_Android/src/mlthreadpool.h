@@ -0,0 +1,118 @@
+#pragma once
+// Internal C++ helper shared by the processing modules (not part of the Unity API).
+//
+// WorkerPool runs a batch of independent tasks (tiles, row bands) on a few
+// persistent threads plus the calling thread, and returns once all of them
+// are done. Threads are started on first use and parked on a condition
+// variable between batches, so a per-frame Run() costs a wake-up, not a
+// thread spawn. Batches from different callers are serialized.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+public:
+    // threads: total parallelism including the caller (0 = min(4, cores))
+    explicit WorkerPool(int32_t threads = 0) : m_threads(threads) {}
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wakeCv.notify_all();
+        for (std::thread& t : m_workers) t.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int32_t Threads() {
+        if (m_threads <= 0) {
+            const int32_t cores = (int32_t)std::thread::hardware_concurrency();
+            m_threads = std::max(1, std::min(4, cores));
+        }
+        return m_threads;
+    }
+
+    // Calls fn(task) for task in [0, taskCount), spread over the pool.
+    void Run(int32_t taskCount, const std::function<void(int32_t)>& fn) {
+        if (taskCount <= 0) return;
+
+        std::lock_guard<std::mutex> runGuard(m_runMutex);
+        const int32_t threads = std::min(Threads(), taskCount);
+        if (threads <= 1) {
+            for (int32_t i = 0; i < taskCount; i++) fn(i);
+            return;
+        }
+        Start(Threads() - 1);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_fn = &fn;
+            m_taskCount = taskCount;
+            m_nextTask.store(0);
+            m_active = (int32_t)m_workers.size();
+            m_generation++;
+        }
+        m_wakeCv.notify_all();
+
+        Drain();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCv.wait(lock, [this] { return m_active == 0; });
+        m_fn = nullptr;
+    }
+
+private:
+    void Start(int32_t workers) {
+        while ((int32_t)m_workers.size() < workers) {
+            m_workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    void Drain() {
+        for (;;) {
+            const int32_t task = m_nextTask.fetch_add(1);
+            if (task >= m_taskCount) break;
+            (*m_fn)(task);
+        }
+    }
+
+    void WorkerLoop() {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeCv.wait(lock, [&] { return m_stop || m_generation != seen; });
+                if (m_stop) return;
+                seen = m_generation;
+            }
+
+            Drain();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_active == 0) m_doneCv.notify_one();
+        }
+    }
+
+    int32_t m_threads;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_runMutex;  // one batch at a time
+    std::mutex m_mutex;
+    std::condition_variable m_wakeCv;
+    std::condition_variable m_doneCv;
+    const std::function<void(int32_t)>* m_fn = nullptr;
+    int32_t m_taskCount = 0;
+    std::atomic<int32_t> m_nextTask{0};
+    int32_t m_active = 0;
+    uint64_t m_generation = 0;
+    bool m_stop = false;
+};
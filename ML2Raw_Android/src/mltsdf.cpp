@@ -0,0 +1,294 @@
+#include "mltsdf.h"
+#include "mltsdfvolume.h"
+#include "mlheadtracking.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstring>
+
+#include <android/log.h>
+
+#define LOG_TAG "MLTsdfUnity"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+
+// Initial worker frame buffer (ML2 depth is 544x480 float32); sized from the
+// active stream when its intrinsics are known, and grown for larger frames
+static constexpr int32_t TSDF_MAX_FRAME_BYTES = 544 * 480 * 4;
+
+// ===== Global state =====
+// g_volumeLock guards the volume, the extraction scratch and the stats.
+static std::mutex g_volumeLock;
+static TsdfVolume g_volume;
+static std::vector<float> g_meshVertices;
+static std::vector<uint32_t> g_meshIndices;
+
+static uint64_t g_framesIntegrated = 0;
+static uint64_t g_framesSkipped = 0;
+static float g_lastIntegrateMs = 0.0f;
+static double g_totalIntegrateMs = 0.0;
+
+// Depth camera (+y down, +z forward) -> head (+y up, -z forward): 180 deg about x
+static std::mutex g_extrinsicsLock;
+static TsdfRigid g_depthToHead = TsdfRigidFromPose(1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+
+// Worker
+static std::atomic<bool> g_workerRunning{false};
+static std::thread g_worker;
+static bool g_workerFiltered = false;
+static std::vector<uint8_t> g_workerFrame;
+
+// ---------- Helpers ----------
+
+static TsdfRigid RigidFromTsdfPose(const TsdfPose& p) {
+    return TsdfRigidFromPose(p.rotation_x, p.rotation_y, p.rotation_z, p.rotation_w,
+                             p.position_x, p.position_y, p.position_z);
+}
+
+static bool Integrate(const DepthFrameInfo& info, const uint8_t* bytes,
+                      const DepthIntrinsics& intrinsics, const TsdfRigid& cameraToWorld) {
+    if (info.bytesPerPixel != (int32_t)sizeof(float) || info.width <= 0 || info.height <= 0) {
+        static int warnCount = 0;
+        if (warnCount++ < 5) {
+            LOGW("Integrate expects float32 depth, got %dx%d bpp=%d", info.width, info.height, info.bytesPerPixel);
+        }
+        return false;
+    }
+
+    TsdfCamera camera;
+    camera.fx = intrinsics.fx;
+    camera.fy = intrinsics.fy;
+    camera.cx = intrinsics.cx;
+    camera.cy = intrinsics.cy;
+
+    std::lock_guard<std::mutex> guard(g_volumeLock);
+    if (!g_volume.IsInitialized()) return false;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    g_volume.Integrate((const float*)bytes, info.width, info.height, info.strideBytes, camera, cameraToWorld);
+    const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    g_framesIntegrated++;
+    g_lastIntegrateMs = ms;
+    g_totalIntegrateMs += ms;
+    return true;
+}
+
+static void WorkerLoop() {
+    LOGI("Worker started (%s depth)", g_workerFiltered ? "filtered" : "processed");
+
+    const uint32_t stream = g_workerFiltered ? DepthStream_Filtered : DepthStream_Depth;
+    uint64_t sequence = 0;
+
+    while (g_workerRunning.load()) {
+        DepthFrameInfo info;
+        int32_t written = 0;
+        uint32_t skipped = 0;
+        const uint64_t since = sequence;
+        if (!MLDepthUnity_TryGetLatestSince(stream, since, 100, &info, g_workerFrame.data(),
+                                            (int32_t)g_workerFrame.size(), &written, &sequence, &skipped)) {
+            if (sequence != since) {
+                // A newer frame couldn't be copied: skip it, and make room if
+                // it was larger than the stream planned for
+                if (written > (int32_t)g_workerFrame.size()) {
+                    LOGW("Worker: %d-byte depth frame, growing buffer from %zu", written, g_workerFrame.size());
+                    g_workerFrame.resize((size_t)written);
+                }
+                std::lock_guard<std::mutex> guard(g_volumeLock);
+                g_framesSkipped += skipped + 1;
+            }
+            continue;
+        }
+
+        HeadPoseData head;
+        DepthIntrinsics intrinsics;
+        const bool havePose = MLHeadTrackingUnity_GetPose(&head) && head.status == HeadTrackingStatus_Valid;
+        if (!havePose || !MLDepthUnity_GetIntrinsics(&intrinsics)) {
+            std::lock_guard<std::mutex> guard(g_volumeLock);
+            g_framesSkipped += skipped + 1;
+            continue;
+        }
+
+        const TsdfRigid headToWorld = TsdfRigidFromPose(head.rotation_x, head.rotation_y, head.rotation_z, head.rotation_w,
+                                                        head.position_x, head.position_y, head.position_z);
+        TsdfRigid depthToHead;
+        {
+            std::lock_guard<std::mutex> guard(g_extrinsicsLock);
+            depthToHead = g_depthToHead;
+        }
+
+        Integrate(info, g_workerFrame.data(), intrinsics, TsdfRigidCompose(headToWorld, depthToHead));
+
+        if (skipped > 0) {
+            std::lock_guard<std::mutex> guard(g_volumeLock);
+            g_framesSkipped += skipped;
+        }
+    }
+
+    LOGI("Worker exiting");
+}
+
+// ---------- API ----------
+
+bool MLTsdfUnity_Init(const TsdfConfig* config) {
+    if (!config) return false;
+    if (g_workerRunning.load()) {
+        LOGW("Init: stop the worker first");
+        return false;
+    }
+
+    TsdfVolume::Params params;
+    params.voxelSize   = config->voxelSize;
+    params.truncation  = config->truncation > 0.0f ? config->truncation : 4.0f * config->voxelSize;
+    params.maxDepth    = config->maxDepth > 0.0f ? config->maxDepth : 4.0f;
+    params.maxWeight   = config->maxWeight > 0.0f ? config->maxWeight : 64.0f;
+    params.maxBlocks   = config->maxBlocks;
+    params.pixelStride = config->pixelStride > 0 ? config->pixelStride : 2;
+
+    std::lock_guard<std::mutex> guard(g_volumeLock);
+    if (!g_volume.Init(params)) {
+        LOGE("Init: invalid config voxelSize=%f maxBlocks=%d", config->voxelSize, config->maxBlocks);
+        return false;
+    }
+
+    g_framesIntegrated = 0;
+    g_framesSkipped = 0;
+    g_lastIntegrateMs = 0.0f;
+    g_totalIntegrateMs = 0.0;
+
+    LOGI("Initialized: voxel=%.3f m trunc=%.3f m maxDepth=%.2f m blocks=%d (%.1f MB)",
+         params.voxelSize, params.truncation, params.maxDepth, params.maxBlocks,
+         (double)params.maxBlocks * sizeof(TsdfBlock) / (1024.0 * 1024.0));
+    return true;
+}
+
+void MLTsdfUnity_SetDepthToHead(const TsdfPose* depthToHead) {
+    if (!depthToHead) return;
+    std::lock_guard<std::mutex> guard(g_extrinsicsLock);
+    g_depthToHead = RigidFromTsdfPose(*depthToHead);
+}
+
+bool MLTsdfUnity_IntegrateFrame(
+    const DepthFrameInfo* info,
+    const uint8_t* bytes,
+    const DepthIntrinsics* intrinsics,
+    const TsdfPose* cameraToWorld)
+{
+    if (!info || !bytes || !intrinsics || !cameraToWorld) return false;
+    return Integrate(*info, bytes, *intrinsics, RigidFromTsdfPose(*cameraToWorld));
+}
+
+bool MLTsdfUnity_StartWorker(bool useFilteredDepth) {
+    if (g_workerRunning.load()) return true;
+
+    {
+        std::lock_guard<std::mutex> guard(g_volumeLock);
+        if (!g_volume.IsInitialized()) {
+            LOGE("StartWorker: call MLTsdfUnity_Init first");
+            return false;
+        }
+    }
+    if (!MLHeadTrackingUnity_IsInitialized()) {
+        LOGW("StartWorker: head tracking not initialized, frames will be skipped until it is");
+    }
+
+    DepthIntrinsics intrinsics;
+    size_t frameBytes = TSDF_MAX_FRAME_BYTES;
+    if (MLDepthUnity_GetIntrinsics(&intrinsics) && intrinsics.width > 0 && intrinsics.height > 0) {
+        frameBytes = std::max(frameBytes, (size_t)intrinsics.width * intrinsics.height * sizeof(float));
+    }
+    g_workerFrame.resize(frameBytes);
+    g_workerFiltered = useFilteredDepth;
+    g_workerRunning.store(true);
+    g_worker = std::thread(WorkerLoop);
+    return true;
+}
+
+void MLTsdfUnity_StopWorker() {
+    g_workerRunning.store(false);
+    if (g_worker.joinable()) {
+        g_worker.join();
+    }
+}
+
+int32_t MLTsdfUnity_GetDirtyBlocks(int32_t* outBlockCoords, int32_t capacityBlocks) {
+    std::lock_guard<std::mutex> guard(g_volumeLock);
+    return g_volume.GetDirtyBlocks(outBlockCoords, outBlockCoords ? capacityBlocks : 0);
+}
+
+bool MLTsdfUnity_ExtractBlockMesh(
+    int32_t blockX,
+    int32_t blockY,
+    int32_t blockZ,
+    float* outVertices,
+    int32_t vertexCapacity,
+    uint32_t* outIndices,
+    int32_t indexCapacity,
+    int32_t* outVertexCount,
+    int32_t* outIndexCount)
+{
+    if (!outVertices || !outIndices || !outVertexCount || !outIndexCount) return false;
+    *outVertexCount = 0;
+    *outIndexCount = 0;
+
+    std::lock_guard<std::mutex> guard(g_volumeLock);
+    if (!g_volume.ExtractBlock(blockX, blockY, blockZ, g_meshVertices, g_meshIndices)) return false;
+
+    const int32_t vertexCount = (int32_t)(g_meshVertices.size() / 3);
+    const int32_t indexCount = (int32_t)g_meshIndices.size();
+    *outVertexCount = vertexCount;
+    *outIndexCount = indexCount;
+    if (vertexCount > vertexCapacity || indexCount > indexCapacity) return false;
+
+    if (indexCount > 0) {
+        std::memcpy(outVertices, g_meshVertices.data(), g_meshVertices.size() * sizeof(float));
+        std::memcpy(outIndices, g_meshIndices.data(), g_meshIndices.size() * sizeof(uint32_t));
+    }
+    g_volume.MarkClean(blockX, blockY, blockZ);
+    return true;
+}
+
+bool MLTsdfUnity_GetStats(TsdfStats* outStats) {
+    if (!outStats) return false;
+
+    std::lock_guard<std::mutex> guard(g_volumeLock);
+    if (!g_volume.IsInitialized()) return false;
+
+    outStats->allocatedBlocks = g_volume.AllocatedBlocks();
+    outStats->maxBlocks = g_volume.GetParams().maxBlocks;
+    outStats->dirtyBlocks = g_volume.DirtyBlocks();
+    outStats->framesIntegrated = g_framesIntegrated;
+    outStats->framesSkipped = g_framesSkipped;
+    outStats->allocationFailures = g_volume.AllocationFailures();
+    outStats->lastIntegrateMs = g_lastIntegrateMs;
+    outStats->avgIntegrateMs = g_framesIntegrated > 0 ? (float)(g_totalIntegrateMs / g_framesIntegrated) : 0.0f;
+    return true;
+}
+
+void MLTsdfUnity_Reset() {
+    std::lock_guard<std::mutex> guard(g_volumeLock);
+    g_volume.Reset();
+    g_framesIntegrated = 0;
+    g_framesSkipped = 0;
+    g_lastIntegrateMs = 0.0f;
+    g_totalIntegrateMs = 0.0;
+}
+
+void MLTsdfUnity_Shutdown() {
+    LOGI("Shutting down...");
+
+    MLTsdfUnity_StopWorker();
+
+    std::lock_guard<std::mutex> guard(g_volumeLock);
+    g_volume.Release();
+    std::vector<float>().swap(g_meshVertices);
+    std::vector<uint32_t>().swap(g_meshIndices);
+    std::vector<uint8_t>().swap(g_workerFrame);
+
+    LOGI("Shutdown complete");
+}
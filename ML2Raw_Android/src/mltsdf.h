@@ -0,0 +1,102 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mldepth.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// TSDF volumetric fusion of depth frames into a sparse voxel map.
+// Voxels live in 8x8x8 blocks that are allocated on demand (hashed by block
+// coordinate) from a pool sized at Init, so memory is bounded and nothing is
+// allocated while integrating. Meshes are extracted per block with marching
+// cubes, only for blocks that changed since their last extraction.
+
+typedef struct TsdfConfig {
+  float voxelSize;      // meters (e.g. 0.02)
+  float truncation;     // meters; <= 0 -> 4 * voxelSize
+  float maxDepth;       // meters; farther pixels are ignored (<= 0 -> 4 m)
+  float maxWeight;      // per-voxel weight cap, lower adapts faster (<= 0 -> 64)
+  int32_t maxBlocks;    // block pool size (4 KB per block)
+  int32_t pixelStride;  // pixel step for block allocation (<= 0 -> 2)
+} TsdfConfig;
+
+// Rigid pose: rotation quaternion (x, y, z, w) + position (meters)
+typedef struct TsdfPose {
+  float rotation_x;
+  float rotation_y;
+  float rotation_z;
+  float rotation_w;
+  float position_x;
+  float position_y;
+  float position_z;
+} TsdfPose;
+
+typedef struct TsdfStats {
+  int32_t allocatedBlocks;
+  int32_t maxBlocks;
+  int32_t dirtyBlocks;
+  uint64_t framesIntegrated;
+  uint64_t framesSkipped;        // worker: newer frame arrived first, or no valid head pose
+  uint64_t allocationFailures;   // blocks not stored because the pool was full
+  float lastIntegrateMs;
+  float avgIntegrateMs;
+} TsdfStats;
+
+// Allocates the block pool. Call again (after StopWorker) to change the config.
+bool MLTsdfUnity_Init(const TsdfConfig* config);
+
+// Depth camera pose relative to the head frame used by the worker.
+// Default: the depth camera frame (+x right, +y down, +z forward) rotated
+// into the head frame (+y up, -z forward) with no offset.
+void MLTsdfUnity_SetDepthToHead(const TsdfPose* depthToHead);
+
+// Integrates one float32 depth frame on the calling thread.
+// cameraToWorld: depth camera pose (+x right, +y down, +z forward) in world.
+// Usable without the depth module (e.g. recorded or synthetic frames).
+bool MLTsdfUnity_IntegrateFrame(
+    const DepthFrameInfo* info,
+    const uint8_t* bytes,
+    const DepthIntrinsics* intrinsics,
+    const TsdfPose* cameraToWorld);
+
+// Starts a worker thread that integrates each new processed depth frame
+// (or the filtered stream, if useFilteredDepth) with the head pose from
+// MLHeadTrackingUnity_GetPose. Needs MLDepthUnity_Init and head tracking.
+// The head pose is sampled when the frame is picked up, not at its capture
+// time, so fast head motion blurs the map slightly.
+bool MLTsdfUnity_StartWorker(bool useFilteredDepth);
+void MLTsdfUnity_StopWorker();
+
+// Copies up to capacityBlocks dirty block coordinates (x, y, z int triples).
+// Returns the total number of dirty blocks.
+int32_t MLTsdfUnity_GetDirtyBlocks(int32_t* outBlockCoords, int32_t capacityBlocks);
+
+// Marching cubes mesh of one block: world-space vertices (xyz floats) and
+// triangle indices into them. Clears the block's dirty flag on success.
+// If a buffer is too small, returns false with the required counts set
+// (the block stays dirty).
+bool MLTsdfUnity_ExtractBlockMesh(
+    int32_t blockX,
+    int32_t blockY,
+    int32_t blockZ,
+    float* outVertices,
+    int32_t vertexCapacity,
+    uint32_t* outIndices,
+    int32_t indexCapacity,
+    int32_t* outVertexCount,
+    int32_t* outIndexCount);
+
+bool MLTsdfUnity_GetStats(TsdfStats* outStats);
+
+// Forgets all blocks (keeps the pool).
+void MLTsdfUnity_Reset();
+
+// Stops the worker and frees the pool.
+void MLTsdfUnity_Shutdown();
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,463 @@
+#include "mltsdfvolume.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// ---------- Rigid transforms ----------
+
+TsdfRigid TsdfRigidFromPose(float qx, float qy, float qz, float qw, float px, float py, float pz) {
+    // Normalize so slightly-off quaternions from tracking stay rigid
+    const float n = std::sqrt(qx * qx + qy * qy + qz * qz + qw * qw);
+    if (n > 0.0f) { qx /= n; qy /= n; qz /= n; qw /= n; } else { qw = 1.0f; }
+
+    TsdfRigid r;
+    r.R[0] = 1 - 2 * (qy * qy + qz * qz); r.R[1] = 2 * (qx * qy - qz * qw);     r.R[2] = 2 * (qx * qz + qy * qw);
+    r.R[3] = 2 * (qx * qy + qz * qw);     r.R[4] = 1 - 2 * (qx * qx + qz * qz); r.R[5] = 2 * (qy * qz - qx * qw);
+    r.R[6] = 2 * (qx * qz - qy * qw);     r.R[7] = 2 * (qy * qz + qx * qw);     r.R[8] = 1 - 2 * (qx * qx + qy * qy);
+    r.t[0] = px; r.t[1] = py; r.t[2] = pz;
+    return r;
+}
+
+TsdfRigid TsdfRigidCompose(const TsdfRigid& a, const TsdfRigid& b) {
+    TsdfRigid r;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            r.R[i * 3 + j] = a.R[i * 3 + 0] * b.R[0 * 3 + j] + a.R[i * 3 + 1] * b.R[1 * 3 + j] + a.R[i * 3 + 2] * b.R[2 * 3 + j];
+        }
+        r.t[i] = a.R[i * 3 + 0] * b.t[0] + a.R[i * 3 + 1] * b.t[1] + a.R[i * 3 + 2] * b.t[2] + a.t[i];
+    }
+    return r;
+}
+
+static TsdfRigid RigidInverse(const TsdfRigid& a) {
+    TsdfRigid r;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) r.R[i * 3 + j] = a.R[j * 3 + i];
+    }
+    for (int i = 0; i < 3; i++) {
+        r.t[i] = -(r.R[i * 3 + 0] * a.t[0] + r.R[i * 3 + 1] * a.t[1] + r.R[i * 3 + 2] * a.t[2]);
+    }
+    return r;
+}
+
+// ---------- Marching cubes table ----------
+// Corner c sits at offset (c & 1, (c >> 1) & 1, (c >> 2) & 1). Edge e runs
+// along axis e / 4 from the corner whose other two bits are e % 4.
+// The triangle table is derived once instead of being pasted in: on each cube
+// face the contour segments are found with a fixed rule (inside corners of
+// an ambiguous face are kept apart), so neighboring cubes agree on shared
+// faces and the mesh is watertight. Segments chain into loops, loops are fanned.
+
+static constexpr int32_t MC_MAX_TRIS = 12;
+
+struct MarchingCubesTable {
+    int8_t tris[256][MC_MAX_TRIS * 3 + 1];  // edge triples, -1 terminated
+
+    static int32_t EdgeCorner(int32_t e, int32_t end) {
+        const int32_t axis = e / 4, sub = e % 4;
+        const int32_t i = (axis + 1) % 3, j = (axis + 2) % 3;
+        int32_t c = ((sub & 1) << i) | (((sub >> 1) & 1) << j);
+        return end ? c | (1 << axis) : c;
+    }
+
+    static int32_t EdgeBetween(int32_t a, int32_t b) {
+        const int32_t diff = a ^ b;
+        const int32_t axis = diff == 1 ? 0 : (diff == 2 ? 1 : 2);
+        const int32_t i = (axis + 1) % 3, j = (axis + 2) % 3;
+        return axis * 4 + ((a >> i) & 1) + 2 * ((a >> j) & 1);
+    }
+
+    MarchingCubesTable() {
+        for (int32_t config = 0; config < 256; config++) {
+            int32_t next[12];
+            for (int32_t e = 0; e < 12; e++) next[e] = -1;
+
+            // Face contours: walk each face counter-clockwise as seen from outside
+            for (int32_t axis = 0; axis < 3; axis++) {
+                const int32_t bi = 1 << ((axis + 1) % 3), bj = 1 << ((axis + 2) % 3);
+                for (int32_t side = 0; side < 2; side++) {
+                    const int32_t base = side << axis;
+                    int32_t corners[4];
+                    if (side) {
+                        corners[0] = base; corners[1] = base | bi; corners[2] = base | bi | bj; corners[3] = base | bj;
+                    } else {
+                        corners[0] = base; corners[1] = base | bj; corners[2] = base | bi | bj; corners[3] = base | bi;
+                    }
+
+                    bool in[4];
+                    int32_t edge[4];
+                    for (int32_t n = 0; n < 4; n++) {
+                        in[n] = (config >> corners[n]) & 1;
+                        edge[n] = EdgeBetween(corners[n], corners[(n + 1) & 3]);
+                    }
+                    // Each exit (inside -> outside) pairs with the entry just
+                    // before it, which isolates each inside corner on ambiguous faces
+                    for (int32_t n = 0; n < 4; n++) {
+                        if (!in[n] || in[(n + 1) & 3]) continue;
+                        int32_t m = n;
+                        do { m = (m + 3) & 3; } while (in[m] || !in[(m + 1) & 3]);
+                        next[edge[n]] = edge[m];
+                    }
+                }
+            }
+
+            int32_t count = 0;
+            bool used[12] = {};
+            for (int32_t start = 0; start < 12; start++) {
+                if (next[start] < 0 || used[start]) continue;
+                int32_t loop[12], len = 0;
+                for (int32_t e = start; !used[e]; e = next[e]) {
+                    used[e] = true;
+                    loop[len++] = e;
+                }
+                for (int32_t k = 1; k + 1 < len && count < MC_MAX_TRIS * 3; k++) {
+                    tris[config][count++] = (int8_t)loop[0];
+                    tris[config][count++] = (int8_t)loop[k + 1];
+                    tris[config][count++] = (int8_t)loop[k];
+                }
+            }
+            tris[config][count] = -1;
+        }
+    }
+};
+
+static const MarchingCubesTable& McTable() {
+    static const MarchingCubesTable table;
+    return table;
+}
+
+// ---------- Block hash ----------
+
+static inline uint32_t HashBlock(int32_t x, int32_t y, int32_t z) {
+    return ((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u) ^ ((uint32_t)z * 83492791u);
+}
+
+bool TsdfVolume::Init(const Params& params) {
+    if (!(params.voxelSize > 0.0f) || !(params.truncation > 0.0f) || !(params.maxDepth > 0.0f) ||
+        !(params.maxWeight >= 1.0f) || params.maxBlocks <= 0 || params.pixelStride <= 0) {
+        return false;
+    }
+
+    m_params = params;
+    m_blocks.assign(params.maxBlocks, TsdfBlock{});
+
+    uint32_t tableSize = 1;
+    while (tableSize < (uint32_t)params.maxBlocks * 2) tableSize <<= 1;
+    m_table.assign(tableSize, -1);
+    m_tableMask = tableSize - 1;
+
+    m_touched.clear();
+    m_touched.reserve(params.maxBlocks);
+    m_dirty.clear();
+    m_dirty.reserve(params.maxBlocks);
+    m_blockCount = 0;
+    m_frame = 0;
+    m_allocFailures = 0;
+
+    const int32_t dim = TSDF_BLOCK_DIM + 1;
+    m_samples.resize(dim * dim * dim);
+    m_edgeVertex.resize(dim * dim * dim * 3);
+    McTable();
+    return true;
+}
+
+void TsdfVolume::Release() {
+    std::vector<TsdfBlock>().swap(m_blocks);
+    std::vector<int32_t>().swap(m_table);
+    std::vector<int32_t>().swap(m_touched);
+    std::vector<int32_t>().swap(m_dirty);
+    m_blockCount = 0;
+}
+
+void TsdfVolume::Reset() {
+    std::fill(m_table.begin(), m_table.end(), -1);
+    m_touched.clear();
+    m_dirty.clear();
+    m_blockCount = 0;
+    m_frame = 0;
+    m_allocFailures = 0;
+}
+
+int32_t TsdfVolume::Find(int32_t bx, int32_t by, int32_t bz) const {
+    if (m_table.empty()) return -1;
+    for (uint32_t h = HashBlock(bx, by, bz) & m_tableMask;; h = (h + 1) & m_tableMask) {
+        const int32_t idx = m_table[h];
+        if (idx < 0) return -1;
+        const TsdfBlock& b = m_blocks[idx];
+        if (b.bx == bx && b.by == by && b.bz == bz) return idx;
+    }
+}
+
+int32_t TsdfVolume::FindOrInsert(int32_t bx, int32_t by, int32_t bz) {
+    // Table is at least twice the pool, so probing always reaches an empty entry
+    uint32_t h = HashBlock(bx, by, bz) & m_tableMask;
+    for (;; h = (h + 1) & m_tableMask) {
+        const int32_t idx = m_table[h];
+        if (idx < 0) break;
+        const TsdfBlock& b = m_blocks[idx];
+        if (b.bx == bx && b.by == by && b.bz == bz) return idx;
+    }
+
+    if (m_blockCount >= (int32_t)m_blocks.size()) {
+        m_allocFailures++;
+        return -1;
+    }
+
+    const int32_t idx = m_blockCount++;
+    TsdfBlock& b = m_blocks[idx];
+    b.bx = bx; b.by = by; b.bz = bz;
+    b.lastFrame = 0;
+    b.dirtyIndex = -1;
+    std::memset(b.voxels, 0, sizeof(b.voxels));
+    m_table[h] = idx;
+    return idx;
+}
+
+void TsdfVolume::MarkDirty(int32_t blockIndex) {
+    TsdfBlock& b = m_blocks[blockIndex];
+    if (b.dirtyIndex < 0) {
+        b.dirtyIndex = (int32_t)m_dirty.size();
+        m_dirty.push_back(blockIndex);
+    }
+}
+
+// ---------- Integration ----------
+
+// Allocates/touches every block along a world-space segment.
+void TsdfVolume::TouchSegment(const float* a, const float* b) {
+    const float blockSize = m_params.voxelSize * TSDF_BLOCK_DIM;
+    const float inv = 1.0f / blockSize;
+    const float d[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    const float len = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    const int32_t steps = (int32_t)std::ceil(len / (blockSize * 0.5f));
+
+    for (int32_t s = 0; s <= steps; s++) {
+        const float f = steps > 0 ? (float)s / (float)steps : 0.0f;
+        const int32_t bx = (int32_t)std::floor((a[0] + d[0] * f) * inv);
+        const int32_t by = (int32_t)std::floor((a[1] + d[1] * f) * inv);
+        const int32_t bz = (int32_t)std::floor((a[2] + d[2] * f) * inv);
+        const int32_t idx = FindOrInsert(bx, by, bz);
+        if (idx < 0) continue;
+        TsdfBlock& block = m_blocks[idx];
+        if (block.lastFrame != m_frame) {
+            block.lastFrame = m_frame;
+            m_touched.push_back(idx);
+        }
+    }
+}
+
+void TsdfVolume::IntegrateBlock(TsdfBlock& block, const float* depth, int32_t width, int32_t height,
+                                int32_t strideBytes, const TsdfCamera& camera, const TsdfRigid& worldToCamera,
+                                bool& updated) {
+    const float vs = m_params.voxelSize;
+    const float trunc = m_params.truncation;
+    const float invTrunc = 1.0f / trunc;
+    const float maxDepth = m_params.maxDepth;
+    const float maxWeight = m_params.maxWeight;
+    const float* R = worldToCamera.R;
+
+    // Camera-space step per voxel along world x, y, z (columns of R)
+    const float sx[3] = { R[0] * vs, R[3] * vs, R[6] * vs };
+    const float sy[3] = { R[1] * vs, R[4] * vs, R[7] * vs };
+    const float sz[3] = { R[2] * vs, R[5] * vs, R[8] * vs };
+
+    const float origin[3] = {
+        (float)(block.bx * TSDF_BLOCK_DIM) * vs,
+        (float)(block.by * TSDF_BLOCK_DIM) * vs,
+        (float)(block.bz * TSDF_BLOCK_DIM) * vs
+    };
+    float pz[3];
+    for (int i = 0; i < 3; i++) {
+        pz[i] = R[i * 3 + 0] * origin[0] + R[i * 3 + 1] * origin[1] + R[i * 3 + 2] * origin[2] + worldToCamera.t[i];
+    }
+
+    TsdfVoxel* voxel = block.voxels;
+    for (int32_t z = 0; z < TSDF_BLOCK_DIM; z++) {
+        float py[3] = { pz[0], pz[1], pz[2] };
+        for (int32_t y = 0; y < TSDF_BLOCK_DIM; y++) {
+            float p[3] = { py[0], py[1], py[2] };
+            for (int32_t x = 0; x < TSDF_BLOCK_DIM; x++, voxel++) {
+                const float cz = p[2];
+                const float cx = p[0], cy = p[1];
+                p[0] += sx[0]; p[1] += sx[1]; p[2] += sx[2];
+
+                if (cz <= 0.0f) continue;
+                const float invZ = 1.0f / cz;
+                const int32_t u = (int32_t)std::floor(camera.fx * cx * invZ + camera.cx + 0.5f);
+                const int32_t v = (int32_t)std::floor(camera.fy * cy * invZ + camera.cy + 0.5f);
+                if (u < 0 || v < 0 || u >= width || v >= height) continue;
+
+                const float d = ((const float*)((const uint8_t*)depth + (size_t)v * strideBytes))[u];
+                if (!(d > 0.0f) || d > maxDepth) continue;
+
+                const float sdf = d - cz;
+                if (sdf < -trunc) continue;  // occluded, leave untouched
+                const float tsdf = std::min(sdf * invTrunc, 1.0f);
+
+                const float w = voxel->weight;
+                voxel->sdf = (voxel->sdf * w + tsdf) / (w + 1.0f);
+                voxel->weight = std::min(w + 1.0f, maxWeight);
+                updated = true;
+            }
+            py[0] += sy[0]; py[1] += sy[1]; py[2] += sy[2];
+        }
+        pz[0] += sz[0]; pz[1] += sz[1]; pz[2] += sz[2];
+    }
+}
+
+int32_t TsdfVolume::Integrate(const float* depth, int32_t width, int32_t height, int32_t strideBytes,
+                              const TsdfCamera& camera, const TsdfRigid& cameraToWorld) {
+    if (!IsInitialized() || !depth || width <= 0 || height <= 0) return 0;
+    if (camera.fx == 0.0f || camera.fy == 0.0f) return 0;
+    if (strideBytes <= 0) strideBytes = width * (int32_t)sizeof(float);
+
+    // Frame ids start at 1 so fresh blocks (lastFrame 0) always count as untouched
+    if (++m_frame == 0) m_frame = 1;
+    m_touched.clear();
+
+    // Pass 1: allocate the blocks around each observed surface point
+    const float trunc = m_params.truncation;
+    const float invFx = 1.0f / camera.fx, invFy = 1.0f / camera.fy;
+    const float* R = cameraToWorld.R;
+    const float* t = cameraToWorld.t;
+    const int32_t stride = m_params.pixelStride;
+
+    for (int32_t v = 0; v < height; v += stride) {
+        const float* row = (const float*)((const uint8_t*)depth + (size_t)v * strideBytes);
+        const float ry = ((float)v - camera.cy) * invFy;
+        for (int32_t u = 0; u < width; u += stride) {
+            const float d = row[u];
+            if (!(d > 0.0f) || d > m_params.maxDepth) continue;
+
+            const float rx = ((float)u - camera.cx) * invFx;
+            const float near = std::max(d - trunc, 0.0f);
+            const float far = d + trunc;
+            float a[3], b[3];
+            for (int i = 0; i < 3; i++) {
+                const float dir = R[i * 3 + 0] * rx + R[i * 3 + 1] * ry + R[i * 3 + 2];
+                a[i] = dir * near + t[i];
+                b[i] = dir * far + t[i];
+            }
+            TouchSegment(a, b);
+        }
+    }
+
+    // Pass 2: update the voxels of every touched block
+    const TsdfRigid worldToCamera = RigidInverse(cameraToWorld);
+    int32_t updatedBlocks = 0;
+    for (int32_t idx : m_touched) {
+        bool updated = false;
+        IntegrateBlock(m_blocks[idx], depth, width, height, strideBytes, camera, worldToCamera, updated);
+        if (!updated) continue;
+        updatedBlocks++;
+
+        // This block's mesh and the meshes of the -x/-y/-z neighbors (which
+        // sample its first voxel layer) are now out of date
+        const TsdfBlock& b = m_blocks[idx];
+        for (int32_t n = 0; n < 8; n++) {
+            const int32_t other = n == 0 ? idx : Find(b.bx - (n & 1), b.by - ((n >> 1) & 1), b.bz - ((n >> 2) & 1));
+            if (other >= 0) MarkDirty(other);
+        }
+    }
+    return updatedBlocks;
+}
+
+int32_t TsdfVolume::GetDirtyBlocks(int32_t* outCoords, int32_t capacity) const {
+    const int32_t n = std::min(capacity, (int32_t)m_dirty.size());
+    for (int32_t i = 0; i < n && outCoords; i++) {
+        const TsdfBlock& b = m_blocks[m_dirty[i]];
+        outCoords[i * 3 + 0] = b.bx;
+        outCoords[i * 3 + 1] = b.by;
+        outCoords[i * 3 + 2] = b.bz;
+    }
+    return (int32_t)m_dirty.size();
+}
+
+// ---------- Extraction ----------
+
+bool TsdfVolume::ExtractBlock(int32_t bx, int32_t by, int32_t bz,
+                              std::vector<float>& outVertices, std::vector<uint32_t>& outIndices) {
+    outVertices.clear();
+    outIndices.clear();
+
+    const int32_t self = Find(bx, by, bz);
+    if (self < 0) return false;
+
+    // Gather the (DIM+1)^3 sample grid: this block plus the first layer of
+    // its +x/+y/+z neighbors (missing neighbors read as unobserved)
+    const int32_t dim = TSDF_BLOCK_DIM + 1;
+    int32_t neighbor[8];
+    for (int32_t n = 0; n < 8; n++) {
+        neighbor[n] = n == 0 ? self : Find(bx + (n & 1), by + ((n >> 1) & 1), bz + ((n >> 2) & 1));
+    }
+    for (int32_t z = 0; z < dim; z++) {
+        for (int32_t y = 0; y < dim; y++) {
+            for (int32_t x = 0; x < dim; x++) {
+                const int32_t n = (x >> 3) | ((y >> 3) << 1) | ((z >> 3) << 2);
+                TsdfVoxel& s = m_samples[(z * dim + y) * dim + x];
+                if (neighbor[n] < 0) {
+                    s = TsdfVoxel{ 1.0f, 0.0f };
+                } else {
+                    s = m_blocks[neighbor[n]].voxels[((z & 7) * TSDF_BLOCK_DIM + (y & 7)) * TSDF_BLOCK_DIM + (x & 7)];
+                }
+            }
+        }
+    }
+
+    std::fill(m_edgeVertex.begin(), m_edgeVertex.end(), -1);
+    const MarchingCubesTable& mc = McTable();
+    const float vs = m_params.voxelSize;
+    const float ox = (float)(bx * TSDF_BLOCK_DIM), oy = (float)(by * TSDF_BLOCK_DIM), oz = (float)(bz * TSDF_BLOCK_DIM);
+
+    for (int32_t z = 0; z < TSDF_BLOCK_DIM; z++) {
+        for (int32_t y = 0; y < TSDF_BLOCK_DIM; y++) {
+            for (int32_t x = 0; x < TSDF_BLOCK_DIM; x++) {
+                const TsdfVoxel* corner[8];
+                int32_t config = 0;
+                bool observed = true;
+                for (int32_t c = 0; c < 8 && observed; c++) {
+                    corner[c] = &m_samples[((z + ((c >> 2) & 1)) * dim + (y + ((c >> 1) & 1))) * dim + (x + (c & 1))];
+                    observed = corner[c]->weight > 0.0f;
+                    if (corner[c]->sdf < 0.0f) config |= 1 << c;
+                }
+                if (!observed || config == 0 || config == 255) continue;
+
+                for (const int8_t* e = mc.tris[config]; *e >= 0; e++) {
+                    const int32_t c0 = MarchingCubesTable::EdgeCorner(*e, 0);
+                    const int32_t c1 = MarchingCubesTable::EdgeCorner(*e, 1);
+                    const int32_t axis = *e / 4;
+                    const int32_t sx = x + (c0 & 1), sy = y + ((c0 >> 1) & 1), sz = z + ((c0 >> 2) & 1);
+                    int32_t& cached = m_edgeVertex[((sz * dim + sy) * dim + sx) * 3 + axis];
+                    if (cached < 0) {
+                        const float s0 = corner[c0]->sdf, s1 = corner[c1]->sdf;
+                        const float f = s0 / (s0 - s1);
+                        float p[3] = { ox + (float)sx, oy + (float)sy, oz + (float)sz };
+                        p[axis] += f;
+                        cached = (int32_t)(outVertices.size() / 3);
+                        outVertices.push_back(p[0] * vs);
+                        outVertices.push_back(p[1] * vs);
+                        outVertices.push_back(p[2] * vs);
+                    }
+                    outIndices.push_back((uint32_t)cached);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void TsdfVolume::MarkClean(int32_t bx, int32_t by, int32_t bz) {
+    const int32_t self = Find(bx, by, bz);
+    if (self < 0) return;
+
+    // Swap-remove from the dirty list
+    TsdfBlock& b = m_blocks[self];
+    if (b.dirtyIndex >= 0) {
+        const int32_t last = m_dirty.back();
+        m_dirty[b.dirtyIndex] = last;
+        m_blocks[last].dirtyIndex = b.dirtyIndex;
+        m_dirty.pop_back();
+        b.dirtyIndex = -1;
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+// Sparse TSDF volume (internal C++, used by mltsdf.cpp).
+// No SDK or Android dependencies, so it builds and runs on a Linux host with
+// synthetic depth frames and poses.
+
+#include <stdint.h>
+#include <vector>
+
+static constexpr int32_t TSDF_BLOCK_DIM = 8;  // voxels per block side
+static constexpr int32_t TSDF_BLOCK_VOXELS = TSDF_BLOCK_DIM * TSDF_BLOCK_DIM * TSDF_BLOCK_DIM;
+
+struct TsdfVoxel {
+    float sdf;     // truncated signed distance / truncation, in [-1, 1]; < 0 behind the surface
+    float weight;  // 0 = never observed
+};
+
+struct TsdfBlock {
+    int32_t bx, by, bz;   // block coordinates (world position = b * TSDF_BLOCK_DIM * voxelSize)
+    uint32_t lastFrame;   // last frame that touched this block (allocation pass)
+    int32_t dirtyIndex;   // position in the dirty list, -1 = mesh up to date
+    TsdfVoxel voxels[TSDF_BLOCK_VOXELS];  // x fastest, then y, then z
+};
+
+struct TsdfCamera {
+    float fx, fy, cx, cy;
+};
+
+// Rigid transform: p_world = R * p_camera + t (R row-major)
+struct TsdfRigid {
+    float R[9];
+    float t[3];
+};
+
+// Quaternion (x, y, z, w) + position -> rigid transform
+TsdfRigid TsdfRigidFromPose(float qx, float qy, float qz, float qw, float px, float py, float pz);
+// a * b
+TsdfRigid TsdfRigidCompose(const TsdfRigid& a, const TsdfRigid& b);
+
+class TsdfVolume {
+public:
+    struct Params {
+        float voxelSize;    // meters
+        float truncation;   // meters
+        float maxDepth;     // meters; farther pixels are ignored
+        float maxWeight;    // running-average weight cap (lets the map adapt)
+        int32_t maxBlocks;  // block pool size, allocated up front
+        int32_t pixelStride;// pixel subsampling for the block allocation pass
+    };
+
+    // Allocates the block pool and hash table. Returns false on bad params.
+    bool Init(const Params& params);
+    void Release();
+    // Forgets all blocks, keeps the storage.
+    void Reset();
+
+    bool IsInitialized() const { return !m_blocks.empty(); }
+    const Params& GetParams() const { return m_params; }
+
+    // Integrates one float32 depth frame (meters, 0/NaN = invalid).
+    // cameraToWorld maps depth camera coordinates (+x right, +y down, +z forward)
+    // to world. Returns the number of blocks updated.
+    int32_t Integrate(const float* depth, int32_t width, int32_t height, int32_t strideBytes,
+                      const TsdfCamera& camera, const TsdfRigid& cameraToWorld);
+
+    int32_t AllocatedBlocks() const { return m_blockCount; }
+    int32_t DirtyBlocks() const { return (int32_t)m_dirty.size(); }
+    uint64_t AllocationFailures() const { return m_allocFailures; }
+
+    // Copies up to capacity dirty block coordinates (x, y, z triples).
+    // Returns the total number of dirty blocks.
+    int32_t GetDirtyBlocks(int32_t* outCoords, int32_t capacity) const;
+
+    // Marching cubes over one block (its voxels plus the first layer of the
+    // +x/+y/+z neighbors). Vertices are world-space xyz, indices are triangles
+    // into this block's vertex list. Returns false if the block doesn't exist.
+    bool ExtractBlock(int32_t bx, int32_t by, int32_t bz,
+                      std::vector<float>& outVertices, std::vector<uint32_t>& outIndices);
+    // Removes a block from the dirty list once its mesh has been consumed.
+    void MarkClean(int32_t bx, int32_t by, int32_t bz);
+
+private:
+    int32_t Find(int32_t bx, int32_t by, int32_t bz) const;
+    int32_t FindOrInsert(int32_t bx, int32_t by, int32_t bz);
+    void MarkDirty(int32_t blockIndex);
+    void TouchSegment(const float* a, const float* b);
+    void IntegrateBlock(TsdfBlock& block, const float* depth, int32_t width, int32_t height,
+                        int32_t strideBytes, const TsdfCamera& camera, const TsdfRigid& worldToCamera,
+                        bool& updated);
+
+    Params m_params{};
+    std::vector<TsdfBlock> m_blocks;    // pool; first m_blockCount are in use
+    int32_t m_blockCount = 0;
+    std::vector<int32_t> m_table;       // open addressing, -1 = empty
+    uint32_t m_tableMask = 0;
+    std::vector<int32_t> m_touched;     // blocks touched by the current frame
+    std::vector<int32_t> m_dirty;       // blocks whose mesh is out of date
+    uint32_t m_frame = 0;
+    uint64_t m_allocFailures = 0;
+
+    // Extraction scratch (sample grid and per-edge vertex cache)
+    std::vector<TsdfVoxel> m_samples;
+    std::vector<int32_t> m_edgeVertex;
+};
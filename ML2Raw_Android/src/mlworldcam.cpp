@@ -1,4 +1,5 @@
 #include "mlworldcam.h"
+#include "mlframeslot.h"
 
 #include <cstring>
 #include <mutex>
@@ -24,10 +25,11 @@ static MLHandle g_handle = ML_INVALID_HANDLE;
 static std::atomic<bool> g_initialized{false};
 static std::atomic<bool> g_running{false};
 
-// Frame buffers for each camera (indexed by camera ID bit position)
+// Frame pools for each camera (indexed by camera ID bit position)
 // Index 0 = LEFT (bit 0), Index 1 = RIGHT (bit 1), Index 2 = CENTER (bit 2)
-static WorldCamFrameInfo g_frameInfo[3];
-static std::vector<uint8_t> g_frameBytes[3];
+// Readers pin slots instead of locking, so leased frames never block capture.
+typedef FrameSlots<WorldCamFrameInfo, 4> WorldCamSlots;
+static WorldCamSlots g_frameSlots[3];
 static std::atomic<bool> g_hasNewFrame[3] = {false, false, false};
 
 // Track which cameras are enabled
@@ -82,30 +84,30 @@ static void CaptureLoop() {
         }
         
         // Process ALL frames returned (up to 3 cameras)
-        {
-            std::lock_guard<std::mutex> lock(g_mutex);
+        for (uint8_t i = 0; i < data_ptr->frame_count; i++) {
+            const MLWorldCameraFrame& f = data_ptr->frames[i];
+            const MLWorldCameraFrameBuffer& fb = f.frame_buffer;
             
-            for (uint8_t i = 0; i < data_ptr->frame_count; i++) {
-                const MLWorldCameraFrame& f = data_ptr->frames[i];
-                const MLWorldCameraFrameBuffer& fb = f.frame_buffer;
+            int idx = CamIdToIndex((uint32_t)f.id);
+            if (idx < 0 || idx >= 3) continue;
+            
+            if (fb.data && fb.size > 0) {
+                WorldCamSlots::Slot* slot = g_frameSlots[idx].BeginWrite();
+                if (!slot) continue;  // every slot leased - drop this frame
+                
+                slot->info.camId = (int32_t)f.id;
+                slot->info.frameType = (int32_t)f.frame_type;
+                slot->info.timestampNs = (int64_t)f.timestamp;
+                slot->info.width = (int32_t)fb.width;
+                slot->info.height = (int32_t)fb.height;
+                slot->info.strideBytes = (int32_t)fb.stride;
+                slot->info.bytesPerPixel = (int32_t)fb.bytes_per_pixel;
                 
-                int idx = CamIdToIndex((uint32_t)f.id);
-                if (idx < 0 || idx >= 3) continue;
+                slot->bytes.resize(fb.size);
+                std::memcpy(slot->bytes.data(), fb.data, fb.size);
                 
-                if (fb.data && fb.size > 0) {
-                    g_frameInfo[idx].camId = (int32_t)f.id;
-                    g_frameInfo[idx].frameType = (int32_t)f.frame_type;
-                    g_frameInfo[idx].timestampNs = (int64_t)f.timestamp;
-                    g_frameInfo[idx].width = (int32_t)fb.width;
-                    g_frameInfo[idx].height = (int32_t)fb.height;
-                    g_frameInfo[idx].strideBytes = (int32_t)fb.stride;
-                    g_frameInfo[idx].bytesPerPixel = (int32_t)fb.bytes_per_pixel;
-                    
-                    g_frameBytes[idx].resize(fb.size);
-                    std::memcpy(g_frameBytes[idx].data(), fb.data, fb.size);
-                    
-                    g_hasNewFrame[idx].store(true);
-                }
+                g_frameSlots[idx].Publish(slot);
+                g_hasNewFrame[idx].store(true);
             }
         }
         
@@ -158,9 +160,8 @@ extern "C" bool MLWorldCamUnity_Init(uint32_t identifiers_mask) {
     
     // Clear all frame buffers
     for (int i = 0; i < 3; i++) {
-        g_frameBytes[i].clear();
+        g_frameSlots[i].Reset();
         g_hasNewFrame[i].store(false);
-        std::memset(&g_frameInfo[i], 0, sizeof(WorldCamFrameInfo));
     }
     
     g_initialized.store(true);
@@ -200,27 +201,76 @@ extern "C" bool MLWorldCamUnity_TryGetLatest(
         return false;
     }
     
-    std::lock_guard<std::mutex> lock(g_mutex);
-    
-    if (g_frameBytes[idx].empty()) {
+    const WorldCamSlots::Slot* slot = g_frameSlots[idx].Acquire();
+    if (!slot) {
         return false;
     }
     
-    int32_t required = (int32_t)g_frameBytes[idx].size();
+    int32_t required = (int32_t)slot->bytes.size();
     if (required > capacity_bytes) {
+        WorldCamSlots::Release(slot);
         *out_bytes_written = required;
         return false;
     }
     
-    *out_info = g_frameInfo[idx];
-    std::memcpy(out_bytes, g_frameBytes[idx].data(), required);
+    *out_info = slot->info;
+    std::memcpy(out_bytes, slot->bytes.data(), required);
     *out_bytes_written = required;
+    WorldCamSlots::Release(slot);
     
     g_hasNewFrame[idx].store(false);
     
     return true;
 }
 
+// Zero-copy access to the latest frame of a camera
+extern "C" bool MLWorldCamUnity_AcquireLatest(
+    uint32_t camId,
+    WorldCamFrameInfo* out_info,
+    const uint8_t** out_bytes,
+    int32_t* out_size_bytes,
+    void** out_lease)
+{
+    if (!out_info || !out_bytes || !out_size_bytes || !out_lease) {
+        return false;
+    }
+    
+    *out_bytes = nullptr;
+    *out_size_bytes = 0;
+    *out_lease = nullptr;
+    
+    if (!g_initialized.load()) {
+        return false;
+    }
+    
+    int idx = CamIdToIndex(camId);
+    if (idx < 0 || idx >= 3) {
+        return false;
+    }
+    
+    if (!g_hasNewFrame[idx].load()) {
+        return false;
+    }
+    
+    const WorldCamSlots::Slot* slot = g_frameSlots[idx].Acquire();
+    if (!slot) {
+        return false;
+    }
+    
+    *out_info = slot->info;
+    *out_bytes = slot->bytes.data();
+    *out_size_bytes = (int32_t)slot->bytes.size();
+    *out_lease = (void*)slot;
+    
+    g_hasNewFrame[idx].store(false);
+    
+    return true;
+}
+
+extern "C" void MLWorldCamUnity_ReleaseFrame(void* lease) {
+    WorldCamSlots::Release((const WorldCamSlots::Slot*)lease);
+}
+
 // Get count of cameras with new frames available
 extern "C" int32_t MLWorldCamUnity_GetAvailableCount() {
     int32_t count = 0;
@@ -254,7 +304,7 @@ extern "C" void MLWorldCamUnity_Shutdown() {
     }
     
     for (int i = 0; i < 3; i++) {
-        g_frameBytes[i].clear();
+        g_frameSlots[i].Reset();
         g_hasNewFrame[i].store(false);
     }
     
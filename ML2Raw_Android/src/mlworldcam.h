@@ -42,6 +42,21 @@ bool MLWorldCamUnity_TryGetLatest(
   int32_t* out_bytes_written
 );
 
+// Zero-copy variant of MLWorldCamUnity_TryGetLatest: pins the latest frame of
+// camId and returns a read-only pointer into the plugin's pooled buffer.
+// The data stays valid until MLWorldCamUnity_ReleaseFrame(*out_lease); the
+// capture thread writes newer frames into other pool slots meanwhile.
+// Every successful acquire must be released exactly once.
+bool MLWorldCamUnity_AcquireLatest(
+  uint32_t camId,
+  WorldCamFrameInfo* out_info,
+  const uint8_t** out_bytes,
+  int32_t* out_size_bytes,
+  void** out_lease
+);
+
+void MLWorldCamUnity_ReleaseFrame(void* lease);
+
 // Get count of cameras with new frames available
 int32_t MLWorldCamUnity_GetAvailableCount(void);
 
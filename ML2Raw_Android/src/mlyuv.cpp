@@ -0,0 +1,534 @@
+#include "mlyuv.h"
+
+#include <cstring>
+#include <vector>
+
+// NEON kernels need AArch64; 32-bit ARM uses the scalar paths.
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#endif
+
+// ---------- Coefficients ----------
+//
+// With uu = (U - 128) << 8, mulhi(uu, k * 16384) = (U - 128) * k * 64, i.e. the
+// chroma term with 6 fractional bits. Coefficients are rounded to even values
+// so that NEON's doubling multiply (vqdmulh by k / 2) matches mulhi exactly.
+
+static int16_t EvenCoef(double k, double scale) {
+    return (int16_t)(2 * (int32_t)(k * scale * 0.5 + 0.5));
+}
+
+YuvCoeffs YuvCoefficients(YuvRange range) {
+    YuvCoeffs c;
+    if (range == YuvRange_Limited) {
+        const double yGain = 255.0 / 219.0;
+        const double cGain = 255.0 / 224.0;
+        c.yMin = 16;
+        c.yScale = EvenCoef(yGain - 1.0, 32768.0);
+        c.vr = EvenCoef(1.402 * cGain, 16384.0);
+        c.ug = EvenCoef(0.344136 * cGain, 16384.0);
+        c.vg = EvenCoef(0.714136 * cGain, 16384.0);
+        c.ub = EvenCoef(1.772 * cGain - 1.0, 16384.0);
+    } else {
+        c.yMin = 0;
+        c.yScale = 0;
+        c.vr = EvenCoef(1.402, 16384.0);
+        c.ug = EvenCoef(0.344136, 16384.0);
+        c.vg = EvenCoef(0.714136, 16384.0);
+        c.ub = EvenCoef(1.772 - 1.0, 16384.0);
+    }
+    return c;
+}
+
+// ---------- Scalar reference ----------
+
+static inline int32_t MulHi(int32_t a, int32_t k) {
+    return (a * k) >> 16;
+}
+
+static inline int32_t Sat16(int32_t v) {
+    return v < -32768 ? -32768 : (v > 32767 ? 32767 : v);
+}
+
+static inline uint8_t Narrow(int32_t v) {
+    v >>= 6;
+    return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+static inline void StorePixel(uint8_t* out, uint8_t r, uint8_t g, uint8_t b, RgbLayout layout) {
+    if (layout == RgbLayout_BGRA) {
+        out[0] = b;
+        out[1] = g;
+        out[2] = r;
+        out[3] = 255;
+    } else {
+        out[0] = r;
+        out[1] = g;
+        out[2] = b;
+        if (layout == RgbLayout_RGBA) out[3] = 255;
+    }
+}
+
+void YuvToRgbRowScalar(const uint8_t* y, const uint8_t* u, const uint8_t* v, int32_t width, bool chromaHalf,
+                       const YuvCoeffs& c, RgbLayout layout, uint8_t* out) {
+    const int32_t bpp = RgbBytesPerPixel(layout);
+    for (int32_t x = 0; x < width; x++) {
+        const int32_t ci = chromaHalf ? x >> 1 : x;
+        const int32_t uu = ((int32_t)u[ci] - 128) * 256;
+        const int32_t vv = ((int32_t)v[ci] - 128) * 256;
+        const int32_t rC = MulHi(vv, c.vr);
+        const int32_t gC = MulHi(uu, c.ug) + MulHi(vv, c.vg);
+        const int32_t bC = ((int32_t)u[ci] - 128) * 64 + MulHi(uu, c.ub);
+
+        const int32_t yy = y[x] > c.yMin ? (int32_t)y[x] - c.yMin : 0;
+        const int32_t yt = yy * 64 + MulHi(yy * 128, c.yScale) + 32;
+
+        StorePixel(out + x * bpp, Narrow(Sat16(yt + rC)), Narrow(Sat16(yt - gC)), Narrow(Sat16(yt + bC)), layout);
+    }
+}
+
+void YuvHalveRowScalar(const uint8_t* row0, const uint8_t* row1, int32_t outWidth, uint8_t* out) {
+    for (int32_t x = 0; x < outWidth; x++) {
+        out[x] = (uint8_t)((row0[2 * x] + row0[2 * x + 1] + row1[2 * x] + row1[2 * x + 1] + 2) >> 2);
+    }
+}
+
+void YuvGatherRowScalar(const uint8_t* src, int32_t pixelStride, int32_t count, uint8_t* out) {
+    for (int32_t x = 0; x < count; x++) {
+        out[x] = src[(size_t)x * pixelStride];
+    }
+}
+
+void YuvInterleaveRowScalar(const uint8_t* u, const uint8_t* v, int32_t count, uint8_t* out) {
+    for (int32_t x = 0; x < count; x++) {
+        out[2 * x] = u[x];
+        out[2 * x + 1] = v[x];
+    }
+}
+
+// ---------- SIMD ----------
+
+#if defined(__aarch64__)
+
+struct Chroma8 {
+    int16x8_t r, g, b;
+};
+
+static inline Chroma8 ChromaTerms(uint8x8_t u8, uint8x8_t v8, const YuvCoeffs& c) {
+    const int16x8_t bias = vdupq_n_s16(128);
+    const int16x8_t u = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u8)), bias);
+    const int16x8_t v = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v8)), bias);
+    const int16x8_t uu = vshlq_n_s16(u, 8);
+    const int16x8_t vv = vshlq_n_s16(v, 8);
+    Chroma8 t;
+    t.r = vqdmulhq_n_s16(vv, (int16_t)(c.vr / 2));
+    t.g = vaddq_s16(vqdmulhq_n_s16(uu, (int16_t)(c.ug / 2)), vqdmulhq_n_s16(vv, (int16_t)(c.vg / 2)));
+    t.b = vaddq_s16(vshlq_n_s16(u, 6), vqdmulhq_n_s16(uu, (int16_t)(c.ub / 2)));
+    return t;
+}
+
+static inline int16x8_t LumaTerm(uint8x8_t y8, const YuvCoeffs& c) {
+    const int16x8_t y = vreinterpretq_s16_u16(vqsubq_u16(vmovl_u8(y8), vdupq_n_u16((uint16_t)c.yMin)));
+    const int16x8_t scaled = vqdmulhq_n_s16(vshlq_n_s16(y, 7), (int16_t)(c.yScale / 2));
+    return vaddq_s16(vaddq_s16(vshlq_n_s16(y, 6), scaled), vdupq_n_s16(32));
+}
+
+static inline uint8x16_t Channel(int16x8_t ylo, int16x8_t yhi, int16x8_t clo, int16x8_t chi, bool subtract) {
+    const int16x8_t lo = subtract ? vqsubq_s16(ylo, clo) : vqaddq_s16(ylo, clo);
+    const int16x8_t hi = subtract ? vqsubq_s16(yhi, chi) : vqaddq_s16(yhi, chi);
+    return vcombine_u8(vqshrun_n_s16(lo, 6), vqshrun_n_s16(hi, 6));
+}
+
+static inline void Store16(uint8_t* out, uint8x16_t r, uint8x16_t g, uint8x16_t b, RgbLayout layout) {
+    if (layout == RgbLayout_RGB) {
+        uint8x16x3_t px = {{r, g, b}};
+        vst3q_u8(out, px);
+    } else {
+        const uint8x16_t a = vdupq_n_u8(255);
+        uint8x16x4_t px = layout == RgbLayout_BGRA ? uint8x16x4_t{{b, g, r, a}} : uint8x16x4_t{{r, g, b, a}};
+        vst4q_u8(out, px);
+    }
+}
+
+void YuvToRgbRow(const uint8_t* y, const uint8_t* u, const uint8_t* v, int32_t width, bool chromaHalf,
+                 const YuvCoeffs& c, RgbLayout layout, uint8_t* out) {
+    const int32_t bpp = RgbBytesPerPixel(layout);
+    int32_t x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        const uint8x16_t y16 = vld1q_u8(y + x);
+        const int16x8_t ylo = LumaTerm(vget_low_u8(y16), c);
+        const int16x8_t yhi = LumaTerm(vget_high_u8(y16), c);
+
+        Chroma8 lo, hi;
+        if (chromaHalf) {
+            const Chroma8 t = ChromaTerms(vld1_u8(u + x / 2), vld1_u8(v + x / 2), c);
+            lo.r = vzip1q_s16(t.r, t.r);
+            hi.r = vzip2q_s16(t.r, t.r);
+            lo.g = vzip1q_s16(t.g, t.g);
+            hi.g = vzip2q_s16(t.g, t.g);
+            lo.b = vzip1q_s16(t.b, t.b);
+            hi.b = vzip2q_s16(t.b, t.b);
+        } else {
+            const uint8x16_t u16 = vld1q_u8(u + x);
+            const uint8x16_t v16 = vld1q_u8(v + x);
+            lo = ChromaTerms(vget_low_u8(u16), vget_low_u8(v16), c);
+            hi = ChromaTerms(vget_high_u8(u16), vget_high_u8(v16), c);
+        }
+
+        Store16(out + x * bpp,
+                Channel(ylo, yhi, lo.r, hi.r, false),
+                Channel(ylo, yhi, lo.g, hi.g, true),
+                Channel(ylo, yhi, lo.b, hi.b, false),
+                layout);
+    }
+
+    if (x < width) {
+        const int32_t cx = chromaHalf ? x / 2 : x;
+        YuvToRgbRowScalar(y + x, u + cx, v + cx, width - x, chromaHalf, c, layout, out + x * bpp);
+    }
+}
+
+void YuvHalveRow(const uint8_t* row0, const uint8_t* row1, int32_t outWidth, uint8_t* out) {
+    int32_t x = 0;
+    for (; x + 16 <= outWidth; x += 16) {
+        uint16x8_t lo = vpaddlq_u8(vld1q_u8(row0 + 2 * x));
+        uint16x8_t hi = vpaddlq_u8(vld1q_u8(row0 + 2 * x + 16));
+        lo = vpadalq_u8(lo, vld1q_u8(row1 + 2 * x));
+        hi = vpadalq_u8(hi, vld1q_u8(row1 + 2 * x + 16));
+        vst1q_u8(out + x, vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));
+    }
+    if (x < outWidth) YuvHalveRowScalar(row0 + 2 * x, row1 + 2 * x, outWidth - x, out + x);
+}
+
+void YuvGatherRow(const uint8_t* src, int32_t pixelStride, int32_t count, uint8_t* out) {
+    if (pixelStride == 1) {
+        memcpy(out, src, (size_t)count);
+        return;
+    }
+    int32_t x = 0;
+    if (pixelStride == 2) {
+        // The last load ends one byte past the final sample: stop one block early
+        for (; x + 16 < count; x += 16) {
+            vst1q_u8(out + x, vld2q_u8(src + 2 * x).val[0]);
+        }
+    }
+    if (x < count) YuvGatherRowScalar(src + (size_t)x * pixelStride, pixelStride, count - x, out + x);
+}
+
+void YuvInterleaveRow(const uint8_t* u, const uint8_t* v, int32_t count, uint8_t* out) {
+    int32_t x = 0;
+    for (; x + 16 <= count; x += 16) {
+        uint8x16x2_t uv = {{vld1q_u8(u + x), vld1q_u8(v + x)}};
+        vst2q_u8(out + 2 * x, uv);
+    }
+    if (x < count) YuvInterleaveRowScalar(u + x, v + x, count - x, out + 2 * x);
+}
+
+#elif defined(__SSE2__)
+
+struct Chroma8 {
+    __m128i r, g, b;
+};
+
+static inline Chroma8 ChromaTerms(__m128i u16, __m128i v16, const YuvCoeffs& c) {
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i u = _mm_sub_epi16(u16, bias);
+    const __m128i v = _mm_sub_epi16(v16, bias);
+    const __m128i uu = _mm_slli_epi16(u, 8);
+    const __m128i vv = _mm_slli_epi16(v, 8);
+    Chroma8 t;
+    t.r = _mm_mulhi_epi16(vv, _mm_set1_epi16(c.vr));
+    t.g = _mm_add_epi16(_mm_mulhi_epi16(uu, _mm_set1_epi16(c.ug)), _mm_mulhi_epi16(vv, _mm_set1_epi16(c.vg)));
+    t.b = _mm_add_epi16(_mm_slli_epi16(u, 6), _mm_mulhi_epi16(uu, _mm_set1_epi16(c.ub)));
+    return t;
+}
+
+static inline __m128i LumaTerm(__m128i y16, const YuvCoeffs& c) {
+    const __m128i y = _mm_subs_epu16(y16, _mm_set1_epi16(c.yMin));
+    const __m128i scaled = _mm_mulhi_epi16(_mm_slli_epi16(y, 7), _mm_set1_epi16(c.yScale));
+    return _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(y, 6), scaled), _mm_set1_epi16(32));
+}
+
+static inline __m128i Channel(__m128i ylo, __m128i yhi, __m128i clo, __m128i chi, bool subtract) {
+    const __m128i lo = subtract ? _mm_subs_epi16(ylo, clo) : _mm_adds_epi16(ylo, clo);
+    const __m128i hi = subtract ? _mm_subs_epi16(yhi, chi) : _mm_adds_epi16(yhi, chi);
+    return _mm_packus_epi16(_mm_srai_epi16(lo, 6), _mm_srai_epi16(hi, 6));
+}
+
+static inline void Store16(uint8_t* out, __m128i r, __m128i g, __m128i b, RgbLayout layout) {
+    const __m128i a = _mm_set1_epi8((char)0xFF);
+    const __m128i c0 = layout == RgbLayout_BGRA ? b : r;
+    const __m128i c2 = layout == RgbLayout_BGRA ? r : b;
+    const __m128i c01lo = _mm_unpacklo_epi8(c0, g);
+    const __m128i c01hi = _mm_unpackhi_epi8(c0, g);
+    const __m128i c23lo = _mm_unpacklo_epi8(c2, a);
+    const __m128i c23hi = _mm_unpackhi_epi8(c2, a);
+    __m128i px[4] = {
+        _mm_unpacklo_epi16(c01lo, c23lo),
+        _mm_unpackhi_epi16(c01lo, c23lo),
+        _mm_unpacklo_epi16(c01hi, c23hi),
+        _mm_unpackhi_epi16(c01hi, c23hi),
+    };
+
+    if (layout != RgbLayout_RGB) {
+        for (int i = 0; i < 4; i++) _mm_storeu_si128((__m128i*)(out + 16 * i), px[i]);
+        return;
+    }
+
+#if defined(__SSSE3__)
+    // Drop every fourth byte: 4 x 12 packed bytes -> 48 bytes
+    const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    for (int i = 0; i < 4; i++) px[i] = _mm_shuffle_epi8(px[i], pack);
+    _mm_storeu_si128((__m128i*)(out + 0), _mm_or_si128(px[0], _mm_slli_si128(px[1], 12)));
+    _mm_storeu_si128((__m128i*)(out + 16), _mm_or_si128(_mm_srli_si128(px[1], 4), _mm_slli_si128(px[2], 8)));
+    _mm_storeu_si128((__m128i*)(out + 32), _mm_or_si128(_mm_srli_si128(px[2], 8), _mm_slli_si128(px[3], 4)));
+#else
+    alignas(16) uint8_t rgba[64];
+    for (int i = 0; i < 4; i++) _mm_store_si128((__m128i*)(rgba + 16 * i), px[i]);
+    for (int i = 0; i < 16; i++) {
+        out[3 * i + 0] = rgba[4 * i + 0];
+        out[3 * i + 1] = rgba[4 * i + 1];
+        out[3 * i + 2] = rgba[4 * i + 2];
+    }
+#endif
+}
+
+void YuvToRgbRow(const uint8_t* y, const uint8_t* u, const uint8_t* v, int32_t width, bool chromaHalf,
+                 const YuvCoeffs& c, RgbLayout layout, uint8_t* out) {
+    const int32_t bpp = RgbBytesPerPixel(layout);
+    const __m128i zero = _mm_setzero_si128();
+    int32_t x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        const __m128i y16 = _mm_loadu_si128((const __m128i*)(y + x));
+        const __m128i ylo = LumaTerm(_mm_unpacklo_epi8(y16, zero), c);
+        const __m128i yhi = LumaTerm(_mm_unpackhi_epi8(y16, zero), c);
+
+        Chroma8 lo, hi;
+        if (chromaHalf) {
+            const __m128i u8 = _mm_loadl_epi64((const __m128i*)(u + x / 2));
+            const __m128i v8 = _mm_loadl_epi64((const __m128i*)(v + x / 2));
+            const Chroma8 t = ChromaTerms(_mm_unpacklo_epi8(u8, zero), _mm_unpacklo_epi8(v8, zero), c);
+            lo.r = _mm_unpacklo_epi16(t.r, t.r);
+            hi.r = _mm_unpackhi_epi16(t.r, t.r);
+            lo.g = _mm_unpacklo_epi16(t.g, t.g);
+            hi.g = _mm_unpackhi_epi16(t.g, t.g);
+            lo.b = _mm_unpacklo_epi16(t.b, t.b);
+            hi.b = _mm_unpackhi_epi16(t.b, t.b);
+        } else {
+            const __m128i u16 = _mm_loadu_si128((const __m128i*)(u + x));
+            const __m128i v16 = _mm_loadu_si128((const __m128i*)(v + x));
+            lo = ChromaTerms(_mm_unpacklo_epi8(u16, zero), _mm_unpacklo_epi8(v16, zero), c);
+            hi = ChromaTerms(_mm_unpackhi_epi8(u16, zero), _mm_unpackhi_epi8(v16, zero), c);
+        }
+
+        Store16(out + x * bpp,
+                Channel(ylo, yhi, lo.r, hi.r, false),
+                Channel(ylo, yhi, lo.g, hi.g, true),
+                Channel(ylo, yhi, lo.b, hi.b, false),
+                layout);
+    }
+
+    if (x < width) {
+        const int32_t cx = chromaHalf ? x / 2 : x;
+        YuvToRgbRowScalar(y + x, u + cx, v + cx, width - x, chromaHalf, c, layout, out + x * bpp);
+    }
+}
+
+// Sums each byte pair of a 16-byte vector into 8 words
+static inline __m128i PairSums(__m128i v) {
+    const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+    return _mm_add_epi16(_mm_and_si128(v, lowBytes), _mm_srli_epi16(v, 8));
+}
+
+void YuvHalveRow(const uint8_t* row0, const uint8_t* row1, int32_t outWidth, uint8_t* out) {
+    const __m128i two = _mm_set1_epi16(2);
+    int32_t x = 0;
+    for (; x + 16 <= outWidth; x += 16) {
+        __m128i lo = _mm_add_epi16(PairSums(_mm_loadu_si128((const __m128i*)(row0 + 2 * x))),
+                                   PairSums(_mm_loadu_si128((const __m128i*)(row1 + 2 * x))));
+        __m128i hi = _mm_add_epi16(PairSums(_mm_loadu_si128((const __m128i*)(row0 + 2 * x + 16))),
+                                   PairSums(_mm_loadu_si128((const __m128i*)(row1 + 2 * x + 16))));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, two), 2);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, two), 2);
+        _mm_storeu_si128((__m128i*)(out + x), _mm_packus_epi16(lo, hi));
+    }
+    if (x < outWidth) YuvHalveRowScalar(row0 + 2 * x, row1 + 2 * x, outWidth - x, out + x);
+}
+
+void YuvGatherRow(const uint8_t* src, int32_t pixelStride, int32_t count, uint8_t* out) {
+    if (pixelStride == 1) {
+        memcpy(out, src, (size_t)count);
+        return;
+    }
+    int32_t x = 0;
+    if (pixelStride == 2) {
+        const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+        // The last load ends one byte past the final sample: stop one block early
+        for (; x + 16 < count; x += 16) {
+            const __m128i a = _mm_and_si128(_mm_loadu_si128((const __m128i*)(src + 2 * x)), lowBytes);
+            const __m128i b = _mm_and_si128(_mm_loadu_si128((const __m128i*)(src + 2 * x + 16)), lowBytes);
+            _mm_storeu_si128((__m128i*)(out + x), _mm_packus_epi16(a, b));
+        }
+    }
+    if (x < count) YuvGatherRowScalar(src + (size_t)x * pixelStride, pixelStride, count - x, out + x);
+}
+
+void YuvInterleaveRow(const uint8_t* u, const uint8_t* v, int32_t count, uint8_t* out) {
+    int32_t x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i*)(u + x));
+        const __m128i b = _mm_loadu_si128((const __m128i*)(v + x));
+        _mm_storeu_si128((__m128i*)(out + 2 * x), _mm_unpacklo_epi8(a, b));
+        _mm_storeu_si128((__m128i*)(out + 2 * x + 16), _mm_unpackhi_epi8(a, b));
+    }
+    if (x < count) YuvInterleaveRowScalar(u + x, v + x, count - x, out + 2 * x);
+}
+
+#else
+
+void YuvToRgbRow(const uint8_t* y, const uint8_t* u, const uint8_t* v, int32_t width, bool chromaHalf,
+                 const YuvCoeffs& c, RgbLayout layout, uint8_t* out) {
+    YuvToRgbRowScalar(y, u, v, width, chromaHalf, c, layout, out);
+}
+
+void YuvHalveRow(const uint8_t* row0, const uint8_t* row1, int32_t outWidth, uint8_t* out) {
+    YuvHalveRowScalar(row0, row1, outWidth, out);
+}
+
+void YuvGatherRow(const uint8_t* src, int32_t pixelStride, int32_t count, uint8_t* out) {
+    if (pixelStride == 1) {
+        memcpy(out, src, (size_t)count);
+        return;
+    }
+    YuvGatherRowScalar(src, pixelStride, count, out);
+}
+
+void YuvInterleaveRow(const uint8_t* u, const uint8_t* v, int32_t count, uint8_t* out) {
+    YuvInterleaveRowScalar(u, v, count, out);
+}
+
+#endif
+
+// ---------- Whole image ----------
+
+void YuvOutputSize(const YuvImage& src, int32_t downscale, int32_t* outWidth, int32_t* outHeight) {
+    const bool supported = downscale == 1 || downscale == 2 || downscale == 4;
+    *outWidth = supported ? src.width / downscale : 0;
+    *outHeight = supported ? src.height / downscale : 0;
+}
+
+bool YuvToRgb(const YuvImage& src, YuvRange range, RgbLayout layout, int32_t downscale, uint8_t* out) {
+    int32_t outWidth, outHeight;
+    YuvOutputSize(src, downscale, &outWidth, &outHeight);
+    if (!src.y || !src.u || !src.v || !out || outWidth <= 0 || outHeight <= 0 || src.uvPixelStride < 1) {
+        return false;
+    }
+
+    const YuvCoeffs c = YuvCoefficients(range);
+    const int32_t chromaWidth = (src.width + 1) / 2;
+    const int32_t halfWidth = src.width / 2;
+    const size_t outStride = (size_t)outWidth * RgbBytesPerPixel(layout);
+
+    // Packed chroma rows (two per plane for 4x) and the Y rows being reduced
+    static thread_local std::vector<uint8_t> scratch;
+    scratch.resize((size_t)chromaWidth * 6 + (size_t)halfWidth * 2 + (size_t)outWidth);
+    uint8_t* uRow[2] = {scratch.data(), scratch.data() + chromaWidth};
+    uint8_t* vRow[2] = {uRow[1] + chromaWidth, uRow[1] + 2 * chromaWidth};
+    uint8_t* uOut = vRow[1] + chromaWidth;
+    uint8_t* vOut = uOut + chromaWidth;
+    uint8_t* yHalf[2] = {vOut + chromaWidth, vOut + chromaWidth + halfWidth};
+    uint8_t* yOut = yHalf[1] + halfWidth;
+
+    auto lumaRow = [&](int32_t row) { return src.y + (size_t)row * src.yStride; };
+    auto chromaRow = [&](const uint8_t* plane, int32_t row, uint8_t* buffer) -> const uint8_t* {
+        const uint8_t* p = plane + (size_t)row * src.uvStride;
+        if (src.uvPixelStride == 1) return p;
+        YuvGatherRow(p, src.uvPixelStride, chromaWidth, buffer);
+        return buffer;
+    };
+
+    const uint8_t* u = nullptr;
+    const uint8_t* v = nullptr;
+    for (int32_t row = 0; row < outHeight; row++) {
+        uint8_t* dst = out + (size_t)row * outStride;
+
+        if (downscale == 1) {
+            // Each chroma row serves two output rows
+            if ((row & 1) == 0) {
+                u = chromaRow(src.u, row / 2, uRow[0]);
+                v = chromaRow(src.v, row / 2, vRow[0]);
+            }
+            YuvToRgbRow(lumaRow(row), u, v, outWidth, true, c, layout, dst);
+        } else if (downscale == 2) {
+            YuvHalveRow(lumaRow(2 * row), lumaRow(2 * row + 1), outWidth, yOut);
+            u = chromaRow(src.u, row, uRow[0]);
+            v = chromaRow(src.v, row, vRow[0]);
+            YuvToRgbRow(yOut, u, v, outWidth, false, c, layout, dst);
+        } else {
+            YuvHalveRow(lumaRow(4 * row), lumaRow(4 * row + 1), halfWidth, yHalf[0]);
+            YuvHalveRow(lumaRow(4 * row + 2), lumaRow(4 * row + 3), halfWidth, yHalf[1]);
+            YuvHalveRow(yHalf[0], yHalf[1], outWidth, yOut);
+            YuvHalveRow(chromaRow(src.u, 2 * row, uRow[0]), chromaRow(src.u, 2 * row + 1, uRow[1]), outWidth, uOut);
+            YuvHalveRow(chromaRow(src.v, 2 * row, vRow[0]), chromaRow(src.v, 2 * row + 1, vRow[1]), outWidth, vOut);
+            YuvToRgbRow(yOut, uOut, vOut, outWidth, false, c, layout, dst);
+        }
+    }
+    return true;
+}
+
+bool YuvRepack(const YuvImage& src, YuvPacking packing, uint8_t* out) {
+    if (!src.y || !src.u || !src.v || !out || src.width <= 0 || src.height <= 0 || src.uvPixelStride < 1) {
+        return false;
+    }
+
+    const int32_t chromaWidth = (src.width + 1) / 2;
+    const int32_t chromaHeight = (src.height + 1) / 2;
+
+    for (int32_t row = 0; row < src.height; row++) {
+        memcpy(out + (size_t)row * src.width, src.y + (size_t)row * src.yStride, (size_t)src.width);
+    }
+    uint8_t* chroma = out + (size_t)src.width * src.height;
+
+    if (packing == YuvPacking_I420) {
+        uint8_t* uOut = chroma;
+        uint8_t* vOut = chroma + (size_t)chromaWidth * chromaHeight;
+        for (int32_t row = 0; row < chromaHeight; row++) {
+            const size_t offset = (size_t)row * src.uvStride;
+            YuvGatherRow(src.u + offset, src.uvPixelStride, chromaWidth, uOut + (size_t)row * chromaWidth);
+            YuvGatherRow(src.v + offset, src.uvPixelStride, chromaWidth, vOut + (size_t)row * chromaWidth);
+        }
+        return true;
+    }
+
+    // NV12 straight from an NV12 source: the UV row is already interleaved
+    const size_t uvRowBytes = (size_t)chromaWidth * 2;
+    if (src.uvPixelStride == 2 && src.v == src.u + 1) {
+        for (int32_t row = 0; row < chromaHeight; row++) {
+            memcpy(chroma + row * uvRowBytes, src.u + (size_t)row * src.uvStride, uvRowBytes);
+        }
+        return true;
+    }
+
+    static thread_local std::vector<uint8_t> scratch;
+    scratch.resize((size_t)chromaWidth * 2);
+    for (int32_t row = 0; row < chromaHeight; row++) {
+        const size_t offset = (size_t)row * src.uvStride;
+        const uint8_t* u = src.u + offset;
+        const uint8_t* v = src.v + offset;
+        if (src.uvPixelStride != 1) {
+            YuvGatherRow(u, src.uvPixelStride, chromaWidth, scratch.data());
+            YuvGatherRow(v, src.uvPixelStride, chromaWidth, scratch.data() + chromaWidth);
+            u = scratch.data();
+            v = scratch.data() + chromaWidth;
+        }
+        YuvInterleaveRow(u, v, chromaWidth, chroma + row * uvRowBytes);
+    }
+    return true;
+}
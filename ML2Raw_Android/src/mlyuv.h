@@ -0,0 +1,95 @@
+#pragma once
+// Internal C++ YUV 4:2:0 to RGB conversion for the RGB camera (not part of
+// the Unity API). Every row kernel has a scalar reference; the default entry
+// point dispatches to NEON or SSE2 when the target supports it and gives
+// bit-identical results.
+//
+// BT.601 in 16-bit fixed point (6 fractional bits). Chroma is upsampled by
+// nearest neighbour; downscaling averages 2x2 blocks (twice for 4x).
+
+#include <cstddef>
+#include <cstdint>
+
+enum YuvRange {
+    YuvRange_Full = 0,     // JFIF: Y, U, V in 0..255 (camera YUV_420_888 default)
+    YuvRange_Limited = 1   // video range: Y in 16..235, U/V in 16..240
+};
+
+enum RgbLayout {
+    RgbLayout_RGBA = 0,
+    RgbLayout_RGB = 1,
+    RgbLayout_BGRA = 2
+};
+
+// One YUV 4:2:0 image. uvPixelStride is 1 for planar (I420/YV12) and 2 for
+// semi-planar (NV12/NV21, u and v pointing into the same interleaved plane or
+// into separate copies of it).
+struct YuvImage {
+    const uint8_t* y;
+    const uint8_t* u;
+    const uint8_t* v;
+    int32_t width;
+    int32_t height;
+    int32_t yStride;
+    int32_t uvStride;
+    int32_t uvPixelStride;
+};
+
+// Tightly packed 4:2:0 layouts: Y rows of width bytes, then
+//   I420: U plane, V plane, rows of (width + 1) / 2 bytes
+//   NV12: one interleaved UV plane, rows of 2 * ((width + 1) / 2) bytes
+enum YuvPacking {
+    YuvPacking_I420 = 0,
+    YuvPacking_NV12 = 1
+};
+
+// Fixed-point coefficients, see YuvCoefficients
+struct YuvCoeffs {
+    int16_t yMin;     // subtracted (with clamping) before scaling Y
+    int16_t yScale;   // Y gain - 1, applied as mulhi(y << 7, yScale)
+    int16_t vr;       // R += mulhi((V - 128) << 8, vr)
+    int16_t ug;       // G -= mulhi((U - 128) << 8, ug)
+    int16_t vg;       // G -= mulhi((V - 128) << 8, vg)
+    int16_t ub;       // B += (U - 128) << 6 + mulhi((U - 128) << 8, ub)
+};
+
+YuvCoeffs YuvCoefficients(YuvRange range);
+
+inline int32_t RgbBytesPerPixel(RgbLayout layout) {
+    return layout == RgbLayout_RGB ? 3 : 4;
+}
+
+// Converts one output row. chromaHalf = true: u/v hold (width + 1) / 2
+// samples, each shared by two pixels; false: one u/v sample per pixel.
+void YuvToRgbRowScalar(const uint8_t* y, const uint8_t* u, const uint8_t* v, int32_t width, bool chromaHalf,
+                       const YuvCoeffs& c, RgbLayout layout, uint8_t* out);
+void YuvToRgbRow(const uint8_t* y, const uint8_t* u, const uint8_t* v, int32_t width, bool chromaHalf,
+                 const YuvCoeffs& c, RgbLayout layout, uint8_t* out);
+
+// 2x2 box average of two rows into outWidth samples: (a + b + c + d + 2) >> 2
+void YuvHalveRowScalar(const uint8_t* row0, const uint8_t* row1, int32_t outWidth, uint8_t* out);
+void YuvHalveRow(const uint8_t* row0, const uint8_t* row1, int32_t outWidth, uint8_t* out);
+
+// Copies count samples spaced pixelStride bytes apart into a packed row
+void YuvGatherRowScalar(const uint8_t* src, int32_t pixelStride, int32_t count, uint8_t* out);
+void YuvGatherRow(const uint8_t* src, int32_t pixelStride, int32_t count, uint8_t* out);
+
+// Interleaves count u and v samples into u0 v0 u1 v1 ...
+void YuvInterleaveRowScalar(const uint8_t* u, const uint8_t* v, int32_t count, uint8_t* out);
+void YuvInterleaveRow(const uint8_t* u, const uint8_t* v, int32_t count, uint8_t* out);
+
+// Output size for a downscale factor (1, 2 or 4; other values give 0x0)
+void YuvOutputSize(const YuvImage& src, int32_t downscale, int32_t* outWidth, int32_t* outHeight);
+
+// Converts a whole image into tightly packed rows of outWidth pixels.
+// Returns false for unsupported arguments. Uses a per-thread scratch buffer.
+bool YuvToRgb(const YuvImage& src, YuvRange range, RgbLayout layout, int32_t downscale, uint8_t* out);
+
+inline size_t YuvPackedSize(int32_t width, int32_t height) {
+    const size_t chroma = (size_t)((width + 1) / 2) * (size_t)((height + 1) / 2);
+    return (size_t)width * (size_t)height + 2 * chroma;
+}
+
+// Copies src into YuvPackedSize bytes of out in the given packing. A
+// semi-planar source with v == u + 1 is copied row by row for NV12.
+bool YuvRepack(const YuvImage& src, YuvPacking packing, uint8_t* out);
@@ -0,0 +1,58 @@
+// Per-frame cost of depth unprojection (MLDepthCloudUnity_Unproject) for a
+// 544x480 float depth frame, XYZ and XYZC output, with the SIMD row kernel
+// and the scalar reference.
+//
+//   bench_depthcloud [frames]
+
+#include "mldepthcloud.h"
+#include "testing.h"
+
+#include <cstring>
+
+extern "C" {
+bool MLDepthUnity_AcquireLatest(uint32_t, DepthFrameInfo*, const uint8_t**, int32_t*, void**) { return false; }
+void MLDepthUnity_ReleaseFrame(void*) {}
+bool MLDepthUnity_GetFrameCalibration(int64_t, DepthIntrinsics*, DepthCameraPose*) { return false; }
+}
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? atoi(argv[1]) : 200;
+    const int32_t width = 544, height = 480;
+
+    TestRandom rng(4);
+    std::vector<float> depth((size_t)width * height), conf((size_t)width * height);
+    for (size_t i = 0; i < depth.size(); i++) {
+        depth[i] = rng.Uniform(0.0f, 1.0f) < 0.05f ? 0.0f : rng.Uniform(0.5f, 4.0f);
+        conf[i] = rng.Uniform(0.0f, 1.0f);
+    }
+    DepthFrameInfo info;
+    memset(&info, 0, sizeof(info));
+    info.width = width;
+    info.height = height;
+    info.strideBytes = width * 4;
+    info.bytesPerPixel = 4;
+    const DepthIntrinsics intrinsics = {width, height, 363.0f, 365.0f, 270.2f, 242.7f, 0};
+
+    std::vector<float> out((size_t)width * height * 4);
+    printf("%dx%d depth, %d frames\n", width, height, frames);
+    const char* names[] = {"XYZ", "XYZC"};
+    for (uint32_t conf4 : {0u, (uint32_t)DepthCloudFlag_Confidence}) {
+        double p50[2], p99[2];
+        for (int scalar = 0; scalar < 2; scalar++) {
+            const uint32_t flags = conf4 | (scalar ? DepthCloudFlag_ForceScalar : 0);
+            std::vector<double> us;
+            for (int f = 0; f < frames; f++) {
+                int32_t count = 0;
+                const int64_t t0 = TestNowNs();
+                MLDepthCloudUnity_Unproject(&info, (const uint8_t*)depth.data(), &info, (const uint8_t*)conf.data(),
+                                            &intrinsics, flags, out.data(), (int32_t)out.size(), &count);
+                us.push_back((double)(TestNowNs() - t0) * 1e-3);
+            }
+            p50[scalar] = Percentile(us, 0.5);
+            p99[scalar] = Percentile(us, 0.99);
+        }
+        printf("%-4s  SIMD p50 %6.0f us p99 %6.0f us  scalar p50 %6.0f us p99 %6.0f us  (%.1fx)\n",
+               names[conf4 ? 1 : 0], p50[0], p99[0], p50[1], p99[1], p50[1] / p50[0]);
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Throughput and compression ratio of the depth codec on synthetic 544x480
+// frames: 16-bit millimetres and float32 metres, each with 10% invalid pixels.
+//
+//   bench_depthcodec [iterations]
+
+#include "mldepthcodec.h"
+#include "testing.h"
+
+#include <cstring>
+
+extern "C" bool MLDepthUnity_AcquireLatest(uint32_t, DepthFrameInfo*, const uint8_t**, int32_t*, void**) {
+    return false;
+}
+
+extern "C" void MLDepthUnity_ReleaseFrame(void*) {}
+
+static void Bench(const char* name, const DepthFrameInfo& info, const std::vector<uint8_t>& bytes, int iterations) {
+    std::vector<uint8_t> encoded((size_t)MLDepthCodecUnity_MaxEncodedSize(&info));
+    std::vector<uint8_t> decoded(bytes.size());
+    int32_t encodedSize = 0, decodedSize = 0;
+    DepthFrameInfo out;
+
+    std::vector<double> encodeUs, decodeUs;
+    for (int i = 0; i < iterations; i++) {
+        int64_t t0 = TestNowNs();
+        CHECK(MLDepthCodecUnity_Encode(&info, bytes.data(), encoded.data(), (int32_t)encoded.size(), &encodedSize));
+        int64_t t1 = TestNowNs();
+        CHECK(MLDepthCodecUnity_Decode(encoded.data(), encodedSize, &out, decoded.data(), (int32_t)decoded.size(), &decodedSize));
+        int64_t t2 = TestNowNs();
+        encodeUs.push_back((double)(t1 - t0) * 1e-3);
+        decodeUs.push_back((double)(t2 - t1) * 1e-3);
+    }
+    CHECK(decoded == bytes);
+
+    const double encodeP50 = Percentile(encodeUs, 0.5), decodeP50 = Percentile(decodeUs, 0.5);
+    printf("%-8s ratio %5.2f:1  encode %7.0f us (%6.0f fps, %6.1f MB/s)  decode %7.0f us (%6.0f fps)\n",
+           name, (double)bytes.size() / encodedSize,
+           encodeP50, 1e6 / encodeP50, (double)bytes.size() / encodeP50,
+           decodeP50, 1e6 / decodeP50);
+}
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? atoi(argv[1]) : 50;
+    const int32_t width = 544, height = 480;
+    TestRandom rng(7);
+
+    DepthFrameInfo info;
+    memset(&info, 0, sizeof(info));
+    info.width = width;
+    info.height = height;
+
+    std::vector<uint8_t> bytes16((size_t)width * height * 2);
+    std::vector<uint8_t> bytesF((size_t)width * height * 4);
+    uint16_t* mm = (uint16_t*)bytes16.data();
+    float* meters = (float*)bytesF.data();
+    for (int32_t v = 0; v < height; v++) {
+        for (int32_t u = 0; u < width; u++) {
+            const bool hole = rng.Uniform(0.0f, 1.0f) < 0.1f;
+            const float depth = 0.8f + 0.003f * u + 0.0015f * v + rng.Uniform(-0.004f, 0.004f);
+            mm[v * width + u] = hole ? 0 : (uint16_t)(depth * 1000.0f);
+            meters[v * width + u] = hole ? 0.0f : depth;
+        }
+    }
+
+    printf("%dx%d, %d iterations (p50)\n", width, height, iterations);
+    info.bytesPerPixel = 2;
+    Bench("uint16", info, bytes16, iterations);
+    info.bytesPerPixel = 4;
+    Bench("float32", info, bytesF, iterations);
+    return 0;
+}
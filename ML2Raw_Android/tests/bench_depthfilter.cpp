@@ -0,0 +1,117 @@
+// Per-frame cost of the temporal depth filter kernel (DepthTemporalRow, as
+// StoreFiltered runs it on the capture thread) against its scalar reference,
+// on synthetic float depth with and without a confidence buffer.
+//
+// Also the confidence/flag mask: the fused DepthMaskRow copy StoreDepth does
+// plus one depth CopyOut, against the three-fetch path it replaces (plain
+// depth copy on capture, then depth, confidence and flags copied out and
+// masked by the consumer).
+//
+//   bench_depthfilter [frames] [width] [height]
+
+#include "mldepthkernels.h"
+#include "testing.h"
+
+#include <cstring>
+
+typedef void (*TemporalRowFn)(const float*, const float*, const float*, float, float, int32_t, float*);
+
+static void Bench(const char* name, TemporalRowFn fn, bool withConfidence, int frames, int32_t width, int32_t height) {
+    const size_t pixels = (size_t)width * height;
+    TestRandom rng(11);
+
+    // A few input frames with noise and ~5% holes, cycled so the filter sees
+    // changing depth; one in 50 pixels jumps past the reset threshold.
+    const int kInputs = 4;
+    std::vector<std::vector<float>> depth(kInputs, std::vector<float>(pixels));
+    std::vector<float> conf(pixels);
+    for (int f = 0; f < kInputs; f++) {
+        for (size_t i = 0; i < pixels; i++) {
+            const float base = 1.0f + 0.001f * (float)(i % (size_t)width);
+            const float r = rng.Uniform(0.0f, 1.0f);
+            depth[f][i] = r < 0.05f ? 0.0f : r < 0.07f ? base + 0.5f : base + rng.Uniform(-0.01f, 0.01f);
+        }
+    }
+    for (float& c : conf) c = rng.Uniform(0.0f, 1.2f);
+
+    std::vector<float> filtered(pixels, 0.0f);
+    std::vector<double> frameUs;
+    for (int f = 0; f < frames; f++) {
+        const std::vector<float>& in = depth[f % kInputs];
+        const int64_t t0 = TestNowNs();
+        for (int32_t v = 0; v < height; v++) {
+            const size_t row = (size_t)v * width;
+            fn(in.data() + row, withConfidence ? conf.data() + row : nullptr,
+               f > 0 ? filtered.data() + row : nullptr, 0.3f, 0.1f, width, filtered.data() + row);
+        }
+        frameUs.push_back((double)(TestNowNs() - t0) * 1e-3);
+    }
+
+    const double p50 = Percentile(frameUs, 0.5), p99 = Percentile(frameUs, 0.99);
+    printf("%-8s %-12s p50 %7.1f us  p99 %7.1f us  (%.2f ns/pixel)\n",
+           name, withConfidence ? "confidence" : "no conf", p50, p99, p50 * 1e3 / (double)pixels);
+}
+
+static void BenchMask(int frames, int32_t width, int32_t height) {
+    const size_t pixels = (size_t)width * height;
+    TestRandom rng(12);
+    std::vector<float> depth(pixels), conf(pixels);
+    std::vector<uint32_t> flags(pixels);
+    for (size_t i = 0; i < pixels; i++) {
+        depth[i] = rng.Uniform(0.3f, 5.0f);
+        conf[i] = rng.Uniform(0.0f, 1.0f);
+        flags[i] = rng.Uniform(0.0f, 1.0f) < 0.05f ? 1u << (rng.Next() % 8) : 0u;
+    }
+    const float minConf = 0.2f;
+    const uint32_t reject = 0x0Fu;
+
+    // Capture-side slots and consumer-side buffers
+    std::vector<float> slotDepth(pixels), slotConf(pixels), outDepth(pixels), outConf(pixels);
+    std::vector<uint32_t> slotFlags(pixels), outFlags(pixels);
+    const size_t bytes = pixels * 4;
+
+    auto run = [&](const char* name, auto frame) {
+        std::vector<double> frameUs;
+        for (int f = 0; f < frames; f++) {
+            const int64_t t0 = TestNowNs();
+            frame();
+            frameUs.push_back((double)(TestNowNs() - t0) * 1e-3);
+        }
+        const double p50 = Percentile(frameUs, 0.5), p99 = Percentile(frameUs, 0.99);
+        printf("mask %-24s p50 %7.1f us  p99 %7.1f us\n", name, p50, p99);
+    };
+
+    run("three-fetch", [&] {
+        memcpy(slotDepth.data(), depth.data(), bytes);
+        memcpy(outDepth.data(), slotDepth.data(), bytes);
+        memcpy(outConf.data(), slotConf.data(), bytes);
+        memcpy(outFlags.data(), slotFlags.data(), bytes);
+        for (size_t i = 0; i < pixels; i++) {
+            if (!(outConf[i] >= minConf) || (outFlags[i] & reject) != 0) outDepth[i] = 0.0f;
+        }
+    });
+    auto fused = [&](bool scalar) {
+        for (int32_t v = 0; v < height; v++) {
+            const size_t row = (size_t)v * width;
+            (scalar ? DepthMaskRowScalar : DepthMaskRow)(depth.data() + row, conf.data() + row, flags.data() + row,
+                                                         minConf, reject, width, slotDepth.data() + row);
+        }
+        memcpy(outDepth.data(), slotDepth.data(), bytes);
+    };
+    run("fused, scalar kernel", [&] { fused(true); });
+    run("fused, dispatch", [&] { fused(false); });
+}
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? atoi(argv[1]) : 300;
+    const int32_t width = argc > 2 ? atoi(argv[2]) : 544;
+    const int32_t height = argc > 3 ? atoi(argv[3]) : 480;
+
+    printf("%dx%d, %d frames\n", width, height, frames);
+    for (bool withConfidence : {false, true}) {
+        Bench("scalar", DepthTemporalRowScalar, withConfidence, frames, width, height);
+        Bench("dispatch", DepthTemporalRow, withConfidence, frames, width, height);
+    }
+    BenchMask(frames, width, height);
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Per-frame cost of normal estimation (MLDepthNormalsUnity_Compute, as the
+// capture thread runs it when normals are configured) for a 544x480 float
+// depth frame: smoothing radius 0-3, float3 and octahedral 16-bit output,
+// SIMD kernels against the scalar reference.
+//
+//   bench_depthnormals [frames]
+
+#include "mldepthnormals.h"
+#include "testing.h"
+
+#include <cstring>
+
+extern "C" {
+bool MLDepthUnity_AcquireLatest(uint32_t, DepthFrameInfo*, const uint8_t**, int32_t*, void**) { return false; }
+void MLDepthUnity_ReleaseFrame(void*) {}
+bool MLDepthUnity_GetFrameCalibration(int64_t, DepthIntrinsics*, DepthCameraPose*) { return false; }
+}
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? atoi(argv[1]) : 100;
+    const int32_t width = 544, height = 480;
+
+    // Curved wall with noise and ~3% holes
+    TestRandom rng(13);
+    std::vector<float> depth((size_t)width * height);
+    for (int32_t v = 0; v < height; v++) {
+        for (int32_t u = 0; u < width; u++) {
+            const float r = rng.Uniform(0.0f, 1.0f);
+            depth[(size_t)v * width + u] =
+                r < 0.03f ? 0.0f : 2.0f + 0.3f * std::sin((float)u / 60.0f) + rng.Uniform(-0.005f, 0.005f);
+        }
+    }
+    DepthFrameInfo info;
+    memset(&info, 0, sizeof(info));
+    info.width = width;
+    info.height = height;
+    info.strideBytes = width * 4;
+    info.bytesPerPixel = 4;
+    const DepthIntrinsics intrinsics = {width, height, 363.0f, 365.0f, 270.2f, 242.7f, 0};
+
+    std::vector<uint8_t> out((size_t)width * height * 12);
+    printf("%dx%d depth, %d frames, p50 / p99 per frame\n", width, height, frames);
+    const char* names[] = {"float3", "oct16"};
+    for (uint32_t format : {DepthNormalFormat_Float3, DepthNormalFormat_Oct16}) {
+        for (int32_t radius = 0; radius <= 3; radius++) {
+            double p50[2], p99[2];
+            for (int scalar = 0; scalar < 2; scalar++) {
+                std::vector<double> us;
+                for (int f = 0; f < frames; f++) {
+                    int32_t written = 0;
+                    const int64_t t0 = TestNowNs();
+                    MLDepthNormalsUnity_Compute(&info, (const uint8_t*)depth.data(), &intrinsics, format, radius, 0.05f,
+                                                scalar ? DepthNormalFlag_ForceScalar : 0, out.data(),
+                                                (int32_t)out.size(), &written);
+                    us.push_back((double)(TestNowNs() - t0) * 1e-3);
+                }
+                p50[scalar] = Percentile(us, 0.5);
+                p99[scalar] = Percentile(us, 0.99);
+            }
+            printf("%-6s radius %d  SIMD %6.0f / %6.0f us  scalar %6.0f / %6.0f us  (%.2fx)\n", names[format], radius,
+                   p50[0], p99[0], p50[1], p99[1], p50[1] / p50[0]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Per-frame cost of the depth pyramid (DepthPyramid_ProcessFrame, as the
+// capture thread runs it after each processed depth frame) for a 544x480
+// float frame, in each reduction mode at 1-4 levels, against the same levels
+// built with the scalar row kernels.
+//
+//   bench_depthpyramid [frames]
+
+#include "mldepthkernels.h"
+#include "mldepthpyramid.h"
+#include "testing.h"
+
+#include <cstring>
+
+namespace {
+
+// The pyramid with the scalar kernels, for the speedup column
+void ScalarPyramid(const float* depth, const float* conf, int32_t width, int32_t height, int32_t levels,
+                   uint32_t mode, std::vector<float>* out, std::vector<float>* weights) {
+    const float* src = depth;
+    const float* srcWeights = mode == DepthPyramid_ConfidenceWeighted ? conf : nullptr;
+    for (int32_t level = 0; level < levels; level++) {
+        const int32_t outWidth = width / 2, outHeight = height / 2;
+        float* dst = out[level].data();
+        float* dstWeights = weights[level].data();
+        for (int32_t y = 0; y < outHeight; y++) {
+            const float* row0 = src + (size_t)(2 * y) * width;
+            const float* row1 = row0 + width;
+            if (mode == DepthPyramid_Median) {
+                DepthReduceMedianRowScalar(row0, row1, outWidth, dst + (size_t)y * outWidth);
+            } else if (mode == DepthPyramid_ConfidenceWeighted) {
+                const float* w0 = srcWeights ? srcWeights + (size_t)(2 * y) * width : nullptr;
+                DepthReduceWeightedRowScalar(row0, row1, w0, w0 ? w0 + width : nullptr, outWidth,
+                                             dst + (size_t)y * outWidth, dstWeights + (size_t)y * outWidth);
+            } else {
+                DepthReduceMinRowScalar(row0, row1, outWidth, dst + (size_t)y * outWidth);
+            }
+        }
+        src = dst;
+        srcWeights = mode == DepthPyramid_ConfidenceWeighted ? dstWeights : nullptr;
+        width = outWidth;
+        height = outHeight;
+    }
+}
+
+template <typename Fn>
+void FrameUs(int frames, Fn fn, double* p50, double* p99) {
+    std::vector<double> us;
+    for (int f = 0; f < frames; f++) {
+        const int64_t t0 = TestNowNs();
+        fn();
+        us.push_back((double)(TestNowNs() - t0) * 1e-3);
+    }
+    *p50 = Percentile(us, 0.5);
+    *p99 = Percentile(us, 0.99);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? atoi(argv[1]) : 200;
+    const int32_t width = 544, height = 480;
+
+    // Noisy wall with ~10% holes and confidence in [0, 1]
+    TestRandom rng(9);
+    std::vector<float> depth((size_t)width * height), conf((size_t)width * height);
+    for (size_t i = 0; i < depth.size(); i++) {
+        depth[i] = rng.Uniform(0.0f, 1.0f) < 0.1f ? 0.0f : 2.0f + rng.Uniform(-0.05f, 0.05f);
+        conf[i] = rng.Uniform(0.0f, 1.0f);
+    }
+    DepthFrameInfo info;
+    memset(&info, 0, sizeof(info));
+    info.width = width;
+    info.height = height;
+    info.strideBytes = width * 4;
+    info.bytesPerPixel = 4;
+
+    std::vector<float> out[4], weights[4];
+    for (int32_t level = 0; level < 4; level++) {
+        const size_t n = (size_t)(width >> (level + 1)) * (height >> (level + 1));
+        out[level].resize(n);
+        weights[level].resize(n);
+    }
+
+    printf("%dx%d depth, %d frames, p50 / p99 per frame\n", width, height, frames);
+    const char* names[] = {"min", "median", "weighted"};
+    for (uint32_t mode : {DepthPyramid_Min, DepthPyramid_Median, DepthPyramid_ConfidenceWeighted}) {
+        for (int32_t levels = 1; levels <= 4; levels++) {
+            MLDepthPyramidUnity_Configure(levels, mode);
+            double p50, p99, scalar50, scalar99;
+            FrameUs(frames, [&] { DepthPyramid_ProcessFrame(info, (const uint8_t*)depth.data(), conf.data(), width * 4); },
+                    &p50, &p99);
+            FrameUs(frames, [&] { ScalarPyramid(depth.data(), conf.data(), width, height, levels, mode, out, weights); },
+                    &scalar50, &scalar99);
+            printf("%-8s levels %d  dispatch %6.0f / %6.0f us  scalar %6.0f / %6.0f us  (%.1fx)\n", names[mode], levels,
+                   p50, p99, scalar50, scalar99, scalar50 / p50);
+        }
+    }
+    MLDepthPyramidUnity_Configure(0, DepthPyramid_Min);
+    return 0;
+}
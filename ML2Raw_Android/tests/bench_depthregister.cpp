@@ -0,0 +1,84 @@
+// Per-frame cost of depth-to-RGB registration (MLDepthRegisterUnity_ToRGB):
+// a 544x480 float depth frame registered into a 1280x720 RGB camera (and a
+// half-size map) with the SIMD and scalar projection kernels, on the worker
+// pool and on the calling thread only.
+//
+//   bench_depthregister [frames]
+
+#include "mldepthregister.h"
+#include "testing.h"
+
+#include <cstring>
+#include <thread>
+
+extern "C" {
+bool MLDepthUnity_AcquireLatest(uint32_t, DepthFrameInfo*, const uint8_t**, int32_t*, void**) { return false; }
+void MLDepthUnity_ReleaseFrame(void*) {}
+bool MLDepthUnity_GetFrameCalibration(int64_t, DepthIntrinsics*, DepthCameraPose*) { return false; }
+}
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? atoi(argv[1]) : 100;
+    const int32_t width = 544, height = 480;
+
+    // Noisy wall with holes, like a long-range frame
+    TestRandom rng(3);
+    std::vector<float> depth((size_t)width * height);
+    for (int32_t v = 0; v < height; v++) {
+        for (int32_t u = 0; u < width; u++) {
+            const float r = rng.Uniform(0.0f, 1.0f);
+            depth[(size_t)v * width + u] = r < 0.05f ? 0.0f : 2.0f + 0.5f * std::sin((float)u / 50.0f) + rng.Uniform(-0.01f, 0.01f);
+        }
+    }
+
+    DepthFrameInfo info;
+    memset(&info, 0, sizeof(info));
+    info.width = width;
+    info.height = height;
+    info.strideBytes = width * 4;
+    info.bytesPerPixel = 4;
+    const DepthIntrinsics intrinsics = {width, height, 363.0f, 365.0f, 270.2f, 242.7f, 0};
+    const DepthRegisterPose depthPose = {0.0f, 0.02f, 0.0f, 0.9998f, 0.0f, 1.5f, 0.0f};
+
+    RGBFrameWithPose rgb;
+    memset(&rgb, 0, sizeof(rgb));
+    rgb.width = 1280;
+    rgb.height = 720;
+    rgb.pose_rotation_w = 1.0f;
+    rgb.pose_position_x = 0.06f;
+    rgb.pose_position_y = 1.5f;
+    rgb.pose_valid = 1;
+    rgb.fx = rgb.fy = 960.0f;
+    rgb.cx = 639.5f;
+    rgb.cy = 359.5f;
+
+    printf("%dx%d depth -> 1280x720 RGB, %d frames, %u hardware threads\n", width, height, frames,
+           std::thread::hardware_concurrency());
+    std::vector<float> out(1280 * 720);
+    const struct {
+        const char* name;
+        uint32_t flags;
+    } modes[] = {
+        {"SIMD, pool", 0},
+        {"scalar, pool", DepthRegisterFlag_ForceScalar},
+        {"SIMD, 1 thread", DepthRegisterFlag_SingleThread},
+        {"scalar, 1 thread", DepthRegisterFlag_ForceScalar | DepthRegisterFlag_SingleThread},
+        {"SIMD, no splat", DepthRegisterFlag_NoSplat},
+    };
+    for (int32_t scale : {1, 2}) {
+        const int32_t outWidth = 1280 / scale, outHeight = 720 / scale;
+        for (const auto& mode : modes) {
+            std::vector<double> us;
+            for (int f = 0; f < frames; f++) {
+                int32_t written = 0;
+                const int64_t t0 = TestNowNs();
+                MLDepthRegisterUnity_ToRGB(&info, (const uint8_t*)depth.data(), &intrinsics, &depthPose, &rgb, outWidth,
+                                           outHeight, mode.flags, out.data(), (int32_t)out.size(), &written);
+                us.push_back((double)(TestNowNs() - t0) * 1e-3);
+            }
+            const double p50 = Percentile(us, 0.5), p99 = Percentile(us, 0.99);
+            printf("%4dx%-4d %-17s p50 %7.0f us  p99 %7.0f us\n", outWidth, outHeight, mode.name, p50, p99);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+// Contention benchmark for FrameSlots (mlframeslot.h) against the single
+// mutex-guarded latest frame it replaced: one producer publishes depth-sized
+// frames at a fixed rate while readers copy the latest frame out as fast as
+// they can. Prints p50/p99 copy-out latency per reader call and the producer's
+// per-frame publish cost.
+//
+//   bench_frameslot [readers] [seconds] [fps]
+
+#include "mlframeslot.h"
+#include "testing.h"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+const size_t kFrameBytes = 544 * 480 * 4;   // float depth at the long-range resolution
+
+struct Info {
+    int64_t timestampNs;
+};
+
+// The previous design: capture thread copies into one buffer under a mutex,
+// readers copy out under the same mutex.
+struct MutexLatest {
+    std::mutex mutex;
+    std::vector<uint8_t> bytes;
+    Info info{};
+    bool has = false;
+
+    void Publish(const uint8_t* src, const Info& frameInfo) {
+        std::lock_guard<std::mutex> lock(mutex);
+        bytes.assign(src, src + kFrameBytes);
+        info = frameInfo;
+        has = true;
+    }
+
+    bool CopyOut(uint8_t* dst, Info* out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!has) return false;
+        memcpy(dst, bytes.data(), bytes.size());
+        *out = info;
+        return true;
+    }
+};
+
+struct SlotsLatest {
+    FrameSlots<Info> slots;
+
+    void Publish(const uint8_t* src, const Info& frameInfo) {
+        FrameSlots<Info>::Slot* slot = slots.BeginWrite();
+        if (!slot) return;
+        slot->bytes.assign(src, src + kFrameBytes);
+        slot->info = frameInfo;
+        slots.Publish(slot);
+    }
+
+    bool CopyOut(uint8_t* dst, Info* out) {
+        const FrameSlots<Info>::Slot* slot = slots.Acquire();
+        if (!slot) return false;
+        memcpy(dst, slot->bytes.data(), slot->bytes.size());
+        *out = slot->info;
+        FrameSlots<Info>::Release(slot);
+        return true;
+    }
+};
+
+template <typename Latest>
+void Run(const char* name, int readers, double seconds, int fps) {
+    Latest latest;
+    std::atomic<bool> running{true};
+    std::vector<std::vector<double>> readerUs(readers);
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&, r] {
+            std::vector<uint8_t> dst(kFrameBytes);
+            Info info;
+            while (running.load()) {
+                const int64_t t0 = TestNowNs();
+                if (latest.CopyOut(dst.data(), &info)) {
+                    readerUs[r].push_back((double)(TestNowNs() - t0) * 1e-3);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint8_t> src(kFrameBytes, 0x5A);
+    std::vector<double> publishUs;
+    const int64_t periodNs = 1000000000LL / fps;
+    const int64_t startNs = TestNowNs();
+    for (int64_t frame = 0;; frame++) {
+        const int64_t dueNs = startNs + frame * periodNs;
+        if (dueNs - startNs > (int64_t)(seconds * 1e9)) break;
+        while (TestNowNs() < dueNs) std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+        src[0] = (uint8_t)frame;
+        const int64_t t0 = TestNowNs();
+        latest.Publish(src.data(), Info{dueNs});
+        publishUs.push_back((double)(TestNowNs() - t0) * 1e-3);
+    }
+    running.store(false);
+    for (std::thread& t : threads) t.join();
+
+    std::vector<double> all;
+    for (const std::vector<double>& r : readerUs) all.insert(all.end(), r.begin(), r.end());
+    const size_t copies = all.size();
+    const double p50 = Percentile(all, 0.50), p99 = Percentile(all, 0.99), max = all.empty() ? 0 : all.back();
+    const double pubP50 = Percentile(publishUs, 0.50), pubP99 = Percentile(publishUs, 0.99);
+    printf("%-12s copy-out p50 %7.1f us  p99 %7.1f us  max %8.1f us  (%zu copies) | publish p50 %7.1f us  p99 %7.1f us\n",
+           name, p50, p99, max, copies, pubP50, pubP99);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int readers = argc > 1 ? atoi(argv[1]) : 2;
+    const double seconds = argc > 2 ? atof(argv[2]) : 2.0;
+    const int fps = argc > 3 ? atoi(argv[3]) : 60;
+
+    printf("%d readers, %.1f s, %d fps, %zu-byte frames, %u hardware threads\n",
+           readers, seconds, fps, kFrameBytes, std::thread::hardware_concurrency());
+    Run<MutexLatest>("mutex", readers, seconds, fps);
+    Run<SlotsLatest>("FrameSlots", readers, seconds, fps);
+    return 0;
+}
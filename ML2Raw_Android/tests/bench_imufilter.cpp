@@ -0,0 +1,46 @@
+// Per-sample cost of the orientation filter (mlimufilter.h), as run on the
+// IMU capture thread: one Update per gyro sample with the latest accel.
+//
+//   bench_imufilter [samples]
+
+#include "mlimufilter.h"
+#include "testing.h"
+
+static void Bench(const char* name, int32_t type, float biasGain, bool withAccel, int64_t samples,
+                  const std::vector<float>& gyro, const std::vector<float>& accel) {
+    OrientationFilter filter;
+    filter.Configure(type, 0.0f, biasGain);
+    const float up[3] = {0.0f, 0.0f, 9.8f};
+    filter.InitFromAccel(up);
+
+    const size_t n = gyro.size() / 3;
+    const int64_t t0 = TestNowNs();
+    for (int64_t k = 0; k < samples; k++) {
+        const size_t i = (size_t)k % n;
+        filter.Update(&gyro[i * 3], withAccel ? &accel[i * 3] : nullptr, 0.001f);
+    }
+    const double ns = (double)(TestNowNs() - t0) / (double)samples;
+
+    float q[4];
+    filter.Quaternion(q);  // keep the result live
+    printf("%-24s %6.1f ns/sample  (q.w %.3f)\n", name, ns, q[3]);
+}
+
+int main(int argc, char** argv) {
+    const int64_t samples = argc > 1 ? atoll(argv[1]) : 20000000;
+
+    // Noisy samples around a slow rotation, so every branch does real work
+    TestRandom rng(3);
+    std::vector<float> gyro(3 * 4096), accel(3 * 4096);
+    for (size_t i = 0; i < gyro.size(); i++) {
+        gyro[i] = rng.Uniform(-0.5f, 0.5f);
+        accel[i] = (i % 3 == 2 ? 9.8f : 0.0f) + rng.Uniform(-0.3f, 0.3f);
+    }
+
+    printf("%lld samples\n", (long long)samples);
+    Bench("Madgwick", OrientationFilter::Madgwick, 0.0f, true, samples, gyro, accel);
+    Bench("Madgwick, gyro only", OrientationFilter::Madgwick, 0.0f, false, samples, gyro, accel);
+    Bench("Mahony", OrientationFilter::Mahony, 0.0f, true, samples, gyro, accel);
+    Bench("Mahony + bias estimate", OrientationFilter::Mahony, 0.1f, true, samples, gyro, accel);
+    return 0;
+}
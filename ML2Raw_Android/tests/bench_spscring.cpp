@@ -0,0 +1,225 @@
+// IMU sample hand-off cost: SpscRing (mlspscring.h) against the mutex-guarded
+// ring it replaced. A producer thread stands in for the sensor callback and
+// pushes one IMUData per event while a reader drains in bulk, like Unity
+// polling MLIMUUnity_GetBuffered. Reports sustained samples/s with the
+// producer running flat out, and per-event push latency (p50/p99/max) at a
+// fixed sensor rate.
+// With fewer cores than threads the p99/max mostly measure preemption.
+//
+// Also the bulk export layouts for one full 2048-sample drain: IMUData
+// structs from SpscRing (MLIMUUnity_GetBuffered), the same drain split into
+// per-field arrays by the caller, and SpscColumnRing popping straight into
+// the arrays (MLIMUUnity_GetBufferedSoA).
+//
+//   bench_spscring [seconds] [rateHz]
+
+#include "mlimu.h"
+#include "mlspscring.h"
+#include "testing.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+const size_t kRingSize = 2048;  // BUFFER_SIZE in mlimu.cpp
+
+// The previous design: one mutex for the callback's write and the whole drain
+struct MutexRing {
+    std::mutex mutex;
+    std::vector<IMUData> items = std::vector<IMUData>(kRingSize);
+    size_t head = 0, tail = 0, count = 0;
+
+    void Push(const IMUData& sample) {
+        std::lock_guard<std::mutex> lock(mutex);
+        items[head] = sample;
+        head = (head + 1) % kRingSize;
+        if (count < kRingSize) {
+            count++;
+        } else {
+            tail = (tail + 1) % kRingSize;
+        }
+    }
+
+    size_t Pop(IMUData* out, size_t max) {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t n = 0;
+        while (count > 0 && n < max) {
+            out[n++] = items[tail];
+            tail = (tail + 1) % kRingSize;
+            count--;
+        }
+        return n;
+    }
+
+    size_t Size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return count;
+    }
+};
+
+struct LockFreeRing {
+    SpscRing<IMUData, kRingSize> ring;
+
+    void Push(const IMUData& sample) { ring.Push(sample); }
+    size_t Pop(IMUData* out, size_t max) { return ring.Pop(out, max); }
+    size_t Size() const { return ring.Size(); }
+};
+
+IMUData MakeSample(int64_t i) {
+    IMUData d = {};
+    d.accel_x = (float)i;
+    d.accel_timestamp_ns = i;
+    d.gyro_timestamp_ns = i;
+    d.has_accel = d.has_gyro = 1;
+    return d;
+}
+
+// Reader drains in bulk until told to stop; returns samples read
+template <typename Ring>
+std::thread StartReader(Ring& ring, std::atomic<bool>& running, uint64_t& read) {
+    return std::thread([&] {
+        std::vector<IMUData> out(512);
+        while (running.load(std::memory_order_relaxed)) {
+            const size_t n = ring.Pop(out.data(), out.size());
+            read += n;
+            if (n == 0) std::this_thread::yield();
+        }
+        read += ring.Pop(out.data(), out.size());
+    });
+}
+
+template <typename Ring>
+void Run(const char* name, double seconds, int rateHz) {
+    // Throughput: push as fast as the reader keeps up (yield while the ring
+    // is nearly full, so nothing is dropped or overwritten)
+    uint64_t pushed = 0, read = 0;
+    {
+        Ring ring;
+        std::atomic<bool> running{true};
+        std::thread reader = StartReader(ring, running, read);
+        const int64_t endNs = TestNowNs() + (int64_t)(seconds * 0.5e9);
+        while (TestNowNs() < endNs) {
+            if (ring.Size() > kRingSize - 256) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (int i = 0; i < 256; i++) ring.Push(MakeSample((int64_t)pushed++));
+        }
+        running.store(false);
+        reader.join();
+    }
+    const double rate = (double)read / (seconds * 0.5);
+
+    // Latency: one push per sensor event at rateHz
+    std::vector<double> pushNs;
+    {
+        Ring ring;
+        std::atomic<bool> running{true};
+        uint64_t latencyRead = 0;
+        std::thread reader = StartReader(ring, running, latencyRead);
+        const int64_t periodNs = 1000000000LL / rateHz;
+        const int64_t startNs = TestNowNs();
+        for (int64_t event = 0;; event++) {
+            const int64_t dueNs = startNs + event * periodNs;
+            if (dueNs - startNs > (int64_t)(seconds * 0.5e9)) break;
+            while (TestNowNs() < dueNs) {
+                if (dueNs - TestNowNs() > 200000) std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            const IMUData sample = MakeSample(event);
+            const int64_t t0 = TestNowNs();
+            ring.Push(sample);
+            pushNs.push_back((double)(TestNowNs() - t0));
+        }
+        running.store(false);
+        reader.join();
+    }
+    const double p50 = Percentile(pushNs, 0.50), p99 = Percentile(pushNs, 0.99);
+    printf("%-8s %6.1f M samples/s | push @%d Hz p50 %6.0f ns  p99 %7.0f ns  max %8.0f ns\n",
+           name, rate * 1e-6, rateHz, p50, p99,
+           pushNs.empty() ? 0.0 : pushNs.back());
+}
+
+// The SoA export's column ring, as declared in mlimu.cpp
+typedef SpscColumnRing<kRingSize, int64_t, int64_t, float, float, float, float, float, float> ColumnRing;
+
+struct Columns {
+    std::vector<int64_t> accelTs = std::vector<int64_t>(kRingSize), gyroTs = std::vector<int64_t>(kRingSize);
+    std::vector<float> ax = std::vector<float>(kRingSize), ay = std::vector<float>(kRingSize),
+                       az = std::vector<float>(kRingSize), gx = std::vector<float>(kRingSize),
+                       gy = std::vector<float>(kRingSize), gz = std::vector<float>(kRingSize);
+};
+
+// Per-drain p50 / p99 in us; fill() refills the ring untimed before each drain
+template <typename Fill, typename Drain>
+void TimeDrain(const char* name, int drains, Fill fill, Drain drain) {
+    std::vector<double> us;
+    for (int i = 0; i < drains; i++) {
+        fill();
+        const int64_t t0 = TestNowNs();
+        const size_t n = drain();
+        us.push_back((double)(TestNowNs() - t0) * 1e-3);
+        CHECK(n == kRingSize);
+    }
+    const double p50 = Percentile(us, 0.50), p99 = Percentile(us, 0.99);
+    printf("%-30s p50 %6.2f us  p99 %6.2f us  (%.2f ns/sample)\n", name, p50, p99, p50 * 1e3 / kRingSize);
+}
+
+void RunDrain(int drains) {
+    // Heap-allocated: the rings are too large for the stack
+    std::unique_ptr<SpscRing<IMUData, kRingSize>> aos(new SpscRing<IMUData, kRingSize>());
+    std::unique_ptr<ColumnRing> soa(new ColumnRing());
+    std::vector<IMUData> structs(kRingSize);
+    Columns cols;
+
+    auto fillAos = [&] {
+        for (size_t i = 0; i < kRingSize; i++) aos->Push(MakeSample((int64_t)i));
+    };
+    auto fillSoa = [&] {
+        const size_t n = soa->Reserve(kRingSize);
+        for (size_t i = 0; i < n; i++) {
+            const IMUData d = MakeSample((int64_t)i);
+            soa->Set(i, d.accel_timestamp_ns, d.gyro_timestamp_ns, d.accel_x, d.accel_y, d.accel_z,
+                     d.gyro_x, d.gyro_y, d.gyro_z);
+        }
+        soa->Commit(n);
+    };
+
+    printf("%zu-sample drain, %d drains\n", kRingSize, drains);
+    TimeDrain("AoS  Pop (IMUData[])", drains, fillAos, [&] { return aos->Pop(structs.data(), kRingSize); });
+    TimeDrain("AoS  Pop + split to arrays", drains, fillAos, [&] {
+        const size_t n = aos->Pop(structs.data(), kRingSize);
+        for (size_t i = 0; i < n; i++) {
+            const IMUData& d = structs[i];
+            cols.accelTs[i] = d.accel_timestamp_ns;
+            cols.gyroTs[i] = d.gyro_timestamp_ns;
+            cols.ax[i] = d.accel_x;
+            cols.ay[i] = d.accel_y;
+            cols.az[i] = d.accel_z;
+            cols.gx[i] = d.gyro_x;
+            cols.gy[i] = d.gyro_y;
+            cols.gz[i] = d.gyro_z;
+        }
+        return n;
+    });
+    TimeDrain("SoA  column Pop", drains, fillSoa, [&] {
+        return soa->Pop(kRingSize, cols.accelTs.data(), cols.gyroTs.data(), cols.ax.data(), cols.ay.data(),
+                        cols.az.data(), cols.gx.data(), cols.gy.data(), cols.gz.data());
+    });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? atof(argv[1]) : 4.0;
+    const int rateHz = argc > 2 ? atoi(argv[2]) : 1000;
+
+    printf("%zu-byte samples, %zu-entry ring, %.1f s, %u hardware threads\n",
+           sizeof(IMUData), kRingSize, seconds, std::thread::hardware_concurrency());
+    Run<MutexRing>("mutex", seconds, rateHz);
+    Run<LockFreeRing>("SpscRing", seconds, rateHz);
+    RunDrain(2000);
+    return 0;
+}
@@ -0,0 +1,75 @@
+// TSDF integration and meshing cost on synthetic 544x480 depth frames (three
+// spheres and a back wall seen from an orbiting camera), for several voxel
+// sizes.
+//
+//   bench_tsdf [frames]
+
+#include "testing.h"
+#include "tsdf_scene.h"
+
+static void Bench(float voxelSize, int frames, const std::vector<std::vector<float>>& depths,
+                  const std::vector<TsdfRigid>& poses, const TsdfCamera& camera, int32_t width, int32_t height) {
+    TsdfVolume::Params params;
+    params.voxelSize = voxelSize;
+    params.truncation = voxelSize * 3.0f;
+    params.maxDepth = 4.0f;
+    params.maxWeight = 64.0f;
+    params.maxBlocks = 65536;
+    params.pixelStride = 4;
+
+    TsdfVolume volume;
+    CHECK(volume.Init(params));
+
+    std::vector<double> integrateUs;
+    for (int f = 0; f < frames; f++) {
+        const size_t i = (size_t)f % depths.size();
+        const int64_t t0 = TestNowNs();
+        volume.Integrate(depths[i].data(), width, height, width * (int32_t)sizeof(float), camera, poses[i]);
+        integrateUs.push_back((double)(TestNowNs() - t0) * 1e-3);
+    }
+
+    std::vector<int32_t> coords((size_t)volume.DirtyBlocks() * 3);
+    const int32_t dirty = volume.GetDirtyBlocks(coords.data(), volume.DirtyBlocks());
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    size_t triangles = 0;
+    const int64_t t0 = TestNowNs();
+    for (int32_t i = 0; i < dirty; i++) {
+        volume.ExtractBlock(coords[i * 3], coords[i * 3 + 1], coords[i * 3 + 2], vertices, indices);
+        triangles += indices.size() / 3;
+    }
+    const double extractMs = (double)(TestNowNs() - t0) * 1e-6;
+
+    const double p50 = Percentile(integrateUs, 0.5), p99 = Percentile(integrateUs, 0.99);
+    printf("voxel %4.1f cm  integrate p50 %7.0f us (%5.0f fps)  p99 %7.0f us  blocks %6d  "
+           "extract %d blocks %6.1f ms (%zu triangles)\n",
+           voxelSize * 100.0f, p50, 1e6 / p50, p99, volume.AllocatedBlocks(), dirty, extractMs, triangles);
+}
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? atoi(argv[1]) : 120;
+    const int32_t width = 544, height = 480;
+    const TsdfCamera camera = {370.0f, 370.0f, 272.0f, 240.0f};
+    const std::vector<SceneSphere> scene = {
+        {{0.0f, 0.0f, 0.0f}, 0.4f}, {{0.5f, 0.4f, -0.1f}, 0.2f}, {{-0.4f, 0.5f, 0.2f}, 0.25f},
+        {{0.0f, 0.0f, -101.0f}, 100.0f},  // floor
+    };
+
+    // Precomputed views on an arc, so the timing covers integration only
+    const int kViews = 24;
+    std::vector<std::vector<float>> depths(kViews);
+    std::vector<TsdfRigid> poses(kViews);
+    for (int i = 0; i < kViews; i++) {
+        const float angle = 1.5f * (float)i / (float)kViews;
+        const float eye[3] = {1.8f * std::cos(angle), 1.8f * std::sin(angle), 0.6f};
+        const float target[3] = {0.0f, 0.0f, 0.0f};
+        poses[i] = LookAt(eye, target);
+        RenderDepth(scene, camera, poses[i], width, height, depths[i]);
+    }
+
+    printf("%dx%d depth, %d frames\n", width, height, frames);
+    for (float voxelSize : {0.01f, 0.02f, 0.04f}) {
+        Bench(voxelSize, frames, depths, poses, camera, width, height);
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Per-frame cost of the RGB camera's YUV_420_888 handling (mlyuv.h) at the
+// preview, video and image resolutions: conversion to each RGB layout and
+// downscale as ReadFrame runs it, the NV12/I420 repack the camera callback
+// does, and the same conversion built from the scalar row kernels.
+// Frames are semi-planar (NV12) with a 64-byte aligned row stride, like the
+// ML2 camera delivers them.
+//
+//   bench_yuv [frames]
+
+#include "mlyuv.h"
+#include "testing.h"
+#include "yuv_frame.h"
+
+namespace {
+
+// YuvToRgb at downscale 1 with the scalar kernels, for the speedup column
+void ScalarToRgb(const YuvImage& src, RgbLayout layout, uint8_t* out) {
+    const YuvCoeffs c = YuvCoefficients(YuvRange_Full);
+    const int32_t chromaWidth = (src.width + 1) / 2;
+    std::vector<uint8_t> u(chromaWidth), v(chromaWidth);
+    for (int32_t row = 0; row < src.height; row++) {
+        if ((row & 1) == 0) {
+            const size_t offset = (size_t)(row / 2) * src.uvStride;
+            YuvGatherRowScalar(src.u + offset, src.uvPixelStride, chromaWidth, u.data());
+            YuvGatherRowScalar(src.v + offset, src.uvPixelStride, chromaWidth, v.data());
+        }
+        YuvToRgbRowScalar(src.y + (size_t)row * src.yStride, u.data(), v.data(), src.width, true, c, layout,
+                          out + (size_t)row * src.width * RgbBytesPerPixel(layout));
+    }
+}
+
+template <typename Fn>
+double FrameUs(int frames, Fn fn) {
+    std::vector<double> us;
+    for (int f = 0; f < frames; f++) {
+        const int64_t t0 = TestNowNs();
+        fn();
+        us.push_back((double)(TestNowNs() - t0) * 1e-3);
+    }
+    return Percentile(us, 0.5);
+}
+
+void Bench(int32_t width, int32_t height, int frames) {
+    TestRandom rng(5);
+    const int32_t pad = ((width + 63) & ~63) - width;
+    const TestYuvFrame frame = MakeYuvFrame(width, height, pad, TestChroma_NV12, rng);
+    const YuvImage& image = frame.image;
+    std::vector<uint8_t> out((size_t)width * height * 4);
+    const double pixels = (double)width * height;
+
+    printf("%dx%d (row stride %d), p50 per frame:\n", width, height, image.yStride);
+    const char* names[] = {"RGBA", "RGB", "BGRA"};
+    for (RgbLayout layout : {RgbLayout_RGBA, RgbLayout_RGB, RgbLayout_BGRA}) {
+        const double scalar = FrameUs(frames, [&] { ScalarToRgb(image, layout, out.data()); });
+        printf("  %-5s", names[layout]);
+        for (int32_t downscale : {1, 2, 4}) {
+            const double us = FrameUs(frames, [&] { YuvToRgb(image, YuvRange_Full, layout, downscale, out.data()); });
+            printf("  /%d %7.0f us", downscale, us);
+            if (downscale == 1) printf(" (%.2f ns/px, scalar %7.0f us, %.1fx)", us * 1e3 / pixels, scalar, scalar / us);
+        }
+        printf("\n");
+    }
+    const double limited = FrameUs(frames, [&] { YuvToRgb(image, YuvRange_Limited, RgbLayout_RGBA, 1, out.data()); });
+    printf("  RGBA limited range /1 %7.0f us\n", limited);
+
+    const double nv12 = FrameUs(frames, [&] { YuvRepack(image, YuvPacking_NV12, out.data()); });
+    const double i420 = FrameUs(frames, [&] { YuvRepack(image, YuvPacking_I420, out.data()); });
+    printf("  repack NV12 %7.0f us  I420 %7.0f us\n", nv12, i420);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? atoi(argv[1]) : 50;
+    Bench(640, 480, frames);
+    Bench(1280, 720, frames);
+    Bench(1920, 1080, frames);
+    return 0;
+}
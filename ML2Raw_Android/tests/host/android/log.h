@@ -0,0 +1,11 @@
+#pragma once
+// Host stand-in for the NDK log header used by the tests: messages are dropped.
+
+#define ANDROID_LOG_DEBUG 3
+#define ANDROID_LOG_INFO 4
+#define ANDROID_LOG_WARN 5
+#define ANDROID_LOG_ERROR 6
+
+inline int __android_log_print(int, const char*, const char*, ...) {
+    return 0;
+}
@@ -0,0 +1,159 @@
+// Depth unprojection tests (mldepthcloud.h): the SIMD row kernel must write
+// exactly what the scalar one does, with and without confidence, for widths
+// that leave a scalar tail, padded row strides and invalid depth; and
+// TryGetLatest must only unproject a leased frame with the intrinsics that
+// were reported for it.
+
+#include "mldepthcloud.h"
+#include "testing.h"
+
+#include <cstring>
+
+// The depth module, reduced to one leased frame and a calibration history
+namespace {
+int64_t g_frameTimeNs = 1000;
+int64_t g_calibrationTimeNs = 1000;
+std::vector<float> g_frameDepth;
+int32_t g_leases = 0;
+const DepthIntrinsics kIntrinsics = {64, 48, 40.0f, 41.0f, 31.7f, 24.2f, 0};
+}  // namespace
+
+extern "C" {
+bool MLDepthUnity_AcquireLatest(uint32_t stream, DepthFrameInfo* outInfo, const uint8_t** outBytes,
+                                int32_t* outSize, void** outLease) {
+    if (stream != DepthStream_Depth) return false;
+    memset(outInfo, 0, sizeof(*outInfo));
+    outInfo->width = kIntrinsics.width;
+    outInfo->height = kIntrinsics.height;
+    outInfo->strideBytes = kIntrinsics.width * 4;
+    outInfo->bytesPerPixel = 4;
+    outInfo->captureTimeNs = g_frameTimeNs;
+    *outBytes = (const uint8_t*)g_frameDepth.data();
+    *outSize = (int32_t)(g_frameDepth.size() * sizeof(float));
+    *outLease = &g_frameDepth;
+    g_leases++;
+    return true;
+}
+void MLDepthUnity_ReleaseFrame(void*) { g_leases--; }
+bool MLDepthUnity_GetFrameCalibration(int64_t captureTimeNs, DepthIntrinsics* outIntrinsics, DepthCameraPose*) {
+    if (captureTimeNs != g_calibrationTimeNs) return false;
+    if (outIntrinsics) *outIntrinsics = kIntrinsics;
+    return true;
+}
+}
+
+namespace {
+
+// Row-major float planes with padStride floats of padding per row
+struct Planes {
+    std::vector<float> depth, conf;
+    DepthFrameInfo depthInfo, confInfo;
+};
+
+Planes MakePlanes(int32_t width, int32_t height, int32_t padFloats, TestRandom& rng) {
+    Planes p;
+    const int32_t stride = width + padFloats;
+    p.depth.assign((size_t)stride * height, -7.0f);
+    p.conf.assign((size_t)stride * height, -7.0f);
+    for (int32_t v = 0; v < height; v++) {
+        for (int32_t u = 0; u < width; u++) {
+            const float r = rng.Uniform(0.0f, 1.0f);
+            float d = rng.Uniform(0.3f, 5.0f);
+            if (r < 0.05f) d = 0.0f;
+            else if (r < 0.1f) d = NAN;
+            else if (r < 0.15f) d = -1.0f;
+            p.depth[(size_t)v * stride + u] = d;
+            p.conf[(size_t)v * stride + u] = rng.Uniform(0.0f, 1.0f);
+        }
+    }
+    for (DepthFrameInfo* info : {&p.depthInfo, &p.confInfo}) {
+        memset(info, 0, sizeof(*info));
+        info->width = width;
+        info->height = height;
+        info->strideBytes = stride * 4;
+        info->bytesPerPixel = 4;
+    }
+    return p;
+}
+
+std::vector<float> Unproject(const Planes& p, const DepthIntrinsics& intrinsics, uint32_t flags) {
+    const int32_t comps = (flags & DepthCloudFlag_Confidence) ? 4 : 3;
+    const int32_t width = p.depthInfo.width, height = p.depthInfo.height;
+    std::vector<float> out((size_t)width * height * comps, -9.0f);
+    int32_t count = 0;
+    CHECK(MLDepthCloudUnity_Unproject(&p.depthInfo, (const uint8_t*)p.depth.data(), &p.confInfo,
+                                      (const uint8_t*)p.conf.data(), &intrinsics, flags, out.data(),
+                                      (int32_t)out.size(), &count));
+    CHECK(count == width * height);
+    return out;
+}
+
+bool SameBits(const std::vector<float>& a, const std::vector<float>& b) {
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+void TestSimdMatchesScalar() {
+    TestRandom rng(11);
+    const int32_t widths[] = {1, 3, 4, 5, 7, 8, 13, 544};
+    for (int32_t width : widths) {
+        for (int32_t pad : {0, 3}) {
+            const Planes p = MakePlanes(width, 9, pad, rng);
+            const DepthIntrinsics intrinsics = {width, 9, 363.0f, 365.0f, width * 0.5f - 0.3f, 4.2f, 0};
+            for (uint32_t conf : {0u, (uint32_t)DepthCloudFlag_Confidence}) {
+                const std::vector<float> simd = Unproject(p, intrinsics, conf);
+                const std::vector<float> scalar = Unproject(p, intrinsics, conf | DepthCloudFlag_ForceScalar);
+                CHECK(SameBits(simd, scalar));
+            }
+        }
+    }
+}
+
+// Scalar output against the pinhole model, invalid pixels at the origin
+void TestScalarValues() {
+    TestRandom rng(12);
+    const Planes p = MakePlanes(21, 7, 2, rng);
+    const DepthIntrinsics intrinsics = {21, 7, 30.0f, 32.0f, 10.3f, 3.1f, 0};
+    const std::vector<float> out = Unproject(p, intrinsics, DepthCloudFlag_Confidence | DepthCloudFlag_ForceScalar);
+    const int32_t stride = 23;
+    for (int32_t v = 0; v < 7; v++) {
+        for (int32_t u = 0; u < 21; u++) {
+            const float d = p.depth[(size_t)v * stride + u];
+            const float z = d > 0.0f ? d : 0.0f;
+            const float* pt = &out[((size_t)v * 21 + u) * 4];
+            CHECK_NEAR(pt[0], z * (u - 10.3f) / 30.0f, 1e-5f);
+            CHECK_NEAR(pt[1], z * (v - 3.1f) / 32.0f, 1e-5f);
+            CHECK(pt[2] == z);
+            CHECK(pt[3] == p.conf[(size_t)v * stride + u]);
+        }
+    }
+}
+
+void TestTryGetLatest() {
+    g_frameDepth.assign((size_t)kIntrinsics.width * kIntrinsics.height, 1.5f);
+    std::vector<float> out((size_t)kIntrinsics.width * kIntrinsics.height * 3);
+    DepthFrameInfo info;
+    int32_t count = 0;
+
+    // Calibration for the leased frame: the frame is unprojected with it
+    CHECK(MLDepthCloudUnity_TryGetLatest(0, &info, out.data(), (int32_t)out.size(), &count));
+    CHECK(count == kIntrinsics.width * kIntrinsics.height);
+    CHECK(info.captureTimeNs == g_frameTimeNs);
+    CHECK_NEAR(out[0], 1.5f * -kIntrinsics.cx / kIntrinsics.fx, 1e-6f);
+    CHECK(g_leases == 0);
+
+    // Only a newer frame's calibration is known: refuse rather than mix them
+    g_calibrationTimeNs = g_frameTimeNs + 33333333;
+    CHECK(!MLDepthCloudUnity_TryGetLatest(0, &info, out.data(), (int32_t)out.size(), &count));
+    CHECK(count == 0);
+    CHECK(g_leases == 0);
+}
+
+}  // namespace
+
+int main() {
+    TestSimdMatchesScalar();
+    TestScalarValues();
+    TestTryGetLatest();
+    printf("test_depthcloud: ok\n");
+    return 0;
+}
@@ -0,0 +1,218 @@
+// Round-trip tests for the lossless depth codec (mldepthcodec.h): synthetic
+// 16-bit and float32 frames, long zero runs, extreme values and bit patterns,
+// padded strides, and the capacity / corrupt-stream error paths.
+
+#include "mldepthcodec.h"
+#include "testing.h"
+
+#include <cfloat>
+#include <cstring>
+#include <limits>
+
+// MLDepthCodecUnity_EncodeLatest leases from the capture pool; the tests hand
+// it a fixed frame instead.
+static DepthFrameInfo g_leaseInfo;
+static std::vector<uint8_t> g_leaseBytes;
+static int g_leaseOutstanding = 0;
+
+extern "C" bool MLDepthUnity_AcquireLatest(uint32_t stream, DepthFrameInfo* outInfo, const uint8_t** outBytes,
+                                           int32_t* outSizeBytes, void** outLease) {
+    if (stream != 0 || g_leaseBytes.empty()) return false;
+    *outInfo = g_leaseInfo;
+    *outBytes = g_leaseBytes.data();
+    *outSizeBytes = (int32_t)g_leaseBytes.size();
+    *outLease = &g_leaseInfo;
+    g_leaseOutstanding++;
+    return true;
+}
+
+extern "C" void MLDepthUnity_ReleaseFrame(void* lease) {
+    CHECK(lease == &g_leaseInfo);
+    g_leaseOutstanding--;
+}
+
+static DepthFrameInfo MakeInfo(int32_t width, int32_t height, int32_t bytesPerPixel, int32_t strideBytes) {
+    DepthFrameInfo info;
+    memset(&info, 0, sizeof(info));
+    info.width = width;
+    info.height = height;
+    info.bytesPerPixel = bytesPerPixel;
+    info.strideBytes = strideBytes;
+    info.format = 7;
+    info.captureTimeNs = 123456789012345LL;
+    return info;
+}
+
+// Encodes and decodes; checks info, exact pixels (ignoring stride padding)
+// and returns the encoded size.
+static int32_t RoundTrip(const DepthFrameInfo& info, const std::vector<uint8_t>& bytes) {
+    std::vector<uint8_t> encoded((size_t)MLDepthCodecUnity_MaxEncodedSize(&info));
+    int32_t encodedSize = 0;
+    CHECK(MLDepthCodecUnity_Encode(&info, bytes.data(), encoded.data(), (int32_t)encoded.size(), &encodedSize));
+    CHECK(encodedSize > 0 && encodedSize <= (int32_t)encoded.size());
+
+    const int32_t rowBytes = info.width * info.bytesPerPixel;
+    std::vector<uint8_t> decoded((size_t)rowBytes * info.height + 1, 0xCD);
+    DepthFrameInfo out;
+    int32_t decodedSize = 0;
+    CHECK(MLDepthCodecUnity_Decode(encoded.data(), encodedSize, &out, decoded.data(), (int32_t)decoded.size(), &decodedSize));
+    CHECK(decodedSize == rowBytes * info.height);
+    CHECK(decoded.back() == 0xCD);  // nothing written past the frame
+    CHECK(out.width == info.width && out.height == info.height);
+    CHECK(out.bytesPerPixel == info.bytesPerPixel && out.strideBytes == rowBytes);
+    CHECK(out.format == info.format && out.captureTimeNs == info.captureTimeNs);
+
+    const int32_t stride = info.strideBytes > 0 ? info.strideBytes : rowBytes;
+    for (int32_t v = 0; v < info.height; v++) {
+        CHECK(memcmp(decoded.data() + (size_t)v * rowBytes, bytes.data() + (size_t)v * stride, (size_t)rowBytes) == 0);
+    }
+    return encodedSize;
+}
+
+static std::vector<uint8_t> Frame16(int32_t width, int32_t height, int32_t stride, TestRandom& rng,
+                                    float holeFraction) {
+    std::vector<uint8_t> bytes((size_t)stride * height, 0xEE);  // padding stays garbage
+    for (int32_t v = 0; v < height; v++) {
+        uint16_t* row = (uint16_t*)(bytes.data() + (size_t)v * stride);
+        for (int32_t u = 0; u < width; u++) {
+            // Smooth surface (mm) with sensor noise and invalid holes
+            const float depth = 800.0f + 3.0f * u + 1.5f * v + rng.Uniform(-4.0f, 4.0f);
+            row[u] = rng.Uniform(0.0f, 1.0f) < holeFraction ? 0 : (uint16_t)depth;
+        }
+    }
+    return bytes;
+}
+
+static void TestSynthetic16() {
+    TestRandom rng(1);
+    const int32_t sizes[][2] = {{544, 480}, {1, 1}, {7, 3}, {33, 17}, {640, 1}, {1, 97}};
+    for (const auto& size : sizes) {
+        const int32_t width = size[0], height = size[1];
+        for (int32_t pad : {0, 6, 64}) {
+            const int32_t stride = width * 2 + pad;
+            const std::vector<uint8_t> bytes = Frame16(width, height, stride, rng, 0.1f);
+            RoundTrip(MakeInfo(width, height, 2, pad ? stride : 0), bytes);
+        }
+    }
+}
+
+static void TestSyntheticFloat() {
+    TestRandom rng(2);
+    const int32_t width = 544, height = 480;
+    std::vector<uint8_t> bytes((size_t)width * height * 4);
+    float* depth = (float*)bytes.data();
+    for (int32_t i = 0; i < width * height; i++) {
+        const float value = 0.5f + 0.002f * (i % width) + rng.Uniform(-0.003f, 0.003f);
+        depth[i] = rng.Uniform(0.0f, 1.0f) < 0.05f ? 0.0f : value;
+    }
+    RoundTrip(MakeInfo(width, height, 4, 0), bytes);
+}
+
+static void TestZeroRuns() {
+    // All zero, one pixel, runs spanning rows, alternating zero / nonzero
+    for (int32_t bpp : {2, 4}) {
+        const int32_t width = 300, height = 200;
+        std::vector<uint8_t> bytes((size_t)width * height * bpp, 0);
+        const int32_t allZero = RoundTrip(MakeInfo(width, height, bpp, 0), bytes);
+        CHECK(allZero < 64 + (int32_t)(height * 2));  // a run header per row at most
+
+        bytes[(size_t)(width * height / 2) * bpp] = 1;
+        RoundTrip(MakeInfo(width, height, bpp, 0), bytes);
+
+        for (size_t i = 0; i < bytes.size(); i += (size_t)bpp * 2) bytes[i] = 0x7F;
+        RoundTrip(MakeInfo(width, height, bpp, 0), bytes);
+
+        // Runs from 1 to > 2^16 pixels in a single row
+        const int32_t longWidth = 70000;
+        std::vector<uint8_t> longRow((size_t)longWidth * bpp, 0);
+        for (int32_t u = 0, gap = 1; u < longWidth; u += gap, gap *= 3) longRow[(size_t)u * bpp] = 0x11;
+        RoundTrip(MakeInfo(longWidth, 1, bpp, 0), longRow);
+    }
+}
+
+static void TestEdgeValues() {
+    // Largest deltas and sign changes: 0 / max alternation, 1 / max, descending
+    const uint16_t values16[] = {0xFFFF, 1, 0xFFFF, 0x8000, 0x7FFF, 0xFFFE, 2, 0xFFFF, 0xFFFF, 1};
+    std::vector<uint8_t> bytes16(sizeof(values16));
+    memcpy(bytes16.data(), values16, sizeof(values16));
+    RoundTrip(MakeInfo(5, 2, 2, 0), bytes16);
+
+    const float specials[] = {
+        std::numeric_limits<float>::quiet_NaN(), -std::numeric_limits<float>::quiet_NaN(),
+        std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+        -0.0f, FLT_MAX, -FLT_MAX, FLT_MIN, std::numeric_limits<float>::denorm_min(), 1.0f, 0.0f, 65535.0f,
+    };
+    std::vector<uint8_t> bytesF(sizeof(specials));
+    memcpy(bytesF.data(), specials, sizeof(specials));
+    RoundTrip(MakeInfo(4, 3, 4, 0), bytesF);
+
+    const uint32_t patterns[] = {0xFFFFFFFFu, 0x00000001u, 0x80000000u, 0x7FFFFFFFu, 0xFFFFFFFEu, 0x00000000u,
+                                 0xFFFFFFFFu, 0x00000000u, 0xDEADBEEFu};
+    std::vector<uint8_t> bytesU(sizeof(patterns));
+    memcpy(bytesU.data(), patterns, sizeof(patterns));
+    RoundTrip(MakeInfo(9, 1, 4, 0), bytesU);
+
+    // Random bit patterns: worst case, must stay within MaxEncodedSize
+    TestRandom rng(3);
+    std::vector<uint8_t> noise((size_t)97 * 61 * 4);
+    for (uint8_t& b : noise) b = (uint8_t)rng.Next();
+    RoundTrip(MakeInfo(97, 61, 4, 0), noise);
+}
+
+static void TestErrors() {
+    TestRandom rng(4);
+    const DepthFrameInfo info = MakeInfo(64, 48, 2, 0);
+    const std::vector<uint8_t> bytes = Frame16(64, 48, 128, rng, 0.0f);
+    std::vector<uint8_t> encoded((size_t)MLDepthCodecUnity_MaxEncodedSize(&info));
+    int32_t written = 0;
+
+    // Unsupported pixel size
+    DepthFrameInfo bad = info;
+    bad.bytesPerPixel = 3;
+    CHECK(!MLDepthCodecUnity_Encode(&bad, bytes.data(), encoded.data(), (int32_t)encoded.size(), &written));
+
+    // Too small: reports the worst-case size
+    CHECK(!MLDepthCodecUnity_Encode(&info, bytes.data(), encoded.data(), 40, &written));
+    CHECK(written == MLDepthCodecUnity_MaxEncodedSize(&info));
+
+    int32_t encodedSize = 0;
+    CHECK(MLDepthCodecUnity_Encode(&info, bytes.data(), encoded.data(), (int32_t)encoded.size(), &encodedSize));
+
+    DepthFrameInfo out;
+    std::vector<uint8_t> decoded(64 * 48 * 2);
+    CHECK(!MLDepthCodecUnity_Decode(encoded.data(), encodedSize, &out, decoded.data(), 100, &written));
+    CHECK(written == 64 * 48 * 2);
+
+    // Truncated payload, bad magic, short header
+    CHECK(!MLDepthCodecUnity_Decode(encoded.data(), encodedSize - 8, &out, decoded.data(), (int32_t)decoded.size(), &written));
+    std::vector<uint8_t> corrupt(encoded.begin(), encoded.begin() + encodedSize);
+    corrupt[0] ^= 0xFF;
+    CHECK(!MLDepthCodecUnity_Decode(corrupt.data(), encodedSize, &out, decoded.data(), (int32_t)decoded.size(), &written));
+    CHECK(!MLDepthCodecUnity_Decode(encoded.data(), 16, &out, decoded.data(), (int32_t)decoded.size(), &written));
+}
+
+static void TestEncodeLatest() {
+    TestRandom rng(5);
+    g_leaseInfo = MakeInfo(40, 30, 2, 0);
+    g_leaseBytes = Frame16(40, 30, 80, rng, 0.2f);
+
+    std::vector<uint8_t> encoded((size_t)MLDepthCodecUnity_MaxEncodedSize(&g_leaseInfo));
+    DepthFrameInfo info;
+    int32_t written = 0;
+    CHECK(MLDepthCodecUnity_EncodeLatest(0, &info, encoded.data(), (int32_t)encoded.size(), &written));
+    CHECK(info.width == 40 && info.captureTimeNs == g_leaseInfo.captureTimeNs);
+    CHECK(!MLDepthCodecUnity_EncodeLatest(0, &info, encoded.data(), 8, &written));
+    CHECK(!MLDepthCodecUnity_EncodeLatest(1, &info, encoded.data(), (int32_t)encoded.size(), &written));
+    CHECK(g_leaseOutstanding == 0);
+}
+
+int main() {
+    TestSynthetic16();
+    TestSyntheticFloat();
+    TestZeroRuns();
+    TestEdgeValues();
+    TestErrors();
+    TestEncodeLatest();
+    printf("test_depthcodec: ok\n");
+    return 0;
+}
@@ -0,0 +1,198 @@
+// Depth pixel kernel tests (mldepthkernels.h): each dispatched NEON/SSE2
+// kernel must produce bit-identical output to its scalar reference, over row
+// widths that exercise the vector body and the scalar tail, and the scalar
+// reference must match a plain restatement of the kernel's contract.
+
+#include "mldepthkernels.h"
+#include "testing.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const int32_t kWidths[] = {1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 544};
+
+bool SameBits(const std::vector<float>& a, const std::vector<float>& b) {
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+// Depth with holes, NaN, negative and signed zero
+std::vector<float> MakeDepth(int32_t width, TestRandom& rng) {
+    std::vector<float> depth(width);
+    for (float& d : depth) {
+        const uint32_t r = rng.Next() % 20;
+        d = r == 0 ? 0.0f : r == 1 ? -0.0f : r == 2 ? NAN : r == 3 ? -0.5f : rng.Uniform(0.2f, 7.0f);
+    }
+    return depth;
+}
+
+// ---------- DepthMaskRow ----------
+
+void TestMask() {
+    TestRandom rng(21);
+    // Confidence at, around and far from each threshold, plus NaN and infinities
+    const float thresholds[] = {0.0f, 0.5f, 1.0f, -INFINITY};
+    const uint32_t rejects[] = {0u, 1u, 0x5u, 0x80000000u, 0xFFFFFFFFu};
+
+    for (int32_t width : kWidths) {
+        const std::vector<float> depth = MakeDepth(width, rng);
+        for (float minConf : thresholds) {
+            std::vector<float> conf(width);
+            for (int32_t u = 0; u < width; u++) {
+                const uint32_t r = rng.Next() % 8;
+                conf[u] = r == 0 ? minConf : r == 1 ? std::nextafter(minConf, -INFINITY)
+                        : r == 2 ? std::nextafter(minConf, INFINITY) : r == 3 ? NAN
+                        : r == 4 ? INFINITY : r == 5 ? -INFINITY : rng.Uniform(-0.5f, 1.5f);
+            }
+            std::vector<uint32_t> flags(width);
+            for (uint32_t& f : flags) {
+                const uint32_t r = rng.Next() % 4;
+                f = r == 0 ? 0u : r == 1 ? 1u << (rng.Next() % 32) : rng.Next() | (rng.Next() << 16);
+            }
+
+            for (uint32_t reject : rejects) {
+                for (int inputs = 0; inputs < 4; inputs++) {
+                    const float* c = (inputs & 1) ? conf.data() : nullptr;
+                    const uint32_t* f = (inputs & 2) ? flags.data() : nullptr;
+                    std::vector<float> simd(width, -9.0f), scalar(width, -9.0f);
+                    DepthMaskRow(depth.data(), c, f, minConf, reject, width, simd.data());
+                    DepthMaskRowScalar(depth.data(), c, f, minConf, reject, width, scalar.data());
+                    CHECK(SameBits(simd, scalar));
+
+                    // Scalar reference: keep only pixels that pass both tests
+                    for (int32_t u = 0; u < width; u++) {
+                        const bool keep = (!c || c[u] >= minConf) && (!f || (f[u] & reject) == 0);
+                        if (keep) {
+                            CHECK(memcmp(&scalar[u], &depth[u], sizeof(float)) == 0);
+                        } else {
+                            CHECK(scalar[u] == 0.0f && !std::signbit(scalar[u]));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// ---------- Pyramid reductions ----------
+
+// Two input rows for outWidth blocks where about a third of the samples are
+// invalid, so blocks with 0..4 valid depths all occur
+struct BlockRows {
+    std::vector<float> row0, row1, w0, w1;
+};
+
+BlockRows MakeBlockRows(int32_t outWidth, TestRandom& rng) {
+    BlockRows r;
+    for (std::vector<float>* row : {&r.row0, &r.row1}) {
+        row->resize((size_t)outWidth * 2);
+        for (float& d : *row) {
+            const uint32_t k = rng.Next() % 12;
+            d = k == 0 ? 0.0f : k == 1 ? -0.0f : k == 2 ? NAN : k == 3 ? -1.0f : rng.Uniform(0.2f, 7.0f);
+        }
+    }
+    // Weights outside [0, 1] and NaN are clamped to 0..1
+    for (std::vector<float>* w : {&r.w0, &r.w1}) {
+        w->resize((size_t)outWidth * 2);
+        for (float& x : *w) {
+            const uint32_t k = rng.Next() % 10;
+            x = k == 0 ? NAN : k == 1 ? -0.3f : k == 2 ? 1.7f : k == 3 ? 0.0f : rng.Uniform(0.0f, 1.0f);
+        }
+    }
+    return r;
+}
+
+// Valid depths of block x, in scan order
+std::vector<float> ValidInBlock(const BlockRows& r, int32_t x) {
+    std::vector<float> v;
+    for (float d : {r.row0[2 * x], r.row0[2 * x + 1], r.row1[2 * x], r.row1[2 * x + 1]}) {
+        if (d > 0.0f) v.push_back(d);
+    }
+    return v;
+}
+
+void TestReduceMin() {
+    TestRandom rng(22);
+    for (int32_t outWidth : kWidths) {
+        const BlockRows r = MakeBlockRows(outWidth, rng);
+        std::vector<float> simd(outWidth, -9.0f), scalar(outWidth, -9.0f);
+        DepthReduceMinRow(r.row0.data(), r.row1.data(), outWidth, simd.data());
+        DepthReduceMinRowScalar(r.row0.data(), r.row1.data(), outWidth, scalar.data());
+        CHECK(SameBits(simd, scalar));
+        for (int32_t x = 0; x < outWidth; x++) {
+            const std::vector<float> v = ValidInBlock(r, x);
+            CHECK(scalar[x] == (v.empty() ? 0.0f : *std::min_element(v.begin(), v.end())));
+        }
+    }
+}
+
+void TestReduceMedian() {
+    TestRandom rng(23);
+    int counts[5] = {0, 0, 0, 0, 0};
+    for (int32_t outWidth : kWidths) {
+        const BlockRows r = MakeBlockRows(outWidth, rng);
+        std::vector<float> simd(outWidth, -9.0f), scalar(outWidth, -9.0f);
+        DepthReduceMedianRow(r.row0.data(), r.row1.data(), outWidth, simd.data());
+        DepthReduceMedianRowScalar(r.row0.data(), r.row1.data(), outWidth, scalar.data());
+        CHECK(SameBits(simd, scalar));
+        for (int32_t x = 0; x < outWidth; x++) {
+            std::vector<float> v = ValidInBlock(r, x);
+            std::sort(v.begin(), v.end());
+            const size_t n = v.size();
+            counts[n]++;
+            const float expected = n == 0 ? 0.0f : (n & 1) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) * 0.5f;
+            CHECK(scalar[x] == expected);
+        }
+    }
+    // Every valid-count case was exercised
+    for (int n = 0; n <= 4; n++) CHECK(counts[n] > 0);
+}
+
+void TestReduceWeighted() {
+    TestRandom rng(24);
+    for (int32_t outWidth : kWidths) {
+        const BlockRows r = MakeBlockRows(outWidth, rng);
+        for (int weights = 0; weights < 4; weights++) {
+            const float* w0 = (weights & 1) ? r.w0.data() : nullptr;
+            const float* w1 = (weights & 2) ? r.w1.data() : nullptr;
+            std::vector<float> simd(outWidth, -9.0f), scalar(outWidth, -9.0f);
+            std::vector<float> simdW(outWidth, -9.0f), scalarW(outWidth, -9.0f);
+            DepthReduceWeightedRow(r.row0.data(), r.row1.data(), w0, w1, outWidth, simd.data(), simdW.data());
+            DepthReduceWeightedRowScalar(r.row0.data(), r.row1.data(), w0, w1, outWidth, scalar.data(), scalarW.data());
+            CHECK(SameBits(simd, scalar));
+            CHECK(SameBits(simdW, scalarW));
+
+            // Without an output weight buffer the depth is unchanged
+            std::vector<float> noWeight(outWidth, -9.0f);
+            DepthReduceWeightedRow(r.row0.data(), r.row1.data(), w0, w1, outWidth, noWeight.data(), nullptr);
+            CHECK(SameBits(noWeight, simd));
+
+            for (int32_t x = 0; x < outWidth; x++) {
+                const float d[4] = {r.row0[2 * x], r.row0[2 * x + 1], r.row1[2 * x], r.row1[2 * x + 1]};
+                const float* w[4] = {w0 ? w0 + 2 * x : nullptr, w0 ? w0 + 2 * x + 1 : nullptr,
+                                     w1 ? w1 + 2 * x : nullptr, w1 ? w1 + 2 * x + 1 : nullptr};
+                double sw = 0.0, swd = 0.0;
+                for (int i = 0; i < 4; i++) {
+                    if (!(d[i] > 0.0f)) continue;
+                    const double wi = w[i] ? (*w[i] > 0.0f ? std::min(*w[i], 1.0f) : 0.0f) : 1.0;
+                    sw += wi;
+                    swd += wi * d[i];
+                }
+                CHECK_NEAR(scalar[x], sw > 0.0 ? swd / sw : 0.0, 1e-5);
+                CHECK_NEAR(scalarW[x], sw * 0.25, 1e-6);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    TestMask();
+    TestReduceMin();
+    TestReduceMedian();
+    TestReduceWeighted();
+    printf("test_depthkernels: ok\n");
+    return 0;
+}
@@ -0,0 +1,330 @@
+// Depth normal tests (mldepthnormals.h): normals of rendered planes and a
+// sphere against their analytic normals, the octahedral encoding against the
+// float normals, the SIMD kernels against the scalar reference, and the
+// capture-thread path (DepthNormals_ProcessFrame / TryGetProcessed) against a
+// direct MLDepthNormalsUnity_Compute.
+
+#include "mldepthnormals.h"
+#include "testing.h"
+
+#include <cstring>
+
+// The depth module, reduced to one leased frame and a calibration history
+namespace {
+int64_t g_calibrationTimeNs = 0;
+DepthIntrinsics g_frameIntrinsics{};
+DepthFrameInfo g_frameInfo{};
+std::vector<float> g_frameDepth;
+int32_t g_leases = 0;
+}  // namespace
+
+extern "C" {
+bool MLDepthUnity_AcquireLatest(uint32_t stream, DepthFrameInfo* outInfo, const uint8_t** outBytes,
+                                int32_t* outSize, void** outLease) {
+    if (stream != DepthStream_Depth || g_frameDepth.empty()) return false;
+    *outInfo = g_frameInfo;
+    *outBytes = (const uint8_t*)g_frameDepth.data();
+    *outSize = (int32_t)(g_frameDepth.size() * sizeof(float));
+    *outLease = &g_frameDepth;
+    g_leases++;
+    return true;
+}
+void MLDepthUnity_ReleaseFrame(void*) { g_leases--; }
+bool MLDepthUnity_GetFrameCalibration(int64_t captureTimeNs, DepthIntrinsics* outIntrinsics, DepthCameraPose*) {
+    if (captureTimeNs != g_calibrationTimeNs) return false;
+    if (outIntrinsics) *outIntrinsics = g_frameIntrinsics;
+    return true;
+}
+}
+
+namespace {
+
+const int32_t kWidth = 160, kHeight = 120;
+
+struct Frame {
+    DepthFrameInfo info;
+    DepthIntrinsics intrinsics;
+    std::vector<float> depth;
+};
+
+Frame MakeFrame() {
+    Frame f;
+    memset(&f.info, 0, sizeof(f.info));
+    f.info.width = kWidth;
+    f.info.height = kHeight;
+    f.info.strideBytes = kWidth * 4;
+    f.info.bytesPerPixel = 4;
+    f.info.captureTimeNs = 5000;
+    f.intrinsics = {kWidth, kHeight, 110.0f, 112.0f, 79.3f, 60.8f, 5000};
+    f.depth.assign((size_t)kWidth * kHeight, 0.0f);
+    return f;
+}
+
+void Ray(const Frame& f, int32_t u, int32_t v, double* r) {
+    r[0] = (u - f.intrinsics.cx) / f.intrinsics.fx;
+    r[1] = (v - f.intrinsics.cy) / f.intrinsics.fy;
+    r[2] = 1.0;
+}
+
+void Normalize(double* n) {
+    const double len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    for (int i = 0; i < 3; i++) n[i] /= len;
+}
+
+std::vector<float> ComputeFloat3(const Frame& f, int32_t radius, float jump, uint32_t flags) {
+    std::vector<float> out((size_t)kWidth * kHeight * 3, -9.0f);
+    int32_t written = 0;
+    CHECK(MLDepthNormalsUnity_Compute(&f.info, (const uint8_t*)f.depth.data(), &f.intrinsics,
+                                      DepthNormalFormat_Float3, radius, jump, flags, (uint8_t*)out.data(),
+                                      (int32_t)(out.size() * sizeof(float)), &written));
+    CHECK(written == kWidth * kHeight * 12);
+    return out;
+}
+
+std::vector<int16_t> ComputeOct(const Frame& f, int32_t radius, float jump, uint32_t flags) {
+    std::vector<int16_t> out((size_t)kWidth * kHeight * 2, 7);
+    int32_t written = 0;
+    CHECK(MLDepthNormalsUnity_Compute(&f.info, (const uint8_t*)f.depth.data(), &f.intrinsics,
+                                      DepthNormalFormat_Oct16, radius, jump, flags, (uint8_t*)out.data(),
+                                      (int32_t)(out.size() * sizeof(int16_t)), &written));
+    CHECK(written == kWidth * kHeight * 4);
+    return out;
+}
+
+// Plane n . P = d seen from the camera; the expected normal faces the camera
+void TestPlane() {
+    const double planes[][4] = {{0.0, 0.0, 1.0, 2.0}, {0.3, -0.2, 1.0, 1.5}, {-0.5, 0.4, 0.8, 2.5}};
+    for (const double* plane : planes) {
+        double n[3] = {plane[0], plane[1], plane[2]};
+        Normalize(n);
+        const double d = plane[3] / std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        Frame f = MakeFrame();
+        for (int32_t v = 0; v < kHeight; v++) {
+            for (int32_t u = 0; u < kWidth; u++) {
+                double r[3];
+                Ray(f, u, v, r);
+                f.depth[(size_t)v * kWidth + u] = (float)(d / (n[0] * r[0] + n[1] * r[1] + n[2] * r[2]));
+            }
+        }
+        // The camera is at the origin, on the -n side of the plane
+        const double expected[3] = {-n[0], -n[1], -n[2]};
+
+        for (int32_t radius = 0; radius <= 3; radius++) {
+            const int32_t step = radius > 0 ? radius : 1;
+            const std::vector<float> out = ComputeFloat3(f, radius, 0.0f, 0);
+            for (int32_t v = 0; v < kHeight; v++) {
+                for (int32_t u = 0; u < kWidth; u++) {
+                    const float* p = &out[((size_t)v * kWidth + u) * 3];
+                    const bool border = u < step || u >= kWidth - step || v < step || v >= kHeight - step;
+                    if (border) {
+                        CHECK(p[0] == 0.0f && p[1] == 0.0f && p[2] == 0.0f);
+                        continue;
+                    }
+                    // Box smoothing of a plane stays on the plane (clipped windows included)
+                    CHECK(p[0] * expected[0] + p[1] * expected[1] + p[2] * expected[2] > 0.9995);
+                }
+            }
+        }
+    }
+}
+
+// Sphere of radius 0.5 m, 1.5 m in front of the camera: normals point from
+// the center through the surface point, towards the camera
+void TestSphere() {
+    const double c[3] = {0.05, -0.03, 1.5}, radiusM = 0.5;
+    Frame f = MakeFrame();
+    std::vector<double> hitX(f.depth.size()), hitY(f.depth.size()), hitZ(f.depth.size());
+    for (int32_t v = 0; v < kHeight; v++) {
+        for (int32_t u = 0; u < kWidth; u++) {
+            double r[3];
+            Ray(f, u, v, r);
+            // |t r - c|^2 = R^2, nearest root
+            const double a = r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+            const double b = -2.0 * (r[0] * c[0] + r[1] * c[1] + r[2] * c[2]);
+            const double cc = c[0] * c[0] + c[1] * c[1] + c[2] * c[2] - radiusM * radiusM;
+            const double disc = b * b - 4 * a * cc;
+            if (disc < 0.0) continue;
+            const double t = (-b - std::sqrt(disc)) / (2 * a);
+            const size_t i = (size_t)v * kWidth + u;
+            f.depth[i] = (float)t;
+            hitX[i] = t * r[0];
+            hitY[i] = t * r[1];
+            hitZ[i] = t * r[2];
+        }
+    }
+
+    for (int32_t radius : {0, 1, 2}) {
+        const std::vector<float> out = ComputeFloat3(f, radius, 0.0f, 0);
+        const int32_t step = radius > 0 ? radius : 1;
+        const int32_t reach = step + radius;  // pixels feeding one normal
+        int32_t checked = 0;
+        for (int32_t v = reach; v < kHeight - reach; v++) {
+            for (int32_t u = reach; u < kWidth - reach; u++) {
+                const size_t i = (size_t)v * kWidth + u;
+                if (!(f.depth[i] > 0.0f)) continue;
+                double nExp[3] = {hitX[i] - c[0], hitY[i] - c[1], hitZ[i] - c[2]};
+                double view[3] = {-hitX[i], -hitY[i], -hitZ[i]};
+                Normalize(nExp);
+                Normalize(view);
+                // Away from the silhouette, where the neighbours run off the sphere
+                if (nExp[0] * view[0] + nExp[1] * view[1] + nExp[2] * view[2] < 0.7) continue;
+                const float* p = &out[i * 3];
+                const double dot = p[0] * nExp[0] + p[1] * nExp[1] + p[2] * nExp[2];
+                CHECK(dot > (radius == 0 ? 0.999 : 0.995));
+                checked++;
+            }
+        }
+        CHECK(checked > 1000);
+    }
+
+    // Outside the sphere there is no depth: invalid, and so are its neighbours
+    const std::vector<float> out = ComputeFloat3(f, 0, 0.0f, 0);
+    const size_t corner = (size_t)5 * kWidth + 5;
+    CHECK(out[corner * 3] == 0.0f && out[corner * 3 + 1] == 0.0f && out[corner * 3 + 2] == 0.0f);
+}
+
+// Octahedral decode of the 16-bit output matches the float normals
+void TestOctEncoding() {
+    Frame f = MakeFrame();
+    TestRandom rng(31);
+    for (int32_t v = 0; v < kHeight; v++) {
+        for (int32_t u = 0; u < kWidth; u++) {
+            f.depth[(size_t)v * kWidth + u] = 1.0f + 0.4f * std::sin(u / 9.0f) * std::cos(v / 7.0f) + rng.Uniform(0.0f, 0.002f);
+        }
+    }
+    const std::vector<float> normals = ComputeFloat3(f, 1, 0.0f, 0);
+    const std::vector<int16_t> oct = ComputeOct(f, 1, 0.0f, 0);
+    for (size_t i = 0; i < (size_t)kWidth * kHeight; i++) {
+        const float* n = &normals[i * 3];
+        if (n[0] == 0.0f && n[1] == 0.0f && n[2] == 0.0f) {
+            CHECK(oct[i * 2] == -32768 && oct[i * 2 + 1] == -32768);
+            continue;
+        }
+        double ox = oct[i * 2] / 32767.0, oy = oct[i * 2 + 1] / 32767.0;
+        double d[3] = {ox, oy, 1.0 - std::fabs(ox) - std::fabs(oy)};
+        if (d[2] < 0.0) {
+            d[0] = (1.0 - std::fabs(oy)) * (ox >= 0.0 ? 1.0 : -1.0);
+            d[1] = (1.0 - std::fabs(ox)) * (oy >= 0.0 ? 1.0 : -1.0);
+        }
+        Normalize(d);
+        CHECK(d[0] * n[0] + d[1] * n[1] + d[2] * n[2] > 0.99999);
+    }
+}
+
+// Rough surface with holes, NaN and depth jumps: SIMD == scalar, both formats
+void TestSimdMatchesScalar() {
+    Frame f = MakeFrame();
+    TestRandom rng(32);
+    for (int32_t v = 0; v < kHeight; v++) {
+        for (int32_t u = 0; u < kWidth; u++) {
+            float d = 1.5f + 0.2f * std::sin(u / 13.0f) + rng.Uniform(-0.01f, 0.01f);
+            if (u > 90 && v > 40 && v < 80) d -= 0.6f;  // step edge
+            const uint32_t r = rng.Next() % 40;
+            if (r == 0) d = 0.0f;
+            else if (r == 1) d = NAN;
+            f.depth[(size_t)v * kWidth + u] = d;
+        }
+    }
+    for (int32_t radius = 0; radius <= 3; radius++) {
+        for (float jump : {0.0f, 0.05f}) {
+            const std::vector<float> simd = ComputeFloat3(f, radius, jump, 0);
+            const std::vector<float> scalar = ComputeFloat3(f, radius, jump, DepthNormalFlag_ForceScalar);
+            CHECK(memcmp(simd.data(), scalar.data(), simd.size() * sizeof(float)) == 0);
+            CHECK(ComputeOct(f, radius, jump, 0) == ComputeOct(f, radius, jump, DepthNormalFlag_ForceScalar));
+        }
+    }
+
+    // The jump limit drops normals across the step edge
+    const std::vector<float> limited = ComputeFloat3(f, 0, 0.05f, 0);
+    const size_t edge = (size_t)60 * kWidth + 91;
+    CHECK(limited[edge * 3 + 2] == 0.0f);
+}
+
+void TestCaptureThread() {
+    Frame f = MakeFrame();
+    for (float& d : f.depth) d = 2.0f;
+    f.depth[(size_t)50 * kWidth + 50] = 0.0f;
+
+    // Not configured: nothing published
+    DepthNormals_ProcessFrame(f.info, (const uint8_t*)f.depth.data(), f.intrinsics);
+    DepthFrameInfo info;
+    std::vector<uint8_t> out((size_t)kWidth * kHeight * 12);
+    int32_t written = 0;
+    CHECK(!MLDepthNormalsUnity_TryGetProcessed(&info, out.data(), (int32_t)out.size(), &written));
+
+    CHECK(!MLDepthNormalsUnity_Configure(true, 7, 0, 0.0f));
+    CHECK(!MLDepthNormalsUnity_Configure(true, DepthNormalFormat_Oct16, -1, 0.0f));
+    for (uint32_t format : {DepthNormalFormat_Float3, DepthNormalFormat_Oct16}) {
+        CHECK(MLDepthNormalsUnity_Configure(true, format, 2, 0.1f));
+        DepthNormals_ProcessFrame(f.info, (const uint8_t*)f.depth.data(), f.intrinsics);
+
+        const int32_t pixelBytes = format == DepthNormalFormat_Float3 ? 12 : 4;
+        std::vector<uint8_t> direct((size_t)kWidth * kHeight * pixelBytes);
+        CHECK(MLDepthNormalsUnity_Compute(&f.info, (const uint8_t*)f.depth.data(), &f.intrinsics, format, 2, 0.1f, 0,
+                                          direct.data(), (int32_t)direct.size(), &written));
+
+        // Too small: required size
+        CHECK(!MLDepthNormalsUnity_TryGetProcessed(&info, out.data(), 16, &written));
+        CHECK(written == (int32_t)direct.size());
+        CHECK(MLDepthNormalsUnity_TryGetProcessed(&info, out.data(), (int32_t)out.size(), &written));
+        CHECK(written == (int32_t)direct.size());
+        CHECK(memcmp(out.data(), direct.data(), direct.size()) == 0);
+        CHECK(info.width == kWidth && info.height == kHeight && info.captureTimeNs == f.info.captureTimeNs);
+        CHECK(info.bytesPerPixel == pixelBytes && info.strideBytes == kWidth * pixelBytes);
+        CHECK(info.format == (int32_t)format);
+
+        const uint8_t* bytes = nullptr;
+        int32_t size = 0;
+        void* lease = nullptr;
+        CHECK(MLDepthNormalsUnity_AcquireProcessed(&info, &bytes, &size, &lease));
+        CHECK(size == (int32_t)direct.size() && memcmp(bytes, direct.data(), direct.size()) == 0);
+        MLDepthNormalsUnity_ReleaseFrame(lease);
+    }
+
+    // Disabled: the last published frame stays, no new ones
+    CHECK(MLDepthNormalsUnity_Configure(false, DepthNormalFormat_Float3, 0, 0.0f));
+    f.info.captureTimeNs = 9999;
+    DepthNormals_ProcessFrame(f.info, (const uint8_t*)f.depth.data(), f.intrinsics);
+    CHECK(MLDepthNormalsUnity_TryGetProcessed(&info, out.data(), (int32_t)out.size(), &written));
+    CHECK(info.captureTimeNs == 5000 && info.format == DepthNormalFormat_Oct16);
+
+    DepthNormals_Reset();
+    CHECK(!MLDepthNormalsUnity_TryGetProcessed(&info, out.data(), (int32_t)out.size(), &written));
+}
+
+// TryGetLatest only uses the intrinsics recorded for the leased frame
+void TestTryGetLatest() {
+    Frame f = MakeFrame();
+    for (float& d : f.depth) d = 2.0f;
+    g_frameInfo = f.info;
+    g_frameDepth = f.depth;
+    g_frameIntrinsics = f.intrinsics;
+    g_calibrationTimeNs = f.info.captureTimeNs;
+
+    std::vector<float> out((size_t)kWidth * kHeight * 3);
+    DepthFrameInfo info;
+    int32_t written = 0;
+    CHECK(MLDepthNormalsUnity_TryGetLatest(DepthNormalFormat_Float3, 0, 0.0f, 0, &info, (uint8_t*)out.data(),
+                                           (int32_t)(out.size() * sizeof(float)), &written));
+    CHECK(info.captureTimeNs == f.info.captureTimeNs);
+    CHECK(out == ComputeFloat3(f, 0, 0.0f, 0));
+    CHECK(g_leases == 0);
+
+    g_calibrationTimeNs = f.info.captureTimeNs + 1;
+    CHECK(!MLDepthNormalsUnity_TryGetLatest(DepthNormalFormat_Float3, 0, 0.0f, 0, &info, (uint8_t*)out.data(),
+                                            (int32_t)(out.size() * sizeof(float)), &written));
+    CHECK(g_leases == 0);
+}
+
+}  // namespace
+
+int main() {
+    TestPlane();
+    TestSphere();
+    TestOctEncoding();
+    TestSimdMatchesScalar();
+    TestCaptureThread();
+    TestTryGetLatest();
+    printf("test_depthnormals: ok\n");
+    return 0;
+}
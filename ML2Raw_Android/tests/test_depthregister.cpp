@@ -0,0 +1,238 @@
+// Depth-to-RGB registration tests (mldepthregister.h, MLDepthRegisterUnity_ToRGB):
+// a synthetic depth frame with a near box in front of a curved wall is
+// registered into an RGB camera with a known pose and intrinsics and compared
+// with a double-precision scalar reprojection that splats and z-buffers the
+// same way, so the box must occlude the wall where both land. The SIMD,
+// scalar and single-thread paths must agree exactly.
+
+#include "mldepthregister.h"
+#include "testing.h"
+
+#include <cstring>
+
+// The latest-frame path pulls from the depth module; not exercised here
+extern "C" {
+bool MLDepthUnity_AcquireLatest(uint32_t, DepthFrameInfo*, const uint8_t**, int32_t*, void**) { return false; }
+void MLDepthUnity_ReleaseFrame(void*) {}
+bool MLDepthUnity_GetFrameCalibration(int64_t, DepthIntrinsics*, DepthCameraPose*) { return false; }
+}
+
+namespace {
+
+const int32_t kDepthWidth = 544, kDepthHeight = 480;
+
+// Box at 0.8 m over a wall at 2-2.6 m, with a band of invalid pixels
+std::vector<float> MakeDepth() {
+    std::vector<float> depth((size_t)kDepthWidth * kDepthHeight);
+    for (int32_t v = 0; v < kDepthHeight; v++) {
+        for (int32_t u = 0; u < kDepthWidth; u++) {
+            float d = 2.3f + 0.3f * std::sin((float)u / 40.0f) * std::cos((float)v / 55.0f);
+            if (u >= 220 && u < 330 && v >= 160 && v < 300) d = 0.8f;
+            if (v >= 400 && v < 404) d = (u & 1) ? 0.0f : NAN;
+            depth[(size_t)v * kDepthWidth + u] = d;
+        }
+    }
+    return depth;
+}
+
+void QuatFromAxisAngle(double ax, double ay, double az, double angle, float* q) {
+    const double n = std::sqrt(ax * ax + ay * ay + az * az);
+    const double s = std::sin(angle / 2) / n;
+    q[0] = (float)(ax * s);
+    q[1] = (float)(ay * s);
+    q[2] = (float)(az * s);
+    q[3] = (float)std::cos(angle / 2);
+}
+
+void QuatToMatrix(const float* q, double* R) {
+    const double x = q[0], y = q[1], z = q[2], w = q[3];
+    R[0] = 1 - 2 * (y * y + z * z); R[1] = 2 * (x * y - z * w);     R[2] = 2 * (x * z + y * w);
+    R[3] = 2 * (x * y + z * w);     R[4] = 1 - 2 * (x * x + z * z); R[5] = 2 * (y * z - x * w);
+    R[6] = 2 * (x * z - y * w);     R[7] = 2 * (y * z + x * w);     R[8] = 1 - 2 * (x * x + y * y);
+}
+
+struct Setup {
+    DepthFrameInfo info;
+    DepthIntrinsics intrinsics;
+    DepthRegisterPose depthPose;
+    RGBFrameWithPose rgb;
+};
+
+Setup MakeSetup() {
+    Setup s;
+    memset(&s, 0, sizeof(s));
+    s.info.width = kDepthWidth;
+    s.info.height = kDepthHeight;
+    s.info.strideBytes = kDepthWidth * 4;
+    s.info.bytesPerPixel = 4;
+    s.intrinsics = {kDepthWidth, kDepthHeight, 363.0f, 365.0f, 270.2f, 242.7f, 0};
+
+    // Depth camera tilted a little; the RGB camera 6 cm to its side, turned
+    // towards it, with a narrower field of view
+    float q[4];
+    QuatFromAxisAngle(0.2, 1.0, 0.1, 0.05, q);
+    s.depthPose = {q[0], q[1], q[2], q[3], 0.01f, 1.5f, -0.02f};
+    QuatFromAxisAngle(0.1, -1.0, 0.3, 0.04, q);
+    RGBFrameWithPose& rgb = s.rgb;
+    rgb.width = 1280;
+    rgb.height = 720;
+    rgb.pose_rotation_x = q[0];
+    rgb.pose_rotation_y = q[1];
+    rgb.pose_rotation_z = q[2];
+    rgb.pose_rotation_w = q[3];
+    rgb.pose_position_x = 0.07f;
+    rgb.pose_position_y = 1.52f;
+    rgb.pose_position_z = -0.03f;
+    rgb.pose_valid = 1;
+    rgb.fx = 960.0f;
+    rgb.fy = 958.0f;
+    rgb.cx = 641.3f;
+    rgb.cy = 358.9f;
+    return s;
+}
+
+// Every valid depth pixel to world and into the output camera, in double
+// precision; a splat x splat square per point, nearest z wins
+std::vector<float> Reference(const Setup& s, const std::vector<float>& depth, int32_t outWidth, int32_t outHeight, bool noSplat) {
+    double Rd[9], Rr[9];
+    const float qd[4] = {s.depthPose.rotation_x, s.depthPose.rotation_y, s.depthPose.rotation_z, s.depthPose.rotation_w};
+    const float qr[4] = {s.rgb.pose_rotation_x, s.rgb.pose_rotation_y, s.rgb.pose_rotation_z, s.rgb.pose_rotation_w};
+    QuatToMatrix(qd, Rd);
+    QuatToMatrix(qr, Rr);
+    const double td[3] = {s.depthPose.position_x, s.depthPose.position_y, s.depthPose.position_z};
+    const double tr[3] = {s.rgb.pose_position_x, s.rgb.pose_position_y, s.rgb.pose_position_z};
+
+    const double sx = (double)outWidth / s.rgb.width, sy = (double)outHeight / s.rgb.height;
+    const double fx = s.rgb.fx * sx, fy = s.rgb.fy * sy;
+    const double cx = (s.rgb.cx + 0.5) * sx - 0.5, cy = (s.rgb.cy + 0.5) * sy - 0.5;
+    int32_t splat = 1;
+    if (!noSplat) {
+        splat = (int32_t)std::ceil(std::max(fx / s.intrinsics.fx, fy / s.intrinsics.fy));
+        splat = std::max(1, std::min(4, splat));
+    }
+    const int32_t back = (splat - 1) / 2;
+
+    std::vector<float> out((size_t)outWidth * outHeight, INFINITY);
+    for (int32_t v = 0; v < kDepthHeight; v++) {
+        for (int32_t u = 0; u < kDepthWidth; u++) {
+            const double d = depth[(size_t)v * kDepthWidth + u];
+            if (!(d > 0.0)) continue;
+            // Image frame (x right, y down, z forward) to pose frame (y up, looking down -z)
+            const double img[3] = {(u - s.intrinsics.cx) / s.intrinsics.fx * d, (v - s.intrinsics.cy) / s.intrinsics.fy * d, d};
+            const double cam[3] = {img[0], -img[1], -img[2]};
+            double world[3], rel[3], q[3];
+            for (int i = 0; i < 3; i++) world[i] = Rd[i * 3] * cam[0] + Rd[i * 3 + 1] * cam[1] + Rd[i * 3 + 2] * cam[2] + td[i];
+            for (int i = 0; i < 3; i++) rel[i] = world[i] - tr[i];
+            for (int i = 0; i < 3; i++) q[i] = Rr[i] * rel[0] + Rr[3 + i] * rel[1] + Rr[6 + i] * rel[2];
+            const double qi[3] = {q[0], -q[1], -q[2]};
+            if (qi[2] <= 0.0) continue;
+
+            const double x = fx * qi[0] / qi[2] + cx + 0.5, y = fy * qi[1] / qi[2] + cy + 0.5;
+            if (x < 0.0 || x >= outWidth || y < 0.0 || y >= outHeight) continue;
+            const int32_t pu = (int32_t)x - back, pv = (int32_t)y - back;
+            for (int32_t r = std::max(pv, 0); r < std::min(pv + splat, outHeight); r++) {
+                for (int32_t c = std::max(pu, 0); c < std::min(pu + splat, outWidth); c++) {
+                    float& z = out[(size_t)r * outWidth + c];
+                    z = std::min(z, (float)qi[2]);
+                }
+            }
+        }
+    }
+    for (float& z : out) {
+        if (z == INFINITY) z = 0.0f;
+    }
+    return out;
+}
+
+std::vector<float> Register(const Setup& s, const std::vector<float>& depth, int32_t outWidth, int32_t outHeight, uint32_t flags) {
+    std::vector<float> out((size_t)outWidth * outHeight, -1.0f);
+    int32_t written = 0;
+    CHECK(MLDepthRegisterUnity_ToRGB(&s.info, (const uint8_t*)depth.data(), &s.intrinsics, &s.depthPose, &s.rgb,
+                                     outWidth, outHeight, flags, out.data(), (int32_t)out.size(), &written));
+    CHECK(written == outWidth * outHeight);
+    return out;
+}
+
+// Rounding at pixel borders differs between float and double for a handful
+// of points; everything else must match the reference. minCoverage: share of
+// the output with data (splatting fills the upsampled image, single points
+// leave it sparse).
+void CompareWithReference(const std::vector<float>& out, const std::vector<float>& ref, double minCoverage) {
+    size_t mismatched = 0, covered = 0;
+    for (size_t i = 0; i < out.size(); i++) {
+        if (ref[i] > 0.0f) covered++;
+        if ((out[i] > 0.0f) != (ref[i] > 0.0f) || std::fabs(out[i] - ref[i]) > 1e-4f) mismatched++;
+    }
+    CHECK((double)covered > minCoverage * (double)out.size());
+    CHECK(mismatched < out.size() / 2000);
+}
+
+void TestAgainstReference() {
+    const Setup s = MakeSetup();
+    const std::vector<float> depth = MakeDepth();
+
+    const int32_t sizes[][2] = {{1280, 720}, {640, 360}, {544, 306}};
+    for (const int32_t* size : sizes) {
+        for (bool noSplat : {false, true}) {
+            const uint32_t flags = noSplat ? DepthRegisterFlag_NoSplat : 0;
+            const std::vector<float> ref = Reference(s, depth, size[0], size[1], noSplat);
+            const std::vector<float> out = Register(s, depth, size[0], size[1], flags);
+            CompareWithReference(out, ref, noSplat ? 0.1 : 0.8);
+
+            // Same kernels' results in every mode
+            CHECK(Register(s, depth, size[0], size[1], flags | DepthRegisterFlag_ForceScalar) == out);
+            CHECK(Register(s, depth, size[0], size[1], flags | DepthRegisterFlag_SingleThread) == out);
+        }
+    }
+}
+
+// Where the box lands, the wall behind it must not show through
+void TestOcclusion() {
+    const Setup s = MakeSetup();
+    const std::vector<float> depth = MakeDepth();
+    const std::vector<float> out = Register(s, depth, 1280, 720, 0);
+
+    // Project the box center with the reference (box only, no wall)
+    std::vector<float> boxOnly(depth.size(), 0.0f);
+    for (int32_t v = 200; v < 260; v++) {
+        for (int32_t u = 250; u < 300; u++) boxOnly[(size_t)v * kDepthWidth + u] = 0.8f;
+    }
+    const std::vector<float> box = Reference(s, boxOnly, 1280, 720, false);
+    size_t boxPixels = 0;
+    for (size_t i = 0; i < box.size(); i++) {
+        if (box[i] <= 0.0f) continue;
+        boxPixels++;
+        // Neighbouring box points may be a little nearer, the wall is >= 1.7 m
+        CHECK(out[i] <= box[i] + 1e-4f && out[i] > 0.7f);
+    }
+    CHECK(boxPixels > 1000);
+}
+
+void TestRejects() {
+    Setup s = MakeSetup();
+    const std::vector<float> depth = MakeDepth();
+    std::vector<float> out(1280 * 720);
+    int32_t written = 0;
+
+    CHECK(!MLDepthRegisterUnity_ToRGB(&s.info, (const uint8_t*)depth.data(), &s.intrinsics, &s.depthPose, &s.rgb,
+                                      0, 0, 0, out.data(), 100, &written));
+    CHECK(written == 1280 * 720);  // required size
+
+    s.rgb.pose_valid = 0;
+    CHECK(!MLDepthRegisterUnity_ToRGB(&s.info, (const uint8_t*)depth.data(), &s.intrinsics, &s.depthPose, &s.rgb,
+                                      0, 0, 0, out.data(), (int32_t)out.size(), &written));
+    s.rgb.pose_valid = 1;
+    s.info.bytesPerPixel = 2;
+    CHECK(!MLDepthRegisterUnity_ToRGB(&s.info, (const uint8_t*)depth.data(), &s.intrinsics, &s.depthPose, &s.rgb,
+                                      0, 0, 0, out.data(), (int32_t)out.size(), &written));
+}
+
+}  // namespace
+
+int main() {
+    TestAgainstReference();
+    TestOcclusion();
+    TestRejects();
+    printf("test_depthregister: ok\n");
+    return 0;
+}
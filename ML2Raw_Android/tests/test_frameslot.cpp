@@ -0,0 +1,205 @@
+// FrameSlots tests (mlframeslot.h): readers racing a producer never see a
+// half-written frame, a pinned slot is never handed back to the producer,
+// WaitForNewer times out and wakes on publish, and Reset() leaves pinned
+// slots alone. Run under TSan as well (-fsanitize=thread).
+
+#include "mlframeslot.h"
+#include "testing.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+struct Info {
+    uint64_t frame;
+};
+
+typedef FrameSlots<Info, 3> Slots;
+
+const size_t kFrameBytes = 64 * 1024;
+
+// Every byte of a frame derives from its number, so a torn copy shows
+void Fill(Slots::Slot* slot, uint64_t frame) {
+    slot->info.frame = frame;
+    slot->bytes.assign(kFrameBytes, (uint8_t)(frame * 31 + 7));
+}
+
+bool Intact(const Slots::Slot* slot) {
+    const uint8_t expected = (uint8_t)(slot->info.frame * 31 + 7);
+    if (slot->bytes.size() != kFrameBytes) return false;
+    for (uint8_t b : slot->bytes) {
+        if (b != expected) return false;
+    }
+    return true;
+}
+
+void TestNoTornReads() {
+    Slots slots;
+    std::atomic<bool> stop{false};
+    std::atomic<int64_t> reads{0}, torn{0}, backwards{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; r++) {
+        readers.emplace_back([&] {
+            uint64_t last = 0;
+            while (!stop.load()) {
+                const Slots::Slot* slot = slots.Acquire();
+                if (!slot) continue;
+                if (!Intact(slot)) torn++;
+                // Copy-out like ReadFrame does, then check again: still pinned
+                std::vector<uint8_t> copy(slot->bytes);
+                const uint64_t frame = slot->info.frame;
+                if (!Intact(slot) || copy[0] != (uint8_t)(frame * 31 + 7) || copy.back() != copy[0]) torn++;
+                if (frame < last) backwards++;
+                last = frame;
+                Slots::Release(slot);
+                reads++;
+            }
+        });
+    }
+
+    uint64_t frame = 0;
+    const int64_t end = TestNowNs() + 300 * 1000000LL;
+    while (TestNowNs() < end) {
+        Slots::Slot* slot = slots.BeginWrite();
+        if (!slot) continue;
+        Fill(slot, ++frame);
+        slots.Publish(slot);
+    }
+    stop.store(true);
+    for (auto& t : readers) t.join();
+
+    CHECK(reads.load() > 0);
+    CHECK(torn.load() == 0);
+    CHECK(backwards.load() == 0);
+    CHECK(frame > 10);
+}
+
+void TestPinnedSlotsNotReused() {
+    Slots slots;
+    Slots::Slot* first = slots.BeginWrite();
+    Fill(first, 1);
+    slots.Publish(first);
+
+    // Pin frame 1, then keep publishing: the producer must write around it
+    const Slots::Slot* pinned = slots.Acquire();
+    CHECK(pinned == first);
+    for (uint64_t f = 2; f < 50; f++) {
+        Slots::Slot* slot = slots.BeginWrite();
+        CHECK(slot != nullptr);
+        CHECK(slot != pinned);
+        Fill(slot, f);
+        slots.Publish(slot);
+    }
+    CHECK(pinned->info.frame == 1 && Intact(pinned));
+    CHECK(slots.DroppedCount() == 0);
+
+    // Pin the latest as well: the only free slot is the one neither holds,
+    // and with that one published too every slot is taken, so frames drop
+    const Slots::Slot* pinned2 = slots.Acquire();
+    CHECK(pinned2 != pinned);
+    Slots::Slot* third = slots.BeginWrite();
+    CHECK(third != nullptr && third != pinned && third != pinned2);
+    Fill(third, 50);
+    slots.Publish(third);
+    const uint64_t before = slots.LatestSequence();
+    CHECK(slots.BeginWrite() == nullptr);
+    CHECK(slots.BeginWrite() == nullptr);
+    CHECK(slots.DroppedCount() == 2);
+    CHECK(pinned->info.frame == 1 && Intact(pinned));
+    CHECK(pinned2->info.frame == 49 && Intact(pinned2));
+
+    // Dropped frames still take a sequence number
+    Slots::Release(pinned);
+    Slots::Slot* next = slots.BeginWrite();
+    CHECK(next == pinned);
+    Fill(next, 53);
+    slots.Publish(next);
+    CHECK(slots.LatestSequence() == before + 3);
+    Slots::Release(pinned2);
+}
+
+void TestWaitForNewer() {
+    Slots slots;
+    CHECK(!slots.WaitForNewer(0, 0));
+
+    // Nothing published: times out after about the timeout
+    int64_t t0 = TestNowNs();
+    CHECK(!slots.WaitForNewer(0, 50));
+    const double waitedMs = (double)(TestNowNs() - t0) * 1e-6;
+    CHECK(waitedMs >= 45.0 && waitedMs < 1000.0);
+
+    // A publish wakes a waiter long before its timeout
+    std::atomic<bool> woke{false};
+    std::atomic<int64_t> wokeNs{0};
+    std::thread waiter([&] {
+        woke.store(slots.WaitForNewer(0, 5000));
+        wokeNs.store(TestNowNs());
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    Slots::Slot* slot = slots.BeginWrite();
+    Fill(slot, 1);
+    t0 = TestNowNs();
+    slots.Publish(slot);
+    waiter.join();
+    CHECK(woke.load());
+    CHECK((double)(wokeNs.load() - t0) * 1e-6 < 1000.0);
+
+    // Already newer: immediate; not newer: waits
+    const uint64_t seq = slots.LatestSequence();
+    CHECK(slots.WaitForNewer(seq - 1, 0));
+    CHECK(!slots.WaitForNewer(seq, 10));
+}
+
+void TestResetWhilePinned() {
+    Slots slots;
+    Slots::Slot* slot = slots.BeginWrite();
+    Fill(slot, 1);
+    slots.Publish(slot);
+    const uint64_t seq = slots.LatestSequence();
+    const Slots::Slot* pinned = slots.Acquire();
+
+    slots.Reset();
+    CHECK(!slots.HasFrame());
+    CHECK(slots.Acquire() == nullptr);
+    // The reader still holds intact data
+    CHECK(pinned->info.frame == 1 && Intact(pinned));
+    CHECK(pinned->sequence == seq);
+
+    // Until released, the producer never hands out the pinned slot
+    for (uint64_t f = 2; f < 10; f++) {
+        Slots::Slot* next = slots.BeginWrite();
+        CHECK(next != nullptr && next != pinned);
+        Fill(next, f);
+        slots.Publish(next);
+    }
+    CHECK(pinned->info.frame == 1 && Intact(pinned));
+    // Sequence numbers keep counting across Reset()
+    CHECK(slots.LatestSequence() > seq);
+    Slots::Release(pinned);
+
+    // Released and reset again, every slot is reusable
+    slots.Reset();
+    bool sawPinned = false;
+    for (uint64_t f = 10; f < 20; f++) {
+        Slots::Slot* next = slots.BeginWrite();
+        CHECK(next != nullptr);
+        if (next == pinned) sawPinned = true;
+        Fill(next, f);
+        slots.Publish(next);
+    }
+    CHECK(sawPinned);
+}
+
+}  // namespace
+
+int main() {
+    TestNoTornReads();
+    TestPinnedSlotsNotReused();
+    TestWaitForNewer();
+    TestResetWhilePinned();
+    printf("test_frameslot: ok\n");
+    return 0;
+}
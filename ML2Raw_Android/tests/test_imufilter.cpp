@@ -0,0 +1,247 @@
+// Orientation filter tests (mlimufilter.h): Madgwick and Mahony fed with
+// gyro/accel samples of a known rotation (spinning about a tilted axis while
+// nodding), with and without sensor noise and gyro bias, must track the tilt
+// and, without noise, the full orientation.
+
+#include "mlimufilter.h"
+#include "testing.h"
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+const double kGravity = 9.80665;
+const double kRateHz = 1000.0;
+
+void MatMul(const double* a, const double* b, double* out) {
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            out[r * 3 + c] = a[r * 3] * b[c] + a[r * 3 + 1] * b[3 + c] + a[r * 3 + 2] * b[6 + c];
+        }
+    }
+}
+
+void RotX(double a, double* R) {
+    const double c = std::cos(a), s = std::sin(a);
+    const double m[9] = {1, 0, 0, 0, c, -s, 0, s, c};
+    for (int i = 0; i < 9; i++) R[i] = m[i];
+}
+
+void RotZ(double a, double* R) {
+    const double c = std::cos(a), s = std::sin(a);
+    const double m[9] = {c, -s, 0, s, c, 0, 0, 0, 1};
+    for (int i = 0; i < 9; i++) R[i] = m[i];
+}
+
+// Sensor-to-earth rotation: yaw at 0.8 rad/s on top of a tilt of 30° that
+// nods by ±20° at 0.5 Hz
+void TrueRotation(double t, double* R) {
+    double Rz[9], Rx[9];
+    RotZ(0.8 * t, Rz);
+    RotX((30.0 + 20.0 * std::sin(2.0 * kPi * 0.5 * t)) * kPi / 180.0, Rx);
+    MatMul(Rz, Rx, R);
+}
+
+// Body rates from R^T dR/dt (central difference)
+void TrueGyro(double t, double* w) {
+    const double h = 1e-5;
+    double R[9], Rp[9], Rm[9];
+    TrueRotation(t, R);
+    TrueRotation(t + h, Rp);
+    TrueRotation(t - h, Rm);
+    double W[9];
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            double sum = 0.0;
+            for (int k = 0; k < 3; k++) sum += R[k * 3 + r] * (Rp[k * 3 + c] - Rm[k * 3 + c]) / (2.0 * h);
+            W[r * 3 + c] = sum;
+        }
+    }
+    w[0] = W[7];
+    w[1] = W[2];
+    w[2] = W[3];
+}
+
+// Accelerometer at rest: earth +z (up) in the sensor frame, times g
+void TrueAccel(double t, double* a) {
+    double R[9];
+    TrueRotation(t, R);
+    for (int i = 0; i < 3; i++) a[i] = R[6 + i] * kGravity;
+}
+
+double Gaussian(TestRandom& rng) {
+    double sum = 0.0;  // Irwin-Hall, close enough for sensor noise
+    for (int i = 0; i < 12; i++) sum += rng.Uniform(0.0f, 1.0f);
+    return sum - 6.0;
+}
+
+struct RunResult {
+    double meanTiltDeg;
+    double maxTiltDeg;
+    double maxOrientationDeg;  // including heading
+};
+
+struct RunOptions {
+    int32_t type;
+    float gain;
+    float biasGain;
+    double seconds;
+    double gyroNoise;   // rad/s per sample
+    double accelNoise;  // m/s² per sample
+    double gyroBias;    // rad/s on every axis
+    double settleSeconds;
+};
+
+RunResult Run(const RunOptions& o) {
+    OrientationFilter filter;
+    filter.Configure(o.type, o.gain, o.biasGain);
+    TestRandom rng(11);
+
+    double a0[3];
+    TrueAccel(0.0, a0);
+    const float accel0[3] = {(float)a0[0], (float)a0[1], (float)a0[2]};
+    filter.InitFromAccel(accel0);
+    CHECK(filter.Initialized());
+
+    RunResult result = {0.0, 0.0, 0.0};
+    int64_t counted = 0;
+    const double dt = 1.0 / kRateHz;
+    const int64_t steps = (int64_t)(o.seconds * kRateHz);
+    for (int64_t k = 1; k <= steps; k++) {
+        const double t = (double)k * dt;
+        double w[3], a[3];
+        TrueGyro(t - 0.5 * dt, w);  // mean rate over the step
+        TrueAccel(t, a);
+        float gyro[3], accel[3];
+        for (int i = 0; i < 3; i++) {
+            gyro[i] = (float)(w[i] + o.gyroBias + o.gyroNoise * Gaussian(rng));
+            accel[i] = (float)(a[i] + o.accelNoise * Gaussian(rng));
+        }
+        filter.Update(gyro, accel, (float)dt);
+        if (t < o.settleSeconds) continue;
+
+        // Tilt: angle between the true and estimated gravity directions
+        float g[3];
+        filter.Gravity(g);
+        const double gn = std::sqrt((double)g[0] * g[0] + (double)g[1] * g[1] + (double)g[2] * g[2]);
+        CHECK_NEAR(gn, kGravity, 1e-3);
+        double dot = 0.0;
+        for (int i = 0; i < 3; i++) dot += g[i] / gn * a[i] / kGravity;
+        const double tilt = std::acos(std::min(1.0, dot)) * 180.0 / kPi;
+        result.meanTiltDeg += tilt;
+        result.maxTiltDeg = std::max(result.maxTiltDeg, tilt);
+        counted++;
+
+        // Full orientation: angle of q_true^-1 q_filter
+        float q[4];
+        filter.Quaternion(q);
+        double R[9];
+        TrueRotation(t, R);
+        const double trueW = 0.5 * std::sqrt(std::max(0.0, 1.0 + R[0] + R[4] + R[8]));
+        const double trueX = (R[7] - R[5]) / (4.0 * trueW);
+        const double trueY = (R[2] - R[6]) / (4.0 * trueW);
+        const double trueZ = (R[3] - R[1]) / (4.0 * trueW);
+        const double qdot = std::fabs(trueX * q[0] + trueY * q[1] + trueZ * q[2] + trueW * q[3]);
+        result.maxOrientationDeg = std::max(result.maxOrientationDeg, 2.0 * std::acos(std::min(1.0, qdot)) * 180.0 / kPi);
+    }
+    result.meanTiltDeg /= (double)counted;
+    return result;
+}
+
+RunOptions Options(int32_t type) {
+    RunOptions o = {};
+    o.type = type;
+    o.seconds = 60.0;
+    o.settleSeconds = 1.0;
+    return o;
+}
+
+void TestNoiseFree() {
+    for (int32_t type : {OrientationFilter::Madgwick, OrientationFilter::Mahony}) {
+        const RunResult r = Run(Options(type));
+        CHECK(r.maxTiltDeg < 0.1);
+        CHECK(r.maxOrientationDeg < 0.2);  // heading holds without a magnetometer when the gyro is exact
+    }
+}
+
+void TestNoisy() {
+    for (int32_t type : {OrientationFilter::Madgwick, OrientationFilter::Mahony}) {
+        RunOptions o = Options(type);
+        o.gyroNoise = 0.005;
+        o.accelNoise = 0.05;
+        const RunResult r = Run(o);
+        CHECK(r.meanTiltDeg < 0.1);
+        CHECK(r.maxTiltDeg < 0.3);
+    }
+}
+
+// Gyro bias: both filters keep the tilt bounded; Mahony's integral term
+// (biasGain) removes most of the remaining error. The heading drifts with
+// the bias either way (no magnetometer), so only the tilt is checked.
+void TestGyroBias() {
+    RunOptions o = Options(OrientationFilter::Madgwick);
+    o.gyroBias = 0.01;
+    o.settleSeconds = 10.0;
+    const RunResult madgwick = Run(o);
+    CHECK(madgwick.meanTiltDeg < 0.2);
+
+    o.type = OrientationFilter::Mahony;
+    const RunResult proportional = Run(o);
+    o.biasGain = 0.1f;
+    const RunResult integral = Run(o);
+    CHECK(proportional.meanTiltDeg < 1.0);
+    CHECK(integral.meanTiltDeg < 0.5 * proportional.meanTiltDeg);
+}
+
+// Started from a wrong tilt, the accel correction pulls the estimate in
+void TestConvergence() {
+    for (int32_t type : {OrientationFilter::Madgwick, OrientationFilter::Mahony}) {
+        OrientationFilter filter;
+        filter.Configure(type, 0.0f, 0.0f);
+        const float wrong[3] = {0.0f, -6.0f, 7.7f};  // ~38° off the other way
+        filter.InitFromAccel(wrong);
+
+        double tilt = 180.0;
+        for (int64_t k = 1; k <= (int64_t)(40.0 * kRateHz); k++) {
+            const double t = (double)k / kRateHz;
+            double w[3], a[3];
+            TrueGyro(t - 0.5 / kRateHz, w);
+            TrueAccel(t, a);
+            const float gyro[3] = {(float)w[0], (float)w[1], (float)w[2]};
+            const float accel[3] = {(float)a[0], (float)a[1], (float)a[2]};
+            filter.Update(gyro, accel, (float)(1.0 / kRateHz));
+            float g[3];
+            filter.Gravity(g);
+            tilt = std::acos(std::min(1.0, (g[0] * a[0] + g[1] * a[1] + g[2] * a[2]) / (kGravity * kGravity))) * 180.0 / kPi;
+        }
+        CHECK(tilt < 0.5);
+    }
+}
+
+// No accel sample: pure gyro integration, and no initialization from gyro alone
+void TestGyroOnly() {
+    OrientationFilter filter;
+    filter.Configure(OrientationFilter::Madgwick, 0.0f, 0.0f);
+    const float gyro[3] = {0.0f, 0.0f, 1.0f};
+    filter.Update(gyro, nullptr, 0.01f);
+    CHECK(!filter.Initialized());
+
+    const float up[3] = {0.0f, 0.0f, 9.8f};
+    filter.InitFromAccel(up);
+    for (int i = 0; i < 1000; i++) filter.Update(gyro, nullptr, 0.001f);  // 1 rad about z
+    float q[4];
+    filter.Quaternion(q);
+    CHECK_NEAR(q[2], std::sin(0.5), 1e-4);
+    CHECK_NEAR(q[3], std::cos(0.5), 1e-4);
+}
+
+}  // namespace
+
+int main() {
+    TestNoiseFree();
+    TestNoisy();
+    TestGyroBias();
+    TestConvergence();
+    TestGyroOnly();
+    printf("test_imufilter: ok\n");
+    return 0;
+}
@@ -0,0 +1,255 @@
+// Preintegration tests (mlimupreint.h, via MLIMUPreintUnity_IntegrateSamples):
+// synthetic gyro/accel streams sampled from smooth signals are compared with
+// a dense double-precision reference integration of the same signals, and
+// the bias Jacobians are checked against re-integration with perturbed
+// biases.
+
+#include "mlimupreint.h"
+#include "testing.h"
+
+#include <cstring>
+
+// The live-history path pulls from the IMU module; not exercised here
+extern "C" {
+bool MLIMUUnity_IsInitialized() { return false; }
+void MLIMUUnity_EnableSecondaryStreams(bool) {}
+bool MLIMUUnity_GetSecondaryAccel(IMUVectorSample*, int32_t, int32_t* out_count) { *out_count = 0; return false; }
+bool MLIMUUnity_GetSecondaryGyro(IMUVectorSample*, int32_t, int32_t* out_count) { *out_count = 0; return false; }
+}
+
+namespace {
+
+// Body rates (rad/s) and specific force (m/s²) as smooth functions of time (s)
+void Gyro(double t, double* w) {
+    w[0] = 0.6 * std::sin(2.0 * t) + 0.1;
+    w[1] = 0.4 * std::cos(3.0 * t);
+    w[2] = 0.9 * std::sin(1.3 * t + 0.5) - 0.2;
+}
+
+void Accel(double t, double* a) {
+    a[0] = 1.2 * std::sin(1.7 * t);
+    a[1] = 0.5 * std::cos(2.3 * t) + 0.3;
+    a[2] = 9.81 + 0.4 * std::sin(3.1 * t);
+}
+
+std::vector<IMUVectorSample> Sample(void (*signal)(double, double*), double rateHz, double offsetS, double durationS) {
+    std::vector<IMUVectorSample> samples;
+    for (double t = offsetS; t <= durationS; t += 1.0 / rateHz) {
+        double v[3];
+        signal(t, v);
+        IMUVectorSample s = {};
+        s.timestamp_ns = (int64_t)std::llround(t * 1e9);
+        s.x = (float)v[0];
+        s.y = (float)v[1];
+        s.z = (float)v[2];
+        samples.push_back(s);
+    }
+    return samples;
+}
+
+// ---- 3x3 helpers (row-major) ----
+
+void MatMul(const double* a, const double* b, double* out) {
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            out[r * 3 + c] = a[r * 3] * b[c] + a[r * 3 + 1] * b[3 + c] + a[r * 3 + 2] * b[6 + c];
+        }
+    }
+}
+
+void Exp(const double* phi, double* R) {
+    const double theta = std::sqrt(phi[0] * phi[0] + phi[1] * phi[1] + phi[2] * phi[2]);
+    const double K[9] = {0, -phi[2], phi[1], phi[2], 0, -phi[0], -phi[1], phi[0], 0};
+    double K2[9];
+    MatMul(K, K, K2);
+    const double a = theta < 1e-8 ? 1.0 : std::sin(theta) / theta;
+    const double b = theta < 1e-8 ? 0.5 : (1.0 - std::cos(theta)) / (theta * theta);
+    for (int i = 0; i < 9; i++) R[i] = (i % 4 == 0 ? 1.0 : 0.0) + a * K[i] + b * K2[i];
+}
+
+void QuatToMatrix(const float* q, double* R) {
+    const double x = q[0], y = q[1], z = q[2], w = q[3];
+    R[0] = 1 - 2 * (y * y + z * z); R[1] = 2 * (x * y - z * w);     R[2] = 2 * (x * z + y * w);
+    R[3] = 2 * (x * y + z * w);     R[4] = 1 - 2 * (x * x + z * z); R[5] = 2 * (y * z - x * w);
+    R[6] = 2 * (x * z - y * w);     R[7] = 2 * (y * z + x * w);     R[8] = 1 - 2 * (x * x + y * y);
+}
+
+// Angle of a^T b (atan2 form, accurate for small angles)
+double AngleBetween(const double* a, const double* b) {
+    double m[9];
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) m[r * 3 + c] = a[r] * b[c] + a[3 + r] * b[3 + c] + a[6 + r] * b[6 + c];
+    }
+    const double sx = m[7] - m[5], sy = m[2] - m[6], sz = m[3] - m[1];
+    const double sinTheta = 0.5 * std::sqrt(sx * sx + sy * sy + sz * sz);
+    return std::atan2(sinTheta, 0.5 * (m[0] + m[4] + m[8] - 1.0));
+}
+
+double Distance3(const float* a, const double* b) {
+    const double d[3] = {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+    return std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+}
+
+// Dense reference of the same quantities, integrating the continuous signals
+// with 10 µs midpoint steps
+void Reference(double t0, double t1, const double* bg, const double* ba, double* dR, double* dv, double* dp) {
+    for (int i = 0; i < 9; i++) dR[i] = i % 4 == 0 ? 1.0 : 0.0;
+    for (int i = 0; i < 3; i++) dv[i] = dp[i] = 0.0;
+    const int steps = (int)std::ceil((t1 - t0) / 1e-5);
+    const double h = (t1 - t0) / steps;
+    for (int k = 0; k < steps; k++) {
+        const double tm = t0 + (k + 0.5) * h;
+        double w[3], a[3];
+        Gyro(tm, w);
+        Accel(tm, a);
+        double half[3], full[3];
+        for (int i = 0; i < 3; i++) {
+            half[i] = 0.5 * (w[i] - bg[i]) * h;
+            full[i] = (w[i] - bg[i]) * h;
+            a[i] -= ba[i];
+        }
+        double Rh[9], Rmid[9], Rs[9], Rn[9];
+        Exp(half, Rh);
+        MatMul(dR, Rh, Rmid);
+        double ra[3];
+        for (int i = 0; i < 3; i++) ra[i] = Rmid[i * 3] * a[0] + Rmid[i * 3 + 1] * a[1] + Rmid[i * 3 + 2] * a[2];
+        for (int i = 0; i < 3; i++) {
+            dp[i] += dv[i] * h + 0.5 * ra[i] * h * h;
+            dv[i] += ra[i] * h;
+        }
+        Exp(full, Rs);
+        MatMul(dR, Rs, Rn);
+        memcpy(dR, Rn, sizeof(Rn));
+    }
+}
+
+struct Streams {
+    std::vector<IMUVectorSample> accel, gyro;
+};
+
+// Gyro at 1 kHz and accel at 800 Hz on unrelated clocks, like the ML2 IMU
+Streams MakeStreams() {
+    Streams s;
+    s.gyro = Sample(Gyro, 1000.0, 0.0003, 1.0);
+    s.accel = Sample(Accel, 800.0, 0.0008, 1.0);
+    return s;
+}
+
+bool Integrate(const Streams& s, int64_t t0, int64_t t1, const float* bg, const float* ba, IMUPreintegration* out) {
+    return MLIMUPreintUnity_IntegrateSamples(s.accel.data(), (int32_t)s.accel.size(), s.gyro.data(),
+                                             (int32_t)s.gyro.size(), t0, t1, bg, ba, nullptr, out);
+}
+
+void TestAgainstReference() {
+    const Streams s = MakeStreams();
+    const float bg[3] = {0.02f, -0.01f, 0.015f};
+    const float ba[3] = {0.1f, -0.05f, 0.2f};
+    const double bgd[3] = {bg[0], bg[1], bg[2]}, bad[3] = {ba[0], ba[1], ba[2]};
+
+    // Interval ends between samples, as with camera timestamps
+    for (double length : {0.0333, 0.1, 0.5}) {
+        const double t0 = 0.01234;
+        const double t1 = t0 + length;
+        IMUPreintegration p;
+        CHECK(Integrate(s, (int64_t)std::llround(t0 * 1e9), (int64_t)std::llround(t1 * 1e9), bg, ba, &p));
+
+        double dR[9], dv[3], dp[3], R[9];
+        Reference(t0, t1, bgd, bad, dR, dv, dp);
+        QuatToMatrix(p.delta_rotation, R);
+        // Linear interpolation of 1 kHz samples of these signals: errors well
+        // below sensor noise, limited by float output over longer intervals
+        CHECK(AngleBetween(R, dR) < 1e-6);
+        CHECK(Distance3(p.delta_velocity, dv) < 5e-6 * length / 0.1);
+        CHECK(Distance3(p.delta_position, dp) < 1e-6 * length / 0.1);
+
+        CHECK(p.gyro_sample_count == (int32_t)std::floor(t1 * 1000.0 - 0.3) - (int32_t)std::ceil(t0 * 1000.0 - 0.3) + 1);
+        CHECK(p.accel_sample_count > 0);
+        for (int i = 0; i < 3; i++) CHECK(p.gyro_bias[i] == bg[i] && p.accel_bias[i] == ba[i]);
+
+        // Covariance: symmetric with a positive diagonal
+        for (int r = 0; r < 9; r++) {
+            CHECK(p.covariance[r * 9 + r] > 0.0f);
+            for (int c = 0; c < r; c++) CHECK_NEAR(p.covariance[r * 9 + c], p.covariance[c * 9 + r], 1e-12);
+        }
+    }
+}
+
+// Re-integrating with bias + delta must match the first-order correction
+// up to second-order terms
+void TestBiasJacobians() {
+    const Streams s = MakeStreams();
+    const int64_t t0 = 20000000, t1 = 320000000;  // 0.3 s
+    const float zero[3] = {0, 0, 0};
+    IMUPreintegration base;
+    CHECK(Integrate(s, t0, t1, zero, zero, &base));
+    double R0[9];
+    QuatToMatrix(base.delta_rotation, R0);
+
+    for (int axis = 0; axis < 3; axis++) {
+        // Gyro bias
+        float bg[3] = {0, 0, 0};
+        bg[axis] = 0.01f;
+        IMUPreintegration p;
+        CHECK(Integrate(s, t0, t1, bg, zero, &p));
+
+        double phi[3], corr[9], Rpred[9], R1[9];
+        for (int i = 0; i < 3; i++) {
+            phi[i] = base.d_rotation_d_gyro_bias[i * 3 + axis] * bg[axis];
+        }
+        Exp(phi, corr);
+        MatMul(R0, corr, Rpred);
+        QuatToMatrix(p.delta_rotation, R1);
+        const double rotChange = AngleBetween(R0, R1);
+        CHECK(rotChange > 1e-3);
+        CHECK(AngleBetween(Rpred, R1) < 1e-3 * rotChange);
+
+        double vPred[3], pPred[3], vChange = 0.0, pChange = 0.0;
+        for (int i = 0; i < 3; i++) {
+            vPred[i] = base.delta_velocity[i] + base.d_velocity_d_gyro_bias[i * 3 + axis] * bg[axis];
+            pPred[i] = base.delta_position[i] + base.d_position_d_gyro_bias[i * 3 + axis] * bg[axis];
+            vChange += std::pow(p.delta_velocity[i] - base.delta_velocity[i], 2.0);
+            pChange += std::pow(p.delta_position[i] - base.delta_position[i], 2.0);
+        }
+        CHECK(std::sqrt(vChange) > 1e-4 && std::sqrt(pChange) > 1e-5);
+        CHECK(Distance3(p.delta_velocity, vPred) < 0.01 * std::sqrt(vChange));
+        CHECK(Distance3(p.delta_position, pPred) < 0.01 * std::sqrt(pChange));
+
+        // Accel bias: dv and dp are linear in it, rotation doesn't depend on it
+        float ba[3] = {0, 0, 0};
+        ba[axis] = 0.05f;
+        CHECK(Integrate(s, t0, t1, zero, ba, &p));
+        QuatToMatrix(p.delta_rotation, R1);
+        CHECK(AngleBetween(R0, R1) < 1e-6);
+        for (int i = 0; i < 3; i++) {
+            vPred[i] = base.delta_velocity[i] + base.d_velocity_d_accel_bias[i * 3 + axis] * ba[axis];
+            pPred[i] = base.delta_position[i] + base.d_position_d_accel_bias[i * 3 + axis] * ba[axis];
+        }
+        CHECK(Distance3(p.delta_velocity, vPred) < 1e-5);
+        CHECK(Distance3(p.delta_position, pPred) < 1e-6);
+    }
+}
+
+void TestCovarianceGrowsAndRejects() {
+    const Streams s = MakeStreams();
+    IMUPreintegration shortRun, longRun;
+    CHECK(Integrate(s, 10000000, 60000000, nullptr, nullptr, &shortRun));
+    CHECK(Integrate(s, 10000000, 510000000, nullptr, nullptr, &longRun));
+    for (int i = 0; i < 9; i++) CHECK(longRun.covariance[i * 10] > shortRun.covariance[i * 10]);
+
+    IMUPreintegration p;
+    CHECK(!Integrate(s, 60000000, 60000000, nullptr, nullptr, &p));   // empty interval
+    CHECK(!Integrate(s, 100, 60000000, nullptr, nullptr, &p));        // before the first samples
+    CHECK(!Integrate(s, 60000000, 2000000000, nullptr, nullptr, &p)); // past the last samples
+    CHECK(!MLIMUPreintUnity_IntegrateSamples(nullptr, 0, s.gyro.data(), (int32_t)s.gyro.size(), 0, 1, nullptr,
+                                             nullptr, nullptr, &p));
+}
+
+}  // namespace
+
+int main() {
+    TestAgainstReference();
+    TestBiasJacobians();
+    TestCovarianceGrowsAndRejects();
+    printf("test_imupreint: ok\n");
+    return 0;
+}
@@ -0,0 +1,245 @@
+// Tests for the sensor direct channel parser (mlsensordirect.h) against a
+// synthetic shared-memory ring written the way the sensor service does:
+// payload first, then the counter with release ordering. Covers buffer
+// wrap, counter wrap (0 is skipped), the writer lapping the reader, and a
+// concurrent writer thread.
+
+#include "mlsensordirect.h"
+#include "testing.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+const int32_t kToken = 7;
+const int32_t kTypeAccel = 1;
+
+uint32_t NextCounter(uint32_t counter) {
+    return counter + 1 == 0 ? 1 : counter + 1;
+}
+
+// Writes reports the way the sensor service does; `sequence` (stored as the
+// timestamp) lets the reader check order and contents
+struct Writer {
+    std::vector<uint8_t> memory;
+    size_t slots;
+    size_t next = 0;
+    uint32_t counter = 1;
+    uint64_t written = 0;
+
+    explicit Writer(size_t slotCount)
+        : memory(slotCount * SENSOR_DIRECT_REPORT_SIZE + 40, 0), slots(slotCount) {}
+
+    void Write(uint64_t sequence) {
+        uint8_t* report = memory.data() + next * SENSOR_DIRECT_REPORT_SIZE;
+        const int32_t size = (int32_t)SENSOR_DIRECT_REPORT_SIZE;
+        const int64_t timestamp = (int64_t)sequence;
+        float data[16] = {};
+        for (int i = 0; i < 3; i++) data[i] = (float)(sequence % 100000) + (float)i * 0.5f;
+        memcpy(report + 0x00, &size, 4);
+        memcpy(report + 0x04, &kToken, 4);
+        memcpy(report + 0x08, &kTypeAccel, 4);
+        memcpy(report + 0x10, &timestamp, 8);
+        memcpy(report + 0x18, data, sizeof(data));
+        __atomic_store_n((uint32_t*)(report + 0x0C), counter, __ATOMIC_RELEASE);
+
+        next = (next + 1) % slots;
+        counter = NextCounter(counter);
+        written++;
+    }
+};
+
+void CheckEvent(const SensorDirectEvent& e, uint64_t sequence) {
+    CHECK(e.token == kToken && e.type == kTypeAccel);
+    CHECK(e.timestamp == (int64_t)sequence);
+    for (int i = 0; i < 3; i++) CHECK(e.data[i] == (float)(sequence % 100000) + (float)i * 0.5f);
+}
+
+void TestEmptyAndDetached() {
+    Writer w(8);
+    SensorDirectReader reader;
+    SensorDirectEvent out[4];
+    CHECK(reader.Read(out, 4) == 0);  // not attached
+
+    reader.Attach(w.memory.data(), w.memory.size());
+    CHECK(reader.Read(out, 4) == 0);  // nothing written
+    w.Write(0);
+    CHECK(reader.Read(out, 0) == 0);
+    CHECK(reader.Read(out, 4) == 1);
+    CheckEvent(out[0], 0);
+    CHECK(reader.Read(out, 4) == 0);
+
+    reader.Detach();
+    w.Write(1);
+    CHECK(reader.Read(out, 4) == 0);
+}
+
+// Reader keeps up across many buffer wraps, in varying chunk sizes
+void TestBufferWrap() {
+    Writer w(8);
+    SensorDirectReader reader;
+    reader.Attach(w.memory.data(), w.memory.size());  // trailing partial report ignored
+
+    TestRandom rng(5);
+    SensorDirectEvent out[8];
+    uint64_t sequence = 0, expected = 0;
+    for (int round = 0; round < 200; round++) {
+        const size_t burst = 1 + rng.Next() % 8;
+        for (size_t i = 0; i < burst; i++) w.Write(sequence++);
+        while (expected < sequence) {
+            const size_t n = reader.Read(out, 1 + rng.Next() % 8);
+            CHECK(n > 0);
+            for (size_t i = 0; i < n; i++) CheckEvent(out[i], expected++);
+        }
+    }
+    CHECK(reader.Lost() == 0);
+}
+
+// The writer gets a full lap (plus extra) ahead: the reader resumes from the
+// newest reports and accounts for every other one as lost
+void TestLapping() {
+    for (size_t extra : {0, 1, 3, 7}) {
+        Writer w(8);
+        SensorDirectReader reader;
+        reader.Attach(w.memory.data(), w.memory.size());
+        SensorDirectEvent out[16];
+
+        uint64_t sequence = 0, received = 0;
+        for (int i = 0; i < 5; i++) w.Write(sequence++);
+        CHECK(reader.Read(out, 2) == 2);  // reader is mid-buffer
+        received += 2;
+
+        for (size_t i = 0; i < 8 + extra; i++) w.Write(sequence++);
+        uint64_t last = 1;
+        for (size_t n; (n = reader.Read(out, 16)) > 0;) {
+            for (size_t i = 0; i < n; i++) {
+                CHECK(out[i].timestamp > (int64_t)last);
+                CheckEvent(out[i], (uint64_t)out[i].timestamp);
+                last = (uint64_t)out[i].timestamp;
+            }
+            received += n;
+        }
+        CHECK(last == sequence - 1);  // ends on the newest report
+        CHECK(reader.Lost() > 0);
+        CHECK(received + reader.Lost() == w.written);
+
+        // And keeps up normally afterwards
+        w.Write(sequence++);
+        CHECK(reader.Read(out, 16) == 1);
+        CheckEvent(out[0], sequence - 1);
+    }
+}
+
+// Counters run 1..0xFFFFFFFF then restart at 1. The writer's counter is
+// jumped forward to reach the wrap (each jump is a legal "lapped" gap of
+// less than 2^31 that the reader counts as lost), then reads are checked in
+// order and with the writer lapping the reader across the wrap.
+void TestCounterWrap() {
+    Writer w(8);
+    SensorDirectReader reader;
+    reader.Attach(w.memory.data(), w.memory.size());
+    SensorDirectEvent out[16];
+    uint64_t sequence = 0, received = 0, skipped = 0;
+
+    // A real writer's slots are never more than one lap apart, so a jump
+    // refills the whole buffer from the new counter
+    auto jumpTo = [&](uint32_t target) {
+        skipped += target - w.counter;
+        w.written += target - w.counter;
+        w.counter = target;
+        const uint64_t first = sequence;
+        for (size_t i = 0; i < w.slots; i++) w.Write(sequence++);
+        CHECK(reader.Read(out, 16) == w.slots);
+        for (size_t i = 0; i < w.slots; i++) CheckEvent(out[i], first + i);
+        received += w.slots;
+        CHECK(reader.Lost() == skipped);
+    };
+
+    w.Write(sequence++);
+    CHECK(reader.Read(out, 16) == 1);
+    received++;
+
+    // In order across the wrap (0xFFFFFFF8 .. 0xFFFFFFFF, 1 .. 32)
+    jumpTo(0x70000000u);
+    jumpTo(0xE0000000u);
+    jumpTo(0xFFFFFFF0u);
+    uint64_t expected = sequence;
+    for (int i = 0; i < 40; i++) {
+        w.Write(sequence++);
+        if (i % 3 == 2) {
+            const size_t n = reader.Read(out, 16);
+            for (size_t k = 0; k < n; k++) CheckEvent(out[k], expected++);
+            received += n;
+        }
+    }
+    const size_t n = reader.Read(out, 16);
+    for (size_t k = 0; k < n; k++) CheckEvent(out[k], expected++);
+    received += n;
+    CHECK(expected == sequence);
+    CHECK(w.counter == 33);
+    CHECK(reader.Lost() == skipped);
+    CHECK(received + reader.Lost() == w.written);
+
+    // Lapped across the wrap: 0xFFFFFFF8 .. 0xFFFFFFFF, 1 .. 3 over 8 slots
+    jumpTo(0x60000000u);
+    jumpTo(0xC0000000u);
+    jumpTo(0xFFFFFFF0u);
+    for (int i = 0; i < 11; i++) w.Write(sequence++);
+    int64_t last = -1;
+    for (size_t got; (got = reader.Read(out, 16)) > 0;) {
+        for (size_t k = 0; k < got; k++) {
+            CHECK(out[k].timestamp > last);
+            CheckEvent(out[k], (uint64_t)out[k].timestamp);
+            last = out[k].timestamp;
+        }
+        received += got;
+    }
+    CHECK(last == (int64_t)sequence - 1);
+    CHECK(reader.Lost() > skipped);
+    CHECK(received + reader.Lost() == w.written);
+}
+
+// A writer thread streams reports while the reader drains. The writer never
+// gets more than one lap minus one ahead (the protocol has no way to detect
+// a payload rewritten under the reader before its counter changes), so
+// every report must arrive, in order and intact.
+void TestConcurrentWriter() {
+    const uint64_t total = 300000;
+    Writer w(64);
+    SensorDirectReader reader;
+    reader.Attach(w.memory.data(), w.memory.size());
+    std::atomic<uint64_t> consumed{0};
+
+    std::thread writer([&] {
+        for (uint64_t s = 0; s < total; s++) {
+            while (s - consumed.load(std::memory_order_acquire) >= w.slots - 1) std::this_thread::yield();
+            w.Write(s);
+        }
+    });
+
+    SensorDirectEvent out[16];
+    uint64_t expected = 0;
+    while (expected < total) {
+        const size_t n = reader.Read(out, 16);
+        for (size_t i = 0; i < n; i++) CheckEvent(out[i], expected++);
+        consumed.store(expected, std::memory_order_release);
+        if (n == 0) std::this_thread::yield();
+    }
+    writer.join();
+    CHECK(reader.Lost() == 0);
+    CHECK(reader.Read(out, 16) == 0);
+}
+
+}  // namespace
+
+int main() {
+    TestEmptyAndDetached();
+    TestBufferWrap();
+    TestLapping();
+    TestCounterWrap();
+    TestConcurrentWriter();
+    printf("test_sensordirect: ok\n");
+    return 0;
+}
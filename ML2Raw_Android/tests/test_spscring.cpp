@@ -0,0 +1,257 @@
+// Stress tests for mlspscring.h: one producer and one consumer thread move
+// millions of samples through small rings in random batch sizes, and the
+// consumer checks that every accepted sample arrives once, in order, intact.
+// Also build with -fsanitize=thread (see CMakeLists.txt) to check the
+// memory ordering.
+
+#include "mlspscring.h"
+#include "testing.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+struct Sample {
+    uint64_t sequence;
+    int64_t timestampNs;
+    float values[6];
+    uint32_t check;
+};
+
+Sample MakeSample(uint64_t sequence) {
+    Sample s;
+    s.sequence = sequence;
+    s.timestampNs = (int64_t)(sequence * 1000);
+    for (int i = 0; i < 6; i++) s.values[i] = (float)(sequence % 4096) + (float)i * 0.25f;
+    s.check = (uint32_t)(sequence * 2654435761u) ^ 0xA5A5A5A5u;
+    return s;
+}
+
+void CheckSample(const Sample& s, uint64_t expected) {
+    CHECK(s.sequence == expected);
+    const Sample ref = MakeSample(expected);
+    CHECK(s.timestampNs == ref.timestampNs && s.check == ref.check);
+    for (int i = 0; i < 6; i++) CHECK(s.values[i] == ref.values[i]);
+}
+
+// Producer pushes batches of 1..maxBatch, retrying what didn't fit, so
+// nothing is lost; the consumer pops random amounts and verifies order
+void StressRing(uint64_t total, size_t maxBatch) {
+    static SpscRing<Sample, 64> ring;
+    ring.Reset();
+
+    std::thread producer([&] {
+        TestRandom rng(1);
+        std::vector<Sample> batch(maxBatch);
+        uint64_t next = 0;
+        while (next < total) {
+            const size_t want = std::min<uint64_t>(1 + rng.Next() % maxBatch, total - next);
+            for (size_t i = 0; i < want; i++) batch[i] = MakeSample(next + i);
+            const size_t n = ring.Push(batch.data(), want);
+            next += n;
+            if (n < want || rng.Next() % 64 == 0) std::this_thread::yield();
+        }
+    });
+
+    TestRandom rng(2);
+    std::vector<Sample> out(maxBatch * 2);
+    uint64_t expected = 0;
+    while (expected < total) {
+        const size_t n = ring.Pop(out.data(), 1 + rng.Next() % out.size());
+        for (size_t i = 0; i < n; i++) CheckSample(out[i], expected++);
+        if (n == 0) std::this_thread::yield();
+    }
+    producer.join();
+
+    CHECK(ring.Size() == 0);
+    CHECK(ring.Pop(out.data(), out.size()) == 0);
+}
+
+// Producer never retries: rejected samples are gone and counted, and what
+// arrives is still an ordered subsequence
+void StressRingDrops(uint64_t total) {
+    static SpscRing<Sample, 16> ring;
+    ring.Reset();
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> accepted{0};
+
+    std::thread producer([&] {
+        for (uint64_t s = 0; s < total; s++) {
+            if (ring.Push(MakeSample(s))) accepted.fetch_add(1, std::memory_order_relaxed);
+        }
+        done.store(true);
+    });
+
+    Sample out[8];
+    uint64_t received = 0;
+    uint64_t last = 0;
+    bool first = true;
+    for (;;) {
+        const bool finished = done.load();
+        const size_t n = ring.Pop(out, 8);
+        for (size_t i = 0; i < n; i++) {
+            CHECK(first || out[i].sequence > last);
+            CheckSample(out[i], out[i].sequence);
+            last = out[i].sequence;
+            first = false;
+        }
+        received += n;
+        if (n == 0 && finished) break;
+    }
+    producer.join();
+
+    CHECK(received == accepted.load());
+    CHECK(received + ring.Dropped() == total);
+}
+
+void StressColumnRing(uint64_t total) {
+    static SpscColumnRing<32, int64_t, float, uint32_t> ring;
+    ring.Reset();
+
+    std::thread producer([&] {
+        TestRandom rng(3);
+        uint64_t next = 0;
+        while (next < total) {
+            const size_t n = ring.Reserve(std::min<uint64_t>(1 + rng.Next() % 12, total - next));
+            for (size_t i = 0; i < n; i++) {
+                const uint64_t s = next + i;
+                ring.Set(i, (int64_t)s, (float)(s % 100000), (uint32_t)(s * 2654435761u));
+            }
+            ring.Commit(n);
+            next += n;
+            if (n == 0) std::this_thread::yield();
+        }
+    });
+
+    TestRandom rng(4);
+    int64_t ts[24];
+    float value[24];
+    uint32_t check[24];
+    uint64_t expected = 0;
+    while (expected < total) {
+        const size_t max = 1 + rng.Next() % 24;
+        // Every few pops skip a column, which must still consume the rows
+        const bool skipValue = rng.Next() % 8 == 0;
+        const size_t n = ring.Pop(max, ts, skipValue ? nullptr : value, check);
+        for (size_t i = 0; i < n; i++, expected++) {
+            CHECK(ts[i] == (int64_t)expected);
+            CHECK(skipValue || value[i] == (float)(expected % 100000));
+            CHECK(check[i] == (uint32_t)(expected * 2654435761u));
+        }
+        if (n == 0) std::this_thread::yield();
+    }
+    producer.join();
+    CHECK(ring.Size() == 0);
+}
+
+// Single-threaded Reserve/Set/Commit around the end of the column arrays:
+// rows must come back in order across the wrap, in one Pop or split over
+// several, short reservations must count drops, and rows reserved but not
+// committed must stay invisible
+void ColumnRingWraparound() {
+    SpscColumnRing<8, int64_t, float> ring;
+    int64_t ts[8];
+    float value[8];
+    int64_t next = 0, expected = 0;
+
+    auto push = [&](size_t count) {
+        const size_t n = ring.Reserve(count);
+        for (size_t i = 0; i < n; i++, next++) ring.Set(i, next, (float)next * 0.5f);
+        ring.Commit(n);
+        return n;
+    };
+    auto pop = [&](size_t max) {
+        const size_t n = ring.Pop(max, ts, value);
+        for (size_t i = 0; i < n; i++, expected++) {
+            CHECK(ts[i] == expected);
+            CHECK(value[i] == (float)expected * 0.5f);
+        }
+        return n;
+    };
+
+    // Move head and tail to slot 5
+    CHECK(push(5) == 5);
+    CHECK(pop(8) == 5);
+
+    // Rows land in slots 5, 6, 7, 0, 1, 2; one Pop reads across the end
+    CHECK(push(6) == 6);
+    CHECK(ring.Size() == 6);
+    CHECK(pop(5) == 5);
+    CHECK(pop(8) == 1);
+
+    // Full ring starting mid-array (slot 3): everything fits, nothing more
+    CHECK(push(8) == 8);
+    CHECK(ring.Size() == 8);
+    CHECK(ring.Dropped() == 0);
+    CHECK(push(3) == 0);
+    CHECK(ring.Dropped() == 3);
+
+    // Short reservation after a partial drain: only the free rows fit
+    CHECK(pop(3) == 3);
+    CHECK(push(5) == 3);
+    CHECK(ring.Dropped() == 5);
+
+    // Reserved and written, committed in part: the rest stays unpublished
+    // and is overwritten by the next reservation
+    CHECK(pop(8) == 8);
+    const size_t reserved = ring.Reserve(6);
+    CHECK(reserved == 6);
+    for (size_t i = 0; i < reserved; i++) ring.Set(i, next + (int64_t)i, (float)(next + (int64_t)i) * 0.5f);
+    ring.Commit(2);
+    next += 2;
+    CHECK(ring.Size() == 2);
+    for (size_t i = 0; i < 4; i++) ring.Set(i, -1, -1.0f);  // the uncommitted rows, now reused
+    CHECK(pop(8) == 2);
+    CHECK(push(7) == 7);
+    CHECK(pop(8) == 7);
+    CHECK(ring.Size() == 0);
+
+    // Many laps with odd batch sizes so every start slot and split occurs
+    for (int lap = 0; lap < 64; lap++) {
+        push(1 + lap % 7);
+        pop(1 + lap % 5);
+    }
+    while (pop(8) > 0) {}
+    CHECK(expected == next);
+}
+
+// Readers must never see a torn mix of two stores
+void StressLatestValue(uint64_t stores) {
+    static LatestValue<Sample> latest;
+    latest.Store(MakeSample(0));
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        for (uint64_t s = 1; s <= stores; s++) latest.Store(MakeSample(s));
+        done.store(true);
+    });
+
+    uint64_t last = 0, reads = 0;
+    while (!done.load() || reads == 0) {
+        const Sample s = latest.Load();
+        CheckSample(s, s.sequence);
+        CHECK(s.sequence >= last);  // single writer: never goes back
+        last = s.sequence;
+        reads++;
+    }
+    writer.join();
+    CHECK(latest.Load().sequence == stores);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    // Optional sample-count scale, e.g. 0.1 for a quick TSan run
+    const double scale = argc > 1 ? atof(argv[1]) : 1.0;
+    const uint64_t total = (uint64_t)(1000000 * scale);
+
+    StressRing(total, 1);
+    StressRing(total, 48);     // batches that wrap the 64-entry ring
+    StressRingDrops(total);
+    ColumnRingWraparound();
+    StressColumnRing(total);
+    StressLatestValue(total / 4);
+    printf("test_spscring: ok\n");
+    return 0;
+}
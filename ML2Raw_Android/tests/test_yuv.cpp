@@ -0,0 +1,260 @@
+// YUV 4:2:0 conversion tests (mlyuv.h): the dispatched row kernels must match
+// their scalar references bit for bit at every width and alignment, and the
+// whole-image paths must match a per-pixel reference over planar, NV12, NV21
+// and pixel-stride-3 chroma at odd sizes and padded strides. The scalar
+// fixed-point math is checked against BT.601 in floating point.
+
+#include "mlyuv.h"
+#include "testing.h"
+#include "yuv_frame.h"
+
+#include <cstring>
+
+namespace {
+
+const RgbLayout kLayouts[] = {RgbLayout_RGBA, RgbLayout_RGB, RgbLayout_BGRA};
+const YuvRange kRanges[] = {YuvRange_Full, YuvRange_Limited};
+const TestChroma kChromas[] = {TestChroma_Planar, TestChroma_NV12, TestChroma_NV21, TestChroma_Stride3};
+
+const uint8_t kGuard = 0xA5;
+
+// Output buffer with guard bytes after size, checked by GuardIntact
+std::vector<uint8_t> Guarded(size_t size) {
+    std::vector<uint8_t> out(size + 32, kGuard);
+    return out;
+}
+
+bool GuardIntact(const std::vector<uint8_t>& out, size_t size) {
+    for (size_t i = size; i < out.size(); i++) {
+        if (out[i] != kGuard) return false;
+    }
+    return true;
+}
+
+std::vector<uint8_t> RandomBytes(size_t size, TestRandom& rng) {
+    std::vector<uint8_t> bytes(size);
+    for (uint8_t& b : bytes) b = (uint8_t)rng.Next();
+    return bytes;
+}
+
+// Source rows are copied to exact-size buffers at every start offset within a
+// 16-byte block, so unaligned loads and overreads both show up
+void TestRowKernels() {
+    TestRandom rng(1);
+    for (int32_t width = 1; width <= 80; width++) {
+        for (int32_t offset = 0; offset < 16; offset += 5) {
+            const std::vector<uint8_t> yPad = RandomBytes((size_t)(offset + width), rng);
+            const uint8_t* y = yPad.data() + offset;
+
+            for (bool chromaHalf : {true, false}) {
+                const size_t chromaCount = chromaHalf ? (size_t)(width + 1) / 2 : (size_t)width;
+                const std::vector<uint8_t> uPad = RandomBytes(offset + chromaCount, rng);
+                const std::vector<uint8_t> vPad = RandomBytes(offset + chromaCount, rng);
+                for (YuvRange range : kRanges) {
+                    const YuvCoeffs c = YuvCoefficients(range);
+                    for (RgbLayout layout : kLayouts) {
+                        const size_t size = (size_t)width * RgbBytesPerPixel(layout);
+                        std::vector<uint8_t> ref = Guarded(size), out = Guarded(size);
+                        YuvToRgbRowScalar(y, uPad.data() + offset, vPad.data() + offset, width, chromaHalf, c, layout, ref.data());
+                        YuvToRgbRow(y, uPad.data() + offset, vPad.data() + offset, width, chromaHalf, c, layout, out.data());
+                        CHECK(GuardIntact(out, size));
+                        CHECK(memcmp(ref.data(), out.data(), size) == 0);
+                    }
+                }
+            }
+
+            // Halving reads 2 * width samples of each row
+            const std::vector<uint8_t> row0 = RandomBytes((size_t)(offset + 2 * width), rng);
+            const std::vector<uint8_t> row1 = RandomBytes((size_t)(offset + 2 * width), rng);
+            std::vector<uint8_t> ref = Guarded(width), out = Guarded(width);
+            YuvHalveRowScalar(row0.data() + offset, row1.data() + offset, width, ref.data());
+            YuvHalveRow(row0.data() + offset, row1.data() + offset, width, out.data());
+            CHECK(GuardIntact(out, width));
+            CHECK(memcmp(ref.data(), out.data(), width) == 0);
+
+            // Gathering ends exactly at the last sample
+            for (int32_t pixelStride = 1; pixelStride <= 4; pixelStride++) {
+                const std::vector<uint8_t> src = RandomBytes((size_t)offset + (size_t)(width - 1) * pixelStride + 1, rng);
+                ref = Guarded(width);
+                out = Guarded(width);
+                YuvGatherRowScalar(src.data() + offset, pixelStride, width, ref.data());
+                YuvGatherRow(src.data() + offset, pixelStride, width, out.data());
+                CHECK(GuardIntact(out, width));
+                CHECK(memcmp(ref.data(), out.data(), width) == 0);
+                for (int32_t x = 0; x < width; x++) CHECK(out[x] == src[offset + (size_t)x * pixelStride]);
+            }
+
+            const std::vector<uint8_t> u = RandomBytes((size_t)(offset + width), rng);
+            const std::vector<uint8_t> v = RandomBytes((size_t)(offset + width), rng);
+            ref = Guarded(2 * (size_t)width);
+            out = Guarded(2 * (size_t)width);
+            YuvInterleaveRowScalar(u.data() + offset, v.data() + offset, width, ref.data());
+            YuvInterleaveRow(u.data() + offset, v.data() + offset, width, out.data());
+            CHECK(GuardIntact(out, 2 * (size_t)width));
+            CHECK(memcmp(ref.data(), out.data(), 2 * (size_t)width) == 0);
+        }
+    }
+}
+
+uint8_t Halve(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    return (uint8_t)((a + b + c + d + 2) >> 2);
+}
+
+// Luma and chroma of one output pixel, straight from the definition of each
+// downscale (2x2 box average, applied twice for 4x)
+void ReferenceSample(const YuvImage& image, int32_t downscale, int32_t x, int32_t y, uint8_t* yOut, uint8_t* uOut, uint8_t* vOut) {
+    auto luma = [&](int32_t px, int32_t py) { return image.y[(size_t)py * image.yStride + px]; };
+    auto halvedLuma = [&](int32_t px, int32_t py) {
+        return Halve(luma(2 * px, 2 * py), luma(2 * px + 1, 2 * py), luma(2 * px, 2 * py + 1), luma(2 * px + 1, 2 * py + 1));
+    };
+    if (downscale == 1) {
+        *yOut = luma(x, y);
+        *uOut = ChromaAt(image, image.u, x / 2, y / 2);
+        *vOut = ChromaAt(image, image.v, x / 2, y / 2);
+    } else if (downscale == 2) {
+        *yOut = halvedLuma(x, y);
+        *uOut = ChromaAt(image, image.u, x, y);
+        *vOut = ChromaAt(image, image.v, x, y);
+    } else {
+        *yOut = Halve(halvedLuma(2 * x, 2 * y), halvedLuma(2 * x + 1, 2 * y), halvedLuma(2 * x, 2 * y + 1), halvedLuma(2 * x + 1, 2 * y + 1));
+        const uint8_t* planes[2] = {image.u, image.v};
+        uint8_t* outs[2] = {uOut, vOut};
+        for (int p = 0; p < 2; p++) {
+            *outs[p] = Halve(ChromaAt(image, planes[p], 2 * x, 2 * y), ChromaAt(image, planes[p], 2 * x + 1, 2 * y),
+                             ChromaAt(image, planes[p], 2 * x, 2 * y + 1), ChromaAt(image, planes[p], 2 * x + 1, 2 * y + 1));
+        }
+    }
+}
+
+void TestWholeImage() {
+    TestRandom rng(2);
+    const int32_t sizes[][2] = {{4, 4}, {5, 7}, {17, 9}, {33, 15}, {64, 48}, {101, 67}, {130, 34}};
+    for (const int32_t* size : sizes) {
+        for (TestChroma chroma : kChromas) {
+            for (int32_t rowPad : {0, 13}) {
+                const TestYuvFrame frame = MakeYuvFrame(size[0], size[1], rowPad, chroma, rng);
+                const YuvImage& image = frame.image;
+                for (int32_t downscale : {1, 2, 4}) {
+                    int32_t outWidth, outHeight;
+                    YuvOutputSize(image, downscale, &outWidth, &outHeight);
+                    CHECK(outWidth == size[0] / downscale && outHeight == size[1] / downscale);
+                    if (outWidth == 0 || outHeight == 0) {
+                        std::vector<uint8_t> out(16);
+                        CHECK(!YuvToRgb(image, YuvRange_Full, RgbLayout_RGBA, downscale, out.data()));
+                        continue;
+                    }
+
+                    for (YuvRange range : kRanges) {
+                        const YuvCoeffs c = YuvCoefficients(range);
+                        for (RgbLayout layout : kLayouts) {
+                            const int32_t bpp = RgbBytesPerPixel(layout);
+                            const size_t bytes = (size_t)outWidth * outHeight * bpp;
+                            std::vector<uint8_t> out = Guarded(bytes);
+                            CHECK(YuvToRgb(image, range, layout, downscale, out.data()));
+                            CHECK(GuardIntact(out, bytes));
+
+                            for (int32_t y = 0; y < outHeight; y++) {
+                                for (int32_t x = 0; x < outWidth; x++) {
+                                    uint8_t ys, us, vs, expected[4];
+                                    ReferenceSample(image, downscale, x, y, &ys, &us, &vs);
+                                    YuvToRgbRowScalar(&ys, &us, &vs, 1, false, c, layout, expected);
+                                    if (memcmp(expected, out.data() + ((size_t)y * outWidth + x) * bpp, bpp) != 0) {
+                                        fprintf(stderr, "%dx%d %s pad %d downscale %d range %d layout %d: pixel (%d, %d)\n",
+                                                size[0], size[1], TestChromaName(chroma), rowPad, downscale, range, layout, x, y);
+                                        CHECK(false);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<uint8_t> out(64);
+    TestYuvFrame frame = MakeYuvFrame(8, 8, 0, TestChroma_Planar, rng);
+    CHECK(!YuvToRgb(frame.image, YuvRange_Full, RgbLayout_RGBA, 3, out.data()));
+    frame.image.uvPixelStride = 0;
+    CHECK(!YuvToRgb(frame.image, YuvRange_Full, RgbLayout_RGBA, 1, out.data()));
+}
+
+void TestRepack() {
+    TestRandom rng(3);
+    const int32_t sizes[][2] = {{1, 1}, {3, 5}, {17, 9}, {64, 48}, {101, 67}};
+    for (const int32_t* size : sizes) {
+        const int32_t width = size[0], height = size[1];
+        const int32_t chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+        for (TestChroma chroma : kChromas) {
+            for (int32_t rowPad : {0, 7}) {
+                const TestYuvFrame frame = MakeYuvFrame(width, height, rowPad, chroma, rng);
+                const YuvImage& image = frame.image;
+                for (YuvPacking packing : {YuvPacking_I420, YuvPacking_NV12}) {
+                    const size_t bytes = YuvPackedSize(width, height);
+                    std::vector<uint8_t> out = Guarded(bytes);
+                    CHECK(YuvRepack(image, packing, out.data()));
+                    CHECK(GuardIntact(out, bytes));
+
+                    for (int32_t y = 0; y < height; y++) {
+                        CHECK(memcmp(out.data() + (size_t)y * width, image.y + (size_t)y * image.yStride, width) == 0);
+                    }
+                    const uint8_t* chromaOut = out.data() + (size_t)width * height;
+                    for (int32_t y = 0; y < chromaHeight; y++) {
+                        for (int32_t x = 0; x < chromaWidth; x++) {
+                            const uint8_t u = ChromaAt(image, image.u, x, y), v = ChromaAt(image, image.v, x, y);
+                            if (packing == YuvPacking_NV12) {
+                                CHECK(chromaOut[((size_t)y * chromaWidth + x) * 2] == u);
+                                CHECK(chromaOut[((size_t)y * chromaWidth + x) * 2 + 1] == v);
+                            } else {
+                                CHECK(chromaOut[(size_t)y * chromaWidth + x] == u);
+                                CHECK(chromaOut[(size_t)(chromaHeight + y) * chromaWidth + x] == v);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// BT.601 in floating point; the fixed-point path may differ by rounding
+void TestAgainstFloat() {
+    const YuvRange ranges[] = {YuvRange_Full, YuvRange_Limited};
+    for (YuvRange range : ranges) {
+        const YuvCoeffs c = YuvCoefficients(range);
+        int worst = 0;
+        for (int y = 0; y < 256; y += 3) {
+            for (int u = 0; u < 256; u += 5) {
+                for (int v = 0; v < 256; v += 5) {
+                    const uint8_t ys = (uint8_t)y, us = (uint8_t)u, vs = (uint8_t)v;
+                    uint8_t rgb[3];
+                    YuvToRgbRowScalar(&ys, &us, &vs, 1, false, c, RgbLayout_RGB, rgb);
+
+                    double yf = y, cGain = 1.0;
+                    if (range == YuvRange_Limited) {
+                        yf = (y > 16 ? y - 16 : 0) * 255.0 / 219.0;
+                        cGain = 255.0 / 224.0;
+                    }
+                    const double uf = (u - 128) * cGain, vf = (v - 128) * cGain;
+                    const double expected[3] = {yf + 1.402 * vf, yf - 0.344136 * uf - 0.714136 * vf, yf + 1.772 * uf};
+                    for (int ch = 0; ch < 3; ch++) {
+                        const int e = (int)std::lround(std::min(255.0, std::max(0.0, expected[ch])));
+                        worst = std::max(worst, std::abs(e - (int)rgb[ch]));
+                    }
+                }
+            }
+        }
+        CHECK(worst <= 2);
+    }
+}
+
+}  // namespace
+
+int main() {
+    TestRowKernels();
+    TestWholeImage();
+    TestRepack();
+    TestAgainstFloat();
+    printf("test_yuv: ok\n");
+    return 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+// Small helpers for the host tests and benchmarks (no test framework): a
+// failed CHECK prints the condition and exits non-zero.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#define CHECK(cond)                                                                   \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::exit(1);                                                             \
+        }                                                                             \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tolerance)                                                   \
+    do {                                                                              \
+        const double checkA_ = (double)(a), checkB_ = (double)(b);                    \
+        if (!(std::fabs(checkA_ - checkB_) <= (double)(tolerance))) {                 \
+            std::fprintf(stderr, "%s:%d: CHECK_NEAR failed: %s = %g, %s = %g (tolerance %g)\n", \
+                         __FILE__, __LINE__, #a, checkA_, #b, checkB_, (double)(tolerance)); \
+            std::exit(1);                                                             \
+        }                                                                             \
+    } while (0)
+
+inline int64_t TestNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// p in [0, 1]; sorts the samples
+inline double Percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) return 0.0;
+    std::sort(samples.begin(), samples.end());
+    const size_t index = (size_t)(p * (double)(samples.size() - 1) + 0.5);
+    return samples[std::min(index, samples.size() - 1)];
+}
+
+// Deterministic generator, so failures reproduce
+struct TestRandom {
+    uint64_t state;
+    explicit TestRandom(uint64_t seed) : state(seed * 2654435761u + 1) {}
+    uint32_t Next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return (uint32_t)(state >> 16);
+    }
+    float Uniform(float lo, float hi) { return lo + (hi - lo) * (float)(Next() & 0xFFFFFF) / (float)0x1000000; }
+};
@@ -0,0 +1,64 @@
+#pragma once
+// Synthetic depth for the TSDF tests and benchmark: a pinhole depth camera
+// looking at spheres, rendered by ray casting.
+
+#include "mltsdfvolume.h"
+
+#include <cmath>
+#include <vector>
+
+struct SceneSphere {
+    float center[3];
+    float radius;
+};
+
+// Camera at eye looking at target, world +z up. Depth camera axes: +x right,
+// +y down, +z forward (the columns of R).
+inline TsdfRigid LookAt(const float eye[3], const float target[3]) {
+    float f[3] = {target[0] - eye[0], target[1] - eye[1], target[2] - eye[2]};
+    const float fl = std::sqrt(f[0] * f[0] + f[1] * f[1] + f[2] * f[2]);
+    for (float& c : f) c /= fl;
+    // right = f x up, down = f x right
+    float r[3] = {f[1], -f[0], 0.0f};
+    const float rl = std::sqrt(r[0] * r[0] + r[1] * r[1]);
+    for (float& c : r) c /= rl;
+    const float d[3] = {f[1] * r[2] - f[2] * r[1], f[2] * r[0] - f[0] * r[2], f[0] * r[1] - f[1] * r[0]};
+
+    TsdfRigid pose;
+    for (int i = 0; i < 3; i++) {
+        pose.R[i * 3 + 0] = r[i];
+        pose.R[i * 3 + 1] = d[i];
+        pose.R[i * 3 + 2] = f[i];
+        pose.t[i] = eye[i];
+    }
+    return pose;
+}
+
+// Depth along the camera z axis of the nearest sphere hit, 0 for a miss
+inline void RenderDepth(const std::vector<SceneSphere>& spheres, const TsdfCamera& camera, const TsdfRigid& pose,
+                        int32_t width, int32_t height, std::vector<float>& depth) {
+    depth.assign((size_t)width * height, 0.0f);
+    for (int32_t v = 0; v < height; v++) {
+        for (int32_t u = 0; u < width; u++) {
+            // Ray with camera z = 1, so the hit parameter is the depth
+            const float x = ((float)u + 0.5f - camera.cx) / camera.fx;
+            const float y = ((float)v + 0.5f - camera.cy) / camera.fy;
+            float dir[3];
+            for (int i = 0; i < 3; i++) dir[i] = pose.R[i * 3 + 0] * x + pose.R[i * 3 + 1] * y + pose.R[i * 3 + 2];
+
+            float best = 0.0f;
+            for (const SceneSphere& s : spheres) {
+                float oc[3];
+                for (int i = 0; i < 3; i++) oc[i] = pose.t[i] - s.center[i];
+                const float a = dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2];
+                const float b = 2.0f * (oc[0] * dir[0] + oc[1] * dir[1] + oc[2] * dir[2]);
+                const float c = oc[0] * oc[0] + oc[1] * oc[1] + oc[2] * oc[2] - s.radius * s.radius;
+                const float disc = b * b - 4.0f * a * c;
+                if (disc < 0.0f) continue;
+                const float t = (-b - std::sqrt(disc)) / (2.0f * a);
+                if (t > 0.0f && (best == 0.0f || t < best)) best = t;
+            }
+            depth[(size_t)v * width + u] = best;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+// Synthetic YUV 4:2:0 frames for the mlyuv.h tests and benchmark. Planes are
+// allocated to end exactly at their last sample, as camera planes may, so
+// ASan catches a kernel that reads past them.
+
+#include "mlyuv.h"
+#include "testing.h"
+
+#include <memory>
+
+enum TestChroma {
+    TestChroma_Planar = 0,   // separate U and V planes, pixel stride 1 (I420)
+    TestChroma_NV12 = 1,     // one interleaved plane, v == u + 1
+    TestChroma_NV21 = 2,     // one interleaved plane, u == v + 1
+    TestChroma_Stride3 = 3   // separate planes, pixel stride 3
+};
+
+inline const char* TestChromaName(TestChroma chroma) {
+    static const char* names[] = {"planar", "NV12", "NV21", "stride3"};
+    return names[chroma];
+}
+
+struct TestYuvFrame {
+    std::unique_ptr<uint8_t[]> y, u, v;   // v is unused for NV12/NV21
+    YuvImage image;
+};
+
+// rowPad: bytes added to every row stride
+inline TestYuvFrame MakeYuvFrame(int32_t width, int32_t height, int32_t rowPad, TestChroma chroma, TestRandom& rng) {
+    const int32_t chromaWidth = (width + 1) / 2;
+    const int32_t chromaHeight = (height + 1) / 2;
+    const int32_t pixelStride = chroma == TestChroma_Planar ? 1 : chroma == TestChroma_Stride3 ? 3 : 2;
+    const bool interleaved = chroma == TestChroma_NV12 || chroma == TestChroma_NV21;
+
+    TestYuvFrame frame;
+    YuvImage& image = frame.image;
+    image.width = width;
+    image.height = height;
+    image.yStride = width + rowPad;
+    image.uvStride = chromaWidth * pixelStride + rowPad;
+    image.uvPixelStride = pixelStride;
+
+    const size_t ySize = (size_t)(height - 1) * image.yStride + width;
+    const size_t uvSize = (size_t)(chromaHeight - 1) * image.uvStride + (size_t)(chromaWidth - 1) * pixelStride + 1 +
+                          (interleaved ? 1 : 0);
+    frame.y.reset(new uint8_t[ySize]);
+    frame.u.reset(new uint8_t[uvSize]);
+    for (size_t i = 0; i < ySize; i++) frame.y[i] = (uint8_t)rng.Next();
+    for (size_t i = 0; i < uvSize; i++) frame.u[i] = (uint8_t)rng.Next();
+
+    image.y = frame.y.get();
+    if (interleaved) {
+        image.u = frame.u.get() + (chroma == TestChroma_NV21 ? 1 : 0);
+        image.v = frame.u.get() + (chroma == TestChroma_NV21 ? 0 : 1);
+    } else {
+        frame.v.reset(new uint8_t[uvSize]);
+        for (size_t i = 0; i < uvSize; i++) frame.v[i] = (uint8_t)rng.Next();
+        image.u = frame.u.get();
+        image.v = frame.v.get();
+    }
+    return frame;
+}
+
+// Sample (x, y) of the U or V plane
+inline uint8_t ChromaAt(const YuvImage& image, const uint8_t* plane, int32_t x, int32_t y) {
+    return plane[(size_t)y * image.uvStride + (size_t)x * image.uvPixelStride];
+}